@@ -0,0 +1,414 @@
+#ifndef __AABB_TREE_H__
+#define __AABB_TREE_H__
+
+#define AABB_TREE_NULL		-1		// Null node index
+#define AABB_TREE_MARGIN	0.1f	// Proxy boxes are fattened by this much so small moves don't need a reinsert
+
+#include <utility>	// Get pairs
+#include "Bvh.h"	// Get bounding boxes
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for storing collision arbitrary data
+		namespace Data
+		{
+			// A node in the dynamic tree
+			struct AabbTreeNode
+			{
+				Aabb	b;			// Node bounds (fattened for leaves)
+				void*	data;		// User data (leaves only)
+				int		parent;		// Parent index (next free index while on the free list)
+				int		left;		// Left child index
+				int		right;		// Right child index
+				int		height;		// Height of the sub tree (0 for leaves, -1 when free)
+
+				inline bool IsLeaf() const { return left == AABB_TREE_NULL; }	// Return true if the node is a leaf
+			};
+
+			// A dynamic bounding volume tree of fattened proxy boxes, kept height balanced with rotations
+			// Insert, remove and move are O(log n), and candidate pairs are only gathered for proxies that moved
+			class AabbTree
+			{
+			private:
+				std::vector<AabbTreeNode>	_nodes;		// Node pool
+				std::vector<int>			_moved;		// Proxies that have been inserted or moved since the last pair update
+				int							_root;		// Root node index
+				int							_free;		// Head of the free list
+
+			public:
+				// Default constructor
+				inline AabbTree() : _root(AABB_TREE_NULL), _free(AABB_TREE_NULL) {}
+
+				inline void* GetData(int proxy) const { return _nodes[proxy].data; }	// Return proxy user data
+				inline const Aabb &GetFatAabb(int proxy) const { return _nodes[proxy].b; }	// Return the fattened proxy box
+				inline int GetHeight() const { return (_root == AABB_TREE_NULL) ? 0 : _nodes[_root].height; }	// Return the tree height
+
+				// Insert a new proxy and return its id
+				inline int CreateProxy(const Aabb &box, void* data)
+				{
+					int proxy = AllocateNode();		// Get a node
+
+					_nodes[proxy].b = box;		// Assign box
+					_nodes[proxy].b.Inflate(AABB_TREE_MARGIN);	// Fatten box
+					_nodes[proxy].data = data;	// Assign user data
+					_nodes[proxy].height = 0;	// Leaves have no height
+
+					InsertLeaf(proxy);	// Insert into the tree
+					_moved.push_back(proxy);	// New proxies need pairs
+
+					return proxy;	// Return id
+				}
+
+				// Remove a proxy from the tree
+				inline void DestroyProxy(int proxy)
+				{
+					RemoveLeaf(proxy);	// Remove from the tree
+					FreeNode(proxy);	// Return node to the pool
+
+					_moved.erase(std::remove(_moved.begin(), _moved.end(), proxy), _moved.end());	// Forget any pending move
+				}
+
+				// Update a proxy's box, only reinserting if it has left its fattened box
+				// Returns true if the proxy was reinserted
+				inline bool MoveProxy(int proxy, const Aabb &box)
+				{
+					if (_nodes[proxy].b.Contains(box))	// If the proxy still fits
+						return false;	// Return false
+
+					RemoveLeaf(proxy);	// Take the proxy out
+
+					_nodes[proxy].b = box;		// Assign box
+					_nodes[proxy].b.Inflate(AABB_TREE_MARGIN);	// Fatten box
+
+					InsertLeaf(proxy);	// Put the proxy back
+					_moved.push_back(proxy);	// Moved proxies need pairs
+
+					return true;	// Return true
+				}
+
+				// Call f(proxy) for every proxy whose fattened box overlaps the box, stopping early if f returns false
+				template <typename F>
+				inline void Query(const Aabb &box, F f) const
+				{
+					if (_root == AABB_TREE_NULL)	// If the tree is empty
+						return;		// Return from function
+
+					std::vector<int> stack;		// Traversal stack
+					stack.push_back(_root);		// Start at the root
+
+					while (!stack.empty())	// Iterate until every overlapping node has been visited
+					{
+						int id = stack.back();	// Get node
+						stack.pop_back();	// Pop node
+
+						const AabbTreeNode &node = _nodes[id];	// Get reference
+						if (!node.b.Overlaps(box))	// If the node misses the box
+							continue;	// Skip node
+
+						if (node.IsLeaf())	// If a proxy was reached
+						{
+							if (!f(id))		// If the caller is done
+								return;		// Return from function
+						}
+						else
+						{
+							stack.push_back(node.left);		// Visit left child
+							stack.push_back(node.right);	// Visit right child
+						}
+					}
+				}
+
+				// Call f(proxy, t_max) for every proxy whose fattened box is hit by the ray within t_max, nearest box first
+				// The callback may shorten t_max (closest hit) or return true to stop the traversal (any hit)
+				template <typename F>
+				inline void Raycast(const glm::vec3 &origin, const glm::vec3 &dir, float t_max, F f) const
+				{
+					if (_root == AABB_TREE_NULL)	// If the tree is empty
+						return;		// Return from function
+
+					glm::vec3 inv_dir = 1.0f / dir;		// Inverse direction for slab tests
+
+					float t_root = _nodes[_root].b.RayEntry(origin, inv_dir, t_max);	// Test root
+					if (t_root == FLT_MAX)	// If the ray misses the root
+						return;		// Return from function
+
+					std::vector<std::pair<int, float>> stack;	// Traversal stack of nodes and their entry distances
+					stack.push_back(std::make_pair(_root, t_root));		// Push root
+
+					while (!stack.empty())	// While there are nodes to visit
+					{
+						std::pair<int, float> top = stack.back();	// Get node
+						stack.pop_back();	// Pop node
+
+						if (top.second > t_max)		// If the node is further than the current hit
+							continue;	// Skip node
+
+						const AabbTreeNode &node = _nodes[top.first];	// Get reference
+
+						if (node.IsLeaf())	// If a proxy was reached
+						{
+							if (f(top.first, t_max))	// Visit proxy
+								return;		// Stop if the callback asked to
+						}
+						else	// Otherwise visit children
+						{
+							int l = node.left, r = node.right;	// Child indices
+							float tl = _nodes[l].b.RayEntry(origin, inv_dir, t_max);	// Left entry distance
+							float tr = _nodes[r].b.RayEntry(origin, inv_dir, t_max);	// Right entry distance
+
+							if (tl > tr) { std::swap(l, r); std::swap(tl, tr); }	// Order nearest first
+
+							if (tr != FLT_MAX) stack.push_back(std::make_pair(r, tr));	// Push far child first
+							if (tl != FLT_MAX) stack.push_back(std::make_pair(l, tl));	// Push near child last so it is visited first
+						}
+					}
+				}
+
+				// Gather the candidate pairs between proxies that moved since the last call and everything they overlap
+				// Each pair is stored once with the lowest proxy id first
+				inline void UpdatePairs(std::vector<std::pair<int, int>> &out_pairs)
+				{
+					out_pairs.clear();	// Reset pair list
+
+					for (int proxy : _moved)	// Iterate through each moved proxy
+					{
+						Query(_nodes[proxy].b, [&](int other)	// Find everything it overlaps
+						{
+							if (other != proxy)		// Don't pair with itself
+								out_pairs.push_back(std::make_pair(std::min(proxy, other), std::max(proxy, other)));	// Add ordered pair
+
+							return true;	// Keep going
+						});
+					}
+
+					std::sort(out_pairs.begin(), out_pairs.end());	// Sort pairs so duplicates are adjacent
+					out_pairs.erase(std::unique(out_pairs.begin(), out_pairs.end()), out_pairs.end());	// Remove pairs found from both sides
+
+					_moved.clear();		// Reset moved list
+				}
+
+			private:
+				// Get a node from the free list or grow the pool
+				inline int AllocateNode()
+				{
+					if (_free == AABB_TREE_NULL)	// If the pool is full
+					{
+						_nodes.push_back(AabbTreeNode());	// Grow pool
+						_free = (int)_nodes.size() - 1;		// New node is free
+						_nodes[_free].parent = AABB_TREE_NULL;	// End of free list
+					}
+
+					int id = _free;		// Take the head
+					_free = _nodes[id].parent;	// Advance free list
+
+					_nodes[id].parent = AABB_TREE_NULL;		// Reset parent
+					_nodes[id].left = AABB_TREE_NULL;	// Reset left child
+					_nodes[id].right = AABB_TREE_NULL;	// Reset right child
+					_nodes[id].height = 0;	// Reset height
+					_nodes[id].data = NULL;		// Reset user data
+
+					return id;	// Return node
+				}
+
+				// Return a node to the free list
+				inline void FreeNode(int id)
+				{
+					_nodes[id].parent = _free;	// Link to free list
+					_nodes[id].height = -1;		// Mark as free
+					_free = id;		// New head
+				}
+
+				// Insert a leaf, choosing the sibling that grows the total surface area the least
+				inline void InsertLeaf(int leaf)
+				{
+					if (_root == AABB_TREE_NULL)	// If the tree is empty
+					{
+						_root = leaf;	// Leaf becomes the root
+						_nodes[_root].parent = AABB_TREE_NULL;	// Root has no parent
+						return;		// Return from function
+					}
+
+					// ------------------------- FIND THE BEST SIBLING -------------------------
+					Aabb leaf_box = _nodes[leaf].b;		// Get box
+					int index = _root;	// Start at the root
+
+					while (!_nodes[index].IsLeaf())		// Descend until a leaf is reached
+					{
+						int left = _nodes[index].left;		// Left child
+						int right = _nodes[index].right;	// Right child
+
+						float area = _nodes[index].b.SurfaceArea();		// Area of this node
+
+						Aabb combined = _nodes[index].b;	// This node grown by the leaf
+						combined.Grow(leaf_box);
+						float combined_area = combined.SurfaceArea();	// Area if the leaf is paired here
+
+						float cost = 2.0f * combined_area;	// Cost of a new parent here
+						float inheritance = 2.0f * (combined_area - area);	// Cost pushed down to the children
+
+						float cost_left = ChildCost(left, leaf_box) + inheritance;		// Cost of descending left
+						float cost_right = ChildCost(right, leaf_box) + inheritance;	// Cost of descending right
+
+						if (cost < cost_left && cost < cost_right)	// If pairing here is cheapest
+							break;	// Break from loop
+
+						index = (cost_left < cost_right) ? left : right;	// Descend
+					}
+
+					// ------------------------- CREATE A NEW PARENT -------------------------
+					int sibling = index;	// Chosen sibling
+					int old_parent = _nodes[sibling].parent;	// Sibling's parent
+					int new_parent = AllocateNode();	// New parent for the sibling and leaf
+
+					_nodes[new_parent].parent = old_parent;		// Link upwards
+					_nodes[new_parent].b = leaf_box;	// Enclose both
+					_nodes[new_parent].b.Grow(_nodes[sibling].b);
+					_nodes[new_parent].height = _nodes[sibling].height + 1;		// One above the sibling
+					_nodes[new_parent].left = sibling;	// Link children
+					_nodes[new_parent].right = leaf;
+
+					if (old_parent != AABB_TREE_NULL)	// If the sibling was not the root
+					{
+						if (_nodes[old_parent].left == sibling) _nodes[old_parent].left = new_parent;	// Replace left link
+						else _nodes[old_parent].right = new_parent;		// Replace right link
+					}
+					else
+						_root = new_parent;		// New parent is the root
+
+					_nodes[sibling].parent = new_parent;	// Link sibling
+					_nodes[leaf].parent = new_parent;	// Link leaf
+
+					FixUpwards(new_parent);		// Refit and rebalance ancestors
+				}
+
+				// Remove a leaf and collapse its parent
+				inline void RemoveLeaf(int leaf)
+				{
+					if (leaf == _root)	// If the leaf is the whole tree
+					{
+						_root = AABB_TREE_NULL;		// Tree is now empty
+						return;		// Return from function
+					}
+
+					int parent = _nodes[leaf].parent;	// Get parent
+					int grand_parent = _nodes[parent].parent;	// Get grand parent
+					int sibling = (_nodes[parent].left == leaf) ? _nodes[parent].right : _nodes[parent].left;	// Get sibling
+
+					if (grand_parent != AABB_TREE_NULL)		// If the parent was not the root
+					{
+						if (_nodes[grand_parent].left == parent) _nodes[grand_parent].left = sibling;	// Replace left link
+						else _nodes[grand_parent].right = sibling;	// Replace right link
+
+						_nodes[sibling].parent = grand_parent;	// Link sibling upwards
+						FreeNode(parent);	// Discard parent
+
+						FixUpwards(grand_parent);	// Refit and rebalance ancestors
+					}
+					else
+					{
+						_root = sibling;	// Sibling is the new root
+						_nodes[sibling].parent = AABB_TREE_NULL;	// Root has no parent
+						FreeNode(parent);	// Discard parent
+					}
+
+					_nodes[leaf].parent = AABB_TREE_NULL;	// Detach leaf
+				}
+
+				// Return the cost of pushing a leaf down into a child
+				inline float ChildCost(int child, const Aabb &leaf_box) const
+				{
+					Aabb combined = _nodes[child].b;	// Child grown by the leaf
+					combined.Grow(leaf_box);
+
+					if (_nodes[child].IsLeaf())		// If the child is a leaf, a new parent would be created
+						return combined.SurfaceArea();	// Return new area
+
+					return combined.SurfaceArea() - _nodes[child].b.SurfaceArea();	// Return area growth
+				}
+
+				// Walk from a node to the root, rebalancing and refitting each ancestor
+				inline void FixUpwards(int index)
+				{
+					while (index != AABB_TREE_NULL)		// Iterate until past the root
+					{
+						index = Balance(index);		// Rebalance
+
+						int left = _nodes[index].left;		// Left child
+						int right = _nodes[index].right;	// Right child
+
+						_nodes[index].height = 1 + glm::max(_nodes[left].height, _nodes[right].height);	// Refit height
+						_nodes[index].b = _nodes[left].b;	// Refit box
+						_nodes[index].b.Grow(_nodes[right].b);
+
+						index = _nodes[index].parent;	// Move up
+					}
+				}
+
+				// Rotate the taller child of node a up if the sub tree is unbalanced, returning the new sub tree root
+				inline int Balance(int a)
+				{
+					if (_nodes[a].IsLeaf() || _nodes[a].height < 2)		// If the node can't be unbalanced
+						return a;	// Return unchanged
+
+					int b = _nodes[a].left;		// Left child
+					int c = _nodes[a].right;	// Right child
+					int balance = _nodes[c].height - _nodes[b].height;	// Height difference
+
+					if (balance > 1)	// If the right side is too tall
+						return Rotate(a, c, b, true);	// Rotate right child up
+
+					if (balance < -1)	// If the left side is too tall
+						return Rotate(a, b, c, false);	// Rotate left child up
+
+					return a;	// Return unchanged
+				}
+
+				// Rotate child up to replace a, where other is a's remaining child and child_is_right says which side child was on
+				inline int Rotate(int a, int child, int other, bool child_is_right)
+				{
+					int f = _nodes[child].left;		// Child's left
+					int g = _nodes[child].right;	// Child's right
+
+					// Child replaces a
+					_nodes[child].left = a;		// a becomes a child
+					_nodes[child].parent = _nodes[a].parent;	// Take a's parent
+					_nodes[a].parent = child;	// Link a
+
+					if (_nodes[child].parent != AABB_TREE_NULL)		// If a was not the root
+					{
+						int p = _nodes[child].parent;	// Get parent
+						if (_nodes[p].left == a) _nodes[p].left = child;	// Replace left link
+						else _nodes[p].right = child;	// Replace right link
+					}
+					else
+						_root = child;	// Child is the new root
+
+					// Keep the taller grand child under child, move the shorter one under a
+					int keep = (_nodes[f].height > _nodes[g].height) ? f : g;	// Taller grand child
+					int give = (keep == f) ? g : f;		// Shorter grand child
+
+					_nodes[child].right = keep;		// Keep taller
+					if (child_is_right) _nodes[a].right = give;		// Give shorter to a (replaces child's slot)
+					else _nodes[a].left = give;
+					_nodes[give].parent = a;	// Link shorter
+
+					_nodes[a].b = _nodes[other].b;	// Refit a
+					_nodes[a].b.Grow(_nodes[give].b);
+					_nodes[a].height = 1 + glm::max(_nodes[other].height, _nodes[give].height);
+
+					_nodes[child].b = _nodes[a].b;	// Refit child
+					_nodes[child].b.Grow(_nodes[keep].b);
+					_nodes[child].height = 1 + glm::max(_nodes[a].height, _nodes[keep].height);
+
+					return child;	// Return new sub tree root
+				}
+			};
+		}
+	}
+}
+
+#endif
@@ -4,6 +4,13 @@
 #include "Object.h"		// Derive from object
 #include "Transform.h"	// Include our transformation data
 #include "Collision.h"	// Include collision
+#include "AabbTree.h"	// Include broad phase proxy ids
+#include "LooseOctree.h"	// Include spatial index proxy ids
+#include "TransformStore.h"	// Include transform hierarchy
+#include "ComponentArray.h"	// Include component handles
+#include "RenderSnapshot.h"	// Include render buffer indices
+
+#define ACTOR_GROUP_NONE	-1	// Update group of actors that only touch themselves in Update
 
 using namespace Collision::Ndc::Data;	// Get scoped namespace
 
@@ -25,15 +32,29 @@ protected:
 	unsigned int	_u_sel;		// The selected unfirom
 
 	CollisionData*	_cd;		// Collision data
+	int				_proxy;		// Broad phase proxy id (AABB_TREE_NULL if not in the tree)
+	int				_octree;	// Spatial index proxy id (OCTREE_NULL if not in the octree)
+	bool			_dirty;		// Has the transform changed since the broad phase last saw it?
+
+	TransformStore*	_store;		// Transform store that owns the world matrix (NULL if the actor computes its own)
+	int				_node;		// Transform handle within the store (TRANSFORM_NULL if not stored)
+	int				_component;	// Handle within the map's component array for this actor's type (COMPONENT_NULL if not stored)
+	int				_group;		// Update group, actors sharing one update in order on one thread (ACTOR_GROUP_NONE if independent)
+	bool			_main;		// Must the actor update on the main thread (touches OpenGL or other actors)?
+
+	glm::mat4		_prev_mat;	// Model matrix at the start of the last simulation tick
+	glm::vec3		_prev_pos;	// Position at the start of the last simulation tick
+	glm::mat4		_draw[RENDER_BUFFERS];	// Model matrix blended between the last two ticks, one per render snapshot
+	bool			_saved;		// Has a tick saved the previous state yet?
 
 public:
 	
 
 	// Default constructor - initialise variables
-	inline Actor() : _sel(false), _act(true), _col(false), _mov(false), _trans({ glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f), glm::mat4(0.0f) }) { _t = ACTOR; }
+	inline Actor() : _sel(false), _act(true), _col(false), _mov(false), _cd(NULL), _proxy(AABB_TREE_NULL), _octree(OCTREE_NULL), _dirty(true), _store(NULL), _node(TRANSFORM_NULL), _component(COMPONENT_NULL), _group(ACTOR_GROUP_NONE), _main(false), _saved(false), _draw{ glm::mat4(1.0f), glm::mat4(1.0f) }, _trans({ glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f), glm::mat4(0.0f) }) { _t = ACTOR; }
 
 	// Initial constructor
-	inline Actor(const char* name, bool active, bool collidable, bool movable, glm::vec3 position, glm::vec3 scale, glm::vec3 rotation)
+	inline Actor(const char* name, bool active, bool collidable, bool movable, glm::vec3 position, glm::vec3 scale, glm::vec3 rotation) : _cd(NULL), _proxy(AABB_TREE_NULL), _octree(OCTREE_NULL), _dirty(true), _store(NULL), _node(TRANSFORM_NULL), _component(COMPONENT_NULL), _group(ACTOR_GROUP_NONE), _main(false), _saved(false), _draw{ glm::mat4(1.0f), glm::mat4(1.0f) }
 	{
 		_t = ACTOR;		// Set the object type to ACTOR
 
@@ -65,7 +86,16 @@ public:
 	inline glm::vec3 &GetScale() { return _trans._sca; }		// Return scale
 	inline glm::vec3 &GetRotation() { return _trans._rot; }		// Return rotation
 	inline glm::mat4 &GetMatrix() { return _trans._mat; }	// Return model matrix
+	inline const glm::mat4 &GetRenderMatrix() { return _draw[RenderSnapshot::Front()]; }	// Return the model matrix to draw with, as published for the front snapshot
+	inline const glm::mat4 &GetDrawMatrix(unsigned int snapshot) { return _draw[snapshot]; }	// Return the model matrix published for a snapshot
 	inline CollisionData* GetCollisionData() { return _cd; }	// Return the collision object
+	inline int GetProxy() { return _proxy; }	// Return the broad phase proxy id
+	inline int GetOctreeProxy() { return _octree; }	// Return the spatial index proxy id
+	inline bool IsDirty() { return _dirty; }	// Return dirty
+	inline int GetNode() { return _node; }	// Return the transform handle
+	inline int GetComponent() { return _component; }	// Return the component handle
+	inline int GetUpdateGroup() { return _group; }	// Return the update group
+	inline bool IsMainThreadOnly() { return _main; }	// Return main thread only
 
 	inline void SetMatrixUniformLocation(unsigned int value) { _u_mat = value; }	// Assign our model matrix uniform location 
 	inline void SetActive(bool value) { _act = value; }		// Assign our active value
@@ -77,25 +107,77 @@ public:
 	inline void SetRotation(glm::vec3 value) { _trans._rot = value; }	 // Assign our rotation as a vec3
 
 	inline void SetMatrix(glm::mat4 value) { _trans._mat = value; }	 // Assign our model matrix as a mat4
-	inline void SetCollisionData(CollisionData* value) { _cd = value; }		// Assign collision data
+	inline void SetCollisionData(CollisionData* value) { _cd = value; _dirty = true; }		// Assign collision data
+	inline void SetProxy(int value) { _proxy = value; }		// Assign the broad phase proxy id
+	inline void SetOctreeProxy(int value) { _octree = value; }	// Assign the spatial index proxy id
+	inline void SetDirty(bool value) { _dirty = value; }	// Assign dirty
+	inline void SetNode(TransformStore* store, int node) { _store = store; _node = node; }	// Assign the transform store and handle
+	inline void SetComponent(int value) { _component = value; }	// Assign the component handle
+	inline void SetUpdateGroup(int value) { _group = value; }	// Assign the update group
+	inline void SetMainThreadOnly(bool value) { _main = value; }	// Assign main thread only
+
+	// Return the world bounds of the collision data
+	inline Aabb GetBounds()
+	{
+		if (!_cd)		// If there is no collision geometry
+			return Aabb(_trans._pos, _trans._pos);	// Return a point at the actor position
+
+		return _cd->wb;		// Return the world bounds
+	}
 
 	// This function will tick the model matrix
 	inline void UpdateModel()
 	{
-		_trans._mat = glm::scale(_trans._sca) *	// Assign the position
-			glm::rotate(glm::radians(_trans._rot.x), glm::vec3(1.0f, 0.0f, 0.0f)) *		// Rotation X
-			glm::rotate(glm::radians(_trans._rot.y), glm::vec3(0.0f, 1.0f, 0.0f)) *		// Rotation Y
-			glm::rotate(glm::radians(_trans._rot.z), glm::vec3(0.0f, 0.0f, 1.0f)) *		// Rotation Z
-			glm::translate(_trans._pos);	// And the scale
+		glm::quat rot = Transform::EulerToQuat(_trans._rot);	// Euler rotation as a quaternion
+
+		if (_store)		// If the store owns the world matrix
+		{
+			_store->SetLocal(_node, _trans._pos, rot, _trans._sca);	// Queue the new local transform, the world matrix arrives with ApplyWorld
+			return;		// Return from function
+		}
+
+		ApplyWorld(Transform::Compose(_trans._pos, rot, _trans._sca));	// Scale * rotate * translate, as maps are authored
+	}
+
+	// This function will assign the world matrix and move the collision data with it
+	inline void ApplyWorld(const glm::mat4 &world)
+	{
+		_trans._mat = world;	// Assign model matrix
+
+		if (_cd)	// If there is collision data
+			_cd->Update(_trans._mat);	// Move collision into the new frame (geometry stays in local space)
+
+		_dirty = true;	// Broad phase needs to see the new transform
 	}
 
 	// This function will update the collision data (interpolated objects only)
 	inline void UpdateCollision()
 	{
 		_cd->Update(_trans._mat);	// Update transformation
+		_dirty = true;	// Broad phase needs to see the new bounds
+	}
+
+	// Remember the transform at the start of a simulation tick, for interpolating towards the next
+	inline void SaveState()
+	{
+		_prev_mat = _trans._mat;	// Save model matrix
+		_prev_pos = _trans._pos;	// Save position
+		_saved = true;	// The previous state is valid now
+	}
+
+	// Publish the render matrix to the back snapshot, blended between the last two ticks (alpha is how far we are into the next tick)
+	inline virtual void Interpolate(float alpha)
+	{
+		if (_saved && alpha < 1.0f)		// If there is a previous tick to blend from
+			_draw[RenderSnapshot::Back()] = Transform::Blend(_prev_mat, _trans._mat, alpha);	// Blend model matrix (returns the current one if the actor didn't move)
+		else
+			_draw[RenderSnapshot::Back()] = _trans._mat;	// Draw the current model matrix
 	}
 
 	// Set virtual functions for deriving classes
+	// Update may run on a worker beside other actors (see Map::UpdateActors), so there it may only touch this actor:
+	// its own getters and transform setters, UpdateModel, ApplyWorld and UpdateCollision are safe
+	// Touching other actors, parenting, adding or removing actors, SetCollisionData and OpenGL calls are not; use SetUpdateGroup or SetMainThreadOnly
 	inline virtual void Update(double& delta) = 0;
 	inline virtual void Render() = 0;
 };
@@ -37,7 +37,7 @@ public:
 	// Render override
 	inline virtual void Render() 
 	{
-		glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(_trans._mat));	// Bind our uniform data
+		glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(GetRenderMatrix()));	// Bind our uniform data
 
 		_vao->Bind();	// Bind our vao
 
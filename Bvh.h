@@ -0,0 +1,418 @@
+#ifndef __BVH_H__
+#define __BVH_H__
+
+#define BVH_LEAF_SIZE		4	// Preferred number of primitives per leaf
+#define BVH_MAX_LEAF_SIZE	16	// Max number of primitives per leaf before a split is forced
+#define BVH_SAH_BINS		12	// Number of bins used when evaluating the surface area heuristic
+#define BVH_MAX_DEPTH		60	// Max tree depth (keeps the traversal stack bounded)
+#define BVH_STACK_SIZE		64	// Traversal stack size
+
+#include <vector>	// Get dynamic arrays
+#include <cfloat>	// Get float limits
+#include <algorithm>	// Get partition
+#include <glm/glm.hpp>	// Get glm variables
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for storing collision arbitrary data
+		namespace Data
+		{
+			// Axis aligned bounding box
+			struct Aabb
+			{
+				glm::vec3 min;	// Min corner
+				glm::vec3 max;	// Max corner
+
+				// Default constructor (empty box)
+				inline Aabb() : min(glm::vec3(FLT_MAX)), max(glm::vec3(-FLT_MAX)) {}
+
+				// Initial constructor
+				inline Aabb(glm::vec3 box_min, glm::vec3 box_max) : min(box_min), max(box_max) {}
+
+				inline glm::vec3 Centre() const { return (min + max) * 0.5f; }	// Return the centre of the box
+				inline glm::vec3 Extent() const { return max - min; }	// Return the size of the box
+				inline bool IsEmpty() const { return (min.x > max.x); }	// Return true if nothing has been added to the box
+
+				// Grow the box to contain a point
+				inline void Grow(const glm::vec3 &p)
+				{
+					min = glm::min(min, p);		// Expand min corner
+					max = glm::max(max, p);		// Expand max corner
+				}
+
+				// Grow the box to contain another box
+				inline void Grow(const Aabb &b)
+				{
+					min = glm::min(min, b.min);		// Expand min corner
+					max = glm::max(max, b.max);		// Expand max corner
+				}
+
+				// Inflate the box by a scalar on every side
+				inline void Inflate(float value)
+				{
+					min -= glm::vec3(value);	// Push out min corner
+					max += glm::vec3(value);	// Push out max corner
+				}
+
+				// Return the surface area of the box
+				inline float SurfaceArea() const
+				{
+					if (IsEmpty()) return 0.0f;		// Empty boxes have no area
+
+					glm::vec3 e = max - min;	// Get the extent
+
+					return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);	// Return area of all six faces
+				}
+
+				// Return true if this box overlaps box b
+				inline bool Overlaps(const Aabb &b) const
+				{
+					return (min.x <= b.max.x && max.x >= b.min.x) &&
+						(min.y <= b.max.y && max.y >= b.min.y) &&
+						(min.z <= b.max.z && max.z >= b.min.z);		// Return result of each axis
+				}
+
+				// Return true if the point is inside the box
+				inline bool Contains(const glm::vec3 &p) const
+				{
+					return (p.x >= min.x && p.x <= max.x) && (p.y >= min.y && p.y <= max.y) && (p.z >= min.z && p.z <= max.z);	// Return result of each axis
+				}
+
+				// Return true if box b is entirely inside this box
+				inline bool Contains(const Aabb &b) const
+				{
+					return (b.min.x >= min.x && b.max.x <= max.x) && (b.min.y >= min.y && b.max.y <= max.y) && (b.min.z >= min.z && b.max.z <= max.z);	// Return result of each axis
+				}
+
+				// Return the box that encloses this box after a transform
+				inline Aabb Transform(const glm::mat4 &m) const
+				{
+					if (IsEmpty()) return *this;	// Empty boxes stay empty
+
+					glm::vec3 c = glm::vec3(m * glm::vec4(Centre(), 1.0f));		// Transformed centre
+					glm::vec3 h = Extent() * 0.5f;	// Half extent
+					glm::vec3 e = glm::abs(glm::vec3(m[0])) * h.x + glm::abs(glm::vec3(m[1])) * h.y + glm::abs(glm::vec3(m[2])) * h.z;	// Transformed half extent
+
+					return Aabb(c - e, c + e);	// Return box
+				}
+
+				// Return the ray entry distance (FLT_MAX if the ray misses within t_max)
+				inline float RayEntry(const glm::vec3 &origin, const glm::vec3 &inv_dir, float t_max) const
+				{
+					glm::vec3 t0 = (min - origin) * inv_dir;	// Distances to min slabs
+					glm::vec3 t1 = (max - origin) * inv_dir;	// Distances to max slabs
+
+					glm::vec3 t_near = glm::min(t0, t1);	// Near slab distances
+					glm::vec3 t_far = glm::max(t0, t1);		// Far slab distances
+
+					float t_enter = glm::max(glm::max(t_near.x, t_near.y), glm::max(t_near.z, 0.0f));	// Latest entry
+					float t_exit = glm::min(glm::min(t_far.x, t_far.y), glm::min(t_far.z, t_max));	// Earliest exit
+
+					return (t_enter <= t_exit) ? t_enter : FLT_MAX;		// Return entry distance or miss
+				}
+			};
+
+			// A node in the bounding volume hierarchy
+			struct BvhNode
+			{
+				Aabb			b;		// Node bounds
+				unsigned int	first;	// First primitive (leaf) or left child index (interior)
+				unsigned int	count;	// Primitive count (zero for interior nodes)
+
+				inline bool IsLeaf() const { return count > 0; }	// Return true if the node is a leaf
+			};
+
+			// A bounding volume hierarchy built with the surface area heuristic over a list of primitive bounds
+			// Children are always stored after their parent, which allows a bottom-up refit in a single reverse pass
+			struct Bvh
+			{
+				std::vector<BvhNode>		nodes;	// Flat node list (root is node 0, siblings are adjacent)
+				std::vector<unsigned int>	prims;	// Primitive indices ordered by leaf
+
+				// Build the hierarchy from a list of primitive bounds
+				inline void Build(const std::vector<Aabb> &bounds)
+				{
+					unsigned int n = (unsigned int)bounds.size();	// Number of primitives
+
+					nodes.clear();	// Clear last nodes
+					prims.resize(n);	// Allocate primitive indices
+
+					if (n == 0)	// If there is nothing to build...
+						return;		// Return from function
+
+					std::vector<glm::vec3> c(n);	// Primitive centroids
+
+					for (unsigned int i = 0; i < n; i++)	// Iterate through each primitive
+					{
+						prims[i] = i;	// Assign primitive index
+						c[i] = bounds[i].Centre();	// Assign centroid
+					}
+
+					nodes.reserve(2 * n);	// A binary tree never exceeds 2n - 1 nodes
+					nodes.push_back({ Aabb(), 0, n });	// Create root node
+
+					std::vector<std::pair<unsigned int, unsigned int>> stack;	// Nodes waiting to be split (node, depth)
+					stack.push_back({ 0, 0 });	// Begin with the root
+
+					while (!stack.empty())	// While there are nodes to split
+					{
+						unsigned int ni = stack.back().first;	// Current node index
+						unsigned int depth = stack.back().second;	// Current node depth
+						stack.pop_back();	// Remove from stack
+
+						unsigned int first = nodes[ni].first;	// First primitive
+						unsigned int count = nodes[ni].count;	// Primitive count
+
+						Aabb nb, cb;	// Node bounds and centroid bounds
+						for (unsigned int i = first; i < first + count; i++)	// Iterate through each primitive in node
+						{
+							nb.Grow(bounds[prims[i]]);	// Grow node bounds
+							cb.Grow(c[prims[i]]);	// Grow centroid bounds
+						}
+
+						nodes[ni].b = nb;	// Assign node bounds
+
+						if (count <= BVH_LEAF_SIZE || depth >= BVH_MAX_DEPTH)	// If the node is small enough (or too deep)...
+							continue;	// Keep as leaf
+
+						// ------------------------- EVALUATE SAH SPLITS -------------------------
+						int best_axis = -1;		// Best split axis
+						unsigned int best_bin = 0;	// Best split bin
+						float best_cost = FLT_MAX;	// Best split cost
+
+						for (int axis = 0; axis < 3; axis++)	// Iterate through each axis
+						{
+							float extent = cb.max[axis] - cb.min[axis];		// Centroid extent along axis
+							if (extent <= 0.0f)		// If all centroids are flat on this axis...
+								continue;	// Skip axis
+
+							Aabb bin_b[BVH_SAH_BINS];	// Bin bounds
+							unsigned int bin_c[BVH_SAH_BINS] = { 0 };	// Bin counts
+							float scale = BVH_SAH_BINS / extent;	// Centroid to bin scale
+
+							for (unsigned int i = first; i < first + count; i++)	// Iterate through each primitive in node
+							{
+								unsigned int b = std::min((unsigned int)((c[prims[i]][axis] - cb.min[axis]) * scale), (unsigned int)BVH_SAH_BINS - 1);	// Get bin
+								bin_b[b].Grow(bounds[prims[i]]);	// Grow bin bounds
+								bin_c[b]++;		// Increment bin count
+							}
+
+							float right_area[BVH_SAH_BINS];		// Accumulated right side areas
+							unsigned int right_count[BVH_SAH_BINS];		// Accumulated right side counts
+							Aabb acc;	// Accumulator
+							unsigned int acc_c = 0;		// Count accumulator
+
+							for (int b = BVH_SAH_BINS - 1; b > 0; b--)	// Sweep from the right
+							{
+								acc.Grow(bin_b[b]);		// Grow bounds
+								acc_c += bin_c[b];	// Add count
+								right_area[b] = acc.SurfaceArea();	// Record area
+								right_count[b] = acc_c;		// Record count
+							}
+
+							acc = Aabb();	// Reset accumulator
+							acc_c = 0;	// Reset count
+
+							for (unsigned int b = 1; b < BVH_SAH_BINS; b++)		// Sweep from the left
+							{
+								acc.Grow(bin_b[b - 1]);		// Grow bounds
+								acc_c += bin_c[b - 1];	// Add count
+
+								if (acc_c == 0 || right_count[b] == 0)	// If either side is empty...
+									continue;	// Skip split
+
+								float cost = acc_c * acc.SurfaceArea() + right_count[b] * right_area[b];	// Calculate split cost
+
+								if (cost < best_cost)	// If this is the cheapest split so far...
+								{
+									best_cost = cost;	// Record cost
+									best_axis = axis;	// Record axis
+									best_bin = b;	// Record bin
+								}
+							}
+						}
+
+						// ------------------------- PARTITION PRIMITIVES -------------------------
+						unsigned int left_count = 0;	// Number of primitives on the left
+
+						if (best_axis != -1)	// If a valid split was found
+						{
+							float leaf_cost = count * nb.SurfaceArea();		// Cost of not splitting
+
+							if (best_cost >= leaf_cost && count <= BVH_MAX_LEAF_SIZE)	// If splitting is not worth it
+								continue;	// Keep as leaf
+
+							float scale = BVH_SAH_BINS / (cb.max[best_axis] - cb.min[best_axis]);	// Centroid to bin scale
+							float lo = cb.min[best_axis];	// Min centroid on axis
+
+							unsigned int* mid = std::partition(&prims[first], &prims[first] + count, [&](unsigned int p)
+							{
+								return std::min((unsigned int)((c[p][best_axis] - lo) * scale), (unsigned int)BVH_SAH_BINS - 1) < best_bin;	// Left of split plane
+							});
+
+							left_count = (unsigned int)(mid - &prims[first]);	// Count left primitives
+						}
+
+						if (left_count == 0 || left_count == count)		// If every centroid is coincident
+						{
+							if (count <= BVH_MAX_LEAF_SIZE)		// If the leaf is still acceptable
+								continue;	// Keep as leaf
+
+							left_count = count / 2;		// Force an even split
+						}
+
+						unsigned int left = (unsigned int)nodes.size();		// Left child index
+						nodes.push_back({ Aabb(), first, left_count });		// Create left child
+						nodes.push_back({ Aabb(), first + left_count, count - left_count });	// Create right child
+
+						nodes[ni].first = left;		// Point to children
+						nodes[ni].count = 0;	// Mark as interior
+
+						stack.push_back({ left, depth + 1 });	// Split left child
+						stack.push_back({ left + 1, depth + 1 });	// Split right child
+					}
+				}
+
+				// Refit the hierarchy to updated primitive bounds without changing its topology
+				inline void Refit(const std::vector<Aabb> &bounds)
+				{
+					for (unsigned int i = (unsigned int)nodes.size(); i-- > 0;)	// Iterate backwards so children are refit before parents
+					{
+						BvhNode &node = nodes[i];	// Temp reference to node i
+						node.b = Aabb();	// Reset bounds
+
+						if (node.IsLeaf())	// If node is a leaf
+						{
+							for (unsigned int k = node.first; k < node.first + node.count; k++)		// Iterate through each primitive
+								node.b.Grow(bounds[prims[k]]);	// Grow bounds
+						}
+						else	// Otherwise if node is interior
+						{
+							node.b.Grow(nodes[node.first].b);	// Grow by left child
+							node.b.Grow(nodes[node.first + 1].b);	// Grow by right child
+						}
+					}
+				}
+
+				// Reorder primitives into leaf order so every leaf covers a contiguous range of primitive ids
+				// Returns the old primitive index of each new slot, which the owner must use to permute its primitive arrays
+				inline std::vector<unsigned int> Flatten()
+				{
+					std::vector<unsigned int> order = prims;	// Old primitive index per slot
+
+					for (unsigned int i = 0; i < prims.size(); i++)		// Iterate through each slot
+						prims[i] = i;	// Primitives are now stored in leaf order
+
+					return order;	// Return permutation
+				}
+
+				// Call f(first, count) for every leaf that overlaps the box
+				template <typename F>
+				inline void QueryLeaves(const Aabb &box, F f) const
+				{
+					if (nodes.empty())	// If tree is empty
+						return;		// Return from function
+
+					unsigned int stack[BVH_STACK_SIZE];		// Traversal stack
+					unsigned int sp = 0;	// Stack pointer
+					stack[sp++] = 0;	// Push root
+
+					while (sp > 0)	// While there are nodes to visit
+					{
+						const BvhNode &node = nodes[stack[--sp]];	// Pop node
+
+						if (!node.b.Overlaps(box))	// If the node is outside the query box
+							continue;	// Skip node
+
+						if (node.IsLeaf())	// If node is a leaf
+							f(node.first, node.count);	// Visit leaf
+						else	// Otherwise visit children
+						{
+							stack[sp++] = node.first;	// Push left child
+							stack[sp++] = node.first + 1;	// Push right child
+						}
+					}
+				}
+
+				// Call f(primitive) for every primitive whose leaf overlaps the box
+				template <typename F>
+				inline void Query(const Aabb &box, F f) const
+				{
+					QueryLeaves(box, [&](unsigned int first, unsigned int count)	// Visit each overlapping leaf
+					{
+						for (unsigned int k = first; k < first + count; k++)	// Iterate through each primitive
+							f(prims[k]);	// Visit primitive
+					});
+				}
+
+				// Call f(first, count, t_max) for every leaf hit by the ray, nearest first
+				// The callback may shorten t_max (closest hit) or return true to stop the traversal (any hit)
+				template <typename F>
+				inline void RaycastLeaves(const glm::vec3 &origin, const glm::vec3 &dir, float t_max, F f) const
+				{
+					if (nodes.empty())	// If tree is empty
+						return;		// Return from function
+
+					glm::vec3 inv_dir = 1.0f / dir;		// Inverse direction for slab tests
+
+					unsigned int stack[BVH_STACK_SIZE];		// Traversal stack
+					float stack_t[BVH_STACK_SIZE];		// Entry distance of each stacked node
+					unsigned int sp = 0;	// Stack pointer
+
+					float t_root = nodes[0].b.RayEntry(origin, inv_dir, t_max);		// Test root
+					if (t_root == FLT_MAX)	// If the ray misses the root
+						return;		// Return from function
+
+					stack[sp] = 0; stack_t[sp++] = t_root;	// Push root
+
+					while (sp > 0)	// While there are nodes to visit
+					{
+						sp--;	// Pop node
+						if (stack_t[sp] > t_max)	// If the node is further than the current hit
+							continue;	// Skip node
+
+						const BvhNode &node = nodes[stack[sp]];		// Temp reference to node
+
+						if (node.IsLeaf())	// If node is a leaf
+						{
+							if (f(node.first, node.count, t_max))	// Visit leaf
+								return;		// Stop if the callback asked to
+						}
+						else	// Otherwise visit children
+						{
+							unsigned int l = node.first, r = node.first + 1;	// Child indices
+							float tl = nodes[l].b.RayEntry(origin, inv_dir, t_max);		// Left entry distance
+							float tr = nodes[r].b.RayEntry(origin, inv_dir, t_max);		// Right entry distance
+
+							if (tl > tr) { std::swap(l, r); std::swap(tl, tr); }	// Order nearest first
+
+							if (tr != FLT_MAX) { stack[sp] = r; stack_t[sp++] = tr; }	// Push far child first
+							if (tl != FLT_MAX) { stack[sp] = l; stack_t[sp++] = tl; }	// Push near child last so it is visited first
+						}
+					}
+				}
+
+				// Call f(primitive, t_max) for every primitive whose leaf is hit by the ray, nearest first
+				// The callback may shorten t_max (closest hit) or return true to stop the traversal (any hit)
+				template <typename F>
+				inline void Raycast(const glm::vec3 &origin, const glm::vec3 &dir, float t_max, F f) const
+				{
+					RaycastLeaves(origin, dir, t_max, [&](unsigned int first, unsigned int count, float &t) -> bool	// Visit each leaf along the ray
+					{
+						for (unsigned int k = first; k < first + count; k++)	// Iterate through each primitive
+							if (f(prims[k], t))		// Visit primitive
+								return true;	// Stop traversal
+
+						return false;	// Keep going
+					});
+				}
+			};
+		}
+	}
+}
+
+#endif
@@ -4,6 +4,7 @@
 #define ORTHO			0x1		// Define an ortho mode
 #define PERSPECTIVE		0x2		// Define a perspective mode
 
+#include <glew.h>	// Include gl
 #include "Actor.h"		// Extend from our abstrct class
 #include "Globals.h"	// Get access to width and height of viewport 
 #include "Keyboard.h"	// Assign keycodes and states for our keyboard
@@ -52,6 +53,7 @@ protected:
 	glm::vec3	_velocity;	// The velocity vector
 	glm::vec3	_position_offset;	// The camera's position offset from player
 
+	glm::vec3	_eye;	// The position the view was last built from (interpolated between ticks)
 	glm::mat4	_view;	// The view matrix
 	glm::mat4	_proj;	// The projection matrix
 	
@@ -77,6 +79,7 @@ public:
 		_current_look_vector = FRONT;	// By default we set the look vector to front
 		_trans._pos = position - position_offset;		// Assign position
 		_position_offset = position_offset;		// Assign position offset
+		_eye = _trans._pos;		// Assign view position
 		_fov = fov;		// Assign feild-of-view
 		_near = n;	// Assign near plane
 		_far = f;		// Assign far plane
@@ -92,8 +95,9 @@ public:
 
 	inline int GetProjectionType() { return _proj_type; }	// Return the projection matrix type
 
-	inline glm::mat4 GetViewMatrix() { return glm::lookAt(_trans._pos, _trans._pos + _front, _up); }	// Function for getting LookAt matrix
+	inline glm::mat4 GetViewMatrix() { return glm::lookAt(_eye, _eye + _front, _up); }	// Function for getting LookAt matrix
 	inline glm::mat4 GetProjectionMatrix() { return _proj; }		// Function for getting projection matrix
+	inline glm::mat4 &GetUniformViewMatrix() { return _view; }		// Return the view matrix passed to the shaders (with the position offset)
 
 	inline glm::vec3 &GetPositionOffset() { return _position_offset; }	// Return the position offset
 	inline glm::vec3 &GetFront() { return _front; }	// Return the front vector
@@ -393,10 +397,28 @@ public:
 		return true;
 	}
 
-	// Update view matrix
-	inline void UpdateView()
+	// Build a world space ray through a viewport pixel, for picking
+	inline void GetPickRay(double x, double y, glm::vec3 &out_origin, glm::vec3 &out_dir)
 	{
-		_view = lookAt(_trans._pos, _trans._pos + _front, _up);		// Update the camera view position
+		float nx = (2.0f * (float)x) / (float)_pd_width - 1.0f;		// Pixel x in normalised device coordinates
+		float ny = 1.0f - (2.0f * (float)y) / (float)_pd_height;	// Pixel y in normalised device coordinates (flipped)
+
+		glm::mat4 inv = glm::inverse(_proj * _view);	// Clip space to world space
+		glm::vec4 p_near = inv * glm::vec4(nx, ny, -1.0f, 1.0f);	// Point on the near plane
+		glm::vec4 p_far = inv * glm::vec4(nx, ny, 1.0f, 1.0f);		// Point on the far plane
+
+		out_origin = glm::vec3(p_near) / p_near.w;	// Ray starts on the near plane
+		out_dir = glm::normalize(glm::vec3(p_far) / p_far.w - out_origin);	// Ray heads to the far plane
+	}
+
+	// Update view matrix from the current position
+	inline void UpdateView() { UpdateView(_trans._pos); }
+
+	// Update view matrix from a given position
+	inline void UpdateView(const glm::vec3 &eye)
+	{
+		_eye = eye;		// Assign view position
+		_view = lookAt(_eye, _eye + _front, _up);		// Update the camera view position
 
 		_view[3][0] = _view[3][0] - _position_offset.x;		// Apply position offset for x
 		_view[3][1] = _view[3][1] - _position_offset.y;		// Apply position offset for y
@@ -406,10 +428,13 @@ public:
 protected:
 
 	// Pass uniform data to shaders
-	inline void UpdateCamUniforms()
+	inline void UpdateCamUniforms() { UpdateCamUniforms(_view, _proj); }
+
+	// Pass given view and projection uniform data to shaders (a published snapshot of this camera)
+	inline void UpdateCamUniforms(const glm::mat4 &view, const glm::mat4 &proj)
 	{
-		glUniformMatrix4fv(_u_view, 1, GL_FALSE, value_ptr(_view));		// Parse the view uniform data
-		glUniformMatrix4fv(_u_proj, 1, GL_FALSE, value_ptr(_proj));		// Parse the projection uniform data
+		glUniformMatrix4fv(_u_view, 1, GL_FALSE, value_ptr(view));		// Parse the view uniform data
+		glUniformMatrix4fv(_u_proj, 1, GL_FALSE, value_ptr(proj));		// Parse the projection uniform data
 	}
 
 public:
@@ -1,6 +1,8 @@
 #ifndef __CHUNK_H__
 #define __CHUNK_H__
 
+#include <vector>	// Get dynamic arrays
+
 // This will contain a chunk of geometry data
 struct Chunk
 {
@@ -20,4 +22,14 @@ struct Chunk
 	}
 };
 
+// This will contain one simplified level of detail of a mesh
+struct MeshLod
+{
+	std::vector<Chunk> _chunks;	// The chunks of this level, in the same index buffer as the full mesh
+	float _error;	// How far the surface has moved, in mesh units
+
+	// Default constructor
+	inline MeshLod() : _error(0.0f) {}
+};
+
 #endif
\ No newline at end of file
@@ -1,17 +1,21 @@
 #ifndef __COLLISION_H__
 #define __COLLISION_H__
 
-#define CAT_POINT					0	// Collision arbitrary type corner
-#define CAT_EDGE					1	// Collision arbitrary type edge
-#define CAT_TRIANGLE				2	// Collision arbitrary type plane
 #define COLLISION_TYPE_NONE			3	// Collision type none
 #define COLLISION_TYPE_CUBE			4	// Collision type box
 #define COLLISION_TYPE_PER_VERTEX	5	// Collision type per-vertex
 #define COLLISION_TYPE_CUSTOM		6	// Collision type custom
 
-#include <glew.h>	// Include gl
+#define COLLISION_WELD_EPSILON		0.00001f	// Points closer than this are welded into one
+
+#include <iostream>	// Get error output
 #include "Math.h"	// Include vector math
 #include "Globals.h"	// Get global data
+#include "Bvh.h"	// Get bounding volume hierarchy
+#include "Simd.h"	// Get vector instruction wrappers
+#include "Gjk.h"	// Get convex shapes and queries
+#include <unordered_map>	// Get hash map
+#include <cstdint>	// Get fixed width integers
 
 // A namespace block to store all collision data and functions
 namespace Collision
@@ -22,114 +26,168 @@ namespace Collision
 		// A namespace for storing collision arbitrary data
 		namespace Data
 		{
-			// Abstract arbitrary class
-			struct Arbitrary
+			// Triangle data stored as contiguous structure-of-arrays, indexed by triangle id
+			// Edge k runs from point k to point (k + 1) % 3
+			struct TriangleData
 			{
-				uint8_t t;	// Arbitrary type
-
-				// Default constructor
-				inline Arbitrary() : t(0) {}
+				std::vector<float>	x[3], y[3], z[3];		// Point positions
+				std::vector<float>	ex[3], ey[3], ez[3];	// Edge vectors
+				std::vector<float>	nx, ny, nz;		// Unit normals
+				std::vector<float>	ax, ay, az;		// Averages (centroids)
 
-				// Virtual void
-				inline virtual void Update() = 0;
-			};
+				inline unsigned int Size() const { return (unsigned int)nx.size(); }	// Return the number of triangles
 
-			// Point arbitrary
-			struct Point : public Arbitrary
-			{
-				glm::vec3 p;	// Position
+				inline glm::vec3 P(unsigned int i, unsigned int k) const { return glm::vec3(x[k][i], y[k][i], z[k][i]); }		// Return point k of triangle i
+				inline glm::vec3 E(unsigned int i, unsigned int k) const { return glm::vec3(ex[k][i], ey[k][i], ez[k][i]); }	// Return edge k of triangle i
+				inline glm::vec3 N(unsigned int i) const { return glm::vec3(nx[i], ny[i], nz[i]); }		// Return the normal of triangle i
+				inline glm::vec3 A(unsigned int i) const { return glm::vec3(ax[i], ay[i], az[i]); }		// Return the average of triangle i
 
-				inline Point(glm::vec3 position)
+				// Assign point k of triangle i (call Update(i) afterwards)
+				inline void SetP(unsigned int i, unsigned int k, const glm::vec3 &p)
 				{
-					t = CAT_POINT;	// Assign arbitrary type
-
-					p = position;	// Assign position
+					x[k][i] = p.x; y[k][i] = p.y; z[k][i] = p.z;	// Assign components
 				}
 
-				// Update
-				inline virtual void Update() {}
-			};
-
-			// Edge arbitrary
-			struct Edge : public Arbitrary
-			{
-				glm::vec3 p_0;	// Edge 0
-				glm::vec3 p_1;	// Edge 1
-				glm::vec3 a;	// Average
-				glm::vec3 v;	// Vector
-				glm::vec3 d;	// Direction
-
-				// Initial contructor
-				inline Edge(glm::vec3 point_0, glm::vec3 point_1)
+				// Resize every array
+				inline void Resize(unsigned int n)
 				{
-					t = CAT_EDGE;	// Assign arbitrary type
-
-					p_0 = point_0;	// Assign edge 0
-					p_1 = point_1;	// Assign edge 1
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each point
+					{
+						x[k].resize(n); y[k].resize(n); z[k].resize(n);		// Resize points
+						ex[k].resize(n); ey[k].resize(n); ez[k].resize(n);	// Resize edges
+					}
 
-					Update();	// Update
+					nx.resize(n); ny.resize(n); nz.resize(n);	// Resize normals
+					ax.resize(n); ay.resize(n); az.resize(n);	// Resize averages
 				}
 
-				// Update
-				inline virtual void Update()
+				// Add a triangle
+				inline void Push(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2)
 				{
-					a = (p_0 + p_1) / 2.0f;		// Assign average
-					v = p_1 - p_0;	// Assign vector
-					d = glm::normalize(p_1 - p_0);	// Assign direction
+					unsigned int i = Size();	// New triangle id
+
+					Resize(i + 1);	// Grow arrays
+					SetP(i, 0, v0); SetP(i, 1, v1); SetP(i, 2, v2);		// Assign points
+					Update(i);	// Calculate derived data
 				}
-			};
 
-			// Triangle data structure
-			struct Triangle : public Arbitrary
-			{
-				glm::vec3	a;		// Average
-				glm::vec3	n;		// Normal
-				Point*		p[3];	// Three points
-				Edge*		e[3];	// Three edges
-				
-				// Constructor
-				inline Triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+				// Recalculate edges, normal and average of triangle i
+				inline void Update(unsigned int i)
 				{
-					t = CAT_TRIANGLE;	// Assign arbitrary type
+					glm::vec3 p0 = P(i, 0), p1 = P(i, 1), p2 = P(i, 2);		// Get points
+					glm::vec3 e[3] = { p1 - p0, p2 - p1, p0 - p2 };		// Calculate edges
+					glm::vec3 n = glm::cross(e[0], -e[2]);	// Calculate normal
+					float l = glm::length(n);	// Normal length (zero for degenerate triangles)
+					glm::vec3 a = (p0 + p1 + p2) / 3.0f;	// Calculate average
 
-					p[0] = new Point(v0);	// Create point 0
-					p[1] = new Point(v1);	// Create point 1
-					p[2] = new Point(v2);	// Create point 2
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each edge
+					{
+						ex[k][i] = e[k].x; ey[k][i] = e[k].y; ez[k][i] = e[k].z;	// Assign edge
+					}
 
-					e[0] = new Edge(v0, v1);	// Create edge 0
-					e[1] = new Edge(v1, v2);	// Create edge 1
-					e[2] = new Edge(v2, v0);	// Create edge 2
+					if (l > 0.0f) n /= l;	// Normalise
+					nx[i] = n.x; ny[i] = n.y; nz[i] = n.z;	// Assign normal
+					ax[i] = a.x; ay[i] = a.y; az[i] = a.z;	// Assign average
+				}
 
-					Update();	// Update vector data
+				// Recalculate derived data of every triangle
+				inline void Update()
+				{
+					for (unsigned int i = 0; i < Size(); i++)	// Iterate through each triangle
+						Update(i);	// Update triangle
 				}
 
-				// Deconstructor
-				inline ~Triangle()
+				// Reorder triangles so that new slot i holds old triangle order[i]
+				inline void Reorder(const std::vector<unsigned int> &order)
 				{
-					for (unsigned int i = 0; i < 3; i++)	// Iterate for all three vertices
+					std::vector<float> tmp(order.size());	// Temp array
+					std::vector<float>* arrays[] = { &x[0], &x[1], &x[2], &y[0], &y[1], &y[2], &z[0], &z[1], &z[2],
+						&ex[0], &ex[1], &ex[2], &ey[0], &ey[1], &ey[2], &ez[0], &ez[1], &ez[2], &nx, &ny, &nz, &ax, &ay, &az };	// Every array
+
+					for (std::vector<float>* a : arrays)	// Iterate through each array
 					{
-						if (p[i])	delete p[i];	// Delete points
-						if (e[i])	delete e[i];	// Delete edges
+						for (unsigned int i = 0; i < order.size(); i++)		// Iterate through each slot
+							tmp[i] = (*a)[order[i]];	// Gather
+						a->swap(tmp);	// Swap in reordered array
 					}
 				}
 
-				// Update vectors
-				inline virtual void Update()
+				// Return the memory used by the triangle data in bytes
+				inline size_t Bytes() const
+				{
+					return sizeof(float) * 24 * nx.capacity();	// 24 float arrays per triangle
+				}
+			};
+
+			// Return the hash key of a grid cell
+			inline static uint64_t CellKey(int64_t cx, int64_t cy, int64_t cz)
+			{
+				return ((uint64_t)(cx & 0x1FFFFF) << 42) | ((uint64_t)(cy & 0x1FFFFF) << 21) | (uint64_t)(cz & 0x1FFFFF);	// Pack 21 bits per axis
+			}
+
+			// Weld points closer than epsilon using a hash grid with epsilon sized cells, in expected O(n)
+			// out_points receives the unique points in first seen order, out_index maps each input point to its unique point
+			inline static void Weld(const std::vector<glm::vec3> &points, float epsilon, std::vector<glm::vec3> &out_points, std::vector<unsigned int> &out_index)
+			{
+				float cell = glm::max(epsilon, FLT_MIN);	// Cell size
+				float eps2 = epsilon * epsilon;		// Squared epsilon
+
+				std::unordered_map<uint64_t, unsigned int> heads;	// First unique point in each cell
+				std::vector<unsigned int> next;		// Next unique point in the same cell
+
+				heads.reserve(points.size());	// Reserve buckets
+				out_points.clear();		// Reset unique points
+				out_index.resize(points.size());	// One index per input point
+
+				for (unsigned int i = 0; i < points.size(); i++)	// Iterate through each point
 				{
-					a = (p[0]->p + p[1]->p + p[2]->p) / 3.0f;	// Calculate average
-					n = glm::cross(p[1]->p - p[0]->p, p[2]->p - p[0]->p);	// Calculate normal
+					const glm::vec3 &p = points[i];		// Get point
+					int64_t cx = (int64_t)glm::floor(p.x / cell);	// Cell x
+					int64_t cy = (int64_t)glm::floor(p.y / cell);	// Cell y
+					int64_t cz = (int64_t)glm::floor(p.z / cell);	// Cell z
 
-					e[0]->p_0 = p[0]->p; e[0]->p_1 = p[1]->p;	// Caclulate edge 0
-					e[1]->p_0 = p[1]->p; e[1]->p_1 = p[2]->p;	// Caclulate edge 1
-					e[2]->p_0 = p[2]->p; e[2]->p_1 = p[0]->p;	// Caclulate edge 2
+					unsigned int found = UINT32_MAX;	// Matching unique point
 
-					for (unsigned int i = 0; i < 3; i++)	// Iterate through each point
+					// A point within epsilon can only be in this cell or a neighbouring one
+					for (int64_t dx = -1; dx <= 1 && found == UINT32_MAX; dx++)
+						for (int64_t dy = -1; dy <= 1 && found == UINT32_MAX; dy++)
+							for (int64_t dz = -1; dz <= 1 && found == UINT32_MAX; dz++)
+							{
+								std::unordered_map<uint64_t, unsigned int>::const_iterator it = heads.find(CellKey(cx + dx, cy + dy, cz + dz));	// Find cell
+								if (it == heads.end())	// If the cell is empty
+									continue;	// Skip cell
+
+								for (unsigned int u = it->second; u != UINT32_MAX; u = next[u])	// Iterate through each unique point in the cell
+								{
+									glm::vec3 d = out_points[u] - p;	// Offset
+									if (glm::dot(d, d) <= eps2)		// If close enough
+									{
+										found = u;	// Weld to this point
+										break;	// Break from loop
+									}
+								}
+							}
+
+					if (found == UINT32_MAX)	// If the point is new
 					{
-						p[i]->Update();		// Update points
-						e[i]->Update();		// Update edges
+						found = (unsigned int)out_points.size();	// New unique id
+						out_points.push_back(p);	// Add unique point
+
+						uint64_t key = CellKey(cx, cy, cz);		// Get cell key
+						std::unordered_map<uint64_t, unsigned int>::iterator it = heads.find(key);	// Find cell
+						next.push_back((it == heads.end()) ? UINT32_MAX : it->second);	// Link to the previous head
+						heads[key] = found;		// Become the head
 					}
+
+					out_index[i] = found;	// Map point
 				}
-			};
+			}
+
+			// Return the largest axis scale of a transform
+			inline static float MaxScale(const glm::mat4 &m)
+			{
+				return glm::sqrt(glm::max(glm::dot(glm::vec3(m[0]), glm::vec3(m[0])), glm::max(glm::dot(glm::vec3(m[1]), glm::vec3(m[1])), glm::dot(glm::vec3(m[2]), glm::vec3(m[2])))));	// Return longest basis vector
+			}
 
 			// A structure for storing an array of hit points on a colliding object, and a normal velocity vector
 			struct HitData
@@ -140,177 +198,161 @@ namespace Collision
 			};
 
 			// A struct for storing all arbitrary data
+			// Geometry is immutable and stays in local space; queries are moved into the local frame with m_inv instead
 			struct CollisionData
 			{
-				float					r;		// Radii value
+				float					r;		// Radii value (local space)
 				uint8_t					ct;		// Collision type
-				glm::vec3				a;		// Average position
+				glm::vec3				a;		// Average position (local space)
 				HitData					hd;		// Hit data
-				std::vector<glm::vec3>	pd;		// Vertex position data
-				std::vector<glm::vec3>  pd_o;	// Original vertex position data
-				std::vector<Triangle*>	t;		// List of triangle data
+				std::vector<glm::vec3>	pd;		// Vertex position data (local space)
+				glm::mat4				m;		// Local to world transform
+				glm::mat4				m_inv;	// World to local transform
+				glm::vec3				wa;		// Average position (world space)
+				float					wr;		// Radii value (world space)
+				Aabb					wb;		// Bounds (world space)
+				std::vector<unsigned int>	ti;		// Point index (into pd) of each triangle point, three per triangle
+				TriangleData			t;		// Triangle data
+				std::vector<Aabb>		tb;		// List of triangle bounds
+				Bvh						bvh;	// Bounding volume hierarchy over triangle data
+				ConvexShape				cs;		// Convex proxy (local space), CONVEX_NONE if only the triangles describe the shape
 
 				// Initial constructor
-				inline CollisionData(uint8_t collision_type, std::vector<glm::vec3> triangle_data)
+				inline CollisionData(uint8_t collision_type, const std::vector<glm::vec3> &triangle_data)
 				{
 					ct = collision_type;	// Assign collision type
 					r = 0.0f;	// Initialise max radii value
+					m = glm::mat4(1.0f);	// Initialise transform
+					m_inv = glm::mat4(1.0f);	// Initialise inverse transform
 					hd = HitData({ false, {} });	// Initialise hit data
+					cs.type = CONVEX_NONE;	// Initialise convex proxy
 					Assign(collision_type, triangle_data);	// Assign data
 				}
 
-				// Deconstructor
-				inline ~CollisionData()
-				{
-					t.clear();	// Clear arbitrary data
-				}
-
 				// Assign indexed vertex data to arbitrary data
-				inline void Assign(uint8_t collision_type, std::vector<glm::vec3> triangle_data)
+				inline void Assign(uint8_t collision_type, const std::vector<glm::vec3> &triangle_data)
 				{
 					if (collision_type == COLLISION_TYPE_CUBE)	// If collision type is cubic
 					{
-						float min_x, max_x;		// Min and max for x
-						float min_y, max_y;		// Min and max for y
-						float min_z, max_z;		// Min and max for z
+						glm::vec3 lo, hi;		// Min and max of all vertices
 						float l, h, d;			// Length, height and depth
 
-						std::vector<float> x_components;	// Temp list of x components
-						std::vector<float> y_components;	// Temp list of y components
-						std::vector<float> z_components;	// Temp list of z components
+						Math::Boundsv3(triangle_data.data(), triangle_data.size(), lo, hi);		// Get bounds of all vertices in one pass
 
-						std::vector<Point*> points;		// Temp point data
+						l = (hi.x - lo.x) / 2.0f;	// Get length
+						h = (hi.y - lo.y) / 2.0f;	// Get Height
+						d = (hi.z - lo.z) / 2.0f;	// Get Depth
 
-						for (unsigned int i = 0; i < triangle_data.size(); i++)	// Iterate through each vertex
-						{
-							x_components.push_back(triangle_data[i].x);		// Add x component
-							y_components.push_back(triangle_data[i].y);		// Add y component
-							z_components.push_back(triangle_data[i].z);		// Add z component
-						}
+						glm::vec3 ao = (lo + hi) / 2.0f;	// Calculate average offset
+
+						t.Push(ao + glm::vec3(-l, -h, d), ao + glm::vec3(l, -h, d), ao + glm::vec3(-l, h, d));		// Create triangle
+						t.Push(ao + glm::vec3(-l, h, d), ao + glm::vec3(l, -h, d), ao + glm::vec3(l, h, d));		// Create triangle
+						t.Push(ao + glm::vec3(-l, h, d), ao + glm::vec3(l, h, d), ao + glm::vec3(-l, h, -d));		// Create triangle
+						t.Push(ao + glm::vec3(-l, h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, -d));	// Create triangle
+						t.Push(ao + glm::vec3(-l, h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, -d));	// Create triangle
+						t.Push(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, d));	// Create triangle
+						t.Push(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(-l, -h, d));	// Create triangle
+						t.Push(ao + glm::vec3(-l, -h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, -h, d));		// Create triangle
+						t.Push(ao + glm::vec3(l, -h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, h, d));		// Create triangle
+						t.Push(ao + glm::vec3(l, h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, h, -d));		// Create triangle
+						t.Push(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(-l, -h, d), ao + glm::vec3(-l, h, -d));	// Create triangle
+						t.Push(ao + glm::vec3(-l, h, -d), ao + glm::vec3(-l, -h, d), ao + glm::vec3(-l, h, d));		// Create triangle
 
-						min_x = Math::Minf(x_components);	// Get min x value from all vertices
-						min_y = Math::Minf(y_components);	// Get min y value from all vertices
-						min_z = Math::Minf(z_components);	// Get min z value from all vertices
-						max_x = Math::Maxf(x_components);	// Get max x value from all vertices
-						max_y = Math::Maxf(y_components);	// Get max y value from all vertices
-						max_z = Math::Maxf(z_components);	// Get max z value from all vertices
-
-						l = abs((max_x - min_x) / 2.0f);	// Get length
-						h = abs((max_y - min_y) / 2.0f);	// Get Height
-						d = abs((max_z - min_z) / 2.0f);	// Get Depth
-
-						glm::vec3 ao = glm::vec3((min_x + max_x) / 2.0f, (min_y + max_y) / 2.0f, (min_z + max_z) / 2.0f);	// Calculate average offset					
-
-						t.push_back(new Triangle(ao + glm::vec3(-l, -h, d), ao + glm::vec3(l, -h, d), ao + glm::vec3(-l, h, d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, h, d), ao + glm::vec3(l, -h, d), ao + glm::vec3(l, h, d)));			// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, h, d), ao + glm::vec3(l, h, d), ao + glm::vec3(-l, h, -d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, -d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, -d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(l, h, -d), ao + glm::vec3(-l, -h, d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(-l, -h, d)));	// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, -h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, -h, d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(l, -h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, h, d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(l, h, d), ao + glm::vec3(l, -h, -d), ao + glm::vec3(l, h, -d)));		// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, -h, -d), ao + glm::vec3(-l, -h, d), ao + glm::vec3(-l, h, -d)));	// Create triangle
-						t.push_back(new Triangle(ao + glm::vec3(-l, h, -d), ao + glm::vec3(-l, -h, d), ao + glm::vec3(-l, h, d)));		// Create triangle
-
-						points.push_back(new Point(ao + glm::vec3(-l, h, d)));		// Front top left		[0]
-						points.push_back(new Point(ao + glm::vec3(l, h, d)));		// Front top right		[1]
-						points.push_back(new Point(ao + glm::vec3(-l, -h, d)));		// Front bottom left	[2]
-						points.push_back(new Point(ao + glm::vec3(l, -h, d)));		// Front bottom right	[3]
-						points.push_back(new Point(ao + glm::vec3(-l, h, -d)));		// Back top left		[4]
-						points.push_back(new Point(ao + glm::vec3(l, h, -d)));		// Back top right		[5]
-						points.push_back(new Point(ao + glm::vec3(-l, -h, -d)));	// Back bottom left		[6]
-						points.push_back(new Point(ao + glm::vec3(l, -h, -d)));		// Back bottom right	[7]
-
-
-						for (unsigned int i = 0; i < 8; i++)	// Iterate through each corner
-							pd.push_back(points[i]->p);		// Assign vertex position data
+						cs = MakeBox(ao, glm::vec3(l, h, d));	// Create convex proxy
 					}
-					
+
 					else if ((collision_type == COLLISION_TYPE_PER_VERTEX) || (collision_type == COLLISION_TYPE_CUSTOM))	// If collision type per-vertex or custom
 					{
-						std::vector<Point*> points;		// Temp point data
+						t.Resize((unsigned int)triangle_data.size() / 3);	// Allocate triangle data once
 
-						for (unsigned int i = 0; i < triangle_data.size(); i += 3)	// Iterate through each indexed vertex position
+						for (unsigned int i = 0; i + 2 < triangle_data.size(); i += 3)	// Iterate through each indexed vertex position
 						{
-							glm::vec3 v0 = triangle_data[i];		// Vertex 0 in tri offset
-							glm::vec3 v1 = triangle_data[i + 1];	// Vertex 1 in tri offset
-							glm::vec3 v2 = triangle_data[i + 2];	// Vertex 2 in tri offset
-
-							points.push_back(new Point(v0));	// Create temp point 0
-							points.push_back(new Point(v1));	// Create temp point 1
-							points.push_back(new Point(v2));	// Create temp point 2
-
-							t.push_back(new Triangle(v0, v1, v2));	// Create triangle
+							t.SetP(i / 3, 0, triangle_data[i]);		// Assign point 0
+							t.SetP(i / 3, 1, triangle_data[i + 1]);		// Assign point 1
+							t.SetP(i / 3, 2, triangle_data[i + 2]);		// Assign point 2
 						}
 
-						// -------------------------- CLEAN UP DUPLICTE POINTS! --------------------------------------
-						for (unsigned int i = 0; i < points.size(); i++)		// Iterate through each edge
-						{
-							for (unsigned int j = 0; j < points.size(); j++)		// Iterate through each edge again
-							{
-								if (i != j)		// If i is not the same element as j
-								{
-									if (points[i]->p == points[j]->p)		// If both values are the same
-									{
-										points.erase(points.begin() + i);		// Remove duplicate
-										i > 0 ? i-- : i = 0;	// Re-assign iteration
-									}
-								}
-							}
-						}
-
-						// --------------------------- ASSIGN OPTIMISED POINT DATA ------------------------------
-						for (unsigned int i = 0; i < points.size(); i++)	// Iterate through each corner
-							pd.push_back(points[i]->p);		// Assign to temp container
-
-						points.clear();		// Clear temp point data
+						t.Update();		// Calculate edges, normals and averages
 					}
-						
+
 					else	// Otherwise if collision type is invalid
 					{
 						std::cerr << "Collision Error: Invalid collision type!\n";	// Print out error message
 						return;		// Return from function
 					}
-					
-					a = Math::Avgv3(pd);	// Calculate average position
-					glm::vec3 max_local = glm::abs(Math::MaxComponentSizev3(pd)) - a;	// Calculate the max vector in local space
-					r = glm::length(max_local);		// Calculate length of radii
 
-					pd_o = pd;	// Assign position data to the original position list
-				}
+					// -------------------------- WELD DUPLICATE POINTS --------------------------------------
+					std::vector<glm::vec3> points(t.Size() * 3);	// Every triangle point
+					for (unsigned int i = 0; i < t.Size(); i++)		// Iterate through each triangle
+						for (unsigned int k = 0; k < 3; k++)	// Iterate through each point
+							points[i * 3 + k] = t.P(i, k);	// Gather point
+
+					Weld(points, COLLISION_WELD_EPSILON, pd, ti);	// Assign unique point data and triangle indices
 
+					if (collision_type == COLLISION_TYPE_CUSTOM)	// If the shape is a custom collision proxy
+						cs = MakeHull(pd);	// Wrap it in a convex hull
+					else if (collision_type == COLLISION_TYPE_PER_VERTEX)	// If the shape is the render mesh
+						cs = ConvexShape();		// Keep the triangles only
 
-				// Update
-				inline void Update(glm::mat4 m)
+					a = Math::Centroidv3(pd.data(), pd.size());		// Calculate average position
+					r = Math::MaxDistancev3(pd.data(), pd.size(), a);	// Calculate radii around the average position
+
+					BuildHierarchy();	// Build bounding volume hierarchy
+					Update(m);	// Calculate world space data
+				}
+
+				// Calculate the bounds of each triangle
+				inline void UpdateTriangleBounds()
 				{
-					// --------------------- UPDATE TRIANGLE DATA ---------------------
-					glm::vec4 res(glm::vec4(0.0f));		// Result for each vertex position
+					tb.resize(t.Size());	// Allocate triangle bounds
 
-					for (unsigned int i = 0; i < t.size(); i++)		// Iterate through each triangle
+					for (unsigned int i = 0; i < t.Size(); i++)		// Iterate through each triangle
 					{
-						for (unsigned int j = 0; j < 3; j++)	// Iterate through each vertex
-						{
-							glm::vec4 v_opt(glm::vec4(t[i]->p[j]->p, 1.0f));	// Optimise vertex position
-							res = glm::vec4(m * v_opt);		// Calculate transform result
-						
-							t[i]->p[j]->p = glm::vec3(res.x / res.w, res.y / res.w, res.z / res.w);		// Convert transform result back to vec3
-						}
-
-						t[i]->Update();		// Update all arbitrary data
+						tb[i] = Aabb(t.P(i, 0), t.P(i, 0));		// Assign first point
+						tb[i].Grow(t.P(i, 1));	// Grow by second point
+						tb[i].Grow(t.P(i, 2));	// Grow by third point
 					}
+				}
+
+				// Build the bounding volume hierarchy from scratch
+				inline void BuildHierarchy()
+				{
+					UpdateTriangleBounds();		// Calculate triangle bounds
+					bvh.Build(tb);	// Build hierarchy
+
+					std::vector<unsigned int> order = bvh.Flatten();	// Store triangles in leaf order
+					t.Reorder(order);	// Reorder triangle data so each leaf is a contiguous run of triangle ids
 
-					// --------------------- UPDATE POINT DATA ---------------------
-					for (unsigned int i = 0; i < pd.size(); i++)	// Iterate through each point
+					std::vector<Aabb> tb_o = tb;	// Copy bounds
+					std::vector<unsigned int> ti_o = ti;	// Copy point indices
+					for (unsigned int i = 0; i < order.size(); i++)		// Iterate through each slot
 					{
-						glm::vec4 v_opt = glm::vec4(pd_o[i], 1.0f);		// Optimise vertex position
-						res = glm::vec4(m * v_opt);		// Calculate transform result
-						
-						pd[i] = glm::vec3(res.x / res.w, res.y / res.w, res.z / res.w);		// Convert transform result back to vec3
+						tb[i] = tb_o[order[i]];		// Reorder bounds
+
+						for (unsigned int k = 0; k < 3 && !ti_o.empty(); k++)	// Iterate through each point
+							ti[i * 3 + k] = ti_o[order[i] * 3 + k];		// Reorder point indices
 					}
-					
-					a = Math::Avgv3(pd);	// Recalculate average position
+				}
+
+				// Refit the bounding volume hierarchy after the local triangles have been edited
+				inline void RefitHierarchy()
+				{
+					UpdateTriangleBounds();		// Recalculate triangle bounds
+					bvh.Refit(tb);	// Refit hierarchy
+				}
+
+				inline glm::vec3 ToLocal(const glm::vec3 &p) const { return glm::vec3(m_inv * glm::vec4(p, 1.0f)); }	// Return a world point in local space
+				inline glm::vec3 ToWorld(const glm::vec3 &p) const { return glm::vec3(m * glm::vec4(p, 1.0f)); }	// Return a local point in world space
+
+				// Update the transform, leaving the local geometry untouched
+				inline void Update(glm::mat4 value)
+				{
+					m = value;	// Assign transform
+					m_inv = glm::inverse(value);	// Assign inverse transform
+
+					wa = ToWorld(a);	// Move average position into world space
+					wr = r * MaxScale(m);	// Scale radii into world space
+					wb = bvh.nodes.empty() ? Aabb(wa, wa) : bvh.nodes[0].b.Transform(m);	// Move root bounds into world space
 				}
 			};
 		}
@@ -322,75 +364,63 @@ namespace Collision
 			// This function will return the radial distance between two collisions
 			inline static float DistABRadii(Data::CollisionData* a, Data::CollisionData* b)
 			{
-				return glm::distance(a->a, b->a) - (a->r + b->r);	// Return radial distance  between object a and b
+				return glm::distance(a->wa, b->wa) - (a->wr + b->wr);	// Return radial distance  between object a and b
 			}
 
 			// This function will return the distance between point a and point b
-			inline static float DistPointToPoint(glm::vec3& point_0, glm::vec3& point_1)
+			inline static float DistPointToPoint(const glm::vec3& point_0, const glm::vec3& point_1)
 			{
 				return glm::distance(point_0, point_1);		// Return final result
 			}
 
 			// This function will return a scalar value where magnitude between a point and an infinity plane
-			inline static float DistPointToInfinityPlane(glm::vec3& point, Data::Triangle *plane)
+			inline static float DistPointToInfinityPlane(const glm::vec3& point, const Data::TriangleData& td, unsigned int i)
 			{
-				return glm::abs(glm::dot(plane->n, plane->a - point));		// Return final result
+				return glm::abs(glm::dot(td.N(i), td.A(i) - point));		// Return final result
 			}
 
 			// This function will return the dot product between a ray and plane normal
-			inline static float DotRayToInfinityPlaneNormal(glm::vec3& ray, Data::Triangle* plane)
+			inline static float DotRayToInfinityPlaneNormal(const glm::vec3& ray, const Data::TriangleData& td, unsigned int i)
 			{
-				return -glm::dot(ray, plane->n);	// Return final result
+				return -glm::dot(ray, td.N(i));		// Return final result
 			}
 
 			// This function will return the distance between a point and infinity plane in respect to it's normal
-			inline static float DistPointToInfinityPlaneNormal(glm::vec3& point, Data::Triangle* plane)
+			inline static float DistPointToInfinityPlaneNormal(const glm::vec3& point, const Data::TriangleData& td, unsigned int i)
 			{
-				float r(0.0f);	// Initialise result
-
-				float point_mag = glm::dot(plane->n, plane->a - point);		// Calculate mangnitude between point and infinity plane
-				float normal_dot = glm::dot(-plane->n, plane->n);	// Calculate the dot of the infinity plane normal
-
-				r = point_mag / normal_dot;		// Check distance
-
-				return r;	// Return final result
+				return glm::dot(point - td.A(i), td.N(i));	// Return signed distance along the unit normal
 			}
 
 			// This function will return the distance between a point to an edges segement
-			inline static float DistPointToEdge(glm::vec3& point, Data::Edge* edge)
+			inline static float DistPointToEdge(const glm::vec3& point, const Data::TriangleData& td, unsigned int i, unsigned int k)
 			{
-				float r(0.0f);	// Initialise result
-				glm::vec3 normal = glm::cross(edge->d, point - edge->p_0);	// Calculate normal alignment between edge segment and point
-
-				r = glm::length(normal);	// Assign result
+				glm::vec3 normal = glm::cross(glm::normalize(td.E(i, k)), point - td.P(i, k));	// Calculate normal alignment between edge segment and point
 
-				return r;	// Return final result
+				return glm::length(normal);		// Return final result
 			}
 
 			// This function will return the distance between two edge arbitraries
-			inline static float DistEdgeToEdge(Data::Edge* edge_0, Data::Edge* edge_1)
+			inline static float DistEdgeToEdge(const Data::TriangleData& td_0, unsigned int i, unsigned int k, const Data::TriangleData& td_1, unsigned int j, unsigned int l)
 			{
-				glm::vec3 av = edge_0->v;	// Get the size of edge 0
-				glm::vec3 bv = edge_1->v;	// Get the size of edge 1
+				glm::vec3 av = td_0.E(i, k);	// Get the size of edge 0
+				glm::vec3 bv = td_1.E(j, l);	// Get the size of edge 1
 
 				glm::vec3 normal = glm::cross(av, bv);	// Find the noraml between both line segments
 				float normal_mag = glm::length(normal);		// Calculate the magnitude of normal
 
 				glm::vec3 clamp_normal = normal * 1.0f / normal_mag;	// Clamp the unit normal to magnitude
 
-				float dist = glm::abs(glm::dot(edge_0->p_0 - edge_1->p_0, clamp_normal));	// Get the absolute value of the magnitude between (e1p0 - e2p0) and the clamped normal
+				float dist = glm::abs(glm::dot(td_0.P(i, k) - td_1.P(j, l), clamp_normal));	// Get the absolute value of the magnitude between (e1p0 - e2p0) and the clamped normal
 
 				return dist;	// Return result
 			}
-			
+
 			// This function will return the Barycentric coordinate between a point to triangle in respect to a normal
-			inline static glm::vec3 BaryCentricCoord(glm::vec3& point, glm::vec3& normal, Data::Triangle* triangle)
+			inline static glm::vec3 BaryCentricCoord(const glm::vec3& point, const glm::vec3& normal, const Data::TriangleData& td, unsigned int i)
 			{
-				glm::vec3 r(glm::vec3(0.0f));	// Initialise result
-
-				glm::vec3 v0 = triangle->p[0]->p - point;	// Define vector from point to triangle v0
-				glm::vec3 v1 = triangle->p[1]->p - point;	// Define vector from point to triangle v1
-				glm::vec3 v2 = triangle->p[2]->p - point;	// Define vector from point to triangle v2
+				glm::vec3 v0 = td.P(i, 0) - point;	// Define vector from point to triangle v0
+				glm::vec3 v1 = td.P(i, 1) - point;	// Define vector from point to triangle v1
+				glm::vec3 v2 = td.P(i, 2) - point;	// Define vector from point to triangle v2
 
 				glm::vec3 v0v1 = glm::cross(v0, v1);	// Calculate normal from v0 and v1
 				glm::vec3 v1v2 = glm::cross(v1, v2);	// Calculate normal from v1 and v2
@@ -400,27 +430,222 @@ namespace Collision
 				float v1v2m = glm::dot(v1v2, normal);	// Calculate magnitude for v0 to v1
 				float v2v0m = glm::dot(v2v0, normal);	// Calculate magnitude for v0 to v1
 
-				r = glm::vec3(v0v1m, v1v2m, v2v0m);		// Assign result
-
 				return glm::vec3(v0v1m, v1v2m, v2v0m);	// Return barycentric position
 			}
 
 			// This function will check for point to edge projection intersection
-			inline static bool PointInsideEdgeProjection(glm::vec3& point, Data::Edge* edge)
+			inline static bool PointInsideEdgeProjection(const glm::vec3& point, const Data::TriangleData& td, unsigned int i, unsigned int k)
 			{
-				float el = glm::length(edge->v);	// Calculate length of edge
-				float ip = glm::dot(point - edge->p_0, edge->v);	// Calculate inner product between length of edge and point minus edge p0
+				glm::vec3 v = td.E(i, k);	// Edge vector
+				float ip = glm::dot(point - td.P(i, k), v);		// Calculate inner product between length of edge and point minus edge p0
 
-				return (ip >= 0.0f && ip <= el * el);	// Return result
+				return (ip >= 0.0f && ip <= glm::dot(v, v));	// Return result
 			}
 
 			// This function will check for point to triangle projection intersection
-			inline static bool PointInsideTriangleProjection(glm::vec3& point, Data::Triangle* triangle)
+			inline static bool PointInsideTriangleProjection(const glm::vec3& point, const Data::TriangleData& td, unsigned int i)
 			{
-				glm::vec3 bcc = BaryCentricCoord(point, -triangle->n, triangle);	// Calculate barycentric coord with triangle normal
+				glm::vec3 bcc = BaryCentricCoord(point, -td.N(i), td, i);	// Calculate barycentric coord with triangle normal
 
 				return (glm::all(glm::lessThan(bcc, glm::vec3(0.0f))));		// Return result
 			}
+
+			// This function will return the closest point on triangle i to a point
+			inline static glm::vec3 ClosestPointOnTriangle(const glm::vec3& point, const Data::TriangleData& td, unsigned int i)
+			{
+				glm::vec3 a = td.P(i, 0);	// Triangle point 0
+				glm::vec3 b = td.P(i, 1);	// Triangle point 1
+				glm::vec3 c = td.P(i, 2);	// Triangle point 2
+
+				glm::vec3 ab = b - a, ac = c - a, ap = point - a;	// Edge vectors from a
+				float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+				if (d1 <= 0.0f && d2 <= 0.0f) return a;		// Vertex region a
+
+				glm::vec3 bp = point - b;	// Vector from b
+				float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+				if (d3 >= 0.0f && d4 <= d3) return b;	// Vertex region b
+
+				float vc = d1 * d4 - d3 * d2;
+				if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));	// Edge region ab
+
+				glm::vec3 cp = point - c;	// Vector from c
+				float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+				if (d6 >= 0.0f && d5 <= d6) return c;	// Vertex region c
+
+				float vb = d5 * d2 - d1 * d6;
+				if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));	// Edge region ac
+
+				float va = d3 * d6 - d5 * d4;
+				if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));	// Edge region bc
+
+				float denom = 1.0f / (va + vb + vc);	// Face region
+				return a + ab * (vb * denom) + ac * (vc * denom);	// Return barycentric position on face
+			}
+
+			// This function will return true if a ray hits triangle i within t_max, and output the hit distance
+			inline static bool RayToTriangle(const glm::vec3& origin, const glm::vec3& dir, const Data::TriangleData& td, unsigned int i, float t_max, float& out_t)
+			{
+				glm::vec3 e0 = td.E(i, 0);	// Edge 0 (p1 - p0)
+				glm::vec3 e1 = -td.E(i, 2);		// Edge p2 - p0
+
+				glm::vec3 pv = glm::cross(dir, e1);		// Perpendicular to direction and edge 1
+				float det = glm::dot(e0, pv);	// Determinant
+
+				if (glm::abs(det) < 1e-8f)	// If the ray is parallel to the triangle
+					return false;	// Return false
+
+				float inv_det = 1.0f / det;		// Inverse determinant
+				glm::vec3 tv = origin - td.P(i, 0);		// Vector from point 0 to origin
+
+				float u = glm::dot(tv, pv) * inv_det;	// Barycentric u
+				if (u < 0.0f || u > 1.0f) return false;		// Outside edge
+
+				glm::vec3 qv = glm::cross(tv, e0);	// Perpendicular to tv and edge 0
+				float v = glm::dot(dir, qv) * inv_det;	// Barycentric v
+				if (v < 0.0f || u + v > 1.0f) return false;	// Outside edge
+
+				float t = glm::dot(e1, qv) * inv_det;	// Ray distance
+				if (t < 0.0f || t > t_max) return false;	// Outside ray range
+
+				out_t = t;	// Assign hit distance
+
+				return true;	// Return true as hit
+			}
+
+			// Vector kernel: test a ray against triangles [i, end) in groups of V::WIDTH, shortening t_max to the closest hit
+			template <typename V>
+			inline static unsigned int RayToTrianglesN(const glm::vec3& origin, const glm::vec3& dir, const Data::TriangleData& td, unsigned int& i, unsigned int end, float& t_max, unsigned int& out_i)
+			{
+				typedef typename V::T T;	// Register type
+				unsigned int hits = 0;	// Number of closer hits found
+
+				T ox = V::Set(origin.x), oy = V::Set(origin.y), oz = V::Set(origin.z);	// Broadcast origin
+				T dx = V::Set(dir.x), dy = V::Set(dir.y), dz = V::Set(dir.z);	// Broadcast direction
+				T zero = V::Set(0.0f), one = V::Set(1.0f), eps = V::Set(1e-8f);		// Constants
+
+				for (; i + V::WIDTH <= end; i += V::WIDTH)	// Iterate through each full group
+				{
+					T e0x = V::Load(&td.ex[0][i]), e0y = V::Load(&td.ey[0][i]), e0z = V::Load(&td.ez[0][i]);	// Edge p1 - p0
+					T e1x = V::Sub(zero, V::Load(&td.ex[2][i])), e1y = V::Sub(zero, V::Load(&td.ey[2][i])), e1z = V::Sub(zero, V::Load(&td.ez[2][i]));	// Edge p2 - p0
+
+					T pvx, pvy, pvz;	// Perpendicular to direction and edge 1
+					Simd::Cross3<V>(dx, dy, dz, e1x, e1y, e1z, pvx, pvy, pvz);
+					T det = Simd::Dot3<V>(e0x, e0y, e0z, pvx, pvy, pvz);	// Determinant
+					T inv_det = V::Div(one, det);	// Inverse determinant
+
+					T tvx = V::Sub(ox, V::Load(&td.x[0][i])), tvy = V::Sub(oy, V::Load(&td.y[0][i])), tvz = V::Sub(oz, V::Load(&td.z[0][i]));	// Origin - p0
+					T u = V::Mul(Simd::Dot3<V>(tvx, tvy, tvz, pvx, pvy, pvz), inv_det);		// Barycentric u
+
+					T qvx, qvy, qvz;	// Perpendicular to tv and edge 0
+					Simd::Cross3<V>(tvx, tvy, tvz, e0x, e0y, e0z, qvx, qvy, qvz);
+					T v = V::Mul(Simd::Dot3<V>(dx, dy, dz, qvx, qvy, qvz), inv_det);	// Barycentric v
+					T t = V::Mul(Simd::Dot3<V>(e1x, e1y, e1z, qvx, qvy, qvz), inv_det);		// Ray distance
+
+					T m = V::And(V::Gt(V::Abs(det), eps), V::And(V::Ge(u, zero), V::Ge(v, zero)));	// Not parallel, inside two edges
+					m = V::And(m, V::And(V::Le(V::Add(u, v), one), V::And(V::Ge(t, zero), V::Le(t, V::Set(t_max)))));	// Inside third edge and ray range
+
+					int mask = V::Mask(m);	// Lanes that hit
+					if (mask)	// If any lane hit
+					{
+						float lanes[V::WIDTH];	// Hit distances
+						V::Store(lanes, t);		// Store distances
+
+						for (unsigned int k = 0; k < V::WIDTH; k++)		// Iterate through each lane
+						{
+							if ((mask & (1 << k)) && lanes[k] <= t_max)		// If lane k is the closest hit so far
+							{
+								t_max = lanes[k];	// Shorten ray
+								out_i = i + k;	// Record triangle
+								hits++;		// Count hit
+							}
+						}
+					}
+				}
+
+				return hits;	// Return number of closer hits
+			}
+
+			// This function will test a ray against a contiguous run of triangles, shortening t_max to the closest hit
+			inline static bool RayToTriangles(const glm::vec3& origin, const glm::vec3& dir, const Data::TriangleData& td, unsigned int first, unsigned int count, float& t_max, unsigned int& out_i)
+			{
+				unsigned int hits = 0;	// Number of closer hits found
+				unsigned int i = first, end = first + count;	// Triangle range
+
+#ifdef SIMD_F8
+				if (Simd::HasAvx2())	// If 8-wide kernels can run
+					hits += RayToTrianglesN<Simd::F8>(origin, dir, td, i, end, t_max, out_i);	// 8 triangles at a time
+#endif
+#ifdef SIMD_SSE
+				hits += RayToTrianglesN<Simd::F4>(origin, dir, td, i, end, t_max, out_i);	// 4 triangles at a time
+#endif
+
+				for (; i < end; i++)	// Iterate through the remaining triangles
+				{
+					float t;	// Hit distance
+					if (RayToTriangle(origin, dir, td, i, t_max, t))	// If triangle i is closer
+					{
+						t_max = t;	// Shorten ray
+						out_i = i;	// Record triangle
+						hits++;		// Count hit
+					}
+				}
+
+				return (hits > 0);	// Return true if a closer hit was found
+			}
+
+			// Vector kernel: reject triangles [i, end) whose plane is further than the radius from the centre before the exact test
+			template <typename V>
+			inline static bool SphereToTrianglesN(const glm::vec3& centre, float radius, const Data::TriangleData& td, unsigned int& i, unsigned int end)
+			{
+				typedef typename V::T T;	// Register type
+
+				T cx = V::Set(centre.x), cy = V::Set(centre.y), cz = V::Set(centre.z);	// Broadcast centre
+				T r = V::Set(radius);	// Broadcast radius
+				float r2 = radius * radius;		// Squared radius
+
+				for (; i + V::WIDTH <= end; i += V::WIDTH)	// Iterate through each full group
+				{
+					T px = V::Sub(cx, V::Load(&td.x[0][i])), py = V::Sub(cy, V::Load(&td.y[0][i])), pz = V::Sub(cz, V::Load(&td.z[0][i]));	// Centre - p0
+					T dist = Simd::Dot3<V>(px, py, pz, V::Load(&td.nx[i]), V::Load(&td.ny[i]), V::Load(&td.nz[i]));	// Signed plane distance
+
+					int mask = V::Mask(V::Le(V::Abs(dist), r));		// Lanes whose plane is within the radius
+					for (unsigned int k = 0; mask && k < V::WIDTH; k++)		// Iterate through each surviving lane
+					{
+						if (mask & (1 << k))	// If lane k survived
+						{
+							glm::vec3 cp = ClosestPointOnTriangle(centre, td, i + k);	// Exact closest point
+
+							if (glm::dot(cp - centre, cp - centre) <= r2)	// If within the radius
+								return true;	// Return true as hit
+						}
+					}
+				}
+
+				return false;	// Return false by default
+			}
+
+			// This function will return true if a sphere touches any triangle in a contiguous run of triangles
+			inline static bool SphereToTriangles(const glm::vec3& centre, float radius, const Data::TriangleData& td, unsigned int first, unsigned int count)
+			{
+				unsigned int i = first, end = first + count;	// Triangle range
+
+#ifdef SIMD_F8
+				if (Simd::HasAvx2() && SphereToTrianglesN<Simd::F8>(centre, radius, td, i, end)) return true;		// 8 triangles at a time
+#endif
+#ifdef SIMD_SSE
+				if (SphereToTrianglesN<Simd::F4>(centre, radius, td, i, end)) return true;		// 4 triangles at a time
+#endif
+
+				for (; i < end; i++)	// Iterate through the remaining triangles
+				{
+					glm::vec3 cp = ClosestPointOnTriangle(centre, td, i);	// Closest point on triangle i
+
+					if (glm::dot(cp - centre, cp - centre) <= radius * radius)	// If within the radius
+						return true;	// Return true as hit
+				}
+
+				return false;	// Return false by default
+			}
 		}
 
 
@@ -433,53 +658,88 @@ namespace Collision
 				return (Detection::DistABRadii(a, b) <= 0);		// Return statement
 			}
 
+			// This function will return true if a sphere (world space) intersects any triangle of an object
+			// Exact for rigid and uniformly scaled objects, conservative under non-uniform scale
+			inline static bool IntersectSphere(Data::CollisionData* obj, glm::vec3 centre, float radius)
+			{
+				bool hit(false);	// Initialise result
+				centre = obj->ToLocal(centre);	// Move centre into local space
+				radius *= Data::MaxScale(obj->m_inv);	// Scale radius into local space
+				Data::Aabb box(centre - glm::vec3(radius), centre + glm::vec3(radius));		// Bounds of the sphere
+
+				obj->bvh.QueryLeaves(box, [&](unsigned int first, unsigned int count)	// Visit nearby leaves only
+				{
+					if (!hit)	// If nothing has been hit yet
+						hit = Detection::SphereToTriangles(centre, radius, obj->t, first, count);	// Test leaf triangles
+				});
+
+				return hit;		// Return result
+			}
+
+			// This function will return true if a point lies within tolerance of any triangle of an object
+			inline static bool IntersectPoint(Data::CollisionData* obj, glm::vec3 point, float tolerance)
+			{
+				return IntersectSphere(obj, point, tolerance);	// A point query is a sphere query with a tolerance radius
+			}
+
+			// This function will return true if the segment p0 -> p1 (world space) hits an object, and output the closest hit fraction and triangle
+			// The hit fraction is unchanged by an affine transform, so it applies to the world space segment too
+			inline static bool IntersectSegment(Data::CollisionData* obj, glm::vec3 p0, glm::vec3 p1, float& out_t, unsigned int& out_triangle)
+			{
+				bool hit(false);	// Initialise result
+				p0 = obj->ToLocal(p0);	// Move start into local space
+				p1 = obj->ToLocal(p1);	// Move end into local space
+				glm::vec3 d = p1 - p0;	// Segment vector
+
+				obj->bvh.RaycastLeaves(p0, d, 1.0f, [&](unsigned int first, unsigned int count, float& t_max) -> bool	// Visit leaves along the segment, nearest first
+				{
+					if (Detection::RayToTriangles(p0, d, obj->t, first, count, t_max, out_triangle))	// If a leaf triangle is closer than the last hit
+					{
+						out_t = t_max;	// Record hit fraction
+						hit = true;		// Record hit
+					}
+
+					return false;	// Keep searching for the closest hit
+				});
+
+				return hit;		// Return result
+			}
+
+			// This function will return true if the convex proxies of a and b overlap, and output the contact (normal from a towards b)
+			// Objects without a convex proxy never report a convex contact
+			inline static bool IntersectConvex(Data::CollisionData* a, Data::CollisionData* b, Convex::Contact& out_contact)
+			{
+				if (a->cs.type == CONVEX_NONE || b->cs.type == CONVEX_NONE)		// If either object is only triangles
+					return false;	// Return false
+
+				if (!a->wb.Overlaps(b->wb))		// If the world bounds are apart
+					return false;	// Return false
+
+				return Convex::Collide(a->cs, a->m, b->cs, b->m, out_contact);	// GJK, then EPA if the shapes overlap
+			}
+
 			// This function will return true if verices intersect between object a and b
 			inline static bool IntersectVertex(float speed_a, glm::vec3 vel_a, Data::CollisionData* obj_a, Data::CollisionData* obj_b)
 			{
-				// THINGS TO CHECK
-				// 1. Check for nearby radii intersection
-				// 2. Check for nearest triangles (facing toward veclotiy vector)
-				// 3. When the distance is less or equal to zero, return true
+				if (glm::dot(vel_a, vel_a) == 0.0f)		// If object a isn't moving it has no direction to sweep along
+					return false;	// Return false
 
 				// --------------------- CHECK FOR NEARBY COLLISION ---------------------
 				if (Detection::DistABRadii(obj_a, obj_b) <= speed_a)	// If distance between collision objects a and b are less or equal to the speed of velocity
 				{
-					// -------------------------------- POINTS --------------------------------
-					for (unsigned int i = 0; i < obj_a->pd.size(); i++)		// Iterate through each point from object a
-					{
-						glm::vec3 p = obj_a->pd[i];		// Temp reference to object a, point i
-						
-						for (unsigned int j = 0; j < obj_b->t.size(); j++)	// Iterate through each triangle of collision object b
-						{
-							Triangle*	t = obj_b->t[j];	// Temp reference to object b, triangle j
+					glm::vec3 step = glm::normalize(vel_a) * speed_a;	// Distance travelled by each point of a
+					float t;	// Unused hit fraction
+					unsigned int tri;	// Unused hit triangle
 
-							// ------------------------ CHECK FOR TRIANGLE INTERSECTION ------------------------
-							if (glm::distance(t->a, p) <= (obj_b->r))	// If the distance between point i is less or equal to the radius of obj b
-							{
-								if (Detection::DotRayToInfinityPlaneNormal(vel_a, t) > 0.0f)	// If the nearby triangles from object b are facing object a's velocity vector
-								{
-									if (Detection::PointInsideTriangleProjection(p, t))		// If point i is within a triangle's projection
-									{
-										if (Detection::DistPointToInfinityPlane(p, t) <= 0.0f)	// If the distance between point i and a triangle is less or equal to zero
-										{
-											return true;	// Return true as point i has intersected with triangle j
-										}
-									}
-								}
-							}
-
-							for (int k = 0; k < 3; k++)		// Iterate through each vertex (TRI = 3 vertices)
-							{
-								// ------------------------ CHECK FOR POINT INTERSECTION -----------------------
-								if (Detection::DistPointToPoint())
-
-								// ------------------------ CHECK FOR EDGE INTERSECTION ------------------------
+					// -------------------------------- POINTS --------------------------------
+					std::vector<glm::vec3> world(obj_a->pd.size());		// Points of object a in world space
+					Math::TransformPointsv3(obj_a->m, obj_a->pd.data(), world.data(), world.size());	// Transform every point in one batch
 
-							}
-						}
+					for (unsigned int i = 0; i < world.size(); i++)		// Iterate through each point from object a
+					{
+						if (IntersectSegment(obj_b, world[i], world[i] + step, t, tri))		// If point i crosses a triangle of object b
+							return true;	// Return true as point i has intersected with object b
 					}
-				
-					
 				}
 
 				return false;	// Return false by default
@@ -501,4 +761,4 @@ namespace Collision
 
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -119,9 +119,9 @@ namespace Commandline
 					std::vector<Material*> test;
 					test.push_back(Content::_materials[1]);
 
-					for (unsigned int i = 0; i < Content::_map->GetActors().size(); i++)
+					for (Actor* a : Content::_map->GetMeshes())
 					{
-						((StaticMesh*)Content::_map->GetActors()[i])->SetMaterials(test);
+						((StaticMesh*)a)->SetMaterials(test);
 					}
 				}
 				break;
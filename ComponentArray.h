@@ -0,0 +1,84 @@
+#ifndef __COMPONENT_ARRAY_H__
+#define __COMPONENT_ARRAY_H__
+
+#define COMPONENT_NULL	-1	// Null component handle
+
+#include <vector>	// Get dynamic arrays
+
+// A dense array of one component type with stable handles
+// Components are packed with no gaps so systems can walk them in order; removing one moves the last component into its place
+template <typename T>
+class ComponentArray
+{
+private:
+	std::vector<T>		_data;		// Packed components
+	std::vector<int>	_handle;	// Handle of each packed component
+	std::vector<int>	_index;		// Packed index of each handle (COMPONENT_NULL when free)
+	std::vector<int>	_free;		// Free handles
+
+public:
+	inline unsigned int Size() const { return (unsigned int)_data.size(); }		// Return the number of components
+	inline bool IsEmpty() const { return _data.empty(); }	// Return true if there are no components
+	inline bool IsValid(int handle) const { return handle >= 0 && handle < (int)_index.size() && _index[handle] != COMPONENT_NULL; }	// Return true if the handle is in use
+
+	inline T &Get(int handle) { return _data[_index[handle]]; }		// Return the component of a handle
+	inline T &operator[](unsigned int i) { return _data[i]; }	// Return the i'th packed component
+	inline int GetHandle(unsigned int i) const { return _handle[i]; }	// Return the handle of the i'th packed component
+
+	inline typename std::vector<T>::iterator begin() { return _data.begin(); }	// Iterate packed components
+	inline typename std::vector<T>::iterator end() { return _data.end(); }
+	inline typename std::vector<T>::const_iterator begin() const { return _data.begin(); }
+	inline typename std::vector<T>::const_iterator end() const { return _data.end(); }
+
+	// Add a component and return its handle
+	inline int Add(const T &value)
+	{
+		int handle;		// New handle
+		if (!_free.empty())		// If a handle can be reused
+		{
+			handle = _free.back();	// Reuse handle
+			_free.pop_back();
+		}
+		else
+		{
+			handle = (int)_index.size();	// New handle
+			_index.push_back(COMPONENT_NULL);
+		}
+
+		_index[handle] = (int)_data.size();		// Map handle
+		_data.push_back(value);		// Add component
+		_handle.push_back(handle);
+
+		return handle;	// Return handle
+	}
+
+	// Remove a component, the last component takes its place
+	inline void Remove(int handle)
+	{
+		if (!IsValid(handle))	// If the handle isn't in use
+			return;		// Return from function
+
+		int i = _index[handle], last = (int)_data.size() - 1;	// Packed index, last packed index
+
+		_data[i] = _data[last];		// Move last component into the gap
+		_handle[i] = _handle[last];
+		_index[_handle[i]] = i;		// Remap moved handle
+
+		_data.pop_back();	// Shrink arrays
+		_handle.pop_back();
+
+		_index[handle] = COMPONENT_NULL;	// Free handle
+		_free.push_back(handle);
+	}
+
+	// Remove every component
+	inline void Clear()
+	{
+		_data.clear();	// Reset components
+		_handle.clear();	// Reset handles
+		_index.clear();		// Reset handle map
+		_free.clear();	// Reset free handles
+	}
+};
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef NOMINMAX
+#define NOMINMAX	// No min and max macros
+#endif
 #include <windows.h>
 #include <fcntl.h>
 #include <sys/types.h>  
@@ -1,7 +1,7 @@
 #ifndef __CONTROL_H__
 #define __CONTROL_H__
 
-#include <glm\glm.hpp>	// Get glm vars
+#include <glm/glm.hpp>	// Get glm vars
 #include "Keyboard.h"	// For checking if control is active
 #include "Mouse.h"	// For checking if control is active
 #include "Rect.h"	// Get the rect class for instancing
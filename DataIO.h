@@ -4,6 +4,9 @@
 #include "Content.h"	// Get access to the content
 #include "ObjLoader.h"	// Get access to our obj wavefront loader functions
 #include "DaeLoader.h"	// Get access to our dao loader functions
+#include "MeshFile.h"	// Get access to our binary mesh format
+#include "VertexCache.h"	// Get access to vertex cache optimisation
+#include "Simplify.h"	// Get access to level of detail generation
 
 
 // This namespace will manage data and information via input / output
@@ -30,28 +33,41 @@ namespace DataIO
 				return false;	// Return false as failed
 			}
 
-			IndexVertexData(obj.v, obj.vt, obj.vn, vd_opt.indices, vd_opt.positions, vd_opt.texcoords, vd_opt.normals, vd_opt.tangents);	// Index our obj data for ebo optimisation
-			CalculateTangents(vd_opt);	// Calculate tangents for each triangle
+			IndexVertexDataParallel(obj.v, obj.vt, obj.vn, vd_opt.indices, vd_opt.positions, vd_opt.texcoords, vd_opt.normals, vd_opt.tangents);	// Index our obj data for ebo optimisation
 
-			Vao* vao_opt = Wavefront::CreateVao(vd_opt.positions, vd_opt.texcoords, vd_opt.normals, vd_opt.tangents, vd_opt.indices);	// Initialise a new ebo using our optimised vertex data
-			
-			chunks_opt.push_back(Chunk(obj.g[0].from, obj.g[0].to, 0));		// Add a chunk for our first main element
+			chunks_opt.push_back(Chunk(obj.g[0].from, obj.g[0].to - obj.g[0].from, 0));		// Add a chunk for our first main element
 			mats_opt.push_back(Content::_materials[0]);		// Assign the default material for our first main element
 
 			if (obj.g.size() > 1)	// If multiple groups were detected...
 			{
 				for (unsigned int i = obj.g.size() - 1; i != 0; i--)	// Iterate through the rest of the groups backwards
 				{
-					chunks_opt.push_back(Chunk(sizeof(GLuint) * obj.g[i].from, obj.g[i].to, i));	// Add another chunk for each group detected
+					chunks_opt.push_back(Chunk(sizeof(GLuint) * obj.g[i].from, obj.g[i].to - obj.g[i].from, i));	// Add another chunk for each group detected
 					mats_opt.push_back(Content::_materials[0]);		// Add another default material to this chunk
 				}
 			}
 
+			VertexCacheStats before, after;		// Vertex cache statistics
+			VertexCache::Optimise(vd_opt, chunks_opt, before, after);	// Reorder triangles and vertices for the vertex cache and overdraw
+			CalculateTangents(vd_opt);	// Calculate tangents for each triangle
+
+			std::vector<MeshLod> lods_opt;	// Simplified levels of detail, appended to our indices
+			Simplify::BuildLods(vd_opt, chunks_opt, lods_opt);	// Simplify each chunk (after the tangents so only the full mesh shapes them)
+			std::cout << "Import (" << obj.o << "): ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << ", " << lods_opt.size() << " levels of detail\n";	// Print statistics
+
+			glm::vec3 bs_centre;	// Bounding sphere centre
+			float bs_radius;	// Bounding sphere radius
+			Math::BoundingSpherev3(vd_opt.positions.data(), vd_opt.positions.size(), bs_centre, bs_radius);	// Bound the positions once at import
+
+			Vao* vao_opt = Wavefront::CreateVao(vd_opt.positions, vd_opt.texcoords, vd_opt.normals, vd_opt.tangents, vd_opt.indices);	// Initialise a new ebo using our optimised vertex data
+
 			Mesh* mesh = new StaticMesh(shader_program, obj.o, mats_opt, Content::_cubemaps[0]);	// Create our temp variable for allocating a mesh
 
 			mesh->SetVao(vao_opt);	// Assign the optimised ebo to our mesh ebo
 			mesh->SetVertexData(vd_opt);	// Assign the optimised vertex data
+			mesh->SetBounds(bs_centre, bs_radius);	// Assign the bounds (after the vertex data, which resets them)
 			mesh->SetChunks(chunks_opt);	// Assign the optimised chunk list to our mesh chunk list
+			mesh->SetLods(lods_opt);	// Assign the levels of detail
 			mesh->SetNumIndices(vd_opt.indices.size());	// Assign the number of indices to our mesh
 
 
@@ -126,36 +142,24 @@ namespace DataIO
 				return false;	// Return false as failed
 			}
 
-			std::string d = " ";	// Create our delim
-			std::fstream f;		// Create our file stream variable
-
-			f.open(static_cast<std::string>(__STATIC_MESH_URI__) + file, std::ios::out);	// Create a new file
-			if (f.is_open())	// If the file opened successfully...
+			VertexData vd;	// Vertex data copied from the file the mesh was opened from
+			if (mesh->GetVertexData().positions.empty())	// If the vertex data only lives on the gpu...
 			{
-				f << "m" << d << mesh->GetMeshType() << d << mesh->GetName() << "\n\n";	// Save the mesh type
-
-				for (unsigned int i = 0; i < mesh->GetChunks().size(); i++)		// Iterate through each chunk...
-					f << "c" << d << mesh->GetChunks()[i]._id << d << mesh->GetChunks()[i]._index_offset << d << mesh->GetChunks()[i]._index_count << d << mesh->GetMaterials()[i]->GetName() << "\n";		// Save the chunk data with each materials assigned
-				f << "\n";	// Create a new line for next value types
-				for (unsigned int i = 0; i < mesh->GetVertexData().positions.size(); i++)		// Iterate through each vertex for our positions...
-					f << "p" << d << mesh->GetVertexData().positions[i].x << d << mesh->GetVertexData().positions[i].y << d << mesh->GetVertexData().positions[i].z << "\n";		// Save the positions
-				f << "\n";	// Create a new line for next value types
-				for (unsigned int i = 0; i < mesh->GetVertexData().texcoords.size(); i++)		// Iterate through each vertex for our texcoords...
-					f << "t" << d << mesh->GetVertexData().texcoords[i].x << d << mesh->GetVertexData().texcoords[i].y << "\n";		// Save the texcoords
-				f << "\n";	// Create a new line for next value types
-				for (unsigned int i = 0; i < mesh->GetVertexData().normals.size(); i++)		// Iterate through each vertex for our normals...
-					f << "n" << d << mesh->GetVertexData().normals[i].x << d << mesh->GetVertexData().normals[i].y  << d << mesh->GetVertexData().normals[i].z << "\n";		// Save the normals
-				f << "\n";	// Create a new line for next value types
-				for (unsigned int i = 0; i < mesh->GetVertexData().indices.size(); i++)		// Iterate through each index for our vertex indices...
-					f << "i" << d << mesh->GetVertexData().indices[i] << "\n";	// Save the indices
-
-				if (mesh->GetMeshType() == M_SKELETAL)	// If the mesh type is skeletal...
+				MeshFile src;	// Mapped source file
+				if (mesh->GetSource().empty() || !src.Open(mesh->GetSource().c_str()))	// If there is no file to copy it from...
 				{
-					// Add extensive values here...
+					std::cout << "Mesh Error: Mesh failed to save - mesh has no vertex data!\n";	// Print error message
+					return false;	// Return false as failed
 				}
+
+				src.GetVertexData(vd);	// Copy the streams out, then unmap so the source can be overwritten
 			}
 
-			return true;	// Return true as success
+			std::vector<std::string> m;		// Material names, one per chunk
+			for (unsigned int i = 0; i < mesh->GetChunks().size(); i++)		// Iterate through each chunk...
+				m.push_back(i < mesh->GetMaterials().size() && mesh->GetMaterials()[i] ? mesh->GetMaterials()[i]->GetName() : "");	// Record the material assigned
+
+			return MeshFile::Write((static_cast<std::string>(__STATIC_MESH_URI__) + file).c_str(), mesh->GetName(), mesh->GetMeshType(), vd.positions.empty() ? mesh->GetVertexData() : vd, mesh->GetChunks(), m, mesh->GetLods());	// Write the binary mesh
 		}
 	};
 
@@ -169,6 +173,24 @@ namespace DataIO
 	public:
 	};
 
+	// This class will convert old files into their current format
+	class Convert
+	{
+	public:
+
+		// Convert a text mesh into a binary mesh file
+		static inline bool TextMeshI(const char* text_file, const char* file)
+		{
+			if (!MeshFile::ConvertText((static_cast<std::string>(__STATIC_MESH_URI__) + text_file).c_str(), (static_cast<std::string>(__STATIC_MESH_URI__) + file).c_str()))	// If the conversion failed...
+			{
+				std::cout << "Mesh Error: The text mesh failed to convert!\n";	// Print error code
+				return false;	// Return false as failed
+			}
+
+			return true;	// Return true as success
+		}
+	};
+
 	class Open
 	{
 	public:
@@ -176,80 +198,50 @@ namespace DataIO
 		// Open a mesh file
 		static inline bool MeshI(unsigned int shader_program, const char* file)
 		{
-			std::ifstream _in(static_cast<std::string>(__STATIC_MESH_URI__) + file);	// Check if the file is valid
-			if (!_in)	// If the file is invalid...
+			MeshFile mf;	// Mapped binary mesh
+			std::string path = static_cast<std::string>(__STATIC_MESH_URI__) + file;	// Full file path
+			if (!mf.Open(path.c_str()))	// If the file is missing or invalid...
 			{
 				std::cout << "Mesh Error: The file is invalid! Check that the file exists.\n";	// Print out error message
 				return false;	// Return false as failed
 			}
 
-			char data[256];		// Create a buffer for each line in the file
-			std::vector <std::string> line;		// This will contain our text from the buffer
-			while (_in.getline(data, 256))	// While each line is being read...
-				line.push_back(data);	// Assign the data to our string container
-
-			unsigned int t = 0;		// This will record the mesh type
-			int cd[3];	// Store chunk data
-			float x, y, z;	// Create temp variables for vertex data
-			char chars[128];	// Create temp variable for character data
-			std::string n;	// This will store the meshes name
-			Vao* vao;	// Our vertex buffer object for storing vertex arrays
-			VertexData vd;	// Our vertex data for parsing to our ebo
 			std::vector<Chunk> c;	// Our chunk data for assigning to our mesh
 			std::vector<Material*> m;	// Our material data for assigning to our mesh chunks
 
-			for (unsigned int i = 0; i < line.size(); i++)	// Iterate through each line...
+			for (unsigned int i = 0; i < mf.GetGroupCount(); i++)	// Iterate through each group...
 			{
-				switch ((line[i])[0])	// Check the value of the first character of each line
+				Material* mat = Content::GetMaterial(mf.GetMaterialName(i));	// Find the material by name
+				if (!mat)	// If the material isn't loaded...
 				{
-				case 'm':	// If the character is a 'm'...
-					sscanf_s((&line[i])[0].c_str(), "m %d %s", &t, &chars, 128);		// Scan this line
-					n = chars;	// Record name data
-					break;
-
-				case 'c':	// If the character is a 'c'...
-					sscanf_s((&line[i])[0].c_str(), "c %d %d %d %s", &cd[0], &cd[1], &cd[2], &chars, 128);		// Scan this line
-
-					c.push_back(Chunk(cd[1], cd[2], cd[0]));	// Record chunk data
-					m.push_back(Content::GetMaterial(chars));	// Record material data
-					break;
-
-				case 'p':	// If the character is a 'p'...
-					sscanf_s((&line[i])[0].c_str(), "p %f %f %f", &x, &y, &z);		// Scan this line
-					vd.positions.push_back(glm::vec3(x, y, z));	// Record attrib data
-					break;
-
-				case 't':	// If the character is a 't'...
-					sscanf_s((&line[i])[0].c_str(), "t %f %f", &x, &y);		// Scan this line
-					vd.texcoords.push_back(glm::vec3(x, y, 0.0f));	// Record attrib data
-					break;
-
-				case 'n':	// If the character is a 'n'...
-					sscanf_s((&line[i])[0].c_str(), "n %f %f %f", &x, &y, &z);		// Scan this line
-					vd.normals.push_back(glm::vec3(x, y, z));	// Record attrib data
-					break;
-
-				case 'i':	// If the character is a 'i'...
-					sscanf_s((&line[i])[0].c_str(), "i %d", &cd[0]);		// Scan this line
-					vd.indices.push_back(cd[0]);	// Record attrib data
-					break;
+					std::cout << "Mesh Warning: Material " << mf.GetMaterialName(i) << " wasn't found, using the default.\n";	// Print out warning
+					mat = Content::_materials[0];	// Use the default material
 				}
+
+				c.push_back(mf.GetChunk(i));	// Record chunk data
+				m.push_back(mat);	// Record material data
 			}
 
-			vao = Wavefront::CreateVao(vd.positions, vd.texcoords, vd.normals, vd.tangents, vd.indices);		// Create our vao
-			
-			Mesh* mesh = new StaticMesh(shader_program, n, m, Content::_cubemaps[0]);		// Create our temp variable for allocating a mesh
+			Vao* vao = new Vao({ new Vbo(mf.GetVertices(), (size_t)mf.GetVertexCount() * sizeof(MeshFileVertex), sizeof(MeshFileVertex), {
+				{ 0, 3, offsetof(MeshFileVertex, position) },
+				{ 1, 3, offsetof(MeshFileVertex, texcoord) },
+				{ 2, 3, offsetof(MeshFileVertex, normal) },
+				{ 3, 3, offsetof(MeshFileVertex, tangent) } }) },
+				new Ebo(mf.GetIndices(), mf.GetIndexCount()));	// Upload straight from the mapped pages
+
+			const MeshFileBounds &b = mf.GetBounds();	// Local bounds
+
+			Mesh* mesh = new StaticMesh(shader_program, mf.GetName(), m, Content::_cubemaps[0]);		// Create our temp variable for allocating a mesh
 			
 			mesh->SetVao(vao);	// Assign the optimised ebo to our mesh ebo
-			mesh->SetVertexData(vd);	// Assign the optimised vertex data
 			mesh->SetChunks(c);	// Assign the optimised chunk list to our mesh chunk list
-			mesh->SetNumIndices(vd.indices.size());	// Assign the number of indices to our mesh
-
-
+			mesh->SetNumIndices(mf.GetIndexCount());	// Assign the number of indices to our mesh
+			mesh->SetBounds(glm::vec3(b.centre[0], b.centre[1], b.centre[2]), b.radius);	// Assign the stored bounds, there are no positions on the cpu to bound
+			mesh->SetSource(path);	// Remember the file, SaveAs::MeshO copies the vertex data back out of it
 
-			// TEMP !!! Set up per-vertex collision ----------------------------------
-			//mesh->SetCollisionType(COLLISION_TYPE_PER_VERTEX);
-			// TEMP !!! --------------------------------------------------------------
+			std::vector<MeshLod> lods;	// Levels of detail (none in files written before they were added)
+			mf.GetLods(lods);
+			mesh->SetLods(lods);	// Assign the levels of detail
 
 			Content::_meshes.push_back(mesh);	// Add the mesh to our content
 			
@@ -6,7 +6,7 @@
 #include "GeometryPass.h"	// Get geometry pass
 #include "LightPass.h"	// Get light pass
 #include "SsaoPass.h"	// Get ssao pass
-#include "CPicker.h" // Get bloom pass
+#include "PostProcessing.h" // Get bloom pass
 
 #include "PBR.h"
 
@@ -185,6 +185,9 @@ public:
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);			// Clear last buffers
 
+		RenderSnapshot &snapshot = Content::_map->GetSnapshot();	// Published render state
+		Mesh::SetLodView(snapshot.eye, snapshot.proj, (float)_pd_height);	// Pick levels of detail from the camera once, so shadows and geometry draw the same ones
+
 		//// ------------------------- SHADOWING PASS -------------------------- // 
 		static_cast<Shadowmapping*>(post_effects[2])->Render();
 		//// ------------------------------------------------------------------- //
@@ -224,7 +227,7 @@ public:
 			glm::mat4 model;
 			for (Actor* a : Content::_map->GetActors())		// Iterate through each actor
 			{
-				model = a->GetMatrix();	// Get model matrix
+				model = a->GetRenderMatrix();	// Get model matrix
 				glUniformMatrix4fv(((LightPass*)passes[LIGHT_PASS])->_u_mat, 1, GL_FALSE, glm::value_ptr(model));	// Send model matrix to buffer
 			}
 
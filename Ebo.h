@@ -11,17 +11,24 @@ class Ebo
 private:
 	GLuint						_ebo;	// Element buffer object
 	std::vector<unsigned int>	_index_data;	// Element buffer object data
+	const unsigned int*			_raw_data;	// Index data to upload instead (only read by Create)
+	size_t						_raw_count;		// Number of raw indices
 
 public:
 	// Default constructor
-	inline Ebo() {}
+	inline Ebo() : _raw_data(NULL), _raw_count(0) {}
 
 	// Initial constructor
 	inline Ebo(std::vector<unsigned int> index_data)
 	{
 		_index_data = index_data;		// Assign index data
+		_raw_data = NULL;	// Use index data
+		_raw_count = 0;
 	}
 
+	// Raw constructor, data only has to stay valid until Create (so it can point straight into a mapped file)
+	inline Ebo(const unsigned int* data, size_t count) : _raw_data(data), _raw_count(count) {}
+
 	// Deconstructor
 	inline ~Ebo()
 	{
@@ -45,7 +52,13 @@ public:
 	{
 		glGenBuffers(1, &_ebo);	// Generate our ebo
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);	// Bind our ebo
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, _index_data.size() * sizeof(unsigned int), &_index_data[0], GL_STATIC_DRAW);	// Buffer our ebo data
+		if (_raw_data)	// If the indices are raw
+		{
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, _raw_count * sizeof(unsigned int), _raw_data, GL_STATIC_DRAW);	// Buffer our ebo data
+			_raw_data = NULL;	// The data may not outlive the upload
+		}
+		else	// Otherwise
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, _index_data.size() * sizeof(unsigned int), &_index_data[0], GL_STATIC_DRAW);	// Buffer our ebo data
 	}
 };
 
@@ -77,7 +77,7 @@ public:
 				// ----------------------------------------------- IMPOSE STATIC MESH TO LEVEL -----------------------------------------------
 				if (Keyboard::GetKey('R').down)		// Add our mesh from the content to the world
 				{
-					Content::_map->GetActors().push_back(Content::_meshes[Content::_meshes.size() - 1]);		// Choose the mesh from our content and add it to the world actor list
+					Content::_map->AddActor(Content::_meshes[Content::_meshes.size() - 1], MESH);		// Choose the mesh from our content and add it to the world actor list
 				}
 				// ----------------------------------------------- SAVE STATIC MESH -----------------------------------------------
 				if (Keyboard::GetKey('M').down)		// Save a mesh file
@@ -95,12 +95,10 @@ public:
 						std::cout << "Filed to open mesh file!\n";
 				}
 
-				// ----------------------------------------------- PRINT STATS -----------------------------------------------
-				if (Keyboard::GetKey('C').down)
+				// ----------------------------------------------- PRINT CULLING STATS -----------------------------------------------
+				if (Keyboard::GetKey('V').down)		// Print how many meshes the last snapshot drew
 				{
-					Content::_map->GetPlayerController()->GetAttachments()[0]->mesh->UpdateCollision();
-
-					Collision::Ndc::Intersection::IntersectVertex(CAMERA_SPEED, Content::_map->GetPlayerController()->GetFront(), Content::_meshes[0]->GetCollisionData(), Content::_meshes[1]->GetCollisionData());
+					std::cout << "Visible meshes: " << Content::_map->GetVisibleCount() << ", culled: " << Content::_map->GetCulledCount() << "\n";		// Print frustum culling stats
 				}
 			}
 			break;
@@ -130,7 +128,17 @@ public:
 			// Check for selected actors
 			if (GetAsyncKeyState(VK_CONTROL) & 0x8000)	// If control is down
 			{
-				unsigned int id = 0; //= Deferred::_cpicker->_selected_id;		// Get reference
+				glm::vec3 origin, dir;	// Pick ray
+				Content::_map->GetPlayerController()->GetPickRay(Mouse::GetPointX(), Mouse::GetPointY(), origin, dir);	// Build a ray through the cursor
+
+				Collision::Ndc::Raycast::RayHit hit;	// Closest hit
+				unsigned int id = -1;	// Selected actor id
+
+				if (Content::_map->RaycastClosest(origin, dir, CAMERA_FAR, hit, MESH))	// If a mesh is under the cursor
+					id = Content::_map->GetActorIndex((Actor*)hit.data);	// Get its actor id
+				else if (Actor* a = Content::_map->PickActor(origin, dir, CAMERA_FAR))	// Otherwise fall back to actor bounds, for meshes without collision
+					if (a->GetObjectType() == MESH)		// If a mesh was picked
+						id = Content::_map->GetActorIndex(a);	// Get its actor id
 				if (id != -1)	// If an actor has been selected
 				{
 					if (GetAsyncKeyState(VK_LSHIFT) & 0x8000)	// Check for multiple selected actors
@@ -0,0 +1,129 @@
+#ifndef __FRUSTUM_H__
+#define __FRUSTUM_H__
+
+#define FRUSTUM_PLANES	6	// Left, right, bottom, top, near and far
+
+#include <vector>	// Get dynamic arrays
+#include <glm/glm.hpp>	// Get 3D variables
+#include "Simd.h"	// Get vector instruction wrappers
+
+// A view frustum as six normalised planes (inside where dot(plane.xyz, p) + plane.w >= 0)
+// Extract once per frame from a view projection matrix, then test any number of bounding spheres against it
+class Frustum
+{
+private:
+	glm::vec4	_planes[FRUSTUM_PLANES];	// Normalised planes
+
+public:
+	// Default constructor - accept everything
+	inline Frustum()
+	{
+		for (int p = 0; p < FRUSTUM_PLANES; p++)
+			_planes[p] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	// Initial constructor
+	inline explicit Frustum(const glm::mat4 &view_proj) { Extract(view_proj); }
+
+	inline const glm::vec4 &GetPlane(int p) const { return _planes[p]; }	// Return a plane
+
+	// Build the planes from the rows of a view projection matrix (world space planes when given proj * view)
+	inline void Extract(const glm::mat4 &view_proj)
+	{
+		glm::vec4 r[4];		// Matrix rows
+		for (int row = 0; row < 4; row++)
+			r[row] = glm::vec4(view_proj[0][row], view_proj[1][row], view_proj[2][row], view_proj[3][row]);
+
+		_planes[0] = r[3] + r[0];	// Left
+		_planes[1] = r[3] - r[0];	// Right
+		_planes[2] = r[3] + r[1];	// Bottom
+		_planes[3] = r[3] - r[1];	// Top
+		_planes[4] = r[3] + r[2];	// Near
+		_planes[5] = r[3] - r[2];	// Far
+
+		for (int p = 0; p < FRUSTUM_PLANES; p++)	// Normalise once, so sphere tests are a dot product each
+			_planes[p] /= glm::length(glm::vec3(_planes[p]));
+	}
+
+	// Return true if any part of a sphere is inside the frustum
+	inline bool TestSphere(const glm::vec3 &centre, float radius) const
+	{
+		for (int p = 0; p < FRUSTUM_PLANES; p++)	// Iterate through each plane
+			if (glm::dot(glm::vec3(_planes[p]), centre) + _planes[p].w <= -radius)	// If the sphere is fully behind the plane
+				return false;	// Return false
+
+		return true;	// Return true
+	}
+
+	// Return true if any part of a box may be inside the frustum (tests the corner furthest along each plane normal)
+	inline bool TestAabb(const glm::vec3 &box_min, const glm::vec3 &box_max) const
+	{
+		for (int p = 0; p < FRUSTUM_PLANES; p++)	// Iterate through each plane
+		{
+			glm::vec3 far_corner(_planes[p].x >= 0.0f ? box_max.x : box_min.x, _planes[p].y >= 0.0f ? box_max.y : box_min.y, _planes[p].z >= 0.0f ? box_max.z : box_min.z);	// Most inside corner
+
+			if (glm::dot(glm::vec3(_planes[p]), far_corner) + _planes[p].w < 0.0f)	// If even that corner is behind the plane
+				return false;	// Return false
+		}
+
+		return true;	// Return true
+	}
+
+	// Append the index of every sphere that touches the frustum to out_visible, and return the number appended
+	// Spheres are split into x, y, z and radius arrays so groups of them can be tested per plane at once
+	inline unsigned int CullSpheres(const float* x, const float* y, const float* z, const float* r, size_t n, std::vector<unsigned int> &out_visible) const
+	{
+		size_t start = out_visible.size(), i = 0;	// First new entry, sphere index
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			CullSpheresN<Simd::F8>(x, y, z, r, i, n, out_visible);	// 8 spheres at a time
+#endif
+#ifdef SIMD_SSE
+		CullSpheresN<Simd::F4>(x, y, z, r, i, n, out_visible);	// 4 spheres at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining spheres
+			if (TestSphere(glm::vec3(x[i], y[i], z[i]), r[i]))	// If the sphere is visible
+				out_visible.push_back((unsigned int)i);		// Add index
+
+		return (unsigned int)(out_visible.size() - start);	// Return number of visible spheres
+	}
+
+private:
+	// Vector kernel: test spheres [i, n) in groups of V::WIDTH and append the visible ones in order
+	template <typename V>
+	inline void CullSpheresN(const float* x, const float* y, const float* z, const float* r, size_t &i, size_t n, std::vector<unsigned int> &out_visible) const
+	{
+		typedef typename V::T T;	// Register type
+		T pa[FRUSTUM_PLANES], pb[FRUSTUM_PLANES], pc[FRUSTUM_PLANES], pd[FRUSTUM_PLANES];	// Broadcast planes
+
+		for (int p = 0; p < FRUSTUM_PLANES; p++)
+		{
+			pa[p] = V::Set(_planes[p].x); pb[p] = V::Set(_planes[p].y);
+			pc[p] = V::Set(_planes[p].z); pd[p] = V::Set(_planes[p].w);
+		}
+
+		T zero = V::Set(0.0f);	// Zero lanes
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			T cx = V::Load(x + i), cy = V::Load(y + i), cz = V::Load(z + i);	// Centres
+			T nr = V::Sub(zero, V::Load(r + i));	// Negated radii
+			T in = V::Ge(zero, zero);	// All lanes inside
+
+			for (int p = 0; p < FRUSTUM_PLANES; p++)	// Iterate through each plane
+			{
+				T d = V::Add(V::Add(V::Add(V::Mul(pa[p], cx), V::Mul(pb[p], cy)), V::Mul(pc[p], cz)), pd[p]);	// Signed distance
+				in = V::And(in, V::Gt(d, nr));	// Keep lanes in front of the plane
+			}
+
+			int mask = V::Mask(in);		// One bit per visible sphere
+			for (int k = 0; mask; k++, mask >>= 1)	// Iterate through each set bit
+				if (mask & 1)
+					out_visible.push_back((unsigned int)(i + k));	// Add index
+		}
+	}
+};
+
+#endif
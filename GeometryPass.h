@@ -61,26 +61,24 @@ public:
 
 
 		glUniform1i(_u_wire_mate, _wire_mate);	// Send polygon mode to shader
-		glUniform3fv(_u_camera_pos, 1, glm::value_ptr(Content::_map->GetPlayerController()->GetPosition()));		// Bind the camera position uniform location
+		RenderSnapshot &snapshot = Content::_map->GetSnapshot();	// Published render state
+		glUniform3fv(_u_camera_pos, 1, glm::value_ptr(snapshot.eye));		// Bind the camera position uniform location
 
-		Content::_map->GetPlayerController()->Render();	// Render the camera
+		Content::_map->GetPlayerController()->Render(snapshot.cam_view, snapshot.proj);	// Render the camera
 		
-		for (Actor* a : Content::_map->GetActors())		// Iterate through each actor in map
+		for (Actor* a : snapshot.visible)		// Iterate through each mesh inside the camera frustum
 		{
-			if (a->GetObjectType() == MESH) // If object type is type mesh
+			if (_wire_mate)		// If wire mode is toggled
 			{
-				if (_wire_mate)		// If wire mode is toggled
-				{
-					glDisable(GL_CULL_FACE);
-					glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);	// Assign current polygon mode
-				}
+				glDisable(GL_CULL_FACE);
+				glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);	// Assign current polygon mode
+			}
 
-				a->Render(); // render mesh actor
+			a->Render(); // render mesh actor
 
-				glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);	// Assign current polygon mode
-				glEnable(GL_CULL_FACE);
-				glEnable(GL_DEPTH_TEST);	// Enable depth test
-			}
+			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);	// Assign current polygon mode
+			glEnable(GL_CULL_FACE);
+			glEnable(GL_DEPTH_TEST);	// Enable depth test
 		}
 	}
 };
@@ -0,0 +1,686 @@
+#ifndef __GJK_H__
+#define __GJK_H__
+
+#define CONVEX_NONE			0	// No convex proxy, use the triangles
+#define CONVEX_BOX			1	// Convex proxy box
+#define CONVEX_SPHERE		2	// Convex proxy sphere
+#define CONVEX_CAPSULE		3	// Convex proxy capsule (along local y)
+#define CONVEX_HULL			4	// Convex proxy hull of points
+
+#define GJK_MAX_ITERATIONS	32			// Max support evaluations before GJK gives up
+#define GJK_TOLERANCE		0.0001f		// Relative distance change that counts as converged
+#define EPA_MAX_ITERATIONS	64			// Max polytope expansions before EPA gives up
+#define EPA_TOLERANCE		0.0001f		// Depth change that counts as converged
+
+#include <vector>	// Get vectors
+#include <algorithm>	// Get remove
+#include <cfloat>	// Get float limits
+#include <cstdint>	// Get fixed width integers
+#include <glm/glm.hpp>	// Get vector math
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for storing collision arbitrary data
+		namespace Data
+		{
+			// A convex shape in local space, described only by its support function
+			struct ConvexShape
+			{
+				uint8_t					type;	// Convex type
+				glm::vec3				c;		// Centre
+				glm::vec3				e;		// Half extents (box)
+				float					r;		// Radius (sphere and capsule)
+				float					h;		// Half segment length (capsule)
+				std::vector<glm::vec3>	v;		// Hull vertices
+			};
+
+			// A hull face wound counter clockwise seen from outside, with its plane and the points in front of it
+			struct HullFace
+			{
+				unsigned int				v[3];		// Point index of each corner
+				glm::vec3					n;			// Unit outward normal
+				float						d;			// Plane distance from the origin
+				std::vector<unsigned int>	outside;	// Points in front of the face (hull building only)
+			};
+
+			// Create a face from three points
+			inline static HullFace MakeFace(const std::vector<glm::vec3> &p, unsigned int a, unsigned int b, unsigned int c)
+			{
+				HullFace f;		// Temp face
+				f.v[0] = a; f.v[1] = b; f.v[2] = c;		// Assign corners
+
+				glm::vec3 n = glm::cross(p[b] - p[a], p[c] - p[a]);	// Unnormalised normal
+				float l = glm::length(n);	// Twice the face area
+				f.n = (l > FLT_MIN) ? n / l : glm::vec3(0.0f);	// Normalise
+				f.d = glm::dot(f.n, p[a]);	// Plane distance
+
+				return f;	// Return face
+			}
+
+			// Replace every face that can see point eye with a fan of faces from the horizon to eye
+			// The points outside removed faces are appended to orphans, and the index of the first new face is returned
+			inline static unsigned int ExpandHull(const std::vector<glm::vec3> &p, std::vector<HullFace> &faces, unsigned int eye, float epsilon, std::vector<unsigned int>* orphans)
+			{
+				std::vector<std::pair<unsigned int, unsigned int>> horizon;		// Edges of removed faces that aren't shared with another removed face
+				unsigned int kept = 0;	// Number of faces kept
+
+				for (unsigned int i = 0; i < faces.size(); i++)		// Iterate through each face
+				{
+					if (glm::dot(faces[i].n, p[eye]) - faces[i].d <= epsilon)	// If the face can't see the point
+					{
+						if (kept != i) faces[kept] = std::move(faces[i]);	// Keep face
+						kept++;
+						continue;	// Skip face
+					}
+
+					if (orphans)	// If the caller wants the points that lost their face
+						orphans->insert(orphans->end(), faces[i].outside.begin(), faces[i].outside.end());	// Gather points
+
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each edge
+					{
+						unsigned int a = faces[i].v[k], b = faces[i].v[(k + 1) % 3];	// Edge points
+						bool shared = false;	// Was the edge already seen from the other side?
+
+						for (unsigned int j = 0; j < horizon.size(); j++)	// Iterate through each open edge
+						{
+							if (horizon[j].first == b && horizon[j].second == a)	// If this is the reverse edge
+							{
+								horizon[j] = horizon.back();	// Cancel both edges
+								horizon.pop_back();
+								shared = true;
+								break;
+							}
+						}
+
+						if (!shared)	// If the edge is open
+							horizon.push_back(std::make_pair(a, b));	// Add edge
+					}
+				}
+
+				faces.resize(kept);		// Drop removed faces
+
+				for (std::pair<unsigned int, unsigned int> &e : horizon)	// Iterate through each horizon edge
+					faces.push_back(MakeFace(p, e.first, e.second, eye));	// Close the hole
+
+				return kept;	// Return first new face
+			}
+
+			// Build a convex hull with quickhull and return its vertices
+			// Degenerate (flat or tiny) point sets keep every point, which gives the same support function
+			inline static std::vector<glm::vec3> QuickHull(const std::vector<glm::vec3> &p)
+			{
+				if (p.size() < 4)	// If there is no volume
+					return p;	// Return every point
+
+				// ------------------------- INITIAL TETRAHEDRON -------------------------
+				unsigned int ext[6] = { 0, 0, 0, 0, 0, 0 };		// Min and max point on each axis
+				glm::vec3 size(0.0f);	// Largest coordinate per axis
+				for (unsigned int i = 0; i < p.size(); i++)		// Iterate through each point
+				{
+					for (int a = 0; a < 3; a++)		// Iterate through each axis
+					{
+						if (p[i][a] < p[ext[a * 2]][a]) ext[a * 2] = i;		// Track min
+						if (p[i][a] > p[ext[a * 2 + 1]][a]) ext[a * 2 + 1] = i;		// Track max
+					}
+
+					size = glm::max(size, glm::abs(p[i]));	// Track scale
+				}
+
+				float epsilon = 3.0f * FLT_EPSILON * (size.x + size.y + size.z);	// Plane tolerance relative to the point scale
+
+				unsigned int i0 = 0, i1 = 0;	// Furthest extreme pair
+				float best = 0.0f;
+				for (int a = 0; a < 6; a++)
+					for (int b = a + 1; b < 6; b++)
+					{
+						float l = glm::dot(p[ext[b]] - p[ext[a]], p[ext[b]] - p[ext[a]]);	// Squared distance
+						if (l > best) { best = l; i0 = ext[a]; i1 = ext[b]; }
+					}
+
+				unsigned int i2 = 0;	// Point furthest from the line
+				best = 0.0f;
+				glm::vec3 dir = p[i1] - p[i0];	// Line direction
+				for (unsigned int i = 0; i < p.size(); i++)
+				{
+					glm::vec3 c = glm::cross(p[i] - p[i0], dir);	// Scaled distance from the line
+					float l = glm::dot(c, c);
+					if (l > best) { best = l; i2 = i; }
+				}
+
+				glm::vec3 n = glm::cross(p[i1] - p[i0], p[i2] - p[i0]);		// Base plane normal
+				if (glm::length(n) <= epsilon)	// If every point is on a line
+					return p;	// Return every point
+
+				n = glm::normalize(n);
+				unsigned int i3 = 0;	// Point furthest from the base plane
+				best = 0.0f;
+				for (unsigned int i = 0; i < p.size(); i++)
+				{
+					float l = glm::abs(glm::dot(n, p[i] - p[i0]));	// Distance from the plane
+					if (l > best) { best = l; i3 = i; }
+				}
+
+				if (best <= epsilon)	// If every point is on a plane
+					return p;	// Return every point
+
+				if (glm::dot(n, p[i3] - p[i0]) > 0.0f)	// If the apex is in front of the base
+					std::swap(i1, i2);	// Flip the base so it faces away from the apex
+
+				std::vector<HullFace> faces;	// Hull faces
+				faces.push_back(MakeFace(p, i0, i1, i2));	// Base
+				faces.push_back(MakeFace(p, i0, i3, i1));	// Side
+				faces.push_back(MakeFace(p, i1, i3, i2));	// Side
+				faces.push_back(MakeFace(p, i2, i3, i0));	// Side
+
+				// ------------------------- ASSIGN OUTSIDE POINTS -------------------------
+				std::vector<unsigned int> pending;	// Points to assign
+				for (unsigned int i = 0; i < p.size(); i++)
+					if (i != i0 && i != i1 && i != i2 && i != i3)
+						pending.push_back(i);
+
+				unsigned int first = 0;		// First face to assign to
+				for (;;)
+				{
+					for (unsigned int i : pending)	// Iterate through each point
+					{
+						float far_d = epsilon;	// Distance to beat
+						int far_f = -1;		// Face the point is furthest in front of
+						for (unsigned int f = first; f < faces.size(); f++)
+						{
+							float l = glm::dot(faces[f].n, p[i]) - faces[f].d;	// Distance in front of the face
+							if (l > far_d) { far_d = l; far_f = (int)f; }
+						}
+
+						if (far_f >= 0)		// If the point is outside the hull
+							faces[far_f].outside.push_back(i);	// Assign point
+					}
+
+					pending.clear();	// Every point has been assigned or dropped
+
+					// ------------------------- EXPAND -------------------------
+					int face = -1;	// Face with points still outside
+					for (unsigned int f = 0; f < faces.size() && face < 0; f++)
+						if (!faces[f].outside.empty())
+							face = (int)f;
+
+					if (face < 0)	// If the hull holds every point
+						break;	// Stop expanding
+
+					unsigned int eye = faces[face].outside[0];	// Furthest point in front of the face
+					float far_d = -FLT_MAX;
+					for (unsigned int i : faces[face].outside)
+					{
+						float l = glm::dot(faces[face].n, p[i]) - faces[face].d;
+						if (l > far_d) { far_d = l; eye = i; }
+					}
+
+					first = ExpandHull(p, faces, eye, epsilon, &pending);	// Replace every face the point can see
+					pending.erase(std::remove(pending.begin(), pending.end(), eye), pending.end());		// The eye is on the hull now
+				}
+
+				// ------------------------- GATHER VERTICES -------------------------
+				std::vector<bool> used(p.size(), false);	// Is the point a hull vertex?
+				std::vector<glm::vec3> out;		// Hull vertices
+				for (HullFace &f : faces)
+					for (int k = 0; k < 3; k++)
+						if (!used[f.v[k]])
+						{
+							used[f.v[k]] = true;
+							out.push_back(p[f.v[k]]);	// Add vertex
+						}
+
+				return out;		// Return hull vertices
+			}
+
+			// Create a box from its centre and half extents
+			inline static ConvexShape MakeBox(glm::vec3 centre, glm::vec3 half_extents)
+			{
+				return ConvexShape({ CONVEX_BOX, centre, half_extents, 0.0f, 0.0f, {} });	// Return shape
+			}
+
+			// Create a sphere from its centre and radius
+			inline static ConvexShape MakeSphere(glm::vec3 centre, float radius)
+			{
+				return ConvexShape({ CONVEX_SPHERE, centre, glm::vec3(0.0f), radius, 0.0f, {} });	// Return shape
+			}
+
+			// Create a capsule along local y from its centre, radius and half segment length
+			inline static ConvexShape MakeCapsule(glm::vec3 centre, float radius, float half_height)
+			{
+				return ConvexShape({ CONVEX_CAPSULE, centre, glm::vec3(0.0f), radius, half_height, {} });	// Return shape
+			}
+
+			// Create the convex hull of a point cloud
+			inline static ConvexShape MakeHull(const std::vector<glm::vec3> &points)
+			{
+				return ConvexShape({ CONVEX_HULL, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f, QuickHull(points) });	// Return shape
+			}
+
+			// Return the point of a shape furthest along a direction (local space)
+			inline static glm::vec3 LocalSupport(const ConvexShape &s, const glm::vec3 &d)
+			{
+				switch (s.type)
+				{
+				case CONVEX_BOX:	// Pick the corner on the side of d
+					return s.c + glm::vec3(d.x < 0.0f ? -s.e.x : s.e.x, d.y < 0.0f ? -s.e.y : s.e.y, d.z < 0.0f ? -s.e.z : s.e.z);
+
+				case CONVEX_SPHERE:		// Push the centre out along d
+				case CONVEX_CAPSULE:	// Pick the segment end on the side of d, then push out along d
+				{
+					float l = glm::length(d);	// Direction length
+					glm::vec3 p = (l > FLT_MIN) ? s.c + d * (s.r / l) : s.c + glm::vec3(s.r, 0.0f, 0.0f);		// Sphere support
+
+					if (s.type == CONVEX_CAPSULE)	// If the sphere is swept
+						p.y += (d.y < 0.0f) ? -s.h : s.h;	// Move to the segment end
+
+					return p;
+				}
+
+				case CONVEX_HULL:	// Pick the vertex furthest along d
+				{
+					glm::vec3 p = s.c;	// Best vertex
+					float best = -FLT_MAX;
+					for (const glm::vec3 &v : s.v)
+					{
+						float l = glm::dot(v, d);
+						if (l > best) { best = l; p = v; }
+					}
+
+					return p;
+				}
+				}
+
+				return s.c;		// Return centre by default
+			}
+
+			// Return the point of a shape furthest along a world space direction, with the shape placed by m
+			// An affine map keeps the support mapping, so the direction goes in through the transpose and the point comes out through m
+			inline static glm::vec3 Support(const ConvexShape &s, const glm::mat4 &m, const glm::vec3 &d)
+			{
+				glm::vec3 local_d(glm::dot(glm::vec3(m[0]), d), glm::dot(glm::vec3(m[1]), d), glm::dot(glm::vec3(m[2]), d));	// Direction in local space
+				return glm::vec3(m * glm::vec4(LocalSupport(s, local_d), 1.0f));	// Return world space point
+			}
+		}
+
+		// A namespace for convex queries on the Minkowski difference A - B
+		namespace Convex
+		{
+			// A point of the Minkowski difference and the shape points it came from
+			struct SupportPoint
+			{
+				glm::vec3	w;		// Point on A - B
+				glm::vec3	a;		// Point on A
+				glm::vec3	b;		// Point on B
+			};
+
+			// The result of a GJK query
+			struct GjkResult
+			{
+				bool			hit;		// Do the shapes overlap?
+				float			distance;	// Distance between the shapes (0 on overlap)
+				glm::vec3		point_a;	// Closest point on A
+				glm::vec3		point_b;	// Closest point on B
+				SupportPoint	s[4];		// Final simplex
+				unsigned int	n;			// Simplex size
+			};
+
+			// A penetration contact
+			struct Contact
+			{
+				glm::vec3	normal;		// Unit normal from A towards B, move A by -normal * depth to separate
+				float		depth;		// Penetration depth
+				glm::vec3	point_a;	// Deepest point of A inside B
+				glm::vec3	point_b;	// Deepest point of B inside A
+			};
+
+			// Return the support point of A - B along a direction
+			inline static SupportPoint Support(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, const glm::vec3 &d)
+			{
+				SupportPoint p;		// Temp point
+				p.a = Data::Support(a, ma, d);	// Furthest point of A along d
+				p.b = Data::Support(b, mb, -d);		// Furthest point of B against d
+				p.w = p.a - p.b;	// Difference
+				return p;	// Return point
+			}
+
+			// Reduce a simplex to the smallest sub simplex that holds the point closest to the origin, and output the barycentric weights of that point
+			// Returns false when a tetrahedron contains the origin
+			inline static bool ReduceSimplex(SupportPoint* s, unsigned int &n, float* l)
+			{
+				if (n == 1)		// Point
+				{
+					l[0] = 1.0f;
+					return true;
+				}
+
+				if (n == 2)		// Segment
+				{
+					glm::vec3 ab = s[1].w - s[0].w;		// Segment vector
+					float t = -glm::dot(s[0].w, ab);	// Projection of the origin
+					float ll = glm::dot(ab, ab);
+
+					if (t <= 0.0f) { n = 1; l[0] = 1.0f; return true; }		// Closest to a
+					if (t >= ll) { s[0] = s[1]; n = 1; l[0] = 1.0f; return true; }		// Closest to b
+
+					l[1] = t / ll;
+					l[0] = 1.0f - l[1];
+					return true;
+				}
+
+				if (n == 3)		// Triangle (Ericson's closest point on triangle by Voronoi region)
+				{
+					glm::vec3 a = s[0].w, b = s[1].w, c = s[2].w;
+					glm::vec3 ab = b - a, ac = c - a, ap = -a;
+
+					float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+					if (d1 <= 0.0f && d2 <= 0.0f) { n = 1; l[0] = 1.0f; return true; }		// Vertex a
+
+					glm::vec3 bp = -b;
+					float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+					if (d3 >= 0.0f && d4 <= d3) { s[0] = s[1]; n = 1; l[0] = 1.0f; return true; }	// Vertex b
+
+					float vc = d1 * d4 - d3 * d2;
+					if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)		// Edge ab
+					{
+						l[1] = d1 / (d1 - d3); l[0] = 1.0f - l[1];
+						n = 2;
+						return true;
+					}
+
+					glm::vec3 cp = -c;
+					float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+					if (d6 >= 0.0f && d5 <= d6) { s[0] = s[2]; n = 1; l[0] = 1.0f; return true; }	// Vertex c
+
+					float vb = d5 * d2 - d1 * d6;
+					if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)		// Edge ac
+					{
+						l[1] = d2 / (d2 - d6); l[0] = 1.0f - l[1];
+						s[1] = s[2]; n = 2;
+						return true;
+					}
+
+					float va = d3 * d6 - d5 * d4;
+					if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)	// Edge bc
+					{
+						l[1] = (d4 - d3) / ((d4 - d3) + (d5 - d6)); l[0] = 1.0f - l[1];
+						s[0] = s[1]; s[1] = s[2]; n = 2;
+						return true;
+					}
+
+					float denom = 1.0f / (va + vb + vc);	// Face
+					l[1] = vb * denom; l[2] = vc * denom; l[0] = 1.0f - l[1] - l[2];
+					return true;
+				}
+
+				// Tetrahedron, test the origin against each face that it could be in front of
+				if (glm::abs(glm::dot(glm::cross(s[1].w - s[0].w, s[2].w - s[0].w), s[3].w - s[0].w)) <= FLT_EPSILON)	// If the tetrahedron is flat
+				{
+					n = 3;	// Drop the last point
+					return ReduceSimplex(s, n, l);	// Reduce as a triangle
+				}
+
+				static const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };	// Face corners, then the opposite corner
+				SupportPoint best_s[3];		// Closest sub simplex
+				unsigned int best_n = 0;
+				float best_l[3] = { 0.0f, 0.0f, 0.0f };
+				float best_d = FLT_MAX;		// Closest squared distance
+				bool inside = true;		// Is the origin behind every face?
+
+				for (int f = 0; f < 4; f++)		// Iterate through each face
+				{
+					glm::vec3 a = s[faces[f][0]].w, b = s[faces[f][1]].w, c = s[faces[f][2]].w, o = s[faces[f][3]].w;
+					glm::vec3 nn = glm::cross(b - a, c - a);	// Face normal
+					float side_o = glm::dot(-a, nn), side_p = glm::dot(o - a, nn);	// Origin and opposite corner against the face
+
+					if (side_o * side_p >= 0.0f)	// If the origin is on the inner side
+						continue;	// Skip face
+
+					inside = false;		// The origin is outside the tetrahedron
+
+					SupportPoint t[3] = { s[faces[f][0]], s[faces[f][1]], s[faces[f][2]] };		// Face simplex
+					unsigned int tn = 3;
+					float tl[3];
+					ReduceSimplex(t, tn, tl);	// Closest point on the face
+
+					glm::vec3 v(0.0f);
+					for (unsigned int i = 0; i < tn; i++) v += t[i].w * tl[i];
+					float dd = glm::dot(v, v);
+
+					if (dd < best_d)	// If this face is closer
+					{
+						best_d = dd;
+						best_n = tn;
+						for (unsigned int i = 0; i < tn; i++) { best_s[i] = t[i]; best_l[i] = tl[i]; }
+					}
+				}
+
+				if (inside)		// If the origin is inside
+					return false;	// Return false
+
+				n = best_n;
+				for (unsigned int i = 0; i < n; i++) { s[i] = best_s[i]; l[i] = best_l[i]; }
+				return true;
+			}
+
+			// Find the distance between two convex shapes, or that they overlap, with GJK
+			inline static bool Gjk(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, GjkResult &out)
+			{
+				glm::vec3 d = glm::vec3(ma[3]) - glm::vec3(mb[3]);	// Start along the centre difference
+				if (glm::dot(d, d) < FLT_MIN) d = glm::vec3(1.0f, 0.0f, 0.0f);
+
+				out.s[0] = Support(a, ma, b, mb, d);	// First point
+				out.n = 1;
+				float l[4] = { 1.0f, 0.0f, 0.0f, 0.0f };	// Barycentric weights
+				glm::vec3 v = out.s[0].w;	// Closest point to the origin so far
+
+				out.hit = false;
+
+				for (int it = 0; it < GJK_MAX_ITERATIONS; it++)		// Iterate until converged
+				{
+					float vv = glm::dot(v, v);
+					if (vv <= GJK_TOLERANCE * GJK_TOLERANCE)	// If the origin is on the simplex
+					{
+						out.hit = true;
+						break;
+					}
+
+					SupportPoint w = Support(a, ma, b, mb, -v);		// Furthest point towards the origin
+
+					if (vv - glm::dot(v, w.w) <= GJK_TOLERANCE * vv)	// If the new point gets no closer
+						break;	// Distance has converged
+
+					bool repeat = false;	// Has the point been seen already?
+					for (unsigned int i = 0; i < out.n; i++)
+						repeat |= (out.s[i].w == w.w);
+					if (repeat) break;
+
+					out.s[out.n++] = w;		// Add point
+
+					if (!ReduceSimplex(out.s, out.n, l))	// If the simplex holds the origin
+					{
+						out.hit = true;
+						break;
+					}
+
+					v = glm::vec3(0.0f);
+					for (unsigned int i = 0; i < out.n; i++) v += out.s[i].w * l[i];	// New closest point
+				}
+
+				out.point_a = glm::vec3(0.0f);
+				out.point_b = glm::vec3(0.0f);
+				if (out.n < 4)	// If the weights are valid
+				{
+					for (unsigned int i = 0; i < out.n; i++)
+					{
+						out.point_a += out.s[i].a * l[i];	// Closest point on A
+						out.point_b += out.s[i].b * l[i];	// Closest point on B
+					}
+				}
+
+				out.distance = out.hit ? 0.0f : glm::length(v);		// Assign distance
+				return out.hit;		// Return result
+			}
+
+			// Find the penetration normal and depth of two overlapping shapes with EPA, starting from a GJK simplex that holds the origin
+			inline static void Epa(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, const GjkResult &gjk, Contact &out)
+			{
+				std::vector<SupportPoint> s(gjk.s, gjk.s + gjk.n);	// Polytope points
+
+				// ------------------------- BLOW UP TO A TETRAHEDRON -------------------------
+				static const glm::vec3 axes[6] = { glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1) };
+
+				if (s.size() == 1)	// If the simplex is a point
+				{
+					for (int i = 0; i < 6 && s.size() == 1; i++)	// Search each axis for a second point
+					{
+						SupportPoint p = Support(a, ma, b, mb, axes[i]);
+						if (glm::dot(p.w - s[0].w, p.w - s[0].w) > EPA_TOLERANCE * EPA_TOLERANCE)
+							s.push_back(p);
+					}
+				}
+
+				if (s.size() == 2)	// If the simplex is a segment
+				{
+					glm::vec3 ab = s[1].w - s[0].w;		// Segment vector
+					glm::vec3 u = glm::abs(ab.x) < glm::abs(ab.y) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);	// Least aligned axis
+					u = glm::normalize(glm::cross(ab, u));	// Perpendicular
+					glm::vec3 w = glm::normalize(glm::cross(ab, u));	// Second perpendicular
+
+					for (int i = 0; i < 6 && s.size() == 2; i++)	// Search around the segment for a third point
+					{
+						float ang = (float)i * 1.04719755f;		// 60 degree steps
+						SupportPoint p = Support(a, ma, b, mb, u * glm::cos(ang) + w * glm::sin(ang));
+						if (glm::length(glm::cross(p.w - s[0].w, ab)) > EPA_TOLERANCE)
+							s.push_back(p);
+					}
+				}
+
+				if (s.size() == 3)	// If the simplex is a triangle
+				{
+					glm::vec3 n = glm::cross(s[1].w - s[0].w, s[2].w - s[0].w);		// Triangle normal
+					SupportPoint p = Support(a, ma, b, mb, n), q = Support(a, ma, b, mb, -n);	// Support on either side
+					s.push_back(glm::abs(glm::dot(p.w - s[0].w, n)) >= glm::abs(glm::dot(q.w - s[0].w, n)) ? p : q);	// Keep the one furthest from the plane
+				}
+
+				out.normal = glm::vec3(0.0f, 1.0f, 0.0f);	// Fallback contact
+				out.depth = 0.0f;
+				out.point_a = gjk.point_a;
+				out.point_b = gjk.point_b;
+
+				if (s.size() < 4)	// If the difference has no volume
+					return;		// Touching contact
+
+				// ------------------------- INITIAL POLYTOPE -------------------------
+				std::vector<glm::vec3> p(s.size());		// Polytope positions
+				for (unsigned int i = 0; i < s.size(); i++) p[i] = s[i].w;
+
+				if (glm::dot(glm::cross(p[1] - p[0], p[2] - p[0]), p[3] - p[0]) > 0.0f)	// If the base faces the apex
+				{
+					std::swap(p[1], p[2]);	// Flip the base
+					std::swap(s[1], s[2]);
+				}
+
+				std::vector<Data::HullFace> faces;	// Polytope faces
+				faces.push_back(Data::MakeFace(p, 0, 1, 2));
+				faces.push_back(Data::MakeFace(p, 0, 3, 1));
+				faces.push_back(Data::MakeFace(p, 1, 3, 2));
+				faces.push_back(Data::MakeFace(p, 2, 3, 0));
+
+				// ------------------------- EXPAND -------------------------
+				int closest = 0;	// Face closest to the origin
+				for (int it = 0; it < EPA_MAX_ITERATIONS; it++)
+				{
+					closest = 0;
+					for (unsigned int f = 1; f < faces.size(); f++)
+						if (faces[f].d < faces[closest].d)
+							closest = (int)f;
+
+					SupportPoint w = Support(a, ma, b, mb, faces[closest].n);	// Furthest point along the face normal
+
+					if (glm::dot(faces[closest].n, w.w) - faces[closest].d <= EPA_TOLERANCE)	// If the face is on the boundary
+						break;	// Depth has converged
+
+					s.push_back(w);		// Add point
+					p.push_back(w.w);
+					Data::ExpandHull(p, faces, (unsigned int)p.size() - 1, 0.0f, NULL);	// Replace every face the point can see
+
+					if (faces.empty())	// If the polytope broke down
+						return;		// Keep the fallback contact
+				}
+
+				closest = 0;
+				for (unsigned int f = 1; f < faces.size(); f++)
+					if (faces[f].d < faces[closest].d)
+						closest = (int)f;
+
+				// ------------------------- CONTACT -------------------------
+				const Data::HullFace &f = faces[closest];	// Closest face
+				glm::vec3 o = f.n * f.d;	// Origin projected onto the face
+
+				glm::vec3 v0 = p[f.v[1]] - p[f.v[0]], v1 = p[f.v[2]] - p[f.v[0]], v2 = o - p[f.v[0]];	// Barycentric of the projection
+				float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1), d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+				float denom = d00 * d11 - d01 * d01;
+				float l1 = (denom > FLT_MIN) ? (d11 * d20 - d01 * d21) / denom : 0.0f;
+				float l2 = (denom > FLT_MIN) ? (d00 * d21 - d01 * d20) / denom : 0.0f;
+				float l0 = 1.0f - l1 - l2;
+
+				out.normal = f.n;	// Assign normal
+				out.depth = f.d;	// Assign depth
+				out.point_a = s[f.v[0]].a * l0 + s[f.v[1]].a * l1 + s[f.v[2]].a * l2;	// Assign point on A
+				out.point_b = s[f.v[0]].b * l0 + s[f.v[1]].b * l1 + s[f.v[2]].b * l2;	// Assign point on B
+			}
+
+			// Return the world space radius of a rounded shape, or 0 if it has none or is scaled unevenly
+			inline static float Margin(const Data::ConvexShape &s, const glm::mat4 &m)
+			{
+				if (s.type != CONVEX_SPHERE && s.type != CONVEX_CAPSULE)	// If the shape isn't rounded
+					return 0.0f;	// Return no margin
+
+				float sx = glm::length(glm::vec3(m[0])), sy = glm::length(glm::vec3(m[1])), sz = glm::length(glm::vec3(m[2]));	// Scale per axis
+				if (glm::abs(sx - sy) > 0.0001f * sx || glm::abs(sx - sz) > 0.0001f * sx)	// If a sphere would become an ellipsoid
+					return 0.0f;	// Return no margin
+
+				return s.r * sx;	// Return scaled radius
+			}
+
+			// Return true if two convex shapes overlap, and output the contact
+			// Spheres and capsules are tested as their core point or segment first, so shallow contacts are exact and skip EPA
+			inline static bool Collide(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, Contact &out)
+			{
+				GjkResult g;	// GJK result
+				float ra = Margin(a, ma), rb = Margin(b, mb);	// Radius of each shape
+
+				if (ra + rb > 0.0f)		// If either shape is rounded
+				{
+					Data::ConvexShape ca, cb;	// Core shapes
+					if (ra > 0.0f) { ca = a; ca.r = 0.0f; }
+					if (rb > 0.0f) { cb = b; cb.r = 0.0f; }
+
+					if (!Gjk(ra > 0.0f ? ca : a, ma, rb > 0.0f ? cb : b, mb, g))	// If the cores are apart
+					{
+						if (g.distance >= ra + rb)	// If the rounded shapes are apart too
+							return false;	// Return false
+
+						out.normal = (g.point_b - g.point_a) / g.distance;	// Assign normal
+						out.depth = ra + rb - g.distance;	// Assign depth
+						out.point_a = g.point_a + out.normal * ra;	// Assign point on A
+						out.point_b = g.point_b - out.normal * rb;	// Assign point on B
+						return true;	// Return true
+					}
+				}
+
+				if (!Gjk(a, ma, b, mb, g))	// If the shapes are apart
+					return false;	// Return false
+
+				Epa(a, ma, b, mb, g, out);	// Find penetration
+				return true;	// Return true
+			}
+		}
+	}
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 
 #define RT_SPEED				0x0001	// The default real-time speed (1) is multiplied by delta
+#define SIM_TICK_RATE			120.0	// Define the default fixed simulation rate in ticks per second
+#define SIM_MAX_SUBSTEPS		8		// Define the most simulation ticks run in one frame (slower time is dropped)
 
 #define	CAMERA_NEAR				0.1f	// Define the default camera near plane
 #define	CAMERA_FAR				2000.0f	// Define the default camera far plane
@@ -0,0 +1,374 @@
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#define JOB_MAX_THREADS		64		// Most threads the system will run (including the main thread)
+#define JOB_SPIN_COUNT		256		// Failed steal rounds before an idle worker sleeps
+
+#include <vector>	// Get dynamic arrays
+#include <deque>	// Get double ended queues
+#include <functional>	// Get function wrappers
+#include <atomic>	// Get atomics
+#include <mutex>	// Get locks
+#include <condition_variable>	// Get sleeping
+#include <thread>	// Get threads
+#include <chrono>	// Get sleep timeouts
+#include <iostream>		// Get error output
+
+// A counter of unfinished jobs, used to wait for a group of jobs or to make a job wait on one
+// The counter must outlive every job that signals it or waits on it
+struct JobCounter
+{
+	std::atomic<int>	count;	// Number of unfinished jobs
+
+	inline JobCounter() : count(0) {}
+	inline bool IsDone() const { return count.load(std::memory_order_acquire) == 0; }	// Return true if every job has finished
+};
+
+// A unit of work
+struct Job
+{
+	std::function<void()>	fn;		// Work to run
+	JobCounter*				signal;		// Counter to decrement when done (NULL for none)
+	JobCounter*				after;		// Counter that must reach zero before the job may start (NULL for none)
+};
+
+// A work stealing job system
+// Each thread owns a queue: it pushes and pops its newest jobs at the back, and idle threads steal the oldest from the front of others
+// The main thread is thread 0 and helps while it waits; jobs that must touch OpenGL go through the main thread queue instead
+// A job whose dependency hasn't finished is parked off the queues, and the job that brings the dependency to zero queues it again
+class JobSystem
+{
+private:
+	// A thread's job queue
+	struct WorkerQueue
+	{
+		std::mutex			lock;	// Queue lock (only contended while stealing)
+		std::deque<Job>		jobs;	// Queued jobs
+	};
+
+	static std::vector<WorkerQueue*>	_queues;	// One queue per thread (0 is the main thread)
+	static std::vector<std::thread>		_threads;	// Worker threads
+	static std::atomic<bool>			_running;	// Are the workers running?
+	static std::atomic<int>				_queued;	// Number of queued jobs, for waking workers
+	static std::mutex					_sleep_lock;	// Lock for sleeping workers
+	static std::condition_variable		_wake;	// Wakes sleeping workers
+
+	static std::mutex					_main_lock;		// Main thread queue lock
+	static std::deque<Job>				_main_jobs;		// Jobs that must run on the main thread
+
+	static std::mutex					_park_lock;		// Parked job lock
+	static std::vector<Job>				_parked;	// Jobs waiting on an unfinished dependency
+	static std::atomic<int>				_parked_count;	// Number of parked jobs, so signals can skip the lock
+
+	static thread_local int				_index;		// Queue index of the calling thread
+
+public:
+	// Start the worker threads (0 picks one per hardware thread, minus the main thread)
+	static inline void Initialise(unsigned int workers = 0)
+	{
+		if (!_queues.empty())	// If already running
+			return;		// Return from function
+
+		if (workers == 0)	// If no count was given
+			workers = (std::thread::hardware_concurrency() > 1) ? std::thread::hardware_concurrency() - 1 : 1;	// Leave the main thread its core
+
+		if (workers > JOB_MAX_THREADS - 1)	// If there are too many workers
+			workers = JOB_MAX_THREADS - 1;	// Clamp
+
+		_index = 0;		// The caller is the main thread
+		_running = true;	// Allow workers to run
+
+		for (unsigned int i = 0; i <= workers; i++)		// One queue per thread
+			_queues.push_back(new WorkerQueue());
+
+		for (unsigned int i = 1; i <= workers; i++)		// Start each worker
+			_threads.push_back(std::thread(WorkerLoop, (int)i));
+	}
+
+	// Finish queued work and stop the worker threads
+	static inline void Destroy()
+	{
+		if (_queues.empty())	// If not running
+			return;		// Return from function
+
+		_running = false;	// Ask workers to stop
+		_wake.notify_all();		// Wake sleeping workers
+
+		for (std::thread &t : _threads)		// Iterate through each worker
+			t.join();	// Wait for it
+
+		while (RunOne()) {}		// Run anything released after the workers stopped
+
+		if (!_parked.empty())	// If jobs are still waiting on dependencies that never finished
+		{
+			std::cerr << "Job Error: " << _parked.size() << " jobs were still waiting on a dependency!\n";	// Print out error message
+			_parked.clear();	// Drop them
+			_parked_count = 0;
+		}
+
+		for (WorkerQueue* q : _queues)	// Iterate through each queue
+			delete q;	// Free queue
+
+		_threads.clear();	// Reset threads
+		_queues.clear();	// Reset queues
+	}
+
+	static inline unsigned int GetThreadCount() { return _queues.empty() ? 1 : (unsigned int)_queues.size(); }	// Return the number of threads running jobs (including the main thread)
+	static inline int GetThreadIndex() { return _index; }	// Return the calling thread's index (0 is the main thread)
+	static inline bool IsMainThread() { return _index == 0; }	// Return true if called from the main thread
+
+	// Queue a job on the calling thread, signalling a counter when done and optionally waiting for another first
+	// Runs the job immediately when the system hasn't been initialised
+	static inline void Run(std::function<void()> fn, JobCounter* signal = NULL, JobCounter* after = NULL)
+	{
+		if (_queues.empty())	// If there are no workers
+		{
+			while (after && !after->IsDone()) PumpMain();	// Wait for the dependency (can only be main thread work)
+			fn();	// Run now
+			return;		// Return from function
+		}
+
+		if (signal)		// If the job is counted
+			signal->count.fetch_add(1, std::memory_order_relaxed);	// Count job
+
+		Job job = { std::move(fn), signal, after };		// Build job
+		WorkerQueue* q = _queues[_index];	// Calling thread's queue
+		{
+			std::lock_guard<std::mutex> guard(q->lock);		// Lock queue
+			q->jobs.push_back(std::move(job));	// Add job
+		}
+
+		_queued.fetch_add(1, std::memory_order_release);	// Count queued job
+		_wake.notify_one();		// Wake a worker
+	}
+
+	// Queue a job for the main thread, which runs it from PumpMain or while it waits
+	static inline void RunOnMain(std::function<void()> fn, JobCounter* signal = NULL)
+	{
+		if (signal)		// If the job is counted
+			signal->count.fetch_add(1, std::memory_order_relaxed);	// Count job
+
+		std::lock_guard<std::mutex> guard(_main_lock);	// Lock main queue
+		_main_jobs.push_back({ std::move(fn), signal, NULL });	// Add job
+	}
+
+	// Run every job queued for the main thread (call once per frame from the main loop)
+	static inline void PumpMain()
+	{
+		if (!IsMainThread())	// If called from a worker
+			return;		// Return from function
+
+		for (;;)	// Iterate until the main queue is empty
+		{
+			Job job;	// Temp job
+			{
+				std::lock_guard<std::mutex> guard(_main_lock);	// Lock main queue
+				if (_main_jobs.empty())		// If there is nothing left
+					return;		// Return from function
+
+				job = std::move(_main_jobs.front());	// Take oldest job
+				_main_jobs.pop_front();
+			}
+
+			Execute(job);	// Run job
+		}
+	}
+
+	// Run other jobs until a counter reaches zero
+	static inline void Wait(JobCounter &counter)
+	{
+		while (!counter.IsDone())	// Iterate until every counted job has finished
+		{
+			if (IsMainThread())		// If this is the main thread
+				PumpMain();		// Run main thread jobs first, a worker may be waiting on one
+
+			if (!RunOne())	// If there was nothing to help with
+				std::this_thread::yield();	// Let the running jobs finish
+		}
+	}
+
+	// Split [begin, end) into ranges of at most grain items and call fn(first, last) for each on any thread, then wait for them all
+	// A grain of 0 picks about four ranges per thread
+	template <typename F>
+	static inline void ParallelFor(size_t begin, size_t end, size_t grain, F fn)
+	{
+		if (end <= begin)	// If there is nothing to do
+			return;		// Return from function
+
+		size_t n = end - begin;		// Number of items
+		if (grain == 0)		// If no grain was given
+			grain = (n + GetThreadCount() * 4 - 1) / (GetThreadCount() * 4);	// About four ranges per thread
+
+		if (_queues.empty() || n <= grain)	// If there is one range or no workers
+		{
+			fn(begin, end);		// Run inline
+			return;		// Return from function
+		}
+
+		JobCounter counter;		// Counter for every range
+		for (size_t first = begin + grain; first < end; first += grain)		// Queue every range but the first
+		{
+			size_t last = (first + grain < end) ? first + grain : end;	// Range end
+			Run([=, &fn]() { fn(first, last); }, &counter);		// Queue range
+		}
+
+		fn(begin, begin + grain);	// Run the first range here
+		Wait(counter);	// Help with the rest
+	}
+
+private:
+	// Run a job, or park it if its dependency hasn't finished
+	static inline void Execute(Job &job)
+	{
+		if (job.after && !job.after->IsDone() && Park(job))		// If the job must wait
+			return;		// Return from function, the dependency's last job queues it again
+
+		job.fn();	// Run job
+
+		if (job.signal && job.signal->count.fetch_sub(1, std::memory_order_seq_cst) == 1)	// If this was the counter's last job (the last access to the counter)
+			Release(job.signal);	// Queue the jobs waiting on it
+	}
+
+	// Park a job until its dependency finishes, and return false if it finished meanwhile
+	static inline bool Park(Job &job)
+	{
+		std::lock_guard<std::mutex> guard(_park_lock);	// Lock parked jobs
+		_parked_count.fetch_add(1, std::memory_order_seq_cst);	// Count first, so a signal either sees the count or this sees the signal
+
+		if (job.after->count.load(std::memory_order_seq_cst) == 0)	// If the dependency finished meanwhile
+		{
+			_parked_count.fetch_sub(1, std::memory_order_relaxed);	// Uncount job
+			return false;	// Return false, run it now
+		}
+
+		_parked.push_back(std::move(job));	// Park job
+		return true;	// Return true
+	}
+
+	// Queue every job parked on a counter that just reached zero
+	// The counter may already be destroyed by a waiter, so it is only compared, never read
+	static inline void Release(const JobCounter* counter)
+	{
+		if (_parked_count.load(std::memory_order_seq_cst) == 0)		// If nothing is parked
+			return;		// Return from function
+
+		std::vector<Job> ready;		// Jobs to queue
+		{
+			std::lock_guard<std::mutex> guard(_park_lock);	// Lock parked jobs
+			for (size_t i = 0; i < _parked.size();)	// Iterate through each parked job
+			{
+				if (_parked[i].after == counter)	// If it waits on this counter
+				{
+					ready.push_back(std::move(_parked[i]));		// Take job
+					_parked[i] = std::move(_parked.back());		// Fill the gap
+					_parked.pop_back();
+				}
+				else
+					i++;
+			}
+			_parked_count.fetch_sub((int)ready.size(), std::memory_order_relaxed);	// Uncount jobs
+		}
+
+		if (ready.empty())	// If none were waiting on it
+			return;		// Return from function
+
+		WorkerQueue* q = _queues[_index];	// Calling thread's queue
+		{
+			std::lock_guard<std::mutex> guard(q->lock);		// Lock queue
+			for (Job &j : ready)
+				q->jobs.push_back(std::move(j));	// Add job
+		}
+
+		_queued.fetch_add((int)ready.size(), std::memory_order_release);	// Count queued jobs
+		_wake.notify_all();		// Wake workers
+	}
+
+	// Run one job from the calling thread's queue, or steal one, and return false if none was found
+	static inline bool RunOne()
+	{
+		if (_queues.empty())	// If there are no queues
+			return false;	// Return false
+
+		Job job;	// Temp job
+		bool found = false;		// Was a job found?
+
+		WorkerQueue* own = _queues[_index];		// Calling thread's queue
+		{
+			std::lock_guard<std::mutex> guard(own->lock);	// Lock queue
+			if (!own->jobs.empty())		// If there is local work
+			{
+				job = std::move(own->jobs.back());	// Take newest job
+				own->jobs.pop_back();
+				found = true;
+			}
+		}
+
+		unsigned int count = (unsigned int)_queues.size();	// Number of queues
+		unsigned int start = (unsigned int)_index * 7 + 1;	// Victim order differs per thread
+		for (unsigned int k = 0; !found && k < count; k++)	// Try every other queue
+		{
+			WorkerQueue* victim = _queues[(start + k) % count];		// Get victim
+			if (victim == own)	// If this is our own queue
+				continue;	// Skip queue
+
+			std::unique_lock<std::mutex> guard(victim->lock, std::try_to_lock);		// Don't wait on a busy queue
+			if (guard.owns_lock() && !victim->jobs.empty())		// If there is work to steal
+			{
+				job = std::move(victim->jobs.front());	// Take oldest job
+				victim->jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found)		// If there was no work
+			return false;	// Return false
+
+		_queued.fetch_sub(1, std::memory_order_relaxed);	// Uncount queued job
+		Execute(job);	// Run job
+		return true;	// Return true
+	}
+
+	// The body of each worker thread
+	static inline void WorkerLoop(int index)
+	{
+		_index = index;		// Assign queue
+		int idle = 0;	// Failed rounds in a row
+
+		while (_running)	// Iterate until asked to stop
+		{
+			if (RunOne())	// If a job was run
+			{
+				idle = 0;	// Reset idle rounds
+				continue;	// Look for more
+			}
+
+			if (++idle < JOB_SPIN_COUNT)	// If it's too early to sleep
+			{
+				std::this_thread::yield();	// Give up the time slice
+				continue;	// Try again
+			}
+
+			std::unique_lock<std::mutex> guard(_sleep_lock);	// Lock for sleeping
+			_wake.wait_for(guard, std::chrono::milliseconds(1), [] { return _queued.load(std::memory_order_acquire) > 0 || !_running; });	// Sleep until work arrives (the timeout covers a missed wake)
+			idle = 0;	// Reset idle rounds
+		}
+
+		while (RunOne()) {}		// Drain remaining work before stopping
+	}
+};
+
+// Static definitions
+std::vector<JobSystem::WorkerQueue*>	JobSystem::_queues;
+std::vector<std::thread>				JobSystem::_threads;
+std::atomic<bool>						JobSystem::_running(false);
+std::atomic<int>						JobSystem::_queued(0);
+std::mutex								JobSystem::_sleep_lock;
+std::condition_variable					JobSystem::_wake;
+std::mutex								JobSystem::_main_lock;
+std::deque<Job>							JobSystem::_main_jobs;
+std::mutex								JobSystem::_park_lock;
+std::vector<Job>						JobSystem::_parked;
+std::atomic<int>						JobSystem::_parked_count(0);
+thread_local int						JobSystem::_index = 0;
+
+#endif
@@ -2,7 +2,7 @@
 #define __JOINT_H__
 
 #include <vector>	// Get dynamic array
-#include <glm\glm.hpp>	// Get glm variables
+#include <glm/glm.hpp>	// Get glm variables
 
 struct Joint
 {
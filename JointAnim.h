@@ -3,7 +3,7 @@
 
 #include <string>	// Include string variable	
 #include <vector>	// Include dynamic arrays
-#include <glm\glm.hpp>	// Include 3d math variables
+#include <glm/glm.hpp>	// Include 3d math variables
 
 // A struct for containing the animation data
 struct JointAnim
@@ -22,80 +22,74 @@ public:
 	inline LightMaster() = default;
 	inline ~LightMaster() {}
 
-	static void getUniforms(int shader_program, std::vector<Actor*> _actors)
+	static void getUniforms(int shader_program, ComponentArray<Light*> &lights)
 	{
-		for (unsigned int i = 0; i < _actors.size(); i++)
+		if (lights.IsEmpty())
+			std::cerr << "Not enough lights in scene" << std::endl;
+
+		for (unsigned int i = 0; i < lights.Size(); i++)
 		{
-			if (_actors.size() > 0)
+			Light* l = lights[i];
+
+			switch (l->GetLightType())
+			{
+			case POINT_LIGHT: // POINT
 			{
-				if (_actors[i]->GetObjectType() == LIGHT)
-				{
-					switch (((Light*)_actors[i])->GetLightType())
-					{
-					case POINT_LIGHT: // POINT
-					{
-						((Light*)_actors[i])->_u_point_positions[i] = glGetUniformLocation(shader_program, ("pointLights[" + std::to_string(i) + "].position").c_str());
-						((Light*)_actors[i])->_u_point_colours[i] = glGetUniformLocation(shader_program, ("pointLights[" + std::to_string(i) + "].colour").c_str());
-
-						break;
-					}
-					case SPOT_LIGHT: // SPOT
-					{
-						((Light*)_actors[i])->_u_spot_positions[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].position").c_str());
-						((Light*)_actors[i])->_u_spot_directions[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].direction").c_str());
-						((Light*)_actors[i])->_u_spot_colours[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].colour").c_str());
-						((Light*)_actors[i])->_u_spot_cutoff[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].cutoff").c_str());
-						((Light*)_actors[i])->_u_spot_outercutoff[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].outerCutoff").c_str());
-
-						break;
-					}
-					default:
-						break;
-					}
-				}			
+				l->_u_point_positions[i] = glGetUniformLocation(shader_program, ("pointLights[" + std::to_string(i) + "].position").c_str());
+				l->_u_point_colours[i] = glGetUniformLocation(shader_program, ("pointLights[" + std::to_string(i) + "].colour").c_str());
+
+				break;
+			}
+			case SPOT_LIGHT: // SPOT
+			{
+				l->_u_spot_positions[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].position").c_str());
+				l->_u_spot_directions[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].direction").c_str());
+				l->_u_spot_colours[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].colour").c_str());
+				l->_u_spot_cutoff[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].cutoff").c_str());
+				l->_u_spot_outercutoff[i] = glGetUniformLocation(shader_program, ("spotLights[" + std::to_string(i) + "].outerCutoff").c_str());
+
+				break;
+			}
+			default:
+				break;
 			}
-			else
-				std::cerr << "Not enough lights in scene" << std::endl ;
 		}
 	}
 
-	static void setUniforms(std::vector<Actor*> _actors)
+	// set the uniforms of every published light, view is the published camera view
+	static void setUniforms(std::vector<RenderLight> &lights, const glm::mat4 &view)
 	{
-		if (_actors.size() > 0)
+		for (RenderLight &rl : lights)
 		{
-			for (unsigned int i = 0; i < _actors.size(); i++)
+			Light* l = rl.light;
+			unsigned int i = rl.index;
+
+			switch (rl.type)
 			{
-				if (_actors[i]->GetObjectType() == LIGHT)
-				{
-					switch (((Light*)_actors[i])->GetLightType())
-					{
-					case POINT_LIGHT: // POINT
-					{
-						glm::vec3 light_pos_view = glm::vec3(Content::_map->GetPlayerController()->GetViewMatrix() * glm::vec4(((Light*)_actors[i])->GetLightPosition().x, ((Light*)_actors[i])->GetLightPosition().y, ((Light*)_actors[i])->GetLightPosition().z, 1.0f));
-
-						glUniform3f(((Light*)_actors[i])->_u_point_positions[i], light_pos_view.x, light_pos_view.y, light_pos_view.z);
-						glUniform3f(((Light*)_actors[i])->_u_point_colours[i], ((Light*)_actors[i])->GetLightColour().x, ((Light*)_actors[i])->GetLightColour().y, ((Light*)_actors[i])->GetLightColour().z);
-
-						break;
-					}
-					case SPOT_LIGHT: // SPOT
-					{
-						glm::vec3 spot_light_pos_view = glm::vec3(Content::_map->GetPlayerController()->GetViewMatrix() *
-							glm::vec4(((Light*)_actors[i])->GetLightPosition().x, ((Light*)_actors[i])->GetLightPosition().y, ((Light*)_actors[i])->GetLightPosition().z, 1.0f));
-						glm::vec3 spot_light_dir_view = glm::vec3(Content::_map->GetPlayerController()->GetViewMatrix() * glm::vec4(0.0f, -1.0f, 0.0f, 0.0f));
-
-						glUniform3f(((Light*)_actors[i])->_u_spot_positions[i], spot_light_pos_view.x, spot_light_pos_view.y, spot_light_pos_view.z);
-						glUniform3f(((Light*)_actors[i])->_u_spot_directions[i], spot_light_dir_view.x, spot_light_dir_view.y, spot_light_dir_view.z);
-						glUniform3f(((Light*)_actors[i])->_u_spot_colours[i], ((Light*)_actors[i])->GetLightColour().x, ((Light*)_actors[i])->GetLightColour().y, ((Light*)_actors[i])->GetLightColour().z);
-						glUniform1f(((Light*)_actors[i])->_u_spot_cutoff[i], glm::cos(glm::radians(12.5f)));
-						glUniform1f(((Light*)_actors[i])->_u_spot_outercutoff[i], glm::cos(glm::radians(17.5f)));
-
-						break;
-					}
-					default:
-						break;
-					}
-				}
+			case POINT_LIGHT: // POINT
+			{
+				glm::vec3 light_pos_view = glm::vec3(view * glm::vec4(rl.position, 1.0f));
+
+				glUniform3f(l->_u_point_positions[i], light_pos_view.x, light_pos_view.y, light_pos_view.z);
+				glUniform3f(l->_u_point_colours[i], rl.colour.x, rl.colour.y, rl.colour.z);
+
+				break;
+			}
+			case SPOT_LIGHT: // SPOT
+			{
+				glm::vec3 spot_light_pos_view = glm::vec3(view * glm::vec4(rl.position, 1.0f));
+				glm::vec3 spot_light_dir_view = glm::vec3(view * glm::vec4(0.0f, -1.0f, 0.0f, 0.0f));
+
+				glUniform3f(l->_u_spot_positions[i], spot_light_pos_view.x, spot_light_pos_view.y, spot_light_pos_view.z);
+				glUniform3f(l->_u_spot_directions[i], spot_light_dir_view.x, spot_light_dir_view.y, spot_light_dir_view.z);
+				glUniform3f(l->_u_spot_colours[i], rl.colour.x, rl.colour.y, rl.colour.z);
+				glUniform1f(l->_u_spot_cutoff[i], glm::cos(glm::radians(12.5f)));
+				glUniform1f(l->_u_spot_outercutoff[i], glm::cos(glm::radians(17.5f)));
+
+				break;
+			}
+			default:
+				break;
 			}
 		}
 	}
@@ -3,8 +3,8 @@
 
 #include "LightMaster.h"
 #include <glew.h>	// Get opengl variables
-#include <glm\glm.hpp>	// glm variables
-#include <glm\gtc/type_ptr.hpp>		// Conversion type
+#include <glm/glm.hpp>	// glm variables
+#include <glm/gtc/type_ptr.hpp>		// Conversion type
 
 // This class will store the light pass data
 class LightPass : public Pass
@@ -49,7 +49,7 @@ public:
 		Content::_map->AddActor(new PointLight(glm::vec3(0.0f, 4.0f, 0.3f), glm::vec3(1.0f, 0.0f, 0.0f)), LIGHT);
 		//Content::_map->AddActor(new SpotLight(glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f)), LIGHT);
 
-		LightMaster::getUniforms(shader_program, Content::_map->GetActors());
+		LightMaster::getUniforms(shader_program, Content::_map->GetLights());
 
 		_u_camera_pos = glGetUniformLocation(shader_program, "camera_pos");		// Initialise camera uniform location
 		_u_lsm = glGetUniformLocation(shader_program, "lightSpaceMatrix"); // load in the light space matrix for the shadow mapping
@@ -66,17 +66,16 @@ public:
 		// Use shader program
 		glUseProgram(_shader_programs[0]);	
 
+		RenderSnapshot &snapshot = Content::_map->GetSnapshot();	// Published render state
+
 		// render the lights
-		for (Actor * l : Content::_map->GetActors())
-		{
-			if(l->GetObjectType() == LIGHT)
-				l->Render();
-		}
+		for (RenderLight &l : snapshot.lights)
+			l.light->Render();
 
-		LightMaster::setUniforms(Content::_map->GetActors());
+		LightMaster::setUniforms(snapshot.lights, snapshot.view);
 
 		// set the camera position uniform
-		glUniform3fv(_u_camera_pos, 1, glm::value_ptr(Content::_map->GetPlayerController()->GetPosition()));		// Bind the camera position uniform location
+		glUniform3fv(_u_camera_pos, 1, glm::value_ptr(snapshot.eye));		// Bind the camera position uniform location
 	}
 };
 
@@ -0,0 +1,355 @@
+#ifndef __LOOSE_OCTREE_H__
+#define __LOOSE_OCTREE_H__
+
+#define OCTREE_NULL				-1		// Null node or proxy index
+#define OCTREE_WORLD_HALF_SIZE	512.0f	// Default half size of the root cell
+#define OCTREE_MAX_DEPTH		8		// Default depth limit (cells at this depth are half size / 2^depth)
+
+#include <utility>	// Get pairs
+#include <algorithm>	// Get sort
+#include "Bvh.h"	// Get bounding boxes
+#include "Frustum.h"	// Get view frustums
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for storing collision arbitrary data
+		namespace Data
+		{
+			// A cell in the loose octree
+			struct LooseOctreeNode
+			{
+				glm::vec3			centre;		// Cell centre
+				float				half;		// Cell half size (the loose bounds are twice this)
+				int					parent;		// Parent node (next free node while on the free list)
+				int					child[8];	// Child nodes, indexed by octant (x | y << 1 | z << 2)
+				unsigned int		count;		// Number of proxies in this sub tree
+				std::vector<int>	items;		// Proxies stored in this cell
+
+				inline Aabb Loose() const { return Aabb(centre - glm::vec3(half * 2.0f), centre + glm::vec3(half * 2.0f)); }		// Return the loose bounds
+			};
+
+			// A proxy in the loose octree
+			struct LooseOctreeProxy
+			{
+				Aabb	b;		// Bounds
+				void*	data;	// User data
+				int		node;	// Cell holding the proxy (OCTREE_NULL when outside the root, or free)
+				int		slot;	// Index within the cell's item list (next free proxy while on the free list)
+			};
+
+			// A loose octree over a fixed cube of the world
+			// Every cell's bounds are twice its size, so a proxy is stored in the one cell that holds its centre at the depth matching its size
+			// Insert, remove and move touch one path from the root, and queries skip every cell whose loose bounds or sub tree count rule it out
+			// Queries are const and keep their own stacks, so threads can query a copy (GetSnapshot) while the owner keeps editing the live tree
+			class LooseOctree
+			{
+			private:
+				std::vector<LooseOctreeNode>	_nodes;		// Node pool (node 0 is the root)
+				std::vector<LooseOctreeProxy>	_proxies;	// Proxy pool
+				std::vector<int>				_outside;	// Proxies that don't fit inside the root's loose bounds, tested by every query
+				int								_free_node;	// Head of the node free list
+				int								_free_proxy;	// Head of the proxy free list
+				int								_max_depth;	// Depth limit
+
+			public:
+				// Default constructor
+				inline LooseOctree(glm::vec3 centre = glm::vec3(0.0f), float half_size = OCTREE_WORLD_HALF_SIZE, int max_depth = OCTREE_MAX_DEPTH) : _free_node(OCTREE_NULL), _free_proxy(OCTREE_NULL), _max_depth(max_depth)
+				{
+					_nodes.push_back(LooseOctreeNode());	// Create root
+					InitNode(0, centre, half_size, OCTREE_NULL);
+				}
+
+				inline void* GetData(int proxy) const { return _proxies[proxy].data; }	// Return proxy user data
+				inline const Aabb &GetAabb(int proxy) const { return _proxies[proxy].b; }	// Return proxy bounds
+				inline unsigned int GetCount() const { return _nodes[0].count + (unsigned int)_outside.size(); }	// Return the number of proxies
+				inline LooseOctree GetSnapshot() const { return *this; }	// Return a read-only copy for other threads to query
+
+				// Insert a new proxy and return its id
+				inline int CreateProxy(const Aabb &box, void* data)
+				{
+					int proxy = _free_proxy;	// Take the head of the free list
+					if (proxy == OCTREE_NULL)	// If the pool is full
+					{
+						proxy = (int)_proxies.size();	// New proxy
+						_proxies.push_back(LooseOctreeProxy());
+					}
+					else
+						_free_proxy = _proxies[proxy].slot;		// Advance free list
+
+					_proxies[proxy].b = box;	// Assign box
+					_proxies[proxy].data = data;	// Assign user data
+					InsertProxy(proxy);		// Place in a cell
+
+					return proxy;	// Return id
+				}
+
+				// Remove a proxy
+				inline void DestroyProxy(int proxy)
+				{
+					RemoveProxy(proxy);		// Take out of its cell
+					_proxies[proxy].data = NULL;	// Reset user data
+					_proxies[proxy].slot = _free_proxy;		// Link to free list
+					_free_proxy = proxy;	// New head
+				}
+
+				// Update a proxy's box, only moving cells if it no longer belongs in its current one
+				// Returns true if the proxy changed cells
+				inline bool MoveProxy(int proxy, const Aabb &box)
+				{
+					LooseOctreeProxy &p = _proxies[proxy];	// Get reference
+					p.b = box;	// Assign box
+
+					if (p.node != OCTREE_NULL && FindCell(box, false) == p.node)	// If the proxy still belongs in its cell
+						return false;	// Return false
+
+					RemoveProxy(proxy);		// Take out of the old cell
+					InsertProxy(proxy);		// Place in the new cell
+					return true;	// Return true
+				}
+
+				// Call f(proxy) for every proxy whose box overlaps the box, until f returns false
+				template <typename F>
+				inline void Query(const Aabb &box, F f) const
+				{
+					Visit([&](const LooseOctreeNode &n) { return n.Loose().Overlaps(box); }, [&](int id) { return !_proxies[id].b.Overlaps(box) || f(id); });	// Walk cells and proxies touching the box
+				}
+
+				// Call f(proxy) for every proxy whose box overlaps the sphere, until f returns false
+				template <typename F>
+				inline void QuerySphere(const glm::vec3 &centre, float radius, F f) const
+				{
+					Visit([&](const LooseOctreeNode &n) { return BoxSphere(n.Loose(), centre, radius); }, [&](int id) { return !BoxSphere(_proxies[id].b, centre, radius) || f(id); });	// Walk cells and proxies touching the sphere
+				}
+
+				// Call f(proxy) for every proxy whose box may be inside the frustum, until f returns false
+				template <typename F>
+				inline void QueryFrustum(const Frustum &frustum, F f) const
+				{
+					Visit([&](const LooseOctreeNode &n) { Aabb b = n.Loose(); return frustum.TestAabb(b.min, b.max); }, [&](int id) { return !frustum.TestAabb(_proxies[id].b.min, _proxies[id].b.max) || f(id); });	// Walk cells and proxies inside the frustum
+				}
+
+				// Call f(proxy, t_max) for every proxy whose box is hit by the ray within t_max, nearest cell first
+				// The callback may shorten t_max (closest hit) or return true to stop (any hit)
+				template <typename F>
+				inline void Raycast(const glm::vec3 &origin, const glm::vec3 &dir, float t_max, F f) const
+				{
+					glm::vec3 inv_dir = 1.0f / dir;		// Inverse direction for slab tests
+
+					for (int id : _outside)		// Iterate through each proxy outside the root
+						if (_proxies[id].b.RayEntry(origin, inv_dir, t_max) != FLT_MAX && f(id, t_max))	// If hit, visit proxy
+							return;		// Stop if the callback asked to
+
+					float t_root = _nodes[0].Loose().RayEntry(origin, inv_dir, t_max);	// Test root
+					if (t_root == FLT_MAX || _nodes[0].count == 0)	// If the ray misses the root or the tree is empty
+						return;		// Return from function
+
+					std::vector<std::pair<int, float>> stack;	// Traversal stack of nodes and their entry distances
+					stack.push_back(std::make_pair(0, t_root));		// Push root
+
+					while (!stack.empty())	// While there are cells to visit
+					{
+						std::pair<int, float> top = stack.back();	// Get cell
+						stack.pop_back();	// Pop cell
+
+						if (top.second > t_max)		// If the cell is further than the current hit
+							continue;	// Skip cell
+
+						const LooseOctreeNode &node = _nodes[top.first];	// Get reference
+
+						for (int id : node.items)	// Iterate through each proxy in the cell
+							if (_proxies[id].b.RayEntry(origin, inv_dir, t_max) != FLT_MAX && f(id, t_max))		// If hit, visit proxy
+								return;		// Stop if the callback asked to
+
+						std::pair<int, float> hits[8];	// Children hit by the ray
+						int n = 0;
+						for (int c = 0; c < 8; c++)		// Iterate through each child
+						{
+							int child = node.child[c];	// Get child
+							if (child == OCTREE_NULL || _nodes[child].count == 0)	// If there is nothing below
+								continue;	// Skip child
+
+							float t = _nodes[child].Loose().RayEntry(origin, inv_dir, t_max);	// Entry distance
+							if (t != FLT_MAX)	// If the child is hit
+								hits[n++] = std::make_pair(child, t);	// Record child
+						}
+
+						std::sort(hits, hits + n, [](const std::pair<int, float> &a, const std::pair<int, float> &b) { return a.second > b.second; });	// Furthest first
+						stack.insert(stack.end(), hits, hits + n);	// Push so the nearest is visited next
+					}
+				}
+
+			private:
+				// Walk every cell that passes test_cell and call visit(proxy) for each of its proxies until visit returns false
+				template <typename C, typename V>
+				inline void Visit(C test_cell, V visit) const
+				{
+					for (int id : _outside)		// Iterate through each proxy outside the root
+						if (!visit(id))		// Visit proxy
+							return;		// Stop if the caller is done
+
+					std::vector<int> stack;		// Traversal stack
+					stack.push_back(0);		// Start at the root
+
+					while (!stack.empty())	// Iterate until every passing cell has been visited
+					{
+						const LooseOctreeNode &node = _nodes[stack.back()];		// Get cell
+						stack.pop_back();	// Pop cell
+
+						if (node.count == 0 || !test_cell(node))	// If the sub tree is empty or ruled out
+							continue;	// Skip cell
+
+						for (int id : node.items)	// Iterate through each proxy in the cell
+							if (!visit(id))		// Visit proxy
+								return;		// Stop if the caller is done
+
+						for (int c = 0; c < 8; c++)		// Iterate through each child
+							if (node.child[c] != OCTREE_NULL)
+								stack.push_back(node.child[c]);		// Visit child
+					}
+				}
+
+				// Return the cell a box belongs in: the one holding its centre at the deepest depth whose cells are at least as large as the box
+				// Returns OCTREE_NULL if the box doesn't fit the root, and creates missing cells on the way down when asked to
+				inline int FindCell(const Aabb &box, bool create)
+				{
+					glm::vec3 c = box.Centre();		// Box centre
+					glm::vec3 e = box.Extent() * 0.5f;	// Half extent
+					float r = glm::max(e.x, glm::max(e.y, e.z));	// Largest half extent
+
+					if (!_nodes[0].Loose().Contains(box))	// If the box doesn't fit the root
+						return OCTREE_NULL;		// Return nothing
+
+					glm::vec3 d = glm::abs(c - _nodes[0].centre);	// Centre offset from the root
+					if (glm::max(d.x, glm::max(d.y, d.z)) > _nodes[0].half)		// If the centre is outside the root cell, no child cell can hold the box
+						return 0;	// Return root
+
+					int id = 0;		// Start at the root
+					for (int depth = 0; depth < _max_depth; depth++)	// Descend until the cells become too small
+					{
+						const LooseOctreeNode &node = _nodes[id];	// Get cell
+						float child_half = node.half * 0.5f;	// Child cell half size
+						if (r > child_half)		// If the box is larger than a child cell
+							break;	// Stop here
+
+						int o = (c.x >= node.centre.x ? 1 : 0) | (c.y >= node.centre.y ? 2 : 0) | (c.z >= node.centre.z ? 4 : 0);	// Octant holding the centre
+
+						if (node.child[o] == OCTREE_NULL)	// If the child doesn't exist
+						{
+							if (!create)	// If cells can't be created
+								return OCTREE_NULL;		// Return nothing (the box belongs deeper than the current cell)
+
+							glm::vec3 offset((o & 1) ? child_half : -child_half, (o & 2) ? child_half : -child_half, (o & 4) ? child_half : -child_half);	// Child centre offset
+							int child = AllocateNode(node.centre + offset, child_half, id);		// Create child (may move the pool)
+							_nodes[id].child[o] = child;	// Link child
+						}
+
+						id = _nodes[id].child[o];	// Descend
+					}
+
+					return id;	// Return cell
+				}
+
+				// Place a proxy in the cell it belongs in
+				inline void InsertProxy(int proxy)
+				{
+					LooseOctreeProxy &p = _proxies[proxy];	// Get reference
+					int id = FindCell(p.b, true);	// Find cell
+					p.node = id;	// Assign cell
+
+					if (id == OCTREE_NULL)	// If the proxy doesn't fit the root
+					{
+						p.slot = (int)_outside.size();	// Assign slot
+						_outside.push_back(proxy);	// Add to outside list
+						return;		// Return from function
+					}
+
+					p.slot = (int)_nodes[id].items.size();	// Assign slot
+					_nodes[id].items.push_back(proxy);	// Add to cell
+
+					for (int n = id; n != OCTREE_NULL; n = _nodes[n].parent)	// Count up to the root
+						_nodes[n].count++;
+				}
+
+				// Take a proxy out of its cell, and free any cells left empty
+				inline void RemoveProxy(int proxy)
+				{
+					LooseOctreeProxy &p = _proxies[proxy];	// Get reference
+					std::vector<int> &items = (p.node == OCTREE_NULL) ? _outside : _nodes[p.node].items;	// List holding the proxy
+
+					items[p.slot] = items.back();	// Move the last proxy into the gap
+					_proxies[items[p.slot]].slot = p.slot;	// Remap its slot
+					items.pop_back();	// Shrink list
+
+					if (p.node == OCTREE_NULL)	// If the proxy was outside the root
+						return;		// Return from function
+
+					int id = p.node;	// Start at the old cell
+					for (int n = id; n != OCTREE_NULL; n = _nodes[n].parent)	// Uncount up to the root
+						_nodes[n].count--;
+
+					while (id != 0 && _nodes[id].count == 0)	// Free empty cells, keeping the root
+					{
+						int parent = _nodes[id].parent;		// Get parent
+						for (int c = 0; c < 8; c++)		// Unlink from the parent
+							if (_nodes[parent].child[c] == id)
+								_nodes[parent].child[c] = OCTREE_NULL;
+
+						FreeNode(id);	// Return cell to the pool
+						id = parent;	// Move up
+					}
+
+					p.node = OCTREE_NULL;	// Reset cell
+				}
+
+				// Reset a node
+				inline void InitNode(int id, const glm::vec3 &centre, float half, int parent)
+				{
+					LooseOctreeNode &n = _nodes[id];	// Get reference
+					n.centre = centre;	// Assign centre
+					n.half = half;	// Assign half size
+					n.parent = parent;	// Assign parent
+					n.count = 0;	// Reset count
+					n.items.clear();	// Reset items
+					for (int c = 0; c < 8; c++)
+						n.child[c] = OCTREE_NULL;	// Reset children
+				}
+
+				// Take a node from the pool
+				inline int AllocateNode(const glm::vec3 &centre, float half, int parent)
+				{
+					int id = _free_node;	// Take the head of the free list
+					if (id == OCTREE_NULL)	// If the pool is full
+					{
+						id = (int)_nodes.size();	// New node
+						_nodes.push_back(LooseOctreeNode());
+					}
+					else
+						_free_node = _nodes[id].parent;		// Advance free list
+
+					InitNode(id, centre, half, parent);		// Reset node
+					return id;	// Return node
+				}
+
+				// Return a node to the free list
+				inline void FreeNode(int id)
+				{
+					_nodes[id].parent = _free_node;		// Link to free list
+					_free_node = id;	// New head
+				}
+
+				// Return true if a box and sphere overlap
+				inline static bool BoxSphere(const Aabb &b, const glm::vec3 &centre, float radius)
+				{
+					glm::vec3 d = centre - glm::clamp(centre, b.min, b.max);	// Offset from the closest point in the box
+					return glm::dot(d, d) <= radius * radius;	// Return result
+				}
+			};
+		}
+	}
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "Context.h"	// Get our device and rendering context
 #include "TimeStep.h"	// Set up a timestep for our looping function
 #include "RendererMaster.h"	// Include our renderer 
+#include "JobSystem.h"	// Get worker threads
 
 // This is the main WinAPI entry point for creating our window application
 int WINAPI WinMain(HINSTANCE hCurrentInst, HINSTANCE hPreviousInst, LPSTR lpszCmdLine, int nCmdShow)
@@ -13,8 +14,10 @@ int WINAPI WinMain(HINSTANCE hCurrentInst, HINSTANCE hPreviousInst, LPSTR lpszCm
 	OpenConsole();	// Open the console for debugging purposes
 	CreateWnd("Capsule Engine", 1920, 1080, true);	// Create our window
 	Keyboard::Initialise();		// Initialise our keycodes
+	JobSystem::Initialise();	// Start our worker threads before any content is loaded
 	RendererMaster::Initialise();		// Initialise our OpenGL renderer
 	tsc.Initialise();	// Initialise our timestep
+	tsc.SetFixedStep(SIM_TICK_RATE, SIM_MAX_SUBSTEPS);	// Simulate at a fixed rate, rendering at whatever rate we can
 
 	while (_running)	// This is our looping function until _running == false
 	{
@@ -31,12 +34,14 @@ int WINAPI WinMain(HINSTANCE hCurrentInst, HINSTANCE hPreviousInst, LPSTR lpszCm
 		else	// If we don't have a message to process... 
 		{
 			tsc.Analyse();	// Begin analysing our timestep
-			RendererMaster::Update(tsc._delta);
-			RendererMaster::Render();		// Render our OpenGL world
+			JobSystem::PumpMain();	// Run work queued for the main thread (OpenGL calls)
+			RendererMaster::Update(tsc._delta);		// Update per frame components
+			RendererMaster::Frame(tsc.GetSteps(), tsc._tick, tsc.GetAlpha());		// Simulate the due ticks and render our OpenGL world
 			tsc.Reset();	// Reset the current delta time
 		}
 	}
 
+	JobSystem::Destroy();	// Stop our worker threads
 	DestroyWnd();	// Destroy the window
 
 	return (int)msg.wParam;		// Return the application message
@@ -8,6 +8,22 @@
 #include "StaticMesh.h"		// Get static mesh class
 #include "AnimMesh.h"	// Get anim mesh class
 #include "Light.h"
+#include "AabbTree.h"	// Get broad phase
+#include "Raycast.h"	// Get ray queries
+#include "Frustum.h"	// Get view culling
+#include "JobSystem.h"	// Get worker threads
+#include <map>	// Get ordered maps
+
+#define MAP_UPDATE_BATCH		64	// Most independent actors updated by one job
+#define MAP_PARALLEL_MIN_ACTORS	256	// Fewer actors than this update serially, the jobs would cost more than they save
+
+// A convex contact between two actors found by the narrow phase
+struct ActorContact
+{
+	Actor*							a;	// First actor
+	Actor*							b;	// Second actor
+	Collision::Ndc::Convex::Contact	c;	// Contact (normal from a towards b)
+};
 
 // The map class will be our 3D canvas
 class Map : public Object
@@ -20,13 +36,29 @@ private:
 	Light*						_light;		// The lights
 	
 	std::vector<Actor*>			_actors;	// Our actor list
+	ComponentArray<Mesh*>		_meshes;	// Every mesh actor, packed for the render passes
+	ComponentArray<Light*>		_lights;	// Every light, packed for the light passes
+
+	AabbTree							_tree;		// Broad phase of every collidable actor
+	LooseOctree							_octree;	// Spatial index of every actor, for scene queries
+	std::vector<std::pair<Actor*, Actor*>>	_pairs;		// Candidate pairs found by the last broad phase update
+	SpatialGrid							_static_grid;	// World space triangles of every static collidable mesh
+	unsigned int						_static_count;	// Number of static meshes baked into the grid
+	std::vector<ActorContact>			_contacts;	// Convex contacts found by the last narrow phase update
+	TransformStore						_transforms;	// Local and world transforms of every actor, parents first
+
+	RenderSnapshot						_snapshots[RENDER_BUFFERS];		// Published render state, the front one is drawn while the back one is written
+
+	bool								_parallel;	// Update actors across the job system?
+	std::vector<std::vector<Actor*>>	_batches;	// Actor batches for the parallel update, each runs in list order on one thread
+	std::vector<Actor*>					_serial;	// Main thread only actors, updated after the batches in list order
 
 public:
 	// Default constructor
-	inline Map() { _t = MAP; }
+	inline Map() : _static_count(0), _parallel(true) { _t = MAP; }
 
 	// Initial constructor
-	inline Map(char* name)
+	inline Map(char* name) : _static_count(0), _parallel(true)
 	{
 		_t = MAP;	// Assign our actor tpye to map
 		_name = name;	// Assign our name variable
@@ -69,12 +101,193 @@ public:
 		return _skybox;		// Return skybox
 	}
 
+	// Get the broad phase tree
+	inline AabbTree &GetTree()
+	{
+		return _tree;	// Return tree
+	}
+
+	// Get the spatial index (copy it with GetSnapshot to query from other threads)
+	inline const LooseOctree &GetOctree()
+	{
+		return _octree;		// Return octree
+	}
+
+	// Gather every actor whose bounds overlap the box
+	inline void QueryActors(const Aabb &box, std::vector<Actor*> &out_actors)
+	{
+		_octree.Query(box, [&](int proxy) { out_actors.push_back((Actor*)_octree.GetData(proxy)); return true; });	// Add each actor
+	}
+
+	// Gather every actor whose bounds overlap the sphere
+	inline void QueryActors(const glm::vec3 &centre, float radius, std::vector<Actor*> &out_actors)
+	{
+		_octree.QuerySphere(centre, radius, [&](int proxy) { out_actors.push_back((Actor*)_octree.GetData(proxy)); return true; });	// Add each actor
+	}
+
+	// Gather every actor whose bounds may be inside the frustum of a view projection matrix
+	inline void QueryActors(const glm::mat4 &view_proj, std::vector<Actor*> &out_actors)
+	{
+		Frustum frustum(view_proj);		// Extract planes once
+		_octree.QueryFrustum(frustum, [&](int proxy) { out_actors.push_back((Actor*)_octree.GetData(proxy)); return true; });	// Add each actor
+	}
+
+	// Return the actor whose bounds the ray enters first within max_dist, or NULL
+	inline Actor* PickActor(glm::vec3 origin, glm::vec3 dir, float max_dist)
+	{
+		Actor* hit = NULL;	// Initialise result
+		glm::vec3 inv_dir = 1.0f / dir;		// Inverse direction for slab tests
+
+		_octree.Raycast(origin, dir, max_dist, [&](int proxy, float &t_max) -> bool	// Visit actors along the ray
+		{
+			float t = _octree.GetAabb(proxy).RayEntry(origin, inv_dir, t_max);		// Entry distance
+			if (t < t_max)	// If closer than the last hit
+			{
+				hit = (Actor*)_octree.GetData(proxy);	// Record actor
+				t_max = t;	// Shorten the ray
+			}
+
+			return false;	// Keep searching for the closest hit
+		});
+
+		return hit;		// Return result
+	}
+
+	// Return the bounds an actor is indexed by: collision bounds, the mesh's bounding sphere, or its position
+	inline Aabb GetOctreeBounds(Actor* a)
+	{
+		if (a->GetObjectType() == MESH && !a->GetCollisionData())	// If a mesh has no collision bounds
+		{
+			glm::vec3 c;	// Centre
+			float r;	// Radius
+			((Mesh*)a)->GetWorldSphere(a->GetMatrix(), c, r);	// Get sphere where the simulation has it
+			return Aabb(c - glm::vec3(r), c + glm::vec3(r));	// Return sphere bounds
+		}
+
+		return a->GetBounds();	// Return actor bounds
+	}
+
+	// Get the candidate pairs for the narrow phase (pairs that involve an actor that moved this update)
+	inline std::vector<std::pair<Actor*, Actor*>> &GetCandidatePairs()
+	{
+		return _pairs;	// Return pairs
+	}
+
+	// Get the convex contacts between candidate pairs
+	inline std::vector<ActorContact> &GetContacts()
+	{
+		return _contacts;	// Return contacts
+	}
+
+	// Return the index of an actor in the actor list (-1 if it isn't in the map)
+	inline unsigned int GetActorIndex(Actor* actor)
+	{
+		std::vector<Actor*>::iterator it = std::find(_actors.begin(), _actors.end(), actor);	// Find actor
+		return (it == _actors.end()) ? (unsigned int)-1 : (unsigned int)(it - _actors.begin());	// Return index
+	}
+
+	// Cast a ray against every active collidable actor of a type (OBJECT for any type) and return the closest hit
+	// hit.data holds the Actor* that was hit
+	inline bool RaycastClosest(glm::vec3 origin, glm::vec3 dir, float max_dist, Collision::Ndc::Raycast::RayHit &out_hit, unsigned int type = OBJECT)
+	{
+		bool hit = Collision::Ndc::Raycast::RaycastClosest(_tree, origin, dir, max_dist, out_hit, [&](void* data) { return FilterRay(data, type); });	// Test moving actors
+		float t_max = hit ? out_hit.t : max_dist;	// Static geometry only needs testing up to the closest hit
+
+		return Collision::Ndc::Raycast::RaycastClosest(_static_grid, origin, dir, t_max, out_hit, [&](void* data) { return FilterRay(data, type); }) || hit;	// Test static geometry
+	}
+
+	// Cast a ray against every active collidable actor of a type (OBJECT for any type) and gather each hit, nearest first
+	inline unsigned int RaycastAll(glm::vec3 origin, glm::vec3 dir, float max_dist, std::vector<Collision::Ndc::Raycast::RayHit> &out_hits, unsigned int type = OBJECT)
+	{
+		std::vector<Collision::Ndc::Raycast::RayHit> static_hits;	// Hits on static geometry
+
+		Collision::Ndc::Raycast::RaycastAll(_tree, origin, dir, max_dist, out_hits, [&](void* data) { return FilterRay(data, type); });		// Test moving actors
+		Collision::Ndc::Raycast::RaycastAll(_static_grid, origin, dir, max_dist, static_hits, [&](void* data) { return FilterRay(data, type); });	// Test static geometry
+
+		out_hits.insert(out_hits.end(), static_hits.begin(), static_hits.end());	// Merge hits
+		std::sort(out_hits.begin(), out_hits.end(), [](const Collision::Ndc::Raycast::RayHit &a, const Collision::Ndc::Raycast::RayHit &b) { return a.t < b.t; });	// Order nearest first
+
+		return (unsigned int)out_hits.size();	// Return number of hits
+	}
+
+	// Get the static geometry grid
+	inline SpatialGrid &GetStaticGrid()
+	{
+		return _static_grid;	// Return grid
+	}
+
 	// Get the list of actors
 	inline std::vector<Actor*> &GetActors()
 	{
 		return _actors;		// Return the list of actors
 	}
 
+	// Get the packed mesh actors
+	inline ComponentArray<Mesh*> &GetMeshes()
+	{
+		return _meshes;		// Return meshes
+	}
+
+	// Get the render snapshot being drawn (only the render thread may use it while a simulation is running)
+	inline RenderSnapshot &GetSnapshot()
+	{
+		return _snapshots[RenderSnapshot::Front()];		// Return front snapshot
+	}
+
+	// Get the meshes inside the camera frustum, as of the last published snapshot
+	inline std::vector<Mesh*> &GetVisibleMeshes()
+	{
+		return GetSnapshot().visible;	// Return visible meshes
+	}
+
+	inline unsigned int GetVisibleCount() { return (unsigned int)GetSnapshot().visible.size(); }		// Return the number of meshes drawn by the camera passes
+	inline unsigned int GetCulledCount() { return GetSnapshot().culled; }	// Return the number of meshes skipped by the camera passes
+
+	// Output every mesh of the last published snapshot whose bounding sphere touches the frustum of a view projection matrix, and return how many there are
+	inline unsigned int CullMeshes(const glm::mat4 &view_proj, std::vector<Mesh*> &out_visible)
+	{
+		return GetSnapshot().CullMeshes(view_proj, out_visible);	// Return number of visible meshes
+	}
+
+	// Write the camera, mesh spheres, camera visible list and lights into the back snapshot
+	inline void Publish()
+	{
+		RenderSnapshot &s = _snapshots[RenderSnapshot::Back()];		// Snapshot being written
+
+		s.view = _player_controller->GetViewMatrix();	// Copy camera
+		s.cam_view = _player_controller->GetUniformViewMatrix();
+		s.proj = _player_controller->GetProjectionMatrix();
+		s.eye = _player_controller->GetPosition();
+
+		unsigned int n = _meshes.Size();	// Number of meshes
+		s.meshes.resize(n);
+		s.sphere_x.resize(n); s.sphere_y.resize(n); s.sphere_z.resize(n); s.sphere_r.resize(n);	// Allocate once
+
+		for (unsigned int i = 0; i < n; i++)	// Iterate through each mesh
+		{
+			glm::vec3 c;	// Centre
+			s.meshes[i] = _meshes[i];	// Copy mesh
+			_meshes[i]->GetWorldSphere(_meshes[i]->GetDrawMatrix(RenderSnapshot::Back()), c, s.sphere_r[i]);	// Get sphere where this snapshot draws it (interpolated), not where the last tick left it
+			s.sphere_x[i] = c.x; s.sphere_y[i] = c.y; s.sphere_z[i] = c.z;		// Split centre
+		}
+
+		unsigned int visible = s.CullMeshes(s.proj * s.view, s.visible);	// Cull against the camera
+		s.culled = n - visible;		// Count skipped meshes
+
+		s.lights.resize(_lights.Size());	// One entry per light
+		for (unsigned int i = 0; i < _lights.Size(); i++)	// Iterate through each light
+		{
+			Light* l = _lights[i];	// Get light
+			s.lights[i] = { l, i, l->GetLightType(), l->GetLightPosition(), l->GetLightColour(), l->GetLightIntensity() };	// Copy light
+		}
+	}
+
+	// Get the packed lights
+	inline ComponentArray<Light*> &GetLights()
+	{
+		return _lights;		// Return lights
+	}
+
 	// Insert actor to vector
 	inline void AddActor(Actor* actor, unsigned int ptr_type)
 	{
@@ -92,18 +305,347 @@ public:
 		}			
 
 		_actors.push_back(actor);	// Push back allocated memory to vector list
+		RegisterComponent(actor);	// Add to its type's component array
+	}
+
+	// Add an actor to the component array of its type, so passes only walk the actors they draw
+	inline void RegisterComponent(Actor* a)
+	{
+		if (a->GetComponent() != COMPONENT_NULL)	// If the actor is already stored
+			return;		// Return from function
+
+		switch (a->GetObjectType())
+		{
+		case MESH:	// If type mesh
+			a->SetComponent(_meshes.Add((Mesh*)a));	// Add to meshes
+			break;
+		case LIGHT:		// If type light
+			a->SetComponent(_lights.Add((Light*)a));	// Add to lights
+			break;
+		}
+	}
+
+	// Remove an actor from the map and its component array (the caller owns the memory)
+	inline void RemoveActor(Actor* a)
+	{
+		std::vector<Actor*>::iterator it = std::find(_actors.begin(), _actors.end(), a);	// Find actor
+		if (it == _actors.end())	// If the actor isn't in the map
+			return;		// Return from function
+
+		_actors.erase(it);	// Remove from actor list
+
+		switch (a->GetObjectType())
+		{
+		case MESH: _meshes.Remove(a->GetComponent()); break;	// Remove from meshes
+		case LIGHT: _lights.Remove(a->GetComponent()); break;	// Remove from lights
+		}
+		a->SetComponent(COMPONENT_NULL);	// Reset component handle
+
+		if (a->GetProxy() != AABB_TREE_NULL)	// If the actor is in the tree
+		{
+			_tree.DestroyProxy(a->GetProxy());	// Remove proxy
+			a->SetProxy(AABB_TREE_NULL);	// Reset proxy id
+		}
+
+		if (a->GetOctreeProxy() != OCTREE_NULL)		// If the actor is in the octree
+		{
+			_octree.DestroyProxy(a->GetOctreeProxy());	// Remove proxy
+			a->SetOctreeProxy(OCTREE_NULL);		// Reset proxy id
+		}
+
+		if (a->GetNode() != TRANSFORM_NULL)		// If the actor has a transform node
+		{
+			_transforms.Destroy(a->GetNode());	// Remove node
+			a->SetNode(NULL, TRANSFORM_NULL);	// Reset node
+		}
 	}
 	
+	// Return true if an actor is static level geometry, which lives in the static grid rather than the tree
+	inline bool IsStaticCollider(Actor* a)
+	{
+		return (a->GetObjectType() == MESH) && !a->IsMovable() && a->IsCollidable() && a->GetCollisionData();	// Return result
+	}
+
+	// Rebake the static grid from every active static mesh
+	inline void RebuildStaticGrid()
+	{
+		_static_grid.Clear();	// Remove old triangles
+		_static_count = 0;	// Reset count
+
+		for (Actor* a : _actors)	// Iterate through our actor list...
+		{
+			if (!IsStaticCollider(a))	// If the actor can move or can't be collided with
+				continue;	// Skip actor
+
+			if (a->IsActive())	// If the actor is active
+				_static_grid.Add(a->GetCollisionData(), a);		// Add its triangles
+
+			_static_count++;	// Count static mesh
+		}
+
+		_static_grid.Build();	// Bucket triangles
+	}
+
+	// Parent an actor to another (NULL to detach), its transform becomes relative to the parent
+	inline bool Attach(Actor* child, Actor* parent)
+	{
+		RegisterTransform(child);	// Make sure both actors are stored
+		if (parent) RegisterTransform(parent);
+
+		return _transforms.SetParent(child->GetNode(), parent ? parent->GetNode() : TRANSFORM_NULL);		// Return result
+	}
+
+	// Give an actor a node in the transform store
+	inline void RegisterTransform(Actor* a)
+	{
+		if (a->GetNode() != TRANSFORM_NULL)		// If the actor is already stored
+			return;		// Return from function
+
+		a->SetNode(&_transforms, _transforms.Create(a));	// Create node
+		a->UpdateModel();	// Push the current local transform
+	}
+
+	// Recompute the world matrix of every actor whose transform, or an ancestor's, changed since the last update
+	inline void UpdateTransforms()
+	{
+		for (Actor* a : _actors)	// Iterate through our actor list...
+		{
+			RegisterComponent(a);	// Pick up actors pushed straight onto the list
+
+			if (a != _player_controller)	// The camera builds its own view
+				RegisterTransform(a);	// Pick up new actors
+		}
+
+		_transforms.Update();	// Propagate dirty sub trees
+
+		for (int node : _transforms.GetChanged())	// Iterate through each changed node
+			((Actor*)_transforms.GetData(node))->ApplyWorld(_transforms.GetWorld(node));	// Hand the world matrix back to the actor
+	}
+
+	// Sync every collidable actor with the broad phase and gather the new candidate pairs
+	// Actors are picked up here rather than in AddActor so ones pushed straight onto the list are also tracked
+	inline void UpdateBroadPhase()
+	{
+		unsigned int static_count = 0;	// Number of static meshes
+		bool static_dirty = false;	// Has a static mesh been moved?
+
+		for (Actor* a : _actors)	// Iterate through our actor list...
+		{
+			bool is_static = IsStaticCollider(a);	// Does the actor belong in the static grid?
+
+			if (is_static)	// If the actor is static
+			{
+				static_count++;		// Count static mesh
+				static_dirty |= a->IsDirty();	// Check for moves
+			}
+
+			bool tracked = !is_static && a->IsCollidable() && a->GetCollisionData() && (a != _player_controller);		// Should the actor be in the tree?
+
+			if (tracked && a->GetProxy() == AABB_TREE_NULL)		// If the actor is new to the tree
+				a->SetProxy(_tree.CreateProxy(a->GetBounds(), a));	// Insert proxy
+			else if (!tracked && a->GetProxy() != AABB_TREE_NULL)	// If the actor is no longer collidable
+			{
+				_tree.DestroyProxy(a->GetProxy());	// Remove proxy
+				a->SetProxy(AABB_TREE_NULL);	// Reset proxy id
+			}
+			else if (tracked && a->IsDirty())	// If the actor has moved
+				_tree.MoveProxy(a->GetProxy(), a->GetBounds());		// Update proxy
+
+			if (a != _player_controller)	// The camera isn't a scene object
+			{
+				if (a->GetOctreeProxy() == OCTREE_NULL)		// If the actor is new to the octree
+					a->SetOctreeProxy(_octree.CreateProxy(GetOctreeBounds(a), a));	// Insert proxy
+				else if (a->IsDirty())	// If the actor has moved
+					_octree.MoveProxy(a->GetOctreeProxy(), GetOctreeBounds(a));		// Update proxy
+			}
+
+			a->SetDirty(false);		// Transform has been seen
+		}
+
+		if (static_dirty || static_count != _static_count)	// If static geometry was added, removed or moved
+			RebuildStaticGrid();	// Rebake static grid
+
+		std::vector<std::pair<int, int>> proxy_pairs;	// Pairs of proxy ids
+		_tree.UpdatePairs(proxy_pairs);		// Gather pairs
+
+		_pairs.clear();		// Reset pair list
+		for (std::pair<int, int> &p : proxy_pairs)	// Iterate through each pair
+			_pairs.push_back(std::make_pair((Actor*)_tree.GetData(p.first), (Actor*)_tree.GetData(p.second)));	// Convert to actors
+	}
+
+	// Test every candidate pair whose actors both have a convex proxy with GJK/EPA
+	// Pairs are tested across the job system into one slot each, then compacted in pair order so the result doesn't depend on scheduling
+	inline void UpdateNarrowPhase()
+	{
+		std::vector<ActorContact> slots(_pairs.size());		// One contact per pair
+		std::vector<uint8_t> hits(_pairs.size(), 0);	// Did each pair collide?
+
+		JobSystem::ParallelFor(0, _pairs.size(), 64, [&](size_t first, size_t last)	// Test pairs in ranges
+		{
+			for (size_t i = first; i < last; i++)	// Iterate through each candidate pair
+			{
+				std::pair<Actor*, Actor*> &p = _pairs[i];	// Get pair
+
+				if (!p.first->IsActive() || !p.second->IsActive())	// If either actor is inactive
+					continue;	// Skip pair
+
+				if (Collision::Ndc::Intersection::IntersectConvex(p.first->GetCollisionData(), p.second->GetCollisionData(), slots[i].c))	// If the proxies overlap
+				{
+					slots[i].a = p.first;	// Assign first actor
+					slots[i].b = p.second;	// Assign second actor
+					hits[i] = 1;	// Record hit
+				}
+			}
+		});
+
+		_contacts.clear();	// Reset contact list
+		for (size_t i = 0; i < slots.size(); i++)	// Iterate through each pair in order
+			if (hits[i])	// If it collided
+				_contacts.push_back(slots[i]);	// Add contact
+	}
+
+	// Gather the collision data of every active collidable actor whose broad phase box overlaps the box
+	inline void GatherColliders(const Aabb &box, std::vector<CollisionData*> &out_nearby)
+	{
+		_tree.Query(box, [&](int proxy)		// Find overlapping proxies
+		{
+			Actor* a = (Actor*)_tree.GetData(proxy);	// Get actor
+
+			if (a->IsActive())	// If the actor is active
+				out_nearby.push_back(a->GetCollisionData());	// Add to nearby list
+
+			return true;	// Keep going
+		});
+	}
+
+	// Return the collision data of a proxy's actor if it passes the ray filter, otherwise NULL
+	inline CollisionData* FilterRay(void* data, unsigned int type)
+	{
+		Actor* a = (Actor*)data;	// Get actor
+
+		if (!a->IsActive() || (type != OBJECT && a->GetObjectType() != type))	// If the actor is filtered out
+			return NULL;	// Return nothing
+
+		return a->GetCollisionData();	// Return collision data
+	}
+
+	inline bool IsParallelUpdate() { return _parallel; }	// Return true if actors update across the job system
+	inline void SetParallelUpdate(bool value) { _parallel = value; }	// Assign parallel actor updates
+
+	// Split the actor list into update batches, the same list always gives the same batches
+	// Independent actors are bucketed by type and cut into runs, grouped actors share one batch per group, main thread only actors go last
+	inline void BuildUpdateBatches()
+	{
+		_batches.clear();	// Reset batches
+		_serial.clear();	// Reset serial list
+
+		std::map<int, unsigned int> buckets;	// Batch of each type or group, in order of first appearance
+		for (Actor* a : _actors)	// Iterate through our actor list...
+		{
+			if (a->IsMainThreadOnly())	// If the actor must run on the main thread
+			{
+				_serial.push_back(a);	// Update it last
+				continue;	// Next actor
+			}
+
+			int key = (a->GetUpdateGroup() == ACTOR_GROUP_NONE) ? -1 - (int)a->GetObjectType() : a->GetUpdateGroup();	// Types map below zero, groups at or above
+			std::map<int, unsigned int>::iterator it = buckets.find(key);	// Find open batch
+
+			if (it == buckets.end() || (key < 0 && _batches[it->second].size() >= MAP_UPDATE_BATCH))	// If there is none, or an independent run is full
+			{
+				buckets[key] = (unsigned int)_batches.size();	// Open a new batch
+				_batches.push_back(std::vector<Actor*>());
+				_batches.back().reserve((key < 0) ? MAP_UPDATE_BATCH : 8);
+			}
+
+			_batches[buckets[key]].push_back(a);	// Add actor
+		}
+	}
+
+	// Update a list of actors in order on the main thread
+	// The pipelined simulation runs on a worker, so from there the list is handed to the main thread (which pumps main jobs while it waits for us)
+	inline void UpdateOnMain(const std::vector<Actor*> &actors, double &delta)
+	{
+		if (JobSystem::IsMainThread())	// If we are already on the main thread
+		{
+			for (Actor* a : actors)		// Iterate through each actor
+				a->Update(delta);	// Update actor
+
+			return;		// Return from function
+		}
+
+		JobCounter done;	// Main thread job counter
+		JobSystem::RunOnMain([&]()	// Update on the main thread
+		{
+			for (Actor* a : actors)		// Iterate through each actor
+				a->Update(delta);	// Update actor
+		}, &done);
+		JobSystem::Wait(done);	// Help with other jobs until it's done
+	}
+
+	// Tick every actor, across the job system when there are enough of them
+	// Actors in different batches must not touch each other in Update; ones that do share a group or are main thread only
+	inline void UpdateActors(double &delta)
+	{
+		if (!_parallel || JobSystem::GetThreadCount() < 2 || _actors.size() < MAP_PARALLEL_MIN_ACTORS)	// If the serial path is cheaper
+		{
+			UpdateOnMain(_actors, delta);	// Update all of the actors (some may be main thread only)
+			return;		// Return from function
+		}
+
+		BuildUpdateBatches();	// Partition actors
+		double dt = delta;	// Shared read only copy of the timestep
+
+		_transforms.BeginDeferred(JobSystem::GetThreadCount());		// Actors moved by the batches queue their transforms per thread
+
+		JobSystem::ParallelFor(0, _batches.size(), 1, [&](size_t first, size_t last)	// One job per batch
+		{
+			for (size_t b = first; b < last; b++)	// Iterate through each batch
+			{
+				for (Actor* a : _batches[b])	// Iterate through each actor in list order
+				{
+					double d = dt;	// Actors take the timestep by reference
+					a->Update(d);	// Update actor
+				}
+			}
+		});
+
+		_transforms.EndDeferred();	// Merge the queued transforms
+		UpdateOnMain(_serial, delta);	// Update each main thread only actor
+	}
+
 	// The update function will check for logic
 	virtual inline void Update(double &delta)
 	{		
-		_player_controller->FreeMove(delta);	// Update camera interpolation and check for collision
-
 		for (Actor* a : _actors)	// Iterate through our actor list...
+			a->SaveState();		// Remember where this tick started, for interpolation
+
+		UpdateTransforms();		// Resolve world matrices of moved actors and their children
+		UpdateBroadPhase();		// Sync broad phase with last update's transforms
+		UpdateNarrowPhase();	// Find convex contacts between candidate pairs
+
+		glm::vec3 move = _player_controller->GetMoveDelta(delta);	// Get the desired camera movement
+
+		if (move != glm::vec3(0.0f))	// If the camera wants to move
 		{
-			a->Update(delta);		// Update all of the actors
+			Aabb box = Collision::Ndc::Sweep::SweepBounds(_player_controller->GetPosition(), move, _player_controller->GetRadii());	// Swept bounds
+			std::vector<CollisionData*> nearby;		// Nearby collision data
+
+			GatherColliders(box, nearby);	// Broad phase over moving actors
+			_player_controller->MoveAndSlide(move, nearby, &_static_grid);		// Sweep and slide camera against moving actors and static geometry
 		}
-		
+
+		UpdateActors(delta);	// Update all of the actors
+	}
+
+	// Blend every actor between the last two simulation ticks, then publish the back snapshot against the blended camera
+	// Runs once per rendered frame, after however many ticks were due; RenderSnapshot::Swap then hands it to the renderer
+	inline void Interpolate(float alpha)
+	{
+		for (Actor* a : _actors)	// Iterate through our actor list...
+			a->Interpolate(alpha);	// Blend render transform
+
+		Publish();	// Write render state for this frame's passes
 	}
 
 	// This will render all actors in the world
@@ -0,0 +1,125 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <iostream>		// Get error output
+#include <cstddef>	// Get size types
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX	// No min and max macros, the loaders use std::min and glm::min
+#endif
+#include <Windows.h>	// Get file mapping
+#else
+#include <sys/mman.h>	// Get file mapping
+#include <sys/stat.h>	// Get file size
+#include <fcntl.h>	// Get open
+#include <unistd.h>		// Get close
+#endif
+
+// A read only view of a whole file mapped into memory, so loaders can parse it in place without copying it into buffers first
+class MappedFile
+{
+private:
+	const char*		_data;	// First byte of the file (NULL when empty or closed)
+	size_t			_size;	// Number of bytes
+
+#ifdef _WIN32
+	HANDLE			_file;	// File handle
+	HANDLE			_map;	// Mapping handle
+#else
+	int				_file;	// File descriptor
+#endif
+
+public:
+	// Default constructor
+#ifdef _WIN32
+	inline MappedFile() : _data(NULL), _size(0), _file(INVALID_HANDLE_VALUE), _map(NULL) {}
+#else
+	inline MappedFile() : _data(NULL), _size(0), _file(-1) {}
+#endif
+
+	// Deconstructor
+	inline ~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;		// The mapping can only have one owner
+	MappedFile &operator=(const MappedFile&) = delete;
+
+	inline const char* Data() const { return _data; }	// Return the first byte
+	inline size_t Size() const { return _size; }	// Return the number of bytes
+
+	// Map a file, returns false if it couldn't be opened (an empty file maps to no data)
+	inline bool Open(const char* file)
+	{
+		Close();	// Release any previous file
+
+#ifdef _WIN32
+		_file = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);	// Open file
+		if (_file == INVALID_HANDLE_VALUE)	// If the file couldn't be opened
+		{
+			std::cerr << "MappedFile Error: The file is invalid! Check that the file exists.\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		LARGE_INTEGER size;		// File size
+		GetFileSizeEx(_file, &size);
+		_size = (size_t)size.QuadPart;
+
+		if (_size == 0)		// If the file is empty there is nothing to map
+			return true;	// Return true
+
+		_map = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);	// Create mapping
+		if (_map)	// If the mapping was created
+			_data = (const char*)MapViewOfFile(_map, FILE_MAP_READ, 0, 0, 0);	// Map the whole file
+#else
+		_file = open(file, O_RDONLY);	// Open file
+		if (_file < 0)	// If the file couldn't be opened
+		{
+			std::cerr << "MappedFile Error: The file is invalid! Check that the file exists.\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		struct stat st;		// File info
+		fstat(_file, &st);
+		_size = (size_t)st.st_size;
+
+		if (_size == 0)		// If the file is empty there is nothing to map
+			return true;	// Return true
+
+		void* p = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, _file, 0);	// Map the whole file
+		if (p != MAP_FAILED)	// If the file was mapped
+		{
+			madvise(p, _size, MADV_SEQUENTIAL);		// We read front to back
+			_data = (const char*)p;
+		}
+#endif
+
+		if (!_data)		// If the mapping failed
+		{
+			std::cerr << "MappedFile Error: The file couldn't be mapped into memory!\n";	// Print out error message
+			Close();	// Release file
+			return false;	// Return false
+		}
+
+		return true;	// Return true
+	}
+
+	// Unmap and close the file
+	inline void Close()
+	{
+#ifdef _WIN32
+		if (_data) UnmapViewOfFile(_data);	// Unmap view
+		if (_map) CloseHandle(_map);	// Close mapping
+		if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);	// Close file
+		_map = NULL;
+		_file = INVALID_HANDLE_VALUE;
+#else
+		if (_data) munmap((void*)_data, _size);		// Unmap file
+		if (_file >= 0) close(_file);	// Close file
+		_file = -1;
+#endif
+		_data = NULL;	// Reset view
+		_size = 0;
+	}
+};
+
+#endif
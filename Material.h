@@ -1,8 +1,8 @@
 #ifndef __MATERIAL_H__
 #define __MATERIAL_H__
 
-#include <glm\gtc\type_ptr.hpp>		// Get valur_ptr for glm
-#include <glm\glm.hpp>	// Get access to vectors
+#include <glm/gtc/type_ptr.hpp>		// Get valur_ptr for glm
+#include <glm/glm.hpp>	// Get access to vectors
 #include "Object.h"		// Derive from object class
 #include "Uniform.h"	// Get access to our uniforms
 #include "Texture.h"	// Get access to our texture object
@@ -2,23 +2,480 @@
 #define __MATH_H__
 
 #define __PI	3.14159		// For radial calculations
+#define SPHERE_SLACK	(8.0f * FLT_EPSILON)	// Points this far outside a sphere (relative to its radius) are treated as inside while growing it
 
 #include <random>	// Include random generators
-#include <glm\glm.hpp>	// Get glm variables
+#include <glm/glm.hpp>	// Get glm variables
+#include <glm/gtx/transform.hpp>	// Get rotation matrices
 #include <vector>	// Get dynamic arrays
+#include <cfloat>	// Get float limits
+#include "Simd.h"	// Get vector instruction wrappers
 
 // This contains some extra math functions
 namespace Math
 {
-	// This function will reset vertex data after rotating
-	static void FreezeRotation(std::vector<glm::vec3> &v, glm::vec3 &rotation)
+	// ------------------------- POINT SET KERNELS -------------------------
+	// Single pass reductions over packed glm::vec3 arrays with no allocations, vectorised when the instruction set allows
+
+	static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Point kernels need tightly packed vec3");	// Kernels read vec3 arrays as flat floats
+
+	// Vector kernel: grow lo and hi by points [i, n) in groups of V::WIDTH
+	template <typename V>
+	static void BoundsN(const glm::vec3* p, size_t &i, size_t n, glm::vec3 &lo, glm::vec3 &hi)
+	{
+		typedef typename V::T T;	// Register type
+		if (i + V::WIDTH > n)	// If there isn't a full group
+			return;		// Return from function
+
+		T lx = V::Set(lo.x), ly = V::Set(lo.y), lz = V::Set(lo.z);	// Lane minimums
+		T hx = V::Set(hi.x), hy = V::Set(hi.y), hz = V::Set(hi.z);	// Lane maximums
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			T x, y, z;	// Point components
+			V::LoadXYZ(&p[i].x, x, y, z);	// Split points into components
+			lx = V::Min(lx, x); ly = V::Min(ly, y); lz = V::Min(lz, z);		// Grow minimums
+			hx = V::Max(hx, x); hy = V::Max(hy, y); hz = V::Max(hz, z);		// Grow maximums
+		}
+
+		float l[3][V::WIDTH], h[3][V::WIDTH];	// Lanes
+		V::Store(l[0], lx); V::Store(l[1], ly); V::Store(l[2], lz);	// Spill minimums
+		V::Store(h[0], hx); V::Store(h[1], hy); V::Store(h[2], hz);	// Spill maximums
+
+		for (int k = 0; k < V::WIDTH; k++)	// Reduce lanes
+		{
+			lo = glm::min(lo, glm::vec3(l[0][k], l[1][k], l[2][k]));	// Grow minimum
+			hi = glm::max(hi, glm::vec3(h[0][k], h[1][k], h[2][k]));	// Grow maximum
+		}
+	}
+
+	// Vector kernel: add points [i, n) to sum in groups of V::WIDTH
+	template <typename V>
+	static void SumN(const glm::vec3* p, size_t &i, size_t n, glm::vec3 &sum)
+	{
+		typedef typename V::T T;	// Register type
+		if (i + V::WIDTH > n)	// If there isn't a full group
+			return;		// Return from function
+
+		T sx = V::Set(0.0f), sy = V::Set(0.0f), sz = V::Set(0.0f);	// Lane sums
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			T x, y, z;	// Point components
+			V::LoadXYZ(&p[i].x, x, y, z);	// Split points into components
+			sx = V::Add(sx, x); sy = V::Add(sy, y); sz = V::Add(sz, z);		// Accumulate
+		}
+
+		float s[3][V::WIDTH];	// Lanes
+		V::Store(s[0], sx); V::Store(s[1], sy); V::Store(s[2], sz);	// Spill sums
+
+		for (int k = 0; k < V::WIDTH; k++)	// Reduce lanes
+			sum += glm::vec3(s[0][k], s[1][k], s[2][k]);	// Add lane k
+	}
+
+	// Vector kernel: grow the max squared distance from c by points [i, n) in groups of V::WIDTH
+	template <typename V>
+	static void MaxDistance2N(const glm::vec3* p, size_t &i, size_t n, const glm::vec3 &c, float &best)
 	{
-		for (unsigned int i = 0; i < v.size(); i++)
+		typedef typename V::T T;	// Register type
+		if (i + V::WIDTH > n)	// If there isn't a full group
+			return;		// Return from function
+
+		T cx = V::Set(c.x), cy = V::Set(c.y), cz = V::Set(c.z);		// Broadcast centre
+		T b = V::Set(best);		// Lane maximums
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
 		{
-			v[i] = glm::vec4(v[i], 1.0f)	* glm::rotate(glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
-				* glm::rotate(glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
-				* glm::rotate(glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+			T x, y, z;	// Point components
+			V::LoadXYZ(&p[i].x, x, y, z);	// Split points into components
+			x = V::Sub(x, cx); y = V::Sub(y, cy); z = V::Sub(z, cz);	// Offset from centre
+			b = V::Max(b, Simd::Dot3<V>(x, y, z, x, y, z));		// Grow maximum
 		}
+
+		float l[V::WIDTH];	// Lanes
+		V::Store(l, b);	// Spill maximums
+
+		for (int k = 0; k < V::WIDTH; k++)	// Reduce lanes
+			best = glm::max(best, l[k]);	// Grow maximum
+	}
+
+	// Vector kernel: grow the extreme points along each axis by points [i, n) in groups of V::WIDTH
+	// ext holds the points with the smallest and largest x, then y, then z
+	template <typename V>
+	static void ExtremesN(const glm::vec3* p, size_t &i, size_t n, glm::vec3 (&ext)[6])
+	{
+		typedef typename V::T T;	// Register type
+		if (i + V::WIDTH > n)	// If there isn't a full group
+			return;		// Return from function
+
+		T ex[6], ey[6], ez[6];	// Lane extreme points
+		for (int e = 0; e < 6; e++)	// Iterate through each extreme
+		{
+			ex[e] = V::Set(ext[e].x); ey[e] = V::Set(ext[e].y); ez[e] = V::Set(ext[e].z);	// Broadcast extreme e
+		}
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			T x, y, z;	// Point components
+			V::LoadXYZ(&p[i].x, x, y, z);	// Split points into components
+
+			T m[6] = { V::Lt(x, ex[0]), V::Gt(x, ex[1]), V::Lt(y, ey[2]), V::Gt(y, ey[3]), V::Lt(z, ez[4]), V::Gt(z, ez[5]) };	// Lanes that beat each extreme
+			for (int e = 0; e < 6; e++)		// Replace the beaten points
+			{
+				ex[e] = V::Select(m[e], x, ex[e]); ey[e] = V::Select(m[e], y, ey[e]); ez[e] = V::Select(m[e], z, ez[e]);	// Keep the further point per lane
+			}
+		}
+
+		for (int e = 0; e < 6; e++)		// Reduce lanes
+		{
+			float lx[V::WIDTH], ly[V::WIDTH], lz[V::WIDTH];	// Lanes
+			V::Store(lx, ex[e]); V::Store(ly, ey[e]); V::Store(lz, ez[e]);	// Spill extreme e
+
+			int axis = e / 2;	// Axis of this extreme
+			for (int k = 0; k < V::WIDTH; k++)	// Iterate through each lane
+			{
+				glm::vec3 q(lx[k], ly[k], lz[k]);	// Lane point
+				if ((e & 1) ? (q[axis] > ext[e][axis]) : (q[axis] < ext[e][axis]))	// If lane k is further out
+					ext[e] = q;	// Record point
+			}
+		}
+	}
+
+	// Grow a sphere just enough to hold q (Ritter's update)
+	static inline void GrowSphere(const glm::vec3 &q, glm::vec3 &c, float &r)
+	{
+		glm::vec3 d = q - c;	// Offset from centre
+		float l2 = glm::dot(d, d);	// Squared distance to q
+		if (l2 <= r * r * (1.0f + SPHERE_SLACK))	// If q is already inside (rounding on a surface shouldn't grow the sphere a hair at a time)
+			return;		// Return from function
+
+		float l = std::sqrt(l2);	// Distance to q
+		float grown = (r + l) * 0.5f;	// New radius spans the old sphere and q
+		c += d * ((grown - r) / l);		// Slide the centre towards q
+		r = grown;	// Assign radius
+	}
+
+	// Vector kernel: grow the sphere by points [i, n) in groups of V::WIDTH, and the max squared distance from b alongside
+	// Whole groups inside the sphere are skipped; lanes outside it are grown one at a time in order
+	template <typename V>
+	static void GrowSphereN(const glm::vec3* p, size_t &i, size_t n, glm::vec3 &c, float &r, const glm::vec3 &b, float &best)
+	{
+		typedef typename V::T T;	// Register type
+		if (i + V::WIDTH > n)	// If there isn't a full group
+			return;		// Return from function
+
+		T cx = V::Set(c.x), cy = V::Set(c.y), cz = V::Set(c.z), r2 = V::Set(r * r * (1.0f + SPHERE_SLACK));	// Broadcast sphere
+		T bx = V::Set(b.x), by = V::Set(b.y), bz = V::Set(b.z), bd = V::Set(best);	// Broadcast second centre, lane maximums
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			T x, y, z;	// Point components
+			V::LoadXYZ(&p[i].x, x, y, z);	// Split points into components
+
+			T ox = V::Sub(x, bx), oy = V::Sub(y, by), oz = V::Sub(z, bz);	// Offset from second centre
+			bd = V::Max(bd, Simd::Dot3<V>(ox, oy, oz, ox, oy, oz));		// Grow maximum
+
+			x = V::Sub(x, cx); y = V::Sub(y, cy); z = V::Sub(z, cz);	// Offset from centre
+			int mask = V::Mask(V::Gt(Simd::Dot3<V>(x, y, z, x, y, z), r2));		// Lanes outside the sphere
+			if (mask)	// If the sphere has to grow
+			{
+				for (int k = 0; k < V::WIDTH; k++)	// Iterate through each lane in order
+					GrowSphere(p[i + k], c, r);		// Grow (the test is repeated, earlier lanes may have covered it)
+
+				cx = V::Set(c.x); cy = V::Set(c.y); cz = V::Set(c.z); r2 = V::Set(r * r * (1.0f + SPHERE_SLACK));	// Broadcast grown sphere
+			}
+		}
+
+		float l[V::WIDTH];	// Lanes
+		V::Store(l, bd);	// Spill maximums
+
+		for (int k = 0; k < V::WIDTH; k++)	// Reduce lanes
+			best = glm::max(best, l[k]);	// Grow maximum
+	}
+
+	// This outputs the component wise min and max of n points
+	static void Boundsv3(const glm::vec3* p, size_t n, glm::vec3 &out_min, glm::vec3 &out_max)
+	{
+		out_min = glm::vec3(FLT_MAX);	// Initialise min
+		out_max = glm::vec3(-FLT_MAX);	// Initialise max
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			BoundsN<Simd::F8>(p, i, n, out_min, out_max);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		BoundsN<Simd::F4>(p, i, n, out_min, out_max);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+		{
+			out_min = glm::min(out_min, p[i]);	// Grow min
+			out_max = glm::max(out_max, p[i]);	// Grow max
+		}
+	}
+
+	// This returns the sum of n points
+	static glm::vec3 Sumv3(const glm::vec3* p, size_t n)
+	{
+		glm::vec3 sum(0.0f);	// Initialise sum
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			SumN<Simd::F8>(p, i, n, sum);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		SumN<Simd::F4>(p, i, n, sum);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+			sum += p[i];	// Accumulate
+
+		return sum;		// Return result
+	}
+
+	// This returns the average of n points
+	static glm::vec3 Centroidv3(const glm::vec3* p, size_t n)
+	{
+		return (n > 0) ? Sumv3(p, n) / (float)n : glm::vec3(0.0f);	// Return result
+	}
+
+	// This returns the distance from c to the furthest of n points
+	static float MaxDistancev3(const glm::vec3* p, size_t n, glm::vec3 c)
+	{
+		float best = 0.0f;	// Max squared distance
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			MaxDistance2N<Simd::F8>(p, i, n, c, best);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		MaxDistance2N<Simd::F4>(p, i, n, c, best);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+			best = glm::max(best, glm::dot(p[i] - c, p[i] - c));	// Grow maximum
+
+		return std::sqrt(best);		// Return result
+	}
+
+	// This outputs a sphere that holds n points using Ritter's two passes (usually within 5-20% of the optimal radius)
+	// The first pass finds the extreme points along each axis and spans the furthest pair, the second grows the sphere over every point outside it
+	// The second pass also measures the sphere centred on the bounds (known after the first), and the smaller of the two is kept
+	static void BoundingSpherev3(const glm::vec3* p, size_t n, glm::vec3 &out_centre, float &out_radius)
+	{
+		out_centre = glm::vec3(0.0f);	// Initialise centre
+		out_radius = 0.0f;	// Initialise radius
+		if (n == 0)		// If there are no points
+			return;		// Return from function
+
+		// -------------------------- EXTREME POINTS --------------------------------------
+		glm::vec3 ext[6] = { p[0], p[0], p[0], p[0], p[0], p[0] };	// Min and max point along x, y and z
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			ExtremesN<Simd::F8>(p, i, n, ext);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		ExtremesN<Simd::F4>(p, i, n, ext);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+			for (int e = 0; e < 6; e++)	// Iterate through each extreme
+				if ((e & 1) ? (p[i][e / 2] > ext[e][e / 2]) : (p[i][e / 2] < ext[e][e / 2]))	// If point i is further out
+					ext[e] = p[i];	// Record point
+
+		int pair = 0;	// Axis whose extremes are furthest apart
+		for (int a = 1; a < 3; a++)	// Iterate through the other axes
+			if (glm::dot(ext[a * 2 + 1] - ext[a * 2], ext[a * 2 + 1] - ext[a * 2]) > glm::dot(ext[pair * 2 + 1] - ext[pair * 2], ext[pair * 2 + 1] - ext[pair * 2]))	// If axis a's extremes are further apart
+				pair = a;	// Record axis
+
+		out_centre = (ext[pair * 2] + ext[pair * 2 + 1]) * 0.5f;	// Span the furthest pair
+		out_radius = glm::distance(ext[pair * 2], ext[pair * 2 + 1]) * 0.5f;	// Half their distance
+
+		glm::vec3 box = glm::vec3(ext[0].x + ext[1].x, ext[2].y + ext[3].y, ext[4].z + ext[5].z) * 0.5f;	// Centre of the bounds
+		float box_r2 = 0.0f;	// Max squared distance from the bounds centre
+
+		// -------------------------- GROW --------------------------------------
+		i = 0;	// Start again from the first point
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			GrowSphereN<Simd::F8>(p, i, n, out_centre, out_radius, box, box_r2);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		GrowSphereN<Simd::F4>(p, i, n, out_centre, out_radius, box, box_r2);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+		{
+			GrowSphere(p[i], out_centre, out_radius);	// Grow sphere
+			box_r2 = glm::max(box_r2, glm::dot(p[i] - box, p[i] - box));	// Grow maximum
+		}
+
+		if (std::sqrt(box_r2) < out_radius)		// If the bounds centred sphere is tighter (flat or boxy point sets)
+		{
+			out_centre = box;	// Use it
+			out_radius = std::sqrt(box_r2);	// Assign radius
+		}
+
+		glm::vec3 a = glm::abs(out_centre);		// Rounding grows with the coordinates as well as the radius
+		out_radius += SPHERE_SLACK * (out_radius + glm::max(a.x, glm::max(a.y, a.z)));	// Cover the slack and the rounding of the centre updates so no point lands just outside
+	}
+
+	// This returns the largest absolute component of n points
+	static float MaxAbsComponentv3(const glm::vec3* p, size_t n)
+	{
+		if (n == 0)		// If there are no points
+			return 0.0f;	// Return zero
+
+		glm::vec3 lo, hi;	// Bounds
+		Boundsv3(p, n, lo, hi);		// Single pass
+
+		glm::vec3 m = glm::max(glm::abs(lo), glm::abs(hi));		// Largest magnitude per axis
+		return glm::max(m.x, glm::max(m.y, m.z));	// Return result
+	}
+
+	// ------------------------- POINT TRANSFORM KERNELS -------------------------
+	// Batched mat4 * point transforms over packed (AoS) or split (SoA) arrays; in and out may be the same array
+	// The affine path assumes the bottom row of m is (0, 0, 0, 1) and skips the divide by w
+
+	// Vector kernel helper: transform one group of split points by the broadcast matrix columns
+	template <typename V, bool PROJECTIVE>
+	static inline void TransformLanes(const typename V::T (&c)[4][4], typename V::T &x, typename V::T &y, typename V::T &z)
+	{
+		typedef typename V::T T;	// Register type
+		T ox = V::Add(V::Add(V::Add(V::Mul(c[0][0], x), V::Mul(c[1][0], y)), V::Mul(c[2][0], z)), c[3][0]);		// Row 0 (summed in glm's scalar order so results match per point transforms)
+		T oy = V::Add(V::Add(V::Add(V::Mul(c[0][1], x), V::Mul(c[1][1], y)), V::Mul(c[2][1], z)), c[3][1]);		// Row 1
+		T oz = V::Add(V::Add(V::Add(V::Mul(c[0][2], x), V::Mul(c[1][2], y)), V::Mul(c[2][2], z)), c[3][2]);		// Row 2
+
+		if (PROJECTIVE)		// If w isn't always 1
+		{
+			T w = V::Add(V::Add(V::Add(V::Mul(c[0][3], x), V::Mul(c[1][3], y)), V::Mul(c[2][3], z)), c[3][3]);	// Row 3
+			T inv_w = V::Div(V::Set(1.0f), w);	// One divide shared by all three components
+			ox = V::Mul(ox, inv_w); oy = V::Mul(oy, inv_w); oz = V::Mul(oz, inv_w);	// Divide by w
+		}
+
+		x = ox; y = oy; z = oz;		// Assign result
+	}
+
+	// Vector kernel: transform packed points [i, n) in groups of V::WIDTH
+	template <typename V, bool PROJECTIVE>
+	static void TransformAoSN(const glm::mat4 &m, const glm::vec3* in, glm::vec3* out, size_t &i, size_t n)
+	{
+		typename V::T c[4][4];	// Broadcast matrix
+		for (int col = 0; col < 4; col++)	// Iterate through each column
+			for (int row = 0; row < 4; row++)	// Iterate through each row
+				c[col][row] = V::Set(m[col][row]);	// Broadcast element
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			typename V::T x, y, z;	// Point components
+			V::LoadXYZ(&in[i].x, x, y, z);	// Split points
+			TransformLanes<V, PROJECTIVE>(c, x, y, z);	// Transform
+			V::StoreXYZ(&out[i].x, x, y, z);	// Interleave points
+		}
+	}
+
+	// Vector kernel: transform split points [i, n) in groups of V::WIDTH
+	template <typename V, bool PROJECTIVE>
+	static void TransformSoAN(const glm::mat4 &m, const float* ix, const float* iy, const float* iz, float* ox, float* oy, float* oz, size_t &i, size_t n)
+	{
+		typename V::T c[4][4];	// Broadcast matrix
+		for (int col = 0; col < 4; col++)	// Iterate through each column
+			for (int row = 0; row < 4; row++)	// Iterate through each row
+				c[col][row] = V::Set(m[col][row]);	// Broadcast element
+
+		for (; i + V::WIDTH <= n; i += V::WIDTH)	// Iterate through each full group
+		{
+			typename V::T x = V::Load(ix + i), y = V::Load(iy + i), z = V::Load(iz + i);	// Load components
+			TransformLanes<V, PROJECTIVE>(c, x, y, z);	// Transform
+			V::Store(ox + i, x); V::Store(oy + i, y); V::Store(oz + i, z);	// Store components
+		}
+	}
+
+	// Transform one point, dividing by w when projective
+	template <bool PROJECTIVE>
+	static inline glm::vec3 TransformPoint(const glm::mat4 &m, const glm::vec3 &p)
+	{
+		glm::vec4 r = m * glm::vec4(p, 1.0f);	// Transform
+		return PROJECTIVE ? glm::vec3(r) / r.w : glm::vec3(r);	// Return result
+	}
+
+	// Transform packed points, picking the widest kernel this machine supports
+	template <bool PROJECTIVE>
+	static void TransformAoS(const glm::mat4 &m, const glm::vec3* in, glm::vec3* out, size_t n)
+	{
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			TransformAoSN<Simd::F8, PROJECTIVE>(m, in, out, i, n);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		TransformAoSN<Simd::F4, PROJECTIVE>(m, in, out, i, n);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+			out[i] = TransformPoint<PROJECTIVE>(m, in[i]);	// Transform point
+	}
+
+	// Transform split points, picking the widest kernel this machine supports
+	template <bool PROJECTIVE>
+	static void TransformSoA(const glm::mat4 &m, const float* ix, const float* iy, const float* iz, float* ox, float* oy, float* oz, size_t n)
+	{
+		size_t i = 0;	// First point not yet visited
+
+#ifdef SIMD_F8
+		if (Simd::HasAvx2())	// If 8-wide kernels can run
+			TransformSoAN<Simd::F8, PROJECTIVE>(m, ix, iy, iz, ox, oy, oz, i, n);	// 8 points at a time
+#endif
+#ifdef SIMD_SSE
+		TransformSoAN<Simd::F4, PROJECTIVE>(m, ix, iy, iz, ox, oy, oz, i, n);	// 4 points at a time
+#endif
+
+		for (; i < n; i++)	// Iterate through the remaining points
+		{
+			glm::vec3 p = TransformPoint<PROJECTIVE>(m, glm::vec3(ix[i], iy[i], iz[i]));	// Transform point
+			ox[i] = p.x; oy[i] = p.y; oz[i] = p.z;	// Store components
+		}
+	}
+
+	// This transforms n packed points by an affine matrix
+	static void TransformPointsv3(const glm::mat4 &m, const glm::vec3* in, glm::vec3* out, size_t n)
+	{
+		TransformAoS<false>(m, in, out, n);	// Affine, packed
+	}
+
+	// This transforms n packed points by a projective matrix and divides by w
+	static void ProjectPointsv3(const glm::mat4 &m, const glm::vec3* in, glm::vec3* out, size_t n)
+	{
+		TransformAoS<true>(m, in, out, n);	// Projective, packed
+	}
+
+	// This transforms n split points by an affine matrix
+	static void TransformPointsSoA(const glm::mat4 &m, const float* ix, const float* iy, const float* iz, float* ox, float* oy, float* oz, size_t n)
+	{
+		TransformSoA<false>(m, ix, iy, iz, ox, oy, oz, n);	// Affine, split
+	}
+
+	// This transforms n split points by a projective matrix and divides by w
+	static void ProjectPointsSoA(const glm::mat4 &m, const float* ix, const float* iy, const float* iz, float* ox, float* oy, float* oz, size_t n)
+	{
+		TransformSoA<true>(m, ix, iy, iz, ox, oy, oz, n);	// Projective, split
+	}
+
+	// This function will reset vertex data after rotating
+	static void FreezeRotation(std::vector<glm::vec3> &v, glm::vec3 &rotation)
+	{
+		glm::mat4 r = glm::rotate(glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
+			* glm::rotate(glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
+			* glm::rotate(glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));	// Combined rotation (applied as v * r)
+
+		TransformPointsv3(glm::transpose(r), v.data(), v.data(), v.size());	// v * r is transpose(r) * v
 	}
 
 	// This returns the lowest value of x[i]
@@ -108,18 +565,9 @@ namespace Math
 	}
 
 	// This returns a scalar value of the greatest component value
-	static float MaxComponentValueAbsv3(std::vector<glm::vec3> &x)
+	static float MaxComponentValueAbsv3(const std::vector<glm::vec3> &x)
 	{
-		std::vector<float> comp_abs;	// Create temp list of vertex component values in absolute
-		for (unsigned int i = 1; i < x.size(); i++)		// Iterate through each vertex
-		{
-			for (unsigned int j = 0; j < 3; j++)	// Iterate through each component
-				comp_abs.push_back(glm::abs(x[i][j]));	// Assign new component value
-		}
-
-		float r = Maxf(comp_abs);	// Get max compoonent value
-
-		return r;	// Return result
+		return MaxAbsComponentv3(x.data(), x.size());	// Return result
 	}
 
 	// This returns the average value of x[i]
@@ -156,14 +604,9 @@ namespace Math
 	}
 
 	// This returns the average value of x[i]
-	static glm::vec3 Avgv3(std::vector<glm::vec3> x)
+	static glm::vec3 Avgv3(const std::vector<glm::vec3> &x)
 	{
-		glm::vec3 it = glm::vec3(0.0f);
-
-		for (unsigned int i = 0; i < x.size(); i++)
-			it += x[i];
-
-		return (it) / static_cast<float>(x.size());
+		return Centroidv3(x.data(), x.size());	// Return result
 	}
 
 	// This will return a normal direction vector
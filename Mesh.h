@@ -1,6 +1,8 @@
 #ifndef __MESH_H__
 #define __MESH_H__
 
+#define MESH_LOD_PIXEL_ERROR	1.0f	// Largest error, in pixels, a level of detail may show on screen
+
 #include "Actor.h"	// Get our deriving class
 #include "Chunk.h"	// Get access to the Chunk struct
 #include "VertexData.h"		// Get access to the vertex data struct
@@ -27,10 +29,17 @@ protected:
 	Cubemap*				_cubemap;	// The cubemap ptr
 	std::vector<Chunk>		_chunks;	// This will contain an array of chunks (elements)
 	std::vector<Material*>	_mats;	// This will contain our material data
+	std::vector<MeshLod>	_lods;	// Simplified levels of detail, coarser with each level
+	glm::vec3				_bs_centre;	// Bounding sphere centre (local space)
+	float					_bs_radius;	// Bounding sphere radius (local space, negative until calculated)
+	std::string				_source;	// Mesh file the buffers were uploaded from (empty if built from vertex data)
+
+	static glm::vec3		_lod_eye;	// Camera position levels of detail are picked for
+	static float			_lod_scale;		// Pixels covered by one unit at a distance of one (zero to always draw the full mesh)
 
 public:
 	// Default constructor
-	inline Mesh() { _t = MESH; }
+	inline Mesh() : _bs_radius(-1.0f) { _t = MESH; }
 
 	// Deconstructor
 	inline ~Mesh() { if (_vao) delete _vao; }
@@ -43,18 +52,90 @@ public:
 	inline Cubemap* GetCubemap() { return _cubemap; }	// Return the cubemap ptr
 	inline std::vector<Chunk> &GetChunks() { return _chunks; }	// This returns our chunk list
 	inline std::vector<Material*> &GetMaterials() { return _mats; }		// Return our materials
+	inline std::vector<MeshLod> &GetLods() { return _lods; }	// Return our levels of detail
+	inline const std::string &GetSource() { return _source; }	// Return the mesh file the buffers came from
 
 	inline void SetMeshType(unsigned int value) { _mt = value;  }	// Assign a value to our mesh type
 	inline void SetNumIndices(unsigned int value) { _num_indices = value; }		// Assign a value to our num_indices
 	inline void SetVao(Vao* value) { _vao = value; }	// Assign a value to our ebo
-	inline void SetVertexData(VertexData value) { _vd = value; }	// Assign a value to our vertex data
+	inline void SetVertexData(VertexData value) { _vd = value; _bs_radius = -1.0f; }	// Assign a value to our vertex data
 	inline void SetCubemap(Cubemap* value) { _cubemap = value; }	// Assign value ptr to cubemap ptr
 	inline void SetChunks(std::vector<Chunk> &value) { _chunks = value; }	// Assign a value to our chunks
 	inline void SetMaterials(std::vector<Material*> &value) { _mats = value; }	// Assign a value to our materials
+	inline void SetBounds(const glm::vec3 &centre, float radius) { _bs_centre = centre; _bs_radius = radius; }	// Assign a local bounding sphere (for meshes without vertex data on the CPU)
+	inline void SetSource(const std::string &value) { _source = value; }	// Assign the mesh file the buffers came from (for meshes without vertex data on the CPU)
+
+	// Assign levels of detail, bounding the positions now so the render thread never has to
+	inline void SetLods(std::vector<MeshLod> &value)
+	{
+		_lods = value;	// Assign levels
+
+		if (_bs_radius < 0.0f && !_vd.positions.empty())	// If the local sphere hasn't been calculated
+			Math::BoundingSpherev3(_vd.positions.data(), _vd.positions.size(), _bs_centre, _bs_radius);	// Bound positions
+	}
+
+	// Assign the camera levels of detail are picked for, once per frame so every pass draws the same levels
+	static inline void SetLodView(const glm::vec3 &eye, const glm::mat4 &proj, float viewport_height)
+	{
+		_lod_eye = eye;		// Assign camera position
+		_lod_scale = proj[1][1] * viewport_height * 0.5f;	// Pixels per unit at unit distance
+	}
+
+	// Return the chunks to draw, picking the coarsest level whose error projects to no more than MESH_LOD_PIXEL_ERROR pixels
+	inline std::vector<Chunk> &GetLodChunks()
+	{
+		if (_lods.empty() || _bs_radius < 0.0f || _lod_scale <= 0.0f)	// If there is nothing to pick from
+			return _chunks;		// Draw the full mesh
+
+		const glm::mat4 &mat = GetRenderMatrix();	// Model matrix being drawn
+		float scale = Collision::Ndc::Data::MaxScale(mat);	// Largest model scale
+		float distance = glm::length(glm::vec3(mat * glm::vec4(_bs_centre, 1.0f)) - _lod_eye) - _bs_radius * scale;		// Distance to the nearest point of the bounding sphere
+		if (distance <= 0.0f)	// If the camera is inside the sphere
+			return _chunks;		// Draw the full mesh
+
+		float pixels = scale * _lod_scale / distance;	// Pixels covered by one mesh unit
+		size_t level = 0;	// Chosen level (zero is the full mesh)
+		while (level < _lods.size() && _lods[level]._error * pixels <= MESH_LOD_PIXEL_ERROR)	// While the next level is still accurate enough
+			level++;	// Take it
+
+		return level ? _lods[level - 1]._chunks : _chunks;	// Return chosen chunks
+	}
+
+	// Output the bounding sphere moved by a model matrix: the simulation matrix for the broad phase, or the matrix being drawn for culling
+	// Collision data already keeps a local sphere, otherwise the vertex positions are bounded once
+	inline void GetWorldSphere(const glm::mat4 &mat, glm::vec3 &out_centre, float &out_radius)
+	{
+		glm::vec3 centre = _bs_centre;	// Local centre
+		float radius = _bs_radius;	// Local radius
+
+		if (_cd)	// If there is collision data
+		{
+			centre = _cd->a;	// Assign local centre
+			radius = _cd->r;	// Assign local radius
+		}
+		else if (_bs_radius < 0.0f)	// If the local sphere hasn't been calculated
+		{
+			if (_vd.positions.empty())	// If there are no positions to bound
+			{
+				out_centre = glm::vec3(mat[3]);		// Assign origin
+				out_radius = FLT_MAX;	// Never cull
+				return;		// Return from function
+			}
+
+			Math::BoundingSpherev3(_vd.positions.data(), _vd.positions.size(), _bs_centre, _bs_radius);	// Bound positions
+			centre = _bs_centre; radius = _bs_radius;
+		}
+
+		out_centre = glm::vec3(mat * glm::vec4(centre, 1.0f));	// Move centre into world space
+		out_radius = radius * Collision::Ndc::Data::MaxScale(mat);	// Scale radius into world space
+	}
 
 	// Virtual voids
 	inline virtual void Update(double &delta) {}
 	inline virtual void Render() {}
 };
 
+glm::vec3	Mesh::_lod_eye = glm::vec3(0.0f);	// No camera yet
+float		Mesh::_lod_scale = 0.0f;	// Draw full meshes until a camera is set
+
 #endif
\ No newline at end of file
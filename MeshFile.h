@@ -0,0 +1,603 @@
+#ifndef __MESH_FILE_H__
+#define __MESH_FILE_H__
+
+#define MESH_FILE_MAGIC		0x4853454D	// "MESH" as a little endian uint32
+#define MESH_FILE_VERSION	1	// Bump when a chunk layout changes
+#define MESH_FILE_ALIGN		16	// Every chunk starts on this byte boundary
+#define MESH_FILE_NAME		64	// Bytes kept for mesh and material names
+
+#define MESH_CHUNK_INFO		0x4F464E49	// "INFO" counts, layout and name
+#define MESH_CHUNK_VERTICES	0x54524556	// "VERT" interleaved vertices
+#define MESH_CHUNK_INDICES	0x58444E49	// "INDX" triangle indices
+#define MESH_CHUNK_BOUNDS	0x53444E42	// "BNDS" local bounds
+#define MESH_CHUNK_GROUPS	0x53505247	// "GRPS" index ranges and their material names
+#define MESH_CHUNK_LODS		0x53444F4C	// "LODS" level of detail index ranges (optional)
+
+#include <iostream>		// Get error output
+#include <fstream>	// Get file output
+#include <cstdint>	// Get fixed width types
+#include <cstddef>	// Get offsetof
+#include <cstring>	// Get string functions
+#include <charconv>		// Get from_chars
+#include <algorithm>	// Get min and max
+#include <vector>	// Get dynamic arrays
+#include <string>	// Get strings
+#include <glm/glm.hpp>	// Get 3D variables
+#include "MappedFile.h"		// Get memory mapped files
+#include "VertexData.h"		// Get vertex data and tangents
+#include "Chunk.h"	// Get draw ranges
+#include "Math.h"	// Get point bounds
+
+// File layout: header, chunk table, then each chunk aligned to MESH_FILE_ALIGN
+// Unknown chunks are skipped so later versions can add data without breaking older readers
+struct MeshFileHeader
+{
+	uint32_t	magic;	// MESH_FILE_MAGIC
+	uint32_t	version;	// MESH_FILE_VERSION
+	uint32_t	header_bytes;	// Size of this header (the chunk table follows it)
+	uint32_t	chunk_count;	// Entries in the chunk table
+	uint64_t	file_bytes;		// Size of the whole file, to catch truncation
+	uint32_t	reserved[2];
+};
+
+// Where a chunk lives in the file
+struct MeshFileChunk
+{
+	uint32_t	tag;	// MESH_CHUNK_ tag
+	uint32_t	reserved;
+	uint64_t	offset;		// Byte offset from the start of the file
+	uint64_t	bytes;	// Byte size
+};
+
+// Counts and layout of the mesh
+struct MeshFileInfo
+{
+	uint32_t	mesh_type;	// Mesh type
+	uint32_t	vertex_count;	// Vertices in the vertex chunk
+	uint32_t	index_count;	// Indices in the index chunk
+	uint32_t	vertex_stride;	// Bytes per vertex
+	uint32_t	group_count;	// Entries in the group chunk
+	uint32_t	reserved[3];
+	char		name[MESH_FILE_NAME];	// Mesh name (zero padded)
+};
+
+// One interleaved vertex, laid out as the geometry shaders read it (locations 0 to 3)
+struct MeshFileVertex
+{
+	float		position[3];	// Location 0
+	float		texcoord[3];	// Location 1
+	float		normal[3];	// Location 2
+	float		tangent[3];		// Location 3
+};
+
+// Local space bounds
+struct MeshFileBounds
+{
+	float		min[3];		// Box minimum
+	float		max[3];		// Box maximum
+	float		centre[3];	// Sphere centre
+	float		radius;		// Sphere radius
+};
+
+// A range of indices drawn with one material
+struct MeshFileGroup
+{
+	uint32_t	id;		// Chunk id
+	uint32_t	first;	// First index
+	uint32_t	count;	// Number of indices
+	uint32_t	reserved;
+	char		material[MESH_FILE_NAME];	// Material name (zero padded)
+};
+
+// A range of indices drawn in place of a group at one level of detail
+struct MeshFileLod
+{
+	uint32_t	level;	// Level, from one (zero is the full mesh)
+	uint32_t	id;		// Chunk id
+	uint32_t	first;	// First index
+	uint32_t	count;	// Number of indices
+	float		error;	// Error of the level, in mesh units
+	uint32_t	reserved[3];
+};
+
+static_assert(sizeof(MeshFileHeader) == 32 && sizeof(MeshFileChunk) == 24 && sizeof(MeshFileInfo) == 96, "Mesh file structs must match the file layout");
+static_assert(sizeof(MeshFileVertex) == 48 && sizeof(MeshFileBounds) == 40 && sizeof(MeshFileGroup) == 80 && sizeof(MeshFileLod) == 32, "Mesh file structs must match the file layout");
+
+// A binary mesh file mapped into memory, checked once on open and then read straight from the mapped pages
+class MeshFile
+{
+private:
+	MappedFile				_file;	// Mapped file
+	const MeshFileInfo*		_info;	// Counts and layout
+	const MeshFileVertex*	_vertices;	// Interleaved vertices
+	const unsigned int*		_indices;	// Triangle indices
+	const MeshFileBounds*	_bounds;	// Local bounds
+	const MeshFileGroup*	_groups;	// Index ranges
+	const MeshFileLod*		_lods;	// Level of detail ranges
+	uint32_t				_lod_count;		// Number of level of detail ranges
+
+	// Copy a zero padded name out of the file
+	static inline std::string ReadName(const char* name)
+	{
+		size_t n = 0;	// Length
+		while (n < MESH_FILE_NAME && name[n]) n++;	// Stop at the padding or the end of the field
+		return std::string(name, n);	// Return name
+	}
+
+	// Copy a name into a zero padded field, cutting it if it doesn't fit
+	static inline void WriteName(char* out, const std::string &name)
+	{
+		memset(out, 0, MESH_FILE_NAME);		// Pad
+		memcpy(out, name.c_str(), std::min(name.size(), (size_t)MESH_FILE_NAME - 1));	// Copy name
+	}
+
+	// Skip spaces and tabs
+	static inline const char* SkipSpace(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t')) p++;	// Skip blanks
+		return p;	// Return first non blank
+	}
+
+	// Read the next word of a line
+	static inline std::string ReadWord(const char* &p, const char* end)
+	{
+		p = SkipSpace(p, end);	// Find token
+		const char* s = p;	// Word start
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;	// Find word end
+		return std::string(s, p);	// Return word
+	}
+
+	// Read the next numbers of a line, returns false if one is missing
+	template <typename T>
+	static inline bool ReadNumbers(const char* &p, const char* end, T* out, int count)
+	{
+		for (int i = 0; i < count; i++)		// Iterate through each wanted number
+		{
+			p = SkipSpace(p, end);	// Find token
+			if (p < end && *p == '+') p++;	// from_chars doesn't take a leading plus
+
+			std::from_chars_result r = std::from_chars(p, end, out[i]);		// Parse in place
+			if (r.ec != std::errc())	// If there was no number
+				return false;	// Return false
+
+			p = r.ptr;	// Consume number
+		}
+
+		return true;	// Return true
+	}
+
+	// Check the header, chunk table and counts so the data can be used without further checks
+	inline bool Validate()
+	{
+		const char* data = _file.Data();	// File start
+		size_t size = _file.Size();		// File size
+
+		if (size < sizeof(MeshFileHeader))	// If there isn't room for a header
+		{
+			std::cerr << "Mesh Error: The file is too small to be a mesh!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		const MeshFileHeader* h = (const MeshFileHeader*)data;	// Header
+		if (h->magic != MESH_FILE_MAGIC)	// If this isn't a binary mesh
+		{
+			if (data[0] == 'm')		// If this is a text mesh
+				std::cerr << "Mesh Error: The file is an old text mesh! Convert it with DataIO::Convert::TextMeshI.\n";	// Print out error message
+			else
+				std::cerr << "Mesh Error: The file is not a mesh!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		if (h->version != MESH_FILE_VERSION)	// If the layout is different
+		{
+			std::cerr << "Mesh Error: The file is version " << h->version << ", expected " << MESH_FILE_VERSION << "!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		if (h->file_bytes != size || h->header_bytes < sizeof(MeshFileHeader) || h->header_bytes % 8 != 0 || h->header_bytes > size ||
+			h->chunk_count > (size - h->header_bytes) / sizeof(MeshFileChunk))	// If the file was cut short or the table doesn't fit
+		{
+			std::cerr << "Mesh Error: The file is truncated or corrupt!\n";		// Print out error message
+			return false;	// Return false
+		}
+
+		const MeshFileChunk* table = (const MeshFileChunk*)(data + h->header_bytes);	// Chunk table
+		const MeshFileChunk* info = NULL, *vertices = NULL, *indices = NULL, *bounds = NULL, *groups = NULL, *lods = NULL;	// Known chunks
+
+		for (uint32_t i = 0; i < h->chunk_count; i++)	// Iterate through each chunk
+		{
+			const MeshFileChunk &c = table[i];	// Chunk
+			if (c.offset % MESH_FILE_ALIGN != 0 || c.offset > size || c.bytes > size - c.offset)	// If the chunk is outside the file
+			{
+				std::cerr << "Mesh Error: Chunk " << i << " is outside the file!\n";	// Print out error message
+				return false;	// Return false
+			}
+
+			const MeshFileChunk** slot = NULL;	// Where a known chunk goes
+			switch (c.tag)
+			{
+			case MESH_CHUNK_INFO: slot = &info; break;
+			case MESH_CHUNK_VERTICES: slot = &vertices; break;
+			case MESH_CHUNK_INDICES: slot = &indices; break;
+			case MESH_CHUNK_BOUNDS: slot = &bounds; break;
+			case MESH_CHUNK_GROUPS: slot = &groups; break;
+			case MESH_CHUNK_LODS: slot = &lods; break;
+			default: continue;	// Skip chunks from later versions
+			}
+
+			if (*slot)	// If the chunk was already seen
+			{
+				std::cerr << "Mesh Error: Chunk " << i << " is repeated!\n";	// Print out error message
+				return false;	// Return false
+			}
+
+			*slot = &c;		// Record chunk
+		}
+
+		if (!info || !vertices || !indices || !bounds || !groups || info->bytes < sizeof(MeshFileInfo) || bounds->bytes < sizeof(MeshFileBounds))	// If a chunk is missing
+		{
+			std::cerr << "Mesh Error: The file is missing a chunk!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		const MeshFileInfo* in = (const MeshFileInfo*)(data + info->offset);	// Counts
+		if (in->vertex_stride != sizeof(MeshFileVertex) || vertices->bytes != (uint64_t)in->vertex_count * in->vertex_stride ||
+			indices->bytes != (uint64_t)in->index_count * sizeof(unsigned int) || in->index_count % 3 != 0 ||
+			groups->bytes != (uint64_t)in->group_count * sizeof(MeshFileGroup) || (lods && lods->bytes % sizeof(MeshFileLod) != 0))	// If the counts don't match the chunks
+		{
+			std::cerr << "Mesh Error: The chunk sizes don't match the mesh info!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		const unsigned int* idx = (const unsigned int*)(data + indices->offset);	// Indices
+		const MeshFileGroup* grp = (const MeshFileGroup*)(data + groups->offset);	// Groups
+
+		for (uint32_t i = 0; i < in->group_count; i++)	// Iterate through each group
+		{
+			if ((uint64_t)grp[i].first + grp[i].count > in->index_count)	// If the range is outside the indices
+			{
+				std::cerr << "Mesh Error: Group " << i << " is outside the indices!\n";		// Print out error message
+				return false;	// Return false
+			}
+
+			if (grp[i].id >= in->group_count)	// If the id would index past the materials
+			{
+				std::cerr << "Mesh Error: Group " << i << " has an id outside the groups!\n";		// Print out error message
+				return false;	// Return false
+			}
+		}
+
+		const MeshFileLod* lod = lods ? (const MeshFileLod*)(data + lods->offset) : NULL;	// Levels of detail
+		uint32_t lod_count = lods ? (uint32_t)(lods->bytes / sizeof(MeshFileLod)) : 0;
+
+		for (uint32_t i = 0; i < lod_count; i++)	// Iterate through each level of detail range
+			if (lod[i].level == 0 || lod[i].id >= in->group_count || (uint64_t)lod[i].first + lod[i].count > in->index_count)	// If the range is outside the indices or its id outside the groups
+			{
+				std::cerr << "Mesh Error: Level of detail range " << i << " is invalid!\n";		// Print out error message
+				return false;	// Return false
+			}
+
+		unsigned int hi = 0;	// Largest index
+		for (uint32_t i = 0; i < in->index_count; i++)	// Iterate through each index
+			hi = std::max(hi, idx[i]);	// Branch free so the scan runs at memory speed
+
+		if (in->index_count > 0 && hi >= in->vertex_count)	// If an index is outside the vertices
+		{
+			std::cerr << "Mesh Error: An index is outside the vertices!\n";		// Print out error message
+			return false;	// Return false
+		}
+
+		_info = in;		// Everything checked out
+		_vertices = (const MeshFileVertex*)(data + vertices->offset);
+		_indices = idx;
+		_bounds = (const MeshFileBounds*)(data + bounds->offset);
+		_groups = grp;
+		_lods = lod;
+		_lod_count = lod_count;
+
+		return true;	// Return true
+	}
+
+public:
+	// Default constructor
+	inline MeshFile() : _info(NULL), _vertices(NULL), _indices(NULL), _bounds(NULL), _groups(NULL), _lods(NULL), _lod_count(0) {}
+
+	// Map and check a mesh file, returns false if it can't be used
+	inline bool Open(const char* file)
+	{
+		Close();	// Release any previous file
+
+		if (!_file.Open(file))	// If the file couldn't be mapped
+			return false;	// Return false
+
+		if (!Validate())	// If the file is broken
+		{
+			Close();	// Release file
+			return false;	// Return false
+		}
+
+		return true;	// Return true
+	}
+
+	// Unmap the file, every pointer returned from it becomes invalid
+	inline void Close()
+	{
+		_file.Close();	// Unmap file
+		_info = NULL;
+		_vertices = NULL;
+		_indices = NULL;
+		_bounds = NULL;
+		_groups = NULL;
+		_lods = NULL;
+		_lod_count = 0;
+	}
+
+	inline std::string GetName() const { return ReadName(_info->name); }	// Return the mesh name
+	inline unsigned int GetMeshType() const { return _info->mesh_type; }	// Return the mesh type
+	inline unsigned int GetVertexCount() const { return _info->vertex_count; }		// Return the number of vertices
+	inline unsigned int GetIndexCount() const { return _info->index_count; }	// Return the number of indices
+	inline const MeshFileVertex* GetVertices() const { return _vertices; }	// Return the mapped vertices
+	inline const unsigned int* GetIndices() const { return _indices; }	// Return the mapped indices
+	inline const MeshFileBounds &GetBounds() const { return *_bounds; }		// Return the local bounds
+	inline unsigned int GetGroupCount() const { return _info->group_count; }	// Return the number of groups
+	inline Chunk GetChunk(unsigned int i) const { return Chunk(_groups[i].first * sizeof(unsigned int), _groups[i].count, _groups[i].id); }	// Return a group as a draw range (byte offset)
+	inline std::string GetMaterialName(unsigned int i) const { return ReadName(_groups[i].material); }	// Return the material name of a group
+
+	// Copy the mapped vertices and indices out into vertex data, so a mesh loaded without CPU data can be saved again
+	inline void GetVertexData(VertexData &out_vd) const
+	{
+		size_t n = _info->vertex_count;		// Vertex count
+		out_vd.positions.resize(n);
+		out_vd.texcoords.resize(n);
+		out_vd.normals.resize(n);
+		out_vd.tangents.resize(n);
+
+		for (size_t i = 0; i < n; i++)	// Iterate through each vertex
+		{
+			const MeshFileVertex &v = _vertices[i];		// Interleaved vertex
+			out_vd.positions[i] = glm::vec3(v.position[0], v.position[1], v.position[2]);
+			out_vd.texcoords[i] = glm::vec3(v.texcoord[0], v.texcoord[1], v.texcoord[2]);
+			out_vd.normals[i] = glm::vec3(v.normal[0], v.normal[1], v.normal[2]);
+			out_vd.tangents[i] = glm::vec3(v.tangent[0], v.tangent[1], v.tangent[2]);
+		}
+
+		out_vd.indices.assign(_indices, _indices + _info->index_count);	// Copy indices
+	}
+
+	// Output the levels of detail, ranges are listed by level so each level gathers its chunks in order
+	inline void GetLods(std::vector<MeshLod> &out_lods) const
+	{
+		out_lods.clear();	// Reset
+		for (uint32_t i = 0; i < _lod_count; i++)	// Iterate through each range
+		{
+			const MeshFileLod &l = _lods[i];	// Range
+			if (out_lods.size() < l.level)	// If the level is new
+				out_lods.resize(l.level);	// Add it
+
+			MeshLod &lod = out_lods[l.level - 1];	// Level
+			lod._chunks.push_back(Chunk(l.first * sizeof(unsigned int), l.count, l.id));	// Add the range (byte offset)
+			lod._error = std::max(lod._error, l.error);
+		}
+	}
+
+	// Write a mesh to a binary file, chunks hold byte offsets as drawn and materials line up with the chunks
+	// Levels of detail are optional and index the same buffers
+	static inline bool Write(const char* file, const std::string &name, unsigned int mesh_type, VertexData &vd, std::vector<Chunk> &chunks, std::vector<std::string> &materials, const std::vector<MeshLod> &lods = std::vector<MeshLod>())
+	{
+		size_t n = vd.positions.size();		// Vertex count
+
+		MeshFileInfo info;	// Counts
+		memset(&info, 0, sizeof(info));
+		info.mesh_type = mesh_type;
+		info.vertex_count = (uint32_t)n;
+		info.index_count = (uint32_t)vd.indices.size();
+		info.vertex_stride = sizeof(MeshFileVertex);
+		info.group_count = (uint32_t)chunks.size();
+		WriteName(info.name, name);
+
+		std::vector<MeshFileVertex> vertices(n);	// Interleave attributes, missing ones are zero
+		for (size_t i = 0; i < n; i++)	// Iterate through each vertex
+		{
+			glm::vec3 t = i < vd.texcoords.size() ? vd.texcoords[i] : glm::vec3(0.0f);		// Texcoord
+			glm::vec3 nm = i < vd.normals.size() ? vd.normals[i] : glm::vec3(0.0f);		// Normal
+			glm::vec3 tg = i < vd.tangents.size() ? vd.tangents[i] : glm::vec3(0.0f);	// Tangent
+
+			for (int k = 0; k < 3; k++)		// Iterate through each component
+			{
+				vertices[i].position[k] = vd.positions[i][k];
+				vertices[i].texcoord[k] = t[k];
+				vertices[i].normal[k] = nm[k];
+				vertices[i].tangent[k] = tg[k];
+			}
+		}
+
+		MeshFileBounds bounds;	// Local bounds
+		glm::vec3 lo, hi, centre;	// Box and sphere
+		float radius;
+		Math::Boundsv3(vd.positions.data(), n, lo, hi);
+		Math::BoundingSpherev3(vd.positions.data(), n, centre, radius);
+		if (n == 0) lo = hi = glm::vec3(0.0f);	// Empty meshes have empty bounds
+		for (int k = 0; k < 3; k++)		// Iterate through each component
+		{
+			bounds.min[k] = lo[k];
+			bounds.max[k] = hi[k];
+			bounds.centre[k] = centre[k];
+		}
+		bounds.radius = radius;
+
+		std::vector<MeshFileGroup> groups(chunks.size());	// Index ranges
+		for (size_t i = 0; i < chunks.size(); i++)	// Iterate through each chunk
+		{
+			memset(&groups[i], 0, sizeof(MeshFileGroup));
+			groups[i].id = chunks[i]._id;
+			groups[i].first = chunks[i]._index_offset / sizeof(unsigned int);	// Byte offset to index
+			groups[i].count = chunks[i]._index_count;
+			WriteName(groups[i].material, i < materials.size() ? materials[i] : "");
+		}
+
+		std::vector<MeshFileLod> ranges;	// Level of detail ranges
+		for (size_t l = 0; l < lods.size(); l++)	// Iterate through each level
+			for (const Chunk &c : lods[l]._chunks)	// Iterate through each chunk
+			{
+				MeshFileLod r;
+				memset(&r, 0, sizeof(r));
+				r.level = (uint32_t)(l + 1);
+				r.id = c._id;
+				r.first = c._index_offset / sizeof(unsigned int);	// Byte offset to index
+				r.count = c._index_count;
+				r.error = lods[l]._error;
+				ranges.push_back(r);
+			}
+
+		int chunk_count = ranges.empty() ? 5 : 6;	// Only write levels of detail if there are some
+		const void* src[6] = { &info, vertices.data(), vd.indices.data(), &bounds, groups.data(), ranges.data() };	// Chunk data in file order
+		uint32_t tags[6] = { MESH_CHUNK_INFO, MESH_CHUNK_VERTICES, MESH_CHUNK_INDICES, MESH_CHUNK_BOUNDS, MESH_CHUNK_GROUPS, MESH_CHUNK_LODS };
+		uint64_t bytes[6] = { sizeof(info), n * sizeof(MeshFileVertex), vd.indices.size() * sizeof(unsigned int), sizeof(bounds), groups.size() * sizeof(MeshFileGroup), ranges.size() * sizeof(MeshFileLod) };
+
+		MeshFileHeader header;	// Header
+		memset(&header, 0, sizeof(header));
+		header.magic = MESH_FILE_MAGIC;
+		header.version = MESH_FILE_VERSION;
+		header.header_bytes = sizeof(MeshFileHeader);
+		header.chunk_count = chunk_count;
+
+		MeshFileChunk table[6];		// Chunk table
+		uint64_t at = sizeof(MeshFileHeader) + chunk_count * sizeof(MeshFileChunk);	// First free byte
+		for (int i = 0; i < chunk_count; i++)		// Iterate through each chunk
+		{
+			at = (at + MESH_FILE_ALIGN - 1) / MESH_FILE_ALIGN * MESH_FILE_ALIGN;	// Align
+			table[i].tag = tags[i];
+			table[i].reserved = 0;
+			table[i].offset = at;
+			table[i].bytes = bytes[i];
+			at += bytes[i];
+		}
+		header.file_bytes = at;
+
+		std::ofstream f(file, std::ios::out | std::ios::binary | std::ios::trunc);	// Create a new file
+		if (!f.is_open())	// If the file couldn't be created
+		{
+			std::cerr << "Mesh Error: The file couldn't be created!\n";		// Print out error message
+			return false;	// Return false
+		}
+
+		f.write((const char*)&header, sizeof(header));	// Write header
+		f.write((const char*)table, chunk_count * sizeof(MeshFileChunk));		// Write chunk table
+
+		static const char pad[MESH_FILE_ALIGN] = {};	// Zero padding
+		uint64_t written = sizeof(header) + chunk_count * sizeof(MeshFileChunk);	// Bytes written
+		for (int i = 0; i < chunk_count; i++)		// Iterate through each chunk
+		{
+			f.write(pad, table[i].offset - written);	// Pad to the chunk
+			if (bytes[i]) f.write((const char*)src[i], bytes[i]);	// Write chunk
+			written = table[i].offset + bytes[i];
+		}
+
+		if (!f)		// If a write failed
+		{
+			std::cerr << "Mesh Error: The file couldn't be written!\n";		// Print out error message
+			return false;	// Return false
+		}
+
+		return true;	// Return true
+	}
+
+	// Convert an old text mesh into a binary one, tangents are calculated since the text format never stored them
+	// The old importer stored each chunk's end index where the count goes, so counts that run past the indices are read as end indices
+	static inline bool ConvertText(const char* text_file, const char* file)
+	{
+		MappedFile in;	// Text file
+		if (!in.Open(text_file))	// If the file couldn't be mapped
+			return false;	// Return false
+
+		std::string name;	// Mesh name
+		unsigned int type = 0;	// Mesh type
+		VertexData vd;	// Vertex data
+		std::vector<Chunk> chunks;	// Draw ranges
+		std::vector<std::string> materials;		// Material names
+		bool bad = false;	// Was a line malformed?
+
+		const char* p = in.Data();	// Cursor
+		const char* end = p + in.Size();	// End of file
+		while (p < end)		// Iterate through each line
+		{
+			p = SkipSpace(p, end);	// Find the line type
+			char c = p < end ? *p : '\n';	// Line type
+			if (c != '\n') p++;	// Consume it, blank lines keep their newline
+			float f[3] = { 0.0f, 0.0f, 0.0f };	// Floats
+			unsigned int u[3];	// Integers
+
+			switch (c)
+			{
+			case 'm':	// Mesh type and name
+				bad |= !ReadNumbers(p, end, &type, 1);
+				name = ReadWord(p, end);
+				break;
+			case 'c':	// Chunk id, byte offset, index count and material
+				if (ReadNumbers(p, end, u, 3))
+				{
+					chunks.push_back(Chunk(u[1], u[2], u[0]));
+					materials.push_back(ReadWord(p, end));
+				}
+				else bad = true;
+				break;
+			case 'p':	// Position
+				bad |= !ReadNumbers(p, end, f, 3);
+				vd.positions.push_back(glm::vec3(f[0], f[1], f[2]));
+				break;
+			case 't':	// Texcoord
+				bad |= !ReadNumbers(p, end, f, 2);
+				vd.texcoords.push_back(glm::vec3(f[0], f[1], 0.0f));
+				break;
+			case 'n':	// Normal
+				bad |= !ReadNumbers(p, end, f, 3);
+				vd.normals.push_back(glm::vec3(f[0], f[1], f[2]));
+				break;
+			case 'i':	// Index
+				if (ReadNumbers(p, end, u, 1)) vd.indices.push_back(u[0]);
+				else bad = true;
+				break;
+			}
+
+			const char* nl = (const char*)memchr(p, '\n', end - p);	// Find line end
+			p = nl ? nl + 1 : end;	// Next line
+		}
+
+		if (bad)	// If something was skipped
+			std::cerr << "Mesh Warning: Some lines of the text mesh were malformed!\n";		// Print out warning
+
+		for (unsigned int i : vd.indices)	// Iterate through each index
+			if (i >= vd.positions.size())	// If it points outside the vertices
+			{
+				std::cerr << "Mesh Error: The text mesh has an index outside its vertices!\n";	// Print out error message
+				return false;	// Return false
+			}
+
+		if (vd.indices.size() % 3 != 0)		// If the last triangle is cut short
+		{
+			std::cerr << "Mesh Error: The text mesh has a partial triangle!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		for (Chunk &c : chunks)		// Iterate through each chunk
+		{
+			uint64_t first = c._index_offset / sizeof(unsigned int);	// First index
+			if (first + c._index_count > vd.indices.size() && c._index_count >= first && c._index_count <= vd.indices.size())	// If the count is an end index, as the old importer stored it
+				c._index_count -= (unsigned int)first;	// Convert it to a count
+
+			if (c._index_offset % sizeof(unsigned int) != 0 || first + c._index_count > vd.indices.size() || c._id >= chunks.size())	// If the range is outside the indices or the id outside the chunks
+			{
+				std::cerr << "Mesh Error: The text mesh has a chunk outside its indices or chunks!\n";	// Print out error message
+				return false;	// Return false
+			}
+		}
+
+		vd.tangents.assign(vd.positions.size(), glm::vec3(0.0f));	// Assign empty tangents ready for calculation
+		if (vd.texcoords.size() == vd.positions.size() && vd.normals.size() == vd.positions.size())		// If every vertex has a texcoord and normal
+			CalculateTangents(vd);	// Calculate tangents for each triangle
+
+		return Write(file, name, type, vd, chunks, materials);	// Write binary mesh
+	}
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef __MOUSE_H__
 #define __MOUSE_H__
 
+#ifndef NOMINMAX
+#define NOMINMAX	// No min and max macros
+#endif
 #include <Windows.h>
 
 
@@ -5,10 +5,20 @@
 #ifndef __OBJ_LOADER_H__
 #define __OBJ_LOADER_H__
 
+#define OBJ_MIN_CHUNK_BYTES	(1 << 20)	// Smallest piece of a file parsed by one job
+
 #include <iostream>
 #include <fstream>
-#include <glm\glm.hpp>
+#include <vector>	// Get dynamic arrays
+#include <string>	// Get strings
+#include <cstring>	// Get memchr
+#include <charconv>		// Get from_chars
+#include <algorithm>	// Get find and binary search
+#include <atomic>	// Get atomics
+#include <glm/glm.hpp>
 #include "Vao.h"
+#include "MappedFile.h"	// Get memory mapped files
+#include "JobSystem.h"	// Get worker threads
 
 
 // The wavefront namespace contains global functions for loading .obj format files and utilities for optimising vertex data for buffer objects
@@ -39,120 +49,375 @@ namespace Wavefront
 		inline ObjData() : o("") {}
 	};
 
-	// This function loads data from a wavefront: obj file and returns the data
-	inline bool Import(const char* file, ObjData &out_obj)
+	// A vertex of a face as indices into the position, texcoord and normal lists (0 based, -1 when missing)
+	struct ObjCorner
+	{
+		int v, vt, vn;	// Position, texcoord and normal index
+	};
+
+	// A run of face corners that use one material
+	struct ObjMaterialRun
+	{
+		size_t		from;	// First corner
+		std::string	name;	// Material name
+	};
+
+	// Everything parsed from one line aligned piece of a file, with indices as written (negative ones are fixed up against the running counts)
+	struct ObjChunk
+	{
+		std::vector<glm::vec3>		v;	// Positions
+		std::vector<glm::vec3>		vt;		// Texcoords
+		std::vector<glm::vec3>		vn;		// Normals
+		std::vector<ObjCorner>		f;	// Face corners, three per triangle
+		std::vector<std::pair<size_t, int>>	rel;	// Corners holding relative indices and which ones (1 v, 2 vt, 4 vn), to offset by the earlier chunks
+		std::vector<ObjMaterialRun>	u;	// Material switches, in order
+		std::string					o;	// Last object name
+		bool						bad;	// Was a line malformed?
+
+		inline ObjChunk() : bad(false) {}
+	};
+
+	// Skip spaces and tabs
+	inline static const char* SkipSpace(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t')) p++;	// Skip blanks
+		return p;	// Return first non blank
+	}
+
+	// Skip to the start of the next line
+	inline static const char* NextLine(const char* p, const char* end)
 	{
-		ObjData obj;	// To store our in / out data
+		const char* n = (const char*)memchr(p, '\n', end - p);	// Find line end
+		return n ? n + 1 : end;		// Return next line
+	}
 
-		std::ifstream _in(file);	// Check if the file is valid
-		if (!_in)	// If the file is invalid...
+	// Read up to count floats from a line into out (missing ones stay as they were), returns the number read
+	inline static int ParseFloats(const char* &p, const char* end, float* out, int count)
+	{
+		int n = 0;	// Floats read
+		while (n < count)	// Iterate through each wanted float
 		{
-			std::cout << "Wavefront Import Error: The file is invalid! Check that the file exists.\n";	// Print out error message
-			return false;	// Return false as failed
+			p = SkipSpace(p, end);	// Find token
+			if (p < end && *p == '+') p++;	// from_chars doesn't take a leading plus
+
+			std::from_chars_result r = std::from_chars(p, end, out[n]);	// Parse in place
+			if (r.ec != std::errc())	// If there was no number
+				break;	// Stop
+
+			p = r.ptr;	// Consume number
+			n++;
 		}
 
-		char data[256];		// Create a buffer for each line in the file
-		std::vector <std::string> line;		// This will contain our text from the buffer
-		while (_in.getline(data, 256))	// While each line is being read...
-			line.push_back(data);	// Assign the data to our string container
-		
-		bool mat_id_exists = false;		// This will check if the newly discovered material already exists
-		int current_group = 0;	// This will record the number of groups
-		unsigned int mat_ids = -1;	// This will store each mat id value for multiple material bindings
-		std::string obj_name = "";	// This will store the object's name from the file
+		return n;	// Return floats read
+	}
+
+	// Read one face vertex (v, v/vt, v//vn or v/vt/vn), returns false at the end of the line
+	inline static bool ParseCorner(const char* &p, const char* end, int* out_idx, bool &out_bad)
+	{
+		p = SkipSpace(p, end);	// Find token
+		if (p >= end || *p == '\r' || *p == '\n' || *p == '#')	// If the line is over
+			return false;	// Return false
 
-		for (unsigned int i = 0; i < line.size(); i++)	// Iterate through each line...
+		out_idx[0] = out_idx[1] = out_idx[2] = 0;	// Missing indices read as 0
+		for (int k = 0; k < 3; k++)		// Iterate through each index of the vertex
 		{
-			switch ((line[i])[0])	// Check the value of the first character of each line
+			if (k > 0)	// If this isn't the position
+			{
+				if (p >= end || *p != '/')	// If there are no more indices
+					break;	// Stop
+				p++;	// Consume slash
+
+				if (p < end && *p == '/')	// If the index is empty (v//vn)
+					continue;	// Next index
+			}
+
+			std::from_chars_result r = std::from_chars(p, end, out_idx[k]);		// Parse in place
+			if (r.ec != std::errc() || out_idx[k] == 0)		// If there was no index
+			{
+				out_bad = true;		// Flag line
+				p = NextLine(p, end) - 1;	// Give up on the line
+				return false;	// Return false
+			}
+
+			p = r.ptr;	// Consume index
+		}
+
+		return true;	// Return true
+	}
+
+	// Turn one written index into a 0 based index, relative ones become chunk local (offset by the earlier chunks when merging), returns true if it was relative
+	inline static bool ResolveIndex(int &idx, size_t count)
+	{
+		if (idx > 0) { idx -= 1; return false; }	// Absolute index
+		if (idx < 0) { idx = (int)count + idx; return true; }	// Relative to the last element so far
+		idx = -1;	// Missing
+		return false;
+	}
+
+	// Add a face corner, remembering it if it holds relative indices
+	inline static void AddCorner(ObjChunk &chunk, const ObjCorner &c, int rel)
+	{
+		if (rel)	// If an index was relative
+			chunk.rel.push_back(std::make_pair(chunk.f.size(), rel));	// Remember to offset it
+		chunk.f.push_back(c);	// Add corner
+	}
+
+	// Parse the lines of [p, end) into a chunk
+	inline static void ParseChunk(const char* p, const char* end, ObjChunk &out_chunk)
+	{
+		while (p < end)		// Iterate through each line
+		{
+			p = SkipSpace(p, end);	// Skip indentation
+			if (p >= end)	// If we're at the end
+				break;	// Stop
+
+			const char* line = p;	// Line start
+			switch (*p)		// Check the value of the first character of each line
 			{
 			case 'v':	// If the character is a 'v'...
-				float x, y, z;	// Create temp variables for vertices
-				char chars[128];	// Create temp variable for character data
-				if ((line[i])[1] == 'n')	// If the second character is 'n'...
+			{
+				float f[3] = { 0.0f, 0.0f, 0.0f };	// Temp variables for vertices
+				char c = (p + 1 < end) ? p[1] : '\n';	// Second character
+
+				if (c == ' ' || c == '\t')	// If this is a position
 				{
-					sscanf_s((&line[i])[0].c_str(), "vn %f %f %f", &x, &y, &z);		// Scan this line and store the three floats to our temp variables
-					obj.vn.push_back(glm::vec3(x, y, z));	// Record this data
+					p++;
+					if (ParseFloats(p, end, f, 3) < 3) out_chunk.bad = true;	// Flag short lines
+					out_chunk.v.push_back(glm::vec3(f[0], f[1], f[2]));		// Record this data
 				}
-				if ((line[i])[1] == 't')	// If the second character is 't'...
+				else if (c == 't')	// If this is a texcoord
 				{
-					sscanf_s((&line[i])[0].c_str(), "vt %f %f", &x, &y);	// Scan this line and store the two floats to our temp variables
-					obj.vt.push_back(glm::vec3(x, -y, 0.0f));		// Record this data
+					p += 2;
+					if (ParseFloats(p, end, f, 2) < 1) out_chunk.bad = true;	// Flag short lines
+					out_chunk.vt.push_back(glm::vec3(f[0], -f[1], 0.0f));	// Record this data (flipped for OpenGL)
 				}
-				else if ((line[i])[1] == ' ')	// If the second character is nothing...
+				else if (c == 'n')	// If this is a normal
+				{
+					p += 2;
+					if (ParseFloats(p, end, f, 3) < 3) out_chunk.bad = true;	// Flag short lines
+					out_chunk.vn.push_back(glm::vec3(f[0], f[1], f[2]));	// Record this data
+				}
+				break;
+			}
+			case 'f':	// If the character is a 'f'...
+			{
+				p++;
+				ObjCorner first, last, c;	// Fan corners
+				int first_rel = 0, last_rel = 0, rel;	// Relative index flags of each
+				int idx[3], n = 0;	// Written indices, corners read
+				bool bad = false;	// Was the face malformed?
+
+				while (ParseCorner(p, end, idx, bad))	// Iterate through each corner
 				{
-					sscanf_s((&line[i])[0].c_str(), "v %f %f %f", &x, &y, &z);	// Scan this line and store the three floats to our temp variables
-					obj.v.push_back(glm::vec3(x, y, z));	// Record this data
+					rel = ResolveIndex(idx[0], out_chunk.v.size()) ? 1 : 0;		// Position
+					rel |= ResolveIndex(idx[1], out_chunk.vt.size()) ? 2 : 0;	// Texcoord
+					rel |= ResolveIndex(idx[2], out_chunk.vn.size()) ? 4 : 0;	// Normal
+					c = { idx[0], idx[1], idx[2] };
 
-					vcount++;
+					if (n >= 2)		// If there is a triangle, fan it from the first corner
+					{
+						AddCorner(out_chunk, first, first_rel);
+						AddCorner(out_chunk, last, last_rel);
+						AddCorner(out_chunk, c, rel);
+					}
+
+					if (n == 0) { first = c; first_rel = rel; }		// Fan root
+					last = c; last_rel = rel;	// Previous corner
+					n++;
 				}
-				
+
+				if (bad || n < 3) out_chunk.bad = true;		// Flag malformed faces
 				break;
+			}
+			case 'u':	// If the character is a 'u'...
 			case 'o':	// if the character is a 'o'...
-				sscanf_s((&line[i])[0].c_str(), "o %s", chars, 128);	// scan this line and store the chars to our temp variables
-				out_obj.o = chars;	// Assign the object name to the obj data
+			{
+				bool use = (*p == 'u');		// Is this a material?
+				const char* key = use ? "usemtl" : "o";		// Expected keyword
+				size_t len = use ? 6 : 1;
+
+				if ((size_t)(end - p) <= len || memcmp(p, key, len) != 0 || (p[len] != ' ' && p[len] != '\t'))	// If this is some other keyword
+					break;	// Ignore line
+
+				const char* s = SkipSpace(p + len, end);	// Name start
+				const char* e = s;	// Name end
+				while (e < end && *e != '\r' && *e != '\n') e++;	// Names run to the end of the line
+				while (e > s && (e[-1] == ' ' || e[-1] == '\t')) e--;	// Trim
+
+				if (use)	// If this is a material
+					out_chunk.u.push_back({ out_chunk.f.size(), std::string(s, e) });	// Record switch
+				else
+					out_chunk.o.assign(s, e);	// Assign the object name
 				break;
-			case 'u':
-				sscanf_s((&line[i])[0].c_str(), "usemtl %s", chars, 128);	// scan this line and store the chars to our temp variables
-				for (unsigned int j = 0; j < obj.u.size(); j++)	// Iterate through our mat names...
+			}
+			}
+
+			p = NextLine(std::max(p, line), end);	// Next line
+		}
+	}
+
+	// This function loads data from a wavefront: obj file and returns the data
+	// The file is mapped and cut into line aligned chunks that are parsed in parallel, then merged in file order
+	// Faces are triangulated as fans and may be v, v/vt, v//vn or v/vt/vn with negative (relative) indices; missing texcoords and normals read as zero
+	inline bool Import(const char* file, ObjData &out_obj)
+	{
+		MappedFile map;		// The whole file
+		if (!map.Open(file))	// If the file is invalid...
+		{
+			std::cout << "Wavefront Import Error: The file is invalid! Check that the file exists.\n";	// Print out error message
+			return false;	// Return false as failed
+		}
+
+		const char* data = map.Data();		// First byte
+		const char* end = data + map.Size();	// Past the last byte
+
+		// ------------------------- PARSE CHUNKS IN PARALLEL -------------------------
+		size_t target = std::max((size_t)OBJ_MIN_CHUNK_BYTES, map.Size() / (JobSystem::GetThreadCount() * 4) + 1);	// About four chunks per thread
+		std::vector<const char*> cuts(1, data);		// Chunk starts
+		while ((size_t)(end - cuts.back()) > target)	// Iterate until the rest fits one chunk
+			cuts.push_back(NextLine(cuts.back() + target, end));	// Cut after the next line break
+		if (cuts.back() >= end && cuts.size() > 1)	// If the last cut landed on the end
+			cuts.pop_back();	// Drop it
+		cuts.push_back(end);	// End of the last chunk
+
+		std::vector<ObjChunk> chunks(cuts.size() - 1);	// One result per chunk
+		JobSystem::ParallelFor(0, chunks.size(), 1, [&](size_t first, size_t last)	// Parse each chunk
+		{
+			for (size_t i = first; i < last; i++)
+				ParseChunk(cuts[i], cuts[i + 1], chunks[i]);
+		});
+
+		// ------------------------- MERGE VERTICES -------------------------
+		size_t nv = 0, nvt = 0, nvn = 0;	// Totals
+		std::vector<ObjCorner> base(chunks.size());		// Attribute counts before each chunk
+		for (size_t i = 0; i < chunks.size(); i++)	// Iterate through each chunk
+		{
+			base[i] = { (int)nv, (int)nvt, (int)nvn };	// Record bases
+			nv += chunks[i].v.size(); nvt += chunks[i].vt.size(); nvn += chunks[i].vn.size();	// Count
+			if (chunks[i].bad) std::cerr << "Wavefront Import Error: Skipped malformed lines in " << file << "!\n";	// Report bad lines once per chunk
+			if (!chunks[i].o.empty()) out_obj.o = chunks[i].o;	// The last object name wins
+		}
+
+		std::vector<glm::vec3> v, vt, vn;	// Whole file attributes
+		v.reserve(nv); vt.reserve(nvt); vn.reserve(nvn);
+		for (ObjChunk &c : chunks)	// Iterate through each chunk in order
+		{
+			v.insert(v.end(), c.v.begin(), c.v.end()); vt.insert(vt.end(), c.vt.begin(), c.vt.end()); vn.insert(vn.end(), c.vn.begin(), c.vn.end());
+			std::vector<glm::vec3>().swap(c.v); std::vector<glm::vec3>().swap(c.vt); std::vector<glm::vec3>().swap(c.vn);	// Free chunk copies
+		}
+		vcount += (int)nv;	// Count positions
+
+		// ------------------------- SPLIT FACES INTO MATERIAL GROUPS -------------------------
+		struct Run { size_t chunk, from, to, group, dest; };	// Corners [from, to) of a chunk that go to one group at dest
+		std::vector<Run> runs;	// Every run in file order
+		std::vector<size_t> group_size;		// Corners per group
+		std::vector<std::string> names;		// Group material names, in order of first use (no name for faces before any usemtl)
+		size_t current = (size_t)-1;	// Group of the current material
+
+		for (size_t i = 0; i < chunks.size(); i++)	// Iterate through each chunk
+		{
+			ObjChunk &c = chunks[i];
+			for (size_t r = 0; r <= c.u.size(); r++)	// Iterate through the runs between material switches
+			{
+				size_t from = (r == 0) ? 0 : c.u[r - 1].from;	// Run start
+				size_t to = (r == c.u.size()) ? c.f.size() : c.u[r].from;	// Run end
+
+				if (r > 0)	// If a material starts the run
 				{
-					if (chars == obj.u[j])	// If the found id matches any existing ids...
+					std::vector<std::string>::iterator it = std::find(names.begin(), names.end(), c.u[r - 1].name);		// Find existing material
+					current = it - names.begin();	// Reuse its group
+					if (it == names.end())	// If the material is new
 					{
-						mat_id_exists = true;	// Mat id already exists
-						current_group = j;	// Set the current group id back to this mat id again
-						break;
+						names.push_back(c.u[r - 1].name);	// Add another mat name
+						group_size.push_back(0);	// Create a new group (obj element)
 					}
 				}
-				if (!mat_id_exists)		// If the mat id doesn't already exist...
-				{
-					mat_ids++;	// Increment the number of materials being used
-					obj.u.push_back(chars);		// Add another mat to the mat string container
-					obj.g.push_back(Group());	// Create a new group (obj element)	
-					current_group = obj.g.size() - 1;	// Set the current group id to the group size
-				}
-				mat_id_exists = false;	// Set mat id exists to false ready for the next
-				break;
-			case 'f':	// If the character is a 'f'...
-				unsigned int v_i[3], vn_i[3], vt_i[3];	// Create temp variables for encapsulating face data
-				
-				sscanf_s((&line[i])[0].c_str(), "f %d/%d/%d %d/%d/%d %d/%d/%d", &v_i[0], &vt_i[0], &vn_i[0], &v_i[1], &vt_i[1], &vn_i[1], &v_i[2], &vt_i[2], &vn_i[2]);		// Scan and consume the face data for each line
 
-				for (unsigned k = 0; k < 3; k++)	// For each vertex...
+				if (from == to)		// If the run has no faces
+					continue;	// Skip run
+
+				if (current == (size_t)-1)	// If there are faces before any material
 				{
-					obj.g[current_group].v_i.push_back(v_i[k]);		// Add a new index for vertex type 0
-					obj.g[current_group].vt_i.push_back(vt_i[k]);	// Add a new index for vertex type 1
-					obj.g[current_group].vn_i.push_back(vn_i[k]);	// Add a new index for vertex type 2
+					current = names.size();		// Give them their own group
+					names.push_back("");
+					group_size.push_back(0);
 				}
-				
-				break;
+
+				runs.push_back({ i, from, to, current, group_size[current] });	// Add run, placed after the group's earlier runs
+				group_size[current] += to - from;
 			}
 		}
 
-		unsigned int offset = 0;	// This variable will be used to increment the offsets for each groups indices
-		for (unsigned int g = 0; g < obj.g.size(); g++)		// Iterate through the number of groups...
+		// ------------------------- EXPAND CORNERS IN PARALLEL -------------------------
+		size_t total = 0;	// Corner count
+		for (size_t g = 0; g < group_size.size(); g++)	// Iterate through each group
 		{
-			out_obj.g.push_back(Group());	// Create a new group for our out_obj
+			Group group;	// New group
+			group.from = (unsigned int)total;	// Set the starting index point of each group's offset
+			group.to = (unsigned int)(total + group_size[g]);	// Set the end index point of each group's offset + index size
+			out_obj.g.push_back(group);
+			out_obj.u.push_back(names[g]);	// Record material name
+			total += group_size[g];
+		}
 
-			for (unsigned int i = 0; i < obj.g[g].v_i.size(); i++)	// Iterate through the number of vertex indices...
+		for (Run &r : runs)		// Iterate through each run
+			r.dest += out_obj.g[r.group].from;	// Make its destination absolute
+
+		out_obj.v.resize(total); out_obj.vt.resize(total); out_obj.vn.resize(total);	// One vertex per corner
+
+		JobSystem::ParallelFor(0, chunks.size(), 1, [&](size_t first, size_t last)	// Offset relative indices by the earlier chunks
+		{
+			for (size_t i = first; i < last; i++)	// Iterate through each chunk
+				for (std::pair<size_t, int> &r : chunks[i].rel)		// Iterate through each relative corner
+				{
+					ObjCorner &f = chunks[i].f[r.first];
+					if (r.second & 1) f.v += base[i].v;		// Offset position
+					if (r.second & 2) f.vt += base[i].vt;	// Offset texcoord
+					if (r.second & 4) f.vn += base[i].vn;	// Offset normal
+				}
+		});
+
+		std::vector<std::vector<unsigned int>> positions(out_obj.g.size());		// Position index of each corner, per group
+		for (size_t g = 0; g < out_obj.g.size(); g++)
+			positions[g].resize(group_size[g]);
+
+		std::atomic<bool> bad(false);	// Was an index out of range?
+		JobSystem::ParallelFor(0, runs.size(), 1, [&](size_t first, size_t last)	// Expand each run
+		{
+			for (size_t k = first; k < last; k++)	// Iterate through each run
 			{
-				unsigned int v_i = obj.g[g].v_i[i];		// Assign a temp varaible to each vertex position's index
-				unsigned int vt_i = obj.g[g].vt_i[i];	// Assign a temp varaible to each vertex texcoord's index
-				unsigned int vn_i = obj.g[g].vn_i[i];	// Assign a temp varaible to each vertex normal's index
+				Run &r = runs[k];
+				ObjChunk &c = chunks[r.chunk];
 
-				glm::vec3 vertex = obj.v[v_i - 1];	// Get the desired position vertex value using our vertex indices
-				glm::vec3 uv = obj.vt[vt_i - 1];	// Get the desired texcoord vertex value using our vertex indices
-				glm::vec3 normal = obj.vn[vn_i - 1];	// Get the desired normal vertex value using our vertex indices
+				for (size_t i = r.from; i < r.to; i++)	// Iterate through each corner
+				{
+					const ObjCorner &f = c.f[i];	// Corner
+					size_t d = r.dest + (i - r.from);	// Destination
 
-				out_obj.v.push_back(vertex);	// Add the indexed version of the vertex position value to our out_obj
-				out_obj.vt.push_back(uv);	// Add the indexed version of the vertex texcoord value to our out_obj
-				out_obj.vn.push_back(normal);	// Add the indexed version of the normal position value to our out_obj
+					if (f.v < 0 || f.v >= (int)nv || f.vt < -1 || f.vt >= (int)nvt || f.vn < -1 || f.vn >= (int)nvn)	// If the corner points outside the file
+					{
+						bad = true;		// Flag it, the vertex stays at zero
+						continue;	// Next corner
+					}
 
-				out_obj.g[g].v_i.push_back(obj.g[g].v_i[i]);	// Assign the indices from the input to output data
+					out_obj.v[d] = v[f.v];	// Get the desired position vertex value using our vertex indices
+					out_obj.vt[d] = (f.vt >= 0) ? vt[f.vt] : glm::vec3(0.0f);	// Get the desired texcoord vertex value using our vertex indices
+					out_obj.vn[d] = (f.vn >= 0) ? vn[f.vn] : glm::vec3(0.0f);	// Get the desired normal vertex value using our vertex indices
+					positions[r.group][d - out_obj.g[r.group].from] = (unsigned int)f.v + 1;	// Keep the written position index
+				}
 			}
-			
-			unsigned int g_index_count = out_obj.g[g].v_i.size();	// Get the index count for each group by getting the index size
-			out_obj.g[g].from = offset;		// Set the starting index point of each group's offset
-			out_obj.g[g].to = offset + g_index_count;	// Set the end index point of each group's offset + index size
-			offset += g_index_count;	// Increment the offset by the last index size
+		});
+
+		for (size_t g = 0; g < out_obj.g.size(); g++)	// Iterate through each group
+			out_obj.g[g].v_i.swap(positions[g]);	// Assign the indices from the input to output data
+
+		if (bad)	// If an index was out of range
+			std::cerr << "Wavefront Import Error: Faces in " << file << " point at vertices that don't exist!\n";	// Print out error message
+
+		if (out_obj.g.empty())	// If there were no faces
+		{
+			std::cout << "Wavefront Import Error: The file has no faces!\n";	// Print out error message
+			return false;	// Return false as failed
 		}
 
 		return true;	// Return success
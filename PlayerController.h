@@ -3,18 +3,24 @@
 
 #include "Camera.h"		// Include camera
 #include "AttachmentMesh.h"		// Include mesh attachments
+#include "Sweep.h"		// Include swept ellipsoid collision
+
+#define PLAYER_ELLIPSOID_RADII	glm::vec3(0.4f, 0.9f, 0.4f)	// Default collision ellipsoid radii of the player
 
 // This class entends from Camera.h and contains overrides to player mechanics
 class PlayerController : public Camera
 {
 private:
 	std::vector<AttachmentMesh*>	_attachments;	// A vector list of mesh attachments
+	glm::vec3						_radii;		// Collision ellipsoid radii
 
 public:
 	// Initial contructor
 	inline PlayerController(unsigned int shader_program, glm::vec3 position, glm::vec3 position_offset, float fov, float speed, float sensitivity, float n, float f, float ratio)
 	{
 		_t = PLAYER_CONTROLLER;		// Assign objet type
+		_radii = PLAYER_ELLIPSOID_RADII;	// Assign collision ellipsoid
+		_main = true;	// Update moves the attachments, so it can't run beside them
 
 		InitialiseCamera(shader_program, position, position_offset, fov, speed, sensitivity, n, f, ratio);	// Initialise camera data
 
@@ -28,6 +34,9 @@ public:
 	}
 
 	inline std::vector<AttachmentMesh*> &GetAttachments() { return _attachments; }	// Return attachment list
+	inline glm::vec3 &GetRadii() { return _radii; }		// Return collision ellipsoid radii
+
+	inline void SetRadii(glm::vec3 value) { _radii = value; }	// Assign collision ellipsoid radii
 
 	// Assign a new attachment to controller
 	inline void AssignAttachment(AttachmentMesh* a)
@@ -41,14 +50,49 @@ public:
 		_attachments.erase(_attachments.begin() + i);	// Remove specific attachment
 	}
 
+	// Return the displacement the controls want this frame, without moving
+	inline glm::vec3 GetMoveDelta(double &delta)
+	{
+		if (!ControlActive())	// If no control is active
+			return glm::vec3(0.0f);		// Return no movement
+
+		glm::vec3 target = _trans._pos;		// Start from current position
+		Interpolation::Linestep(target, _velocity, GetCurrentLookVectorV(), _speed, delta);	// Interpolate target
+
+		return target - _trans._pos;	// Return displacement
+	}
+
+	// Sweep the collision ellipsoid by move and slide along any geometry in the nearby objects and static grid
+	inline void MoveAndSlide(glm::vec3 move, const std::vector<CollisionData*> &nearby, const SpatialGrid* grid = NULL)
+	{
+		_trans._pos = Collision::Ndc::Sweep::CollideAndSlide(_trans._pos, move, _radii, nearby, grid);	// Assign resolved position
+	}
+
 	// Update virtual void
 	inline virtual void Update(double &delta)
 	{
 		UpdateView();	// Update view matrix
+		UpdateAttachments();	// Follow the camera
+	}
+
+	// Build the view between the last two ticks, so the camera moves smoothly when rendering faster than the simulation
+	inline virtual void Interpolate(float alpha)
+	{
+		UpdateView(_saved ? glm::mix(_prev_pos, _trans._pos, alpha) : _trans._pos);	// Update view matrix from the blended position
+		UpdateAttachments();	// Follow the blended camera
+
+		for (AttachmentMesh* a : _attachments)	// Iterate through each attachment
+			a->mesh->Interpolate(1.0f);		// Publish its matrix, it's already at the blended camera
+	}
+
+	// Move every attachment to the camera
+	inline void UpdateAttachments()
+	{
+		glm::mat4 world = glm::inverse(GetViewMatrix());	// Camera world matrix, shared by every attachment
 		
 		for (AttachmentMesh* a : _attachments)	// Iterate through each attachment
 		{
-			a->mesh->SetMatrix(glm::inverse(GetViewMatrix()) * glm::translate(a->offset));	// Assign camera view matrix with mesh position offset
+			a->mesh->SetMatrix(world * glm::translate(a->offset));	// Assign camera world matrix with mesh position offset
 		}
 
 		//if (ControlActive())	// If camera is moving
@@ -58,9 +102,12 @@ public:
 	}
 
 	// Redner virtual void
-	inline virtual void Render()
+	inline virtual void Render() { Render(_view, _proj); }
+
+	// Render with a published view and projection, rather than the live camera
+	inline void Render(const glm::mat4 &view, const glm::mat4 &proj)
 	{
-		UpdateCamUniforms();	// Pass matrix uniform data
+		UpdateCamUniforms(view, proj);	// Pass matrix uniform data
 
 		for (AttachmentMesh* a : _attachments)	// Iterate through each attachment
 			a->mesh->Render();	// Render mesh attachments
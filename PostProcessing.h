@@ -225,6 +225,8 @@ private:
 
 	glm::mat4 shadow_light_projection[3];
 
+	std::vector<Mesh*> _casters; // meshes inside the light frustum, culled each frame
+
 	Fbo* _h_blur;
 public:
 	Fbo* _v_blur;
@@ -315,7 +317,8 @@ public:
 		{ // DIRECTIONAL SHADOWS
 			light_projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 50.0f); // project onto the scene from the position of the light (sun)
 			light_view = glm::lookAt(glm::vec3(x, y, z), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)); // position the camera at the lights position
-			light_space_matrix = light_projection * light_view * glm::inverse(Content::_map->GetPlayerController()->GetViewMatrix()); // calculate the lightSpaceMatrix
+			RenderSnapshot &snapshot = Content::_map->GetSnapshot(); // published render state
+			light_space_matrix = light_projection * light_view * glm::inverse(snapshot.view); // calculate the lightSpaceMatrix
 
 			glUseProgram(_shader_programs[0]); // bind the first pass shader
 
@@ -325,13 +328,13 @@ public:
 			_fbo->Bind();
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clear any depth info
 
-			// loop through all the meshes within the scene
-			for (unsigned int i = 0; i < Content::_map->GetActors().size(); i++)
-			{
-				glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(Content::_map->GetPlayerController()->GetViewMatrix() * Content::_map->GetActors()[i]->GetMatrix())); // set the viewspace model matrix uniform
+			snapshot.CullMeshes(light_projection * light_view, _casters); // only draw casters the light can see
 
-				if (Content::_map->GetActors()[i]->GetObjectType() == MESH)
-					Content::_map->GetActors()[i]->Render(); // render all the meshes into the shadowmap
+			// loop through all the meshes within the light frustum
+			for (Actor* a : _casters)
+			{
+				glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(snapshot.view * a->GetRenderMatrix())); // set the viewspace model matrix uniform
+				a->Render(); // render all the meshes into the shadowmap
 			}
 
 			_fbo->Unbind(); // unbind the shadowmap fbo
@@ -387,7 +390,8 @@ public:
 		glm::mat4 model;  // model matrix for all the meshes in the shadowmap
 
 		{ // DIRECTIONAL SHADOWS
-			glm::mat4 light_space_matrix = Content::_map->GetPlayerController()->GetProjectionMatrix() * Content::_map->GetPlayerController()->GetViewMatrix(); // calculate the lightSpaceMatrix
+			RenderSnapshot &snapshot = Content::_map->GetSnapshot(); // published render state
+			glm::mat4 light_space_matrix = snapshot.proj * snapshot.view; // calculate the lightSpaceMatrix
 
 			glUseProgram(_shader_programs[0]); // bind the first pass shader
 
@@ -399,13 +403,11 @@ public:
 
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clear any depth info
 
-			// loop through all the meshes within the scene
-			for (unsigned int i = 0; i < Content::_map->GetActors().size(); i++)
+			// loop through all the meshes within the camera frustum
+			for (Actor* a : snapshot.visible)
 			{
-				glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(Content::_map->GetActors()[i]->GetMatrix())); // set the viewspace model matrix uniform
-
-				if (Content::_map->GetActors()[i]->GetObjectType() == MESH)
-					Content::_map->GetActors()[i]->Render(); // render all the meshes into the shadowmap
+				glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(a->GetRenderMatrix())); // set the model matrix uniform
+				a->Render(); // render all the meshes into the shadowmap
 			}
 
 			_fbo->Unbind(); // unbind the shadowmap fbo
@@ -533,8 +535,9 @@ public:
 		glEnable(GL_CULL_FACE); // enable cull facing
 
 		glm::mat4 model; // model matrix for each model in the light scatter texture
-		glm::mat4 projection = Content::_map->GetPlayerController()->GetProjectionMatrix(); // camera projection
-		glm::mat4 view = Content::_map->GetPlayerController()->GetViewMatrix(); // camera view
+		RenderSnapshot &snapshot = Content::_map->GetSnapshot(); // published render state
+		glm::mat4 projection = snapshot.proj; // camera projection
+		glm::mat4 view = snapshot.view; // camera view
 
 		_fbo1->Bind();  // bind the light scatter fbo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clear any data on the screen 
@@ -552,14 +555,12 @@ public:
 		
 		Primitives::sphere();
 
-		// render the models
-		for (Actor* a : Content::_map->GetActors())
+		// render the models within the camera frustum
+		for (Actor* a : snapshot.visible)
 		{
-			glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(view * a->GetMatrix())); // set the model matrix uniform	
+			glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(view * a->GetRenderMatrix())); // set the model matrix uniform	
 			glUniform3f(_u_objtype, 0.0f, 0.0f, 0.0f);
-
-			if (a->GetObjectType() == MESH) // If object type is type mesh
-				a->Render();
+			a->Render();
 		}
 
 		_fbo1->Unbind(); // unbind the fbo
@@ -0,0 +1,168 @@
+#ifndef __RAYCAST_H__
+#define __RAYCAST_H__
+
+#include "Collision.h"	// Get collision data
+#include "AabbTree.h"	// Get broad phase
+#include "SpatialGrid.h"	// Get static triangle grid
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for casting world space rays through a broad phase tree and each object's hierarchy
+		// Rays are origin + dir * t, so t is in units of dir (a distance when dir is normalised)
+		namespace Raycast
+		{
+			// A structure for storing a single ray hit
+			struct RayHit
+			{
+				void*					data;		// User data of the proxy that was hit
+				Data::CollisionData*	cd;			// Collision data that was hit
+				float					t;			// Distance along the ray
+				glm::vec3				point;		// Hit point (world space)
+				glm::vec3				normal;		// Unit triangle normal (world space)
+				unsigned int			triangle;	// Triangle id within the collision data
+			};
+
+			// This function will return true if a ray hits an object within t_max, and output the closest hit
+			inline static bool RayToObject(Data::CollisionData* obj, glm::vec3 origin, glm::vec3 dir, float t_max, RayHit &out_hit)
+			{
+				float f;	// Hit fraction of the segment
+				unsigned int tri;	// Hit triangle
+
+				if (!Intersection::IntersectSegment(obj, origin, origin + dir * t_max, f, tri))	// If the ray misses
+					return false;	// Return false
+
+				glm::vec3 n = obj->t.N(tri);	// Local normal
+				n = glm::vec3(glm::dot(glm::vec3(obj->m_inv[0]), n), glm::dot(glm::vec3(obj->m_inv[1]), n), glm::dot(glm::vec3(obj->m_inv[2]), n));	// Inverse transpose into world space
+
+				out_hit.cd = obj;	// Assign collision data
+				out_hit.t = f * t_max;	// Assign distance
+				out_hit.point = origin + dir * out_hit.t;	// Assign point
+				out_hit.normal = glm::normalize(n);		// Assign normal
+				out_hit.triangle = tri;		// Assign triangle
+
+				return true;	// Return true
+			}
+
+			// Return the closest hit along a ray, where resolve(data) returns the collision data of a proxy or NULL to skip it
+			template <typename F>
+			inline static bool RaycastClosest(const Data::AabbTree &tree, glm::vec3 origin, glm::vec3 dir, float max_dist, RayHit &out_hit, F resolve)
+			{
+				bool hit(false);	// Initialise result
+
+				tree.Raycast(origin, dir, max_dist, [&](int proxy, float &t_max) -> bool	// Visit proxies along the ray, nearest first
+				{
+					void* data = tree.GetData(proxy);	// Get user data
+					Data::CollisionData* cd = resolve(data);	// Get collision data
+					RayHit h;	// Temp hit
+
+					if (cd && RayToObject(cd, origin, dir, t_max, h))	// If the object is closer than the last hit
+					{
+						h.data = data;	// Assign user data
+						out_hit = h;	// Record hit
+						t_max = h.t;	// Shorten the ray
+						hit = true;		// Record hit
+					}
+
+					return false;	// Keep searching for the closest hit
+				});
+
+				return hit;		// Return result
+			}
+
+			// Return the closest hit along a ray through a static grid, where resolve(owner) returns the owner's collision data or NULL to skip it
+			template <typename F>
+			inline static bool RaycastClosest(const Data::SpatialGrid &grid, glm::vec3 origin, glm::vec3 dir, float max_dist, RayHit &out_hit, F resolve)
+			{
+				bool hit(false);	// Initialise result
+
+				grid.Raycast(origin, dir, max_dist, [&](unsigned int tri, float &t_max) -> bool		// Visit cells along the ray, nearest first
+				{
+					float t;	// Hit distance
+					Data::CollisionData* cd = resolve(grid.owner[tri]);		// Get collision data
+
+					if (cd && Detection::RayToTriangle(origin, dir, grid.t, tri, t_max, t))		// If the triangle is closer than the last hit
+					{
+						out_hit.data = grid.owner[tri];		// Assign user data
+						out_hit.cd = cd;	// Assign collision data
+						out_hit.t = t;	// Assign distance
+						out_hit.point = origin + dir * t;	// Assign point
+						out_hit.normal = grid.t.N(tri);		// Assign normal (already world space)
+						out_hit.triangle = grid.source[tri];	// Assign triangle id within the owner
+						t_max = t;	// Shorten the ray
+						hit = true;		// Record hit
+					}
+
+					return false;	// Keep searching for the closest hit
+				});
+
+				return hit;		// Return result
+			}
+
+			// Gather the closest hit on every object along a ray, sorted nearest first, and return the number of hits
+			template <typename F>
+			inline static unsigned int RaycastAll(const Data::AabbTree &tree, glm::vec3 origin, glm::vec3 dir, float max_dist, std::vector<RayHit> &out_hits, F resolve)
+			{
+				out_hits.clear();	// Reset hit list
+
+				tree.Raycast(origin, dir, max_dist, [&](int proxy, float &t_max) -> bool	// Visit every proxy along the ray
+				{
+					void* data = tree.GetData(proxy);	// Get user data
+					Data::CollisionData* cd = resolve(data);	// Get collision data
+					RayHit h;	// Temp hit
+
+					if (cd && RayToObject(cd, origin, dir, t_max, h))	// If the object is hit
+					{
+						h.data = data;	// Assign user data
+						out_hits.push_back(h);	// Add hit
+					}
+
+					return false;	// Keep going
+				});
+
+				std::sort(out_hits.begin(), out_hits.end(), [](const RayHit &a, const RayHit &b) { return a.t < b.t; });	// Order nearest first
+
+				return (unsigned int)out_hits.size();	// Return number of hits
+			}
+
+			// Gather the closest hit on every owner along a ray through a static grid, sorted nearest first, and return the number of hits
+			template <typename F>
+			inline static unsigned int RaycastAll(const Data::SpatialGrid &grid, glm::vec3 origin, glm::vec3 dir, float max_dist, std::vector<RayHit> &out_hits, F resolve)
+			{
+				out_hits.clear();	// Reset hit list
+
+				grid.Raycast(origin, dir, max_dist, [&](unsigned int tri, float &t_max) -> bool		// Visit every cell along the ray
+				{
+					float t;	// Hit distance
+					Data::CollisionData* cd = resolve(grid.owner[tri]);		// Get collision data
+
+					if (!cd || !Detection::RayToTriangle(origin, dir, grid.t, tri, t_max, t))	// If the triangle is skipped or missed
+						return false;	// Keep going
+
+					RayHit h = { grid.owner[tri], cd, t, origin + dir * t, grid.t.N(tri), grid.source[tri] };	// Temp hit
+
+					for (RayHit &o : out_hits)	// Iterate through each earlier hit
+					{
+						if (o.data == h.data)	// If this owner was already hit
+						{
+							if (h.t < o.t) o = h;	// Keep the closer hit
+							return false;	// Keep going
+						}
+					}
+
+					out_hits.push_back(h);	// Add hit
+					return false;	// Keep going
+				});
+
+				std::sort(out_hits.begin(), out_hits.end(), [](const RayHit &a, const RayHit &b) { return a.t < b.t; });	// Order nearest first
+
+				return (unsigned int)out_hits.size();	// Return number of hits
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef __RENDER_SNAPSHOT_H__
+#define __RENDER_SNAPSHOT_H__
+
+#define RENDER_BUFFERS	2	// One snapshot being drawn, one being written
+
+#include <vector>	// Get dynamic arrays
+#include <glm/glm.hpp>	// Get 3D variables
+#include "Frustum.h"	// Get view culling
+
+class Mesh;		// Declared in Mesh.h
+class Light;	// Declared in Light.h
+
+// The state of a light as it was published
+struct RenderLight
+{
+	Light*			light;		// Light (for its uniform locations)
+	unsigned int	index;		// Packed index, which picks the uniform array element
+	unsigned int	type;		// Light type
+	glm::vec3		position;	// World position
+	glm::vec3		colour;		// Colour
+	float			intensity;	// Brightness
+};
+
+// Everything the render passes read about the scene for one frame, published once the frame's simulation has finished
+// The simulation writes the back snapshot while the renderer draws the front one, so the two can run on different threads
+// Mesh model matrices live with each actor, double buffered by the same index (see Actor::GetRenderMatrix)
+class RenderSnapshot
+{
+private:
+	static unsigned int		_front;		// Index of the snapshot being drawn
+
+	std::vector<unsigned int>	_cull_ids;	// Sphere ids that passed the last cull (scratch for the render thread)
+
+public:
+	glm::mat4				view;	// Camera view matrix
+	glm::mat4				cam_view;	// Camera view matrix with the position offset, as uploaded to the geometry shaders
+	glm::mat4				proj;	// Camera projection matrix
+	glm::vec3				eye;	// Camera position
+
+	std::vector<Mesh*>		meshes;		// Every mesh
+	std::vector<float>		sphere_x;	// World bounding sphere of each mesh, split per component for culling
+	std::vector<float>		sphere_y;
+	std::vector<float>		sphere_z;
+	std::vector<float>		sphere_r;
+
+	std::vector<Mesh*>		visible;	// Meshes inside the camera frustum
+	unsigned int			culled;		// Meshes outside the camera frustum
+
+	std::vector<RenderLight>	lights;		// Every light
+
+	// Default constructor
+	inline RenderSnapshot() : view(1.0f), cam_view(1.0f), proj(1.0f), eye(0.0f), culled(0) {}
+
+	static inline unsigned int Front() { return _front; }	// Return the index of the snapshot being drawn
+	static inline unsigned int Back() { return (_front + 1) % RENDER_BUFFERS; }		// Return the index of the snapshot being written
+	static inline void Swap() { _front = Back(); }	// Draw the snapshot just written (call while neither side is running)
+
+	// Output every mesh whose bounding sphere touches the frustum of a view projection matrix, and return how many there are
+	inline unsigned int CullMeshes(const glm::mat4 &view_proj, std::vector<Mesh*> &out_visible)
+	{
+		Frustum frustum(view_proj);		// Extract planes once
+
+		_cull_ids.clear();	// Reset ids
+		frustum.CullSpheres(sphere_x.data(), sphere_y.data(), sphere_z.data(), sphere_r.data(), sphere_x.size(), _cull_ids);	// Batched sphere test
+
+		out_visible.clear();	// Reset output
+		for (unsigned int i : _cull_ids)	// Iterate through each visible id
+			out_visible.push_back(meshes[i]);	// Add mesh
+
+		return (unsigned int)out_visible.size();	// Return number of visible meshes
+	}
+};
+
+// Static definitions
+unsigned int RenderSnapshot::_front = 0;
+
+#endif
@@ -4,15 +4,23 @@
 #include "Context.h"	// Include context for setting up OpenGL
 #include "Deferred.h"	// Include the deferred passes for rendering in screenspce
 #include "Editor.h"		// Include the editor compnents
+#include "JobSystem.h"	// Get worker threads
 
 
 Context	_opengl_context;	// Our OpenGL context class needs to be globally accessed
 
 
 // This class will be for rendering the OpenGL world
+// When pipelined, the simulation of the next frame runs on a worker while this thread draws the last published snapshot
 class RendererMaster
 {
+private:
+	static bool		_pipelined;		// Does the simulation run beside rendering?
+
 public:
+	static inline bool IsPipelined() { return _pipelined; }		// Return true if the simulation runs beside rendering
+	static inline void SetPipelined(bool value) { _pipelined = value; }		// Assign pipelining
+
 	// Initialise buffers and glsl shaders
 	static inline void Initialise()
 	{
@@ -27,6 +35,7 @@ public:
 
 		glDisable(GL_BLEND);
 		Deferred::Initialise(_pd_width, _pd_height);	// Initialise the deferred renderer
+		_pipelined = JobSystem::GetThreadCount() > 1;	// Pipeline when there is a worker to simulate on
 
 		// Load player content
 		DataIO::Import::WavefrontObjI(Deferred::shaders[0]->GetProgram(), "DefaultPlayer.obj");
@@ -39,15 +48,56 @@ public:
 		_opengl_context.Destroy();	// Free our context data
 	}
 
-	// Update our object's logic with delta time
-	static inline void Update(double& delta)
+	// Advance the world's logic by one simulation tick
+	static inline void Step(double& tick)
 	{
 		if (!UI::_controls[0]->active)	// If the console is NOT active...
-			Deferred::Update(delta);	// Update the world through deferred passes
-		
+			Deferred::Update(tick);		// Update the world through deferred passes
+	}
+
+	// Update our per frame components with delta time
+	static inline void Update(double& delta)
+	{
 		Editor::Update(delta);	// Update the editor components
 	}
 
+	// Blend render transforms between the last two simulation ticks and publish them, alpha is how far we are into the next tick
+	static inline void Interpolate(float alpha)
+	{
+		Content::_map->Interpolate(alpha);	// Interpolate the world
+	}
+
+	// Run the ticks due this frame and publish the render snapshot (no OpenGL calls, so it may run on a worker)
+	// Main thread only actors are handed back to the main thread, which pumps them while it waits in Frame
+	static inline void Simulate(unsigned int steps, double tick, float alpha)
+	{
+		for (unsigned int i = 0; i < steps; i++)	// Iterate through each tick due this frame
+			Step(tick);		// Advance the simulation one tick
+
+		Interpolate(alpha);		// Publish the back snapshot
+	}
+
+	// Simulate and draw one frame
+	// Pipelined: frame N is drawn from the front snapshot while frame N + 1 is simulated into the back one, so a frame costs about the slower of the two
+	// Otherwise the frame is simulated, published and drawn in turn
+	static inline void Frame(unsigned int steps, double tick, float alpha)
+	{
+		if (_pipelined)		// If the simulation runs beside rendering
+		{
+			JobCounter sim;		// Simulation job counter
+			JobSystem::Run([=]() { Simulate(steps, tick, alpha); }, &sim);		// Simulate the next frame on a worker
+			Render();	// Draw the last published frame
+			JobSystem::Wait(sim);	// Help with the simulation until it's done
+			RenderSnapshot::Swap();		// Draw the new frame next time
+		}
+		else
+		{
+			Simulate(steps, tick, alpha);	// Simulate this frame
+			RenderSnapshot::Swap();		// Draw it now
+			Render();	// Draw the frame
+		}
+	}
+
 	// Render our OpenGL context by clearing buffers and binding buffer objects to the gpu
 	static inline void Render()
 	{
@@ -58,4 +108,6 @@ public:
 	}
 };
 
+bool RendererMaster::_pipelined = false;
+
 #endif
\ No newline at end of file
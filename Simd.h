@@ -0,0 +1,188 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#if defined(__AVX2__)
+#define SIMD_AVX2	// 8-wide float kernels are available
+#endif
+
+#if defined(SIMD_AVX2) || (defined(_MSC_VER) && defined(_M_X64))
+#define SIMD_F8		// 8-wide float kernels can be compiled in, and picked at runtime with Simd::HasAvx2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SIMD_SSE	// 4-wide float kernels are available
+#endif
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>	// Get sse intrinsics
+#endif
+
+#ifdef SIMD_F8
+#include <immintrin.h>	// Get avx intrinsics
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>		// Get cpuid
+#endif
+
+// A namespace of thin wrappers over the float vector instruction sets, so kernels can be written once as templates
+namespace Simd
+{
+#ifdef SIMD_SSE
+	// 4-wide float vector
+	struct F4
+	{
+		typedef __m128 T;	// Register type
+		enum { WIDTH = 4 };		// Number of lanes
+
+		static inline T Load(const float* p) { return _mm_loadu_ps(p); }	// Unaligned load
+		static inline void Store(float* p, T a) { _mm_storeu_ps(p, a); }	// Unaligned store
+		static inline T Set(float a) { return _mm_set1_ps(a); }		// Broadcast
+		static inline T Add(T a, T b) { return _mm_add_ps(a, b); }	// a + b
+		static inline T Sub(T a, T b) { return _mm_sub_ps(a, b); }	// a - b
+		static inline T Mul(T a, T b) { return _mm_mul_ps(a, b); }	// a * b
+		static inline T Div(T a, T b) { return _mm_div_ps(a, b); }	// a / b
+		static inline T Min(T a, T b) { return _mm_min_ps(a, b); }	// min(a, b)
+		static inline T Max(T a, T b) { return _mm_max_ps(a, b); }	// max(a, b)
+		static inline T And(T a, T b) { return _mm_and_ps(a, b); }	// a & b
+		static inline T Or(T a, T b) { return _mm_or_ps(a, b); }	// a | b
+		static inline T Lt(T a, T b) { return _mm_cmplt_ps(a, b); }		// a < b
+		static inline T Le(T a, T b) { return _mm_cmple_ps(a, b); }		// a <= b
+		static inline T Gt(T a, T b) { return _mm_cmpgt_ps(a, b); }		// a > b
+		static inline T Ge(T a, T b) { return _mm_cmpge_ps(a, b); }		// a >= b
+		static inline T Abs(T a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }	// |a|
+		static inline T Select(T m, T a, T b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }	// m ? a : b
+		static inline int Mask(T a) { return _mm_movemask_ps(a); }	// One bit per lane
+
+		// Load 4 packed xyz points (12 floats) and split them into x, y and z lanes
+		static inline void LoadXYZ(const float* p, T &x, T &y, T &z)
+		{
+			T a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);	// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+			T t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));	// x2 y2 x3 y3
+			T t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));	// y0 z0 y1 z1
+			x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));		// x0 x1 x2 x3
+			y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));	// y0 y1 y2 y3
+			z = _mm_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));		// z0 z1 z2 z3
+		}
+
+		// Interleave x, y and z lanes and store them as 4 packed xyz points (12 floats)
+		static inline void StoreXYZ(float* p, T x, T y, T z)
+		{
+			T t0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));	// x0 x2 y0 y2
+			T t1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));	// z0 z2 x1 x3
+			T t2 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));	// y1 y3 z1 z3
+			_mm_storeu_ps(p, _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0)));		// x0 y0 z0 x1
+			_mm_storeu_ps(p + 4, _mm_shuffle_ps(t2, t0, _MM_SHUFFLE(3, 1, 2, 0)));	// y1 z1 x2 y2
+			_mm_storeu_ps(p + 8, _mm_shuffle_ps(t1, t2, _MM_SHUFFLE(3, 1, 3, 1)));	// z2 x3 y3 z3
+		}
+	};
+#endif
+
+#ifdef SIMD_F8
+	// 8-wide float vector
+	struct F8
+	{
+		typedef __m256 T;	// Register type
+		enum { WIDTH = 8 };		// Number of lanes
+
+		static inline T Load(const float* p) { return _mm256_loadu_ps(p); }		// Unaligned load
+		static inline void Store(float* p, T a) { _mm256_storeu_ps(p, a); }		// Unaligned store
+		static inline T Set(float a) { return _mm256_set1_ps(a); }	// Broadcast
+		static inline T Add(T a, T b) { return _mm256_add_ps(a, b); }	// a + b
+		static inline T Sub(T a, T b) { return _mm256_sub_ps(a, b); }	// a - b
+		static inline T Mul(T a, T b) { return _mm256_mul_ps(a, b); }	// a * b
+		static inline T Div(T a, T b) { return _mm256_div_ps(a, b); }	// a / b
+		static inline T Min(T a, T b) { return _mm256_min_ps(a, b); }	// min(a, b)
+		static inline T Max(T a, T b) { return _mm256_max_ps(a, b); }	// max(a, b)
+		static inline T And(T a, T b) { return _mm256_and_ps(a, b); }	// a & b
+		static inline T Or(T a, T b) { return _mm256_or_ps(a, b); }		// a | b
+		static inline T Lt(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }	// a < b
+		static inline T Le(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }	// a <= b
+		static inline T Gt(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }	// a > b
+		static inline T Ge(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }	// a >= b
+		static inline T Abs(T a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }	// |a|
+		static inline T Select(T m, T a, T b) { return _mm256_blendv_ps(b, a, m); }		// m ? a : b
+		static inline int Mask(T a) { return _mm256_movemask_ps(a); }	// One bit per lane
+
+		// Load 8 packed xyz points (24 floats) and split them into x, y and z lanes
+		// The halves are regrouped so each 128 bit lane holds 4 whole points, then split as in F4
+		static inline void LoadXYZ(const float* p, T &x, T &y, T &z)
+		{
+			T l0 = _mm256_loadu_ps(p), l1 = _mm256_loadu_ps(p + 8), l2 = _mm256_loadu_ps(p + 16);	// 24 packed floats
+			T a = _mm256_blend_ps(l0, l1, 0xF0);	// Points 0-1 | points 4-5
+			T b = _mm256_permute2f128_ps(l0, l2, 0x21);		// Points 1-2 | points 5-6
+			T c = _mm256_blend_ps(l1, l2, 0xF0);	// Points 2-3 | points 6-7
+			T t0 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+			T t1 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+			x = _mm256_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));	// x0 - x7
+			y = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));		// y0 - y7
+			z = _mm256_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));	// z0 - z7
+		}
+
+		// Interleave x, y and z lanes and store them as 8 packed xyz points (24 floats)
+		static inline void StoreXYZ(float* p, T x, T y, T z)
+		{
+			T t0 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			T t1 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			T t2 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			T a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));	// Points 0-1 | points 4-5
+			T b = _mm256_shuffle_ps(t2, t0, _MM_SHUFFLE(3, 1, 2, 0));	// Points 1-2 | points 5-6
+			T c = _mm256_shuffle_ps(t1, t2, _MM_SHUFFLE(3, 1, 3, 1));	// Points 2-3 | points 6-7
+			_mm256_storeu_ps(p, _mm256_permute2f128_ps(a, b, 0x20));	// Floats 0 - 7
+			_mm256_storeu_ps(p + 8, _mm256_blend_ps(c, a, 0xF0));	// Floats 8 - 15
+			_mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(b, c, 0x31));	// Floats 16 - 23
+		}
+	};
+#endif
+
+	// Return true if the cpu and os support avx2, checked once
+	inline bool DetectAvx2()
+	{
+#if defined(SIMD_AVX2)
+		return true;	// The whole build already requires avx2
+#elif defined(_MSC_VER) && defined(_M_X64)
+		int info[4];	// Cpuid registers
+		__cpuid(info, 0);	// Highest leaf
+		if (info[0] < 7)	// If the extended feature leaf is missing
+			return false;	// Return false
+
+		__cpuid(info, 1);	// Feature leaf
+		if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)))	// If there is no osxsave or avx
+			return false;	// Return false
+
+		if ((_xgetbv(0) & 6) != 6)	// If the os doesn't save ymm registers
+			return false;	// Return false
+
+		__cpuidex(info, 7, 0);	// Extended feature leaf
+		return (info[1] & (1 << 5)) != 0;	// Return the avx2 bit
+#else
+		return false;	// 8-wide kernels aren't compiled in
+#endif
+	}
+
+	// Return true if 8-wide kernels can run on this machine
+	inline bool HasAvx2()
+	{
+		static const bool avx2 = DetectAvx2();	// Detect once
+		return avx2;	// Return result
+	}
+
+	// Dot product of two 3-component vectors stored as separate lanes
+	template <typename V>
+	inline typename V::T Dot3(typename V::T ax, typename V::T ay, typename V::T az, typename V::T bx, typename V::T by, typename V::T bz)
+	{
+		return V::Add(V::Add(V::Mul(ax, bx), V::Mul(ay, by)), V::Mul(az, bz));	// Return ax*bx + ay*by + az*bz
+	}
+
+	// Cross product of two 3-component vectors stored as separate lanes
+	template <typename V>
+	inline void Cross3(typename V::T ax, typename V::T ay, typename V::T az, typename V::T bx, typename V::T by, typename V::T bz,
+		typename V::T &rx, typename V::T &ry, typename V::T &rz)
+	{
+		rx = V::Sub(V::Mul(ay, bz), V::Mul(az, by));	// Calculate x
+		ry = V::Sub(V::Mul(az, bx), V::Mul(ax, bz));	// Calculate y
+		rz = V::Sub(V::Mul(ax, by), V::Mul(ay, bx));	// Calculate z
+	}
+}
+
+#endif
@@ -0,0 +1,433 @@
+#ifndef __SIMPLIFY_H__
+#define __SIMPLIFY_H__
+
+#define SIMPLIFY_LOD_LEVELS		3		// Simplified levels built below the full mesh
+#define SIMPLIFY_LOD_RATIO		0.5f	// Index count of each level relative to the level above
+#define SIMPLIFY_MIN_GAIN		0.9f	// A level is only kept if it has at most this fraction of the indices of the level above
+#define SIMPLIFY_EDGE_WEIGHT	10.0	// Weight of the quadrics that hold borders and seams in place
+#define SIMPLIFY_NONE			0xFFFFFFFF	// No open edge
+#define SIMPLIFY_MANY			0xFFFFFFFE	// More than one open edge
+
+#include <vector>	// Get dynamic arrays
+#include <cmath>	// Get sqrt
+#include <algorithm>	// Get sort
+#include <glm/glm.hpp>	// Get 3D variables
+#include "VertexData.h"		// Get vertex data and vertex hashing
+#include "VertexCache.h"	// Get triangle ordering
+#include "Chunk.h"	// Get index ranges and levels of detail
+
+// Quadric error metric mesh simplification (Garland and Heckbert), used to build levels of detail at import
+// Edges are collapsed onto one of their existing vertices, so every level indexes the original vertex buffer
+namespace Simplify
+{
+	// How a vertex may move
+	enum VertexKind
+	{
+		VK_MANIFOLD,	// Inside the surface, can collapse along any edge
+		VK_BORDER,	// On an open border, can only slide along it
+		VK_SEAM,	// On a texcoord or normal seam (two vertices at one position), both sides slide along the seam together
+		VK_LOCKED,	// Anything else, never moves
+	};
+
+	// Sum of squared distances to a set of weighted planes
+	struct Quadric
+	{
+		double a00, a11, a22, a01, a02, a12;	// Symmetric matrix
+		double b0, b1, b2;	// Linear term
+		double c;	// Constant
+		double w;	// Total weight
+
+		// Default constructor
+		inline Quadric() : a00(0), a11(0), a22(0), a01(0), a02(0), a12(0), b0(0), b1(0), b2(0), c(0), w(0) {}
+
+		// Add the plane n.p + d = 0 (n unit length) with a weight
+		inline void AddPlane(double nx, double ny, double nz, double d, double weight)
+		{
+			a00 += weight * nx * nx; a11 += weight * ny * ny; a22 += weight * nz * nz;
+			a01 += weight * nx * ny; a02 += weight * nx * nz; a12 += weight * ny * nz;
+			b0 += weight * nx * d; b1 += weight * ny * d; b2 += weight * nz * d;
+			c += weight * d * d;
+			w += weight;
+		}
+
+		// Add another quadric
+		inline void Add(const Quadric &q)
+		{
+			a00 += q.a00; a11 += q.a11; a22 += q.a22; a01 += q.a01; a02 += q.a02; a12 += q.a12;
+			b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; w += q.w;
+		}
+
+		// Return the weighted mean squared distance of a point to the planes
+		inline double Error(const glm::vec3 &p) const
+		{
+			double x = p.x, y = p.y, z = p.z;	// Point
+			double e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+			return (w > 0.0) ? std::max(e, 0.0) / w : 0.0;	// Return error
+		}
+	};
+
+	// An edge collapse, moving one vertex onto another
+	struct Collapse
+	{
+		unsigned int from, to;	// Vertices
+		double cost;	// Error after collapsing
+	};
+
+	// Half edges of a triangle list, grouped by start vertex
+	struct HalfEdges
+	{
+		std::vector<unsigned int> begin;	// First edge of each vertex
+		std::vector<unsigned int> to;	// End vertex of each edge
+
+		// Build from triangles
+		inline void Build(const std::vector<unsigned int> &indices, size_t vertex_count)
+		{
+			begin.assign(vertex_count + 1, 0);	// Count edges per vertex
+			for (unsigned int i : indices)
+				begin[i + 1]++;
+			for (size_t v = 0; v < vertex_count; v++)	// Prefix sum
+				begin[v + 1] += begin[v];
+
+			to.resize(indices.size());	// Fill edges
+			std::vector<unsigned int> fill(begin.begin(), begin.end() - 1);		// Write cursor per vertex
+			for (size_t t = 0; t + 2 < indices.size(); t += 3)	// Iterate through each triangle
+				for (int k = 0; k < 3; k++)
+					to[fill[indices[t + k]]++] = indices[t + (k + 1) % 3];
+		}
+
+		// Return true if an edge exists
+		inline bool Has(unsigned int a, unsigned int b) const
+		{
+			for (unsigned int e = begin[a]; e < begin[a + 1]; e++)	// Iterate through a's edges
+				if (to[e] == b) return true;
+			return false;
+		}
+	};
+
+	// Link vertices that share a position: remap points at the first of them, wedge links them in a ring
+	static inline void WeldPositions(const std::vector<glm::vec3> &positions, std::vector<unsigned int> &out_remap, std::vector<unsigned int> &out_wedge)
+	{
+		size_t n = positions.size();	// Vertex count
+		out_remap.resize(n);
+		out_wedge.resize(n);
+
+		VertexHashTable table;	// Position to first vertex
+		table.Reserve(n / VERTEX_SHARING);	// Size for a typical mesh
+		glm::vec3 zero(0.0f);	// Unused hash inputs
+
+		for (unsigned int v = 0; v < n; v++)	// Iterate through each vertex
+		{
+			unsigned int first;		// First vertex at this position
+			table.FindOrInsert(HashPackedVertex(positions[v], zero, zero), v, [&](uint32_t o) { return memcmp(&positions[o], &positions[v], sizeof(glm::vec3)) == 0; }, first);
+
+			out_remap[v] = first;
+			if (first == v)		// If the position is new
+				out_wedge[v] = v;	// Ring of one
+			else
+			{
+				out_wedge[v] = out_wedge[first];	// Join the ring
+				out_wedge[first] = v;
+			}
+		}
+	}
+
+	// Find each vertex's open half edge out and in, an edge is open if no triangle has it the other way round
+	static inline void FindOpenEdges(const std::vector<unsigned int> &indices, const HalfEdges &edges, size_t vertex_count, std::vector<unsigned int> &out_open_out, std::vector<unsigned int> &out_open_in)
+	{
+		out_open_out.assign(vertex_count, SIMPLIFY_NONE);	// Reset
+		out_open_in.assign(vertex_count, SIMPLIFY_NONE);
+
+		for (size_t t = 0; t + 2 < indices.size(); t += 3)	// Iterate through each triangle
+			for (int k = 0; k < 3; k++)		// Iterate through each edge
+			{
+				unsigned int a = indices[t + k], b = indices[t + (k + 1) % 3];	// Edge
+				if (edges.Has(b, a))	// If the edge has a partner
+					continue;	// It's closed
+
+				out_open_out[a] = (out_open_out[a] == SIMPLIFY_NONE || out_open_out[a] == b) ? b : SIMPLIFY_MANY;	// Record or mark as ambiguous
+				out_open_in[b] = (out_open_in[b] == SIMPLIFY_NONE || out_open_in[b] == a) ? a : SIMPLIFY_MANY;
+			}
+	}
+
+	// Return true if moving a position would turn a triangle around it over
+	static inline bool HasFlips(const std::vector<unsigned int> &indices, const std::vector<unsigned int> &tri_begin, const std::vector<unsigned int> &tris, const std::vector<unsigned int> &remap, const std::vector<glm::vec3> &positions, unsigned int from, unsigned int to)
+	{
+		unsigned int rf = remap[from], rt = remap[to];	// Positions
+		for (unsigned int k = tri_begin[rf]; k < tri_begin[rf + 1]; k++)	// Iterate through each triangle at the position
+		{
+			const unsigned int* t = &indices[tris[k] * 3];	// Triangle
+			unsigned int r0 = remap[t[0]], r1 = remap[t[1]], r2 = remap[t[2]];
+			if (r0 == rt || r1 == rt || r2 == rt)	// If it contains the edge it's removed
+				continue;
+
+			glm::vec3 p0 = positions[t[0]], p1 = positions[t[1]], p2 = positions[t[2]];		// Corners before
+			glm::vec3 n0 = glm::cross(p1 - p0, p2 - p0);
+			if (r0 == rf) p0 = positions[to];	// Corners after
+			if (r1 == rf) p1 = positions[to];
+			if (r2 == rf) p2 = positions[to];
+			glm::vec3 n1 = glm::cross(p1 - p0, p2 - p0);
+
+			if (glm::dot(n0, n1) < 0.25f * glm::length(n0) * glm::length(n1))	// If the normal turns by more than about 75 degrees
+				return true;	// Return true
+		}
+
+		return false;	// Return false
+	}
+
+	// Collapse edges of one index range until each target index count is reached, outputting a level per reached target and its error in mesh units
+	// Positions in locked are never moved (they're shared with other index ranges)
+	static inline void SimplifyRange(const unsigned int* in_indices, size_t count, const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &remap, const std::vector<unsigned int> &wedge, const std::vector<unsigned char> &locked,
+		const std::vector<size_t> &targets, std::vector<std::vector<unsigned int>> &out_levels, std::vector<float> &out_errors)
+	{
+		size_t n = positions.size();	// Vertex count
+		std::vector<unsigned int> indices(in_indices, in_indices + count - count % 3);	// Working triangles
+
+		HalfEdges edges;	// Edge lookup
+		std::vector<unsigned int> open_out, open_in;	// Open edges
+		edges.Build(indices, n);
+		FindOpenEdges(indices, edges, n, open_out, open_in);
+
+		auto single = [](unsigned int e) { return e < SIMPLIFY_MANY; };	// Is there exactly one open edge?
+		std::vector<unsigned char> kind(n, VK_LOCKED);	// Kind of each vertex
+		for (unsigned int v = 0; v < n; v++)	// Iterate through each vertex
+		{
+			unsigned int w = wedge[v];	// Next vertex at the same position
+			if (locked[remap[v]])	// If other ranges use the position
+				kind[v] = VK_LOCKED;
+			else if (w == v)	// If the vertex is alone at its position
+			{
+				if (open_out[v] == SIMPLIFY_NONE && open_in[v] == SIMPLIFY_NONE)
+					kind[v] = VK_MANIFOLD;
+				else if (single(open_out[v]) && single(open_in[v]))
+					kind[v] = VK_BORDER;
+			}
+			else if (wedge[w] == v)		// If two vertices share the position, both sides of a seam must follow the same edges
+			{
+				if (single(open_out[v]) && single(open_in[v]) && single(open_out[w]) && single(open_in[w]) && remap[open_out[v]] == remap[open_in[w]] && remap[open_in[v]] == remap[open_out[w]])
+					kind[v] = VK_SEAM;
+			}
+		}
+
+		std::vector<Quadric> quadrics(n);	// Quadric of each position
+		for (size_t t = 0; t < indices.size(); t += 3)	// Iterate through each triangle
+		{
+			const glm::vec3 &p0 = positions[indices[t]], &p1 = positions[indices[t + 1]], &p2 = positions[indices[t + 2]];		// Corners
+			glm::vec3 nm = glm::cross(p1 - p0, p2 - p0);	// Normal scaled by twice the area
+			double len = glm::length(nm);
+			if (len <= 0.0)		// If the triangle is degenerate
+				continue;	// It has no plane
+
+			double nx = nm.x / len, ny = nm.y / len, nz = nm.z / len;	// Unit normal
+			double d = -(nx * p0.x + ny * p0.y + nz * p0.z);	// Plane offset
+			for (int k = 0; k < 3; k++)		// Add the plane to each corner, weighted by area
+				quadrics[remap[indices[t + k]]].AddPlane(nx, ny, nz, d, len * 0.5);
+
+			for (int k = 0; k < 3; k++)		// Iterate through each edge
+			{
+				unsigned int a = indices[t + k], b = indices[t + (k + 1) % 3];	// Edge
+				if (edges.Has(b, a))	// If the edge is closed
+					continue;	// Skip it
+
+				glm::vec3 e = positions[b] - positions[a];	// Edge vector
+				glm::vec3 m = glm::cross(e, nm);	// Perpendicular to the surface along the edge
+				double m_len = glm::length(m);
+				if (m_len <= 0.0)	// If the edge is degenerate
+					continue;	// Skip it
+
+				double mx = m.x / m_len, my = m.y / m_len, mz = m.z / m_len;	// Unit edge plane normal
+				double md = -(mx * positions[a].x + my * positions[a].y + mz * positions[a].z);		// Edge plane offset
+				double w = glm::dot(e, e) * SIMPLIFY_EDGE_WEIGHT;	// Edge weight, scaled like an area
+				quadrics[remap[a]].AddPlane(mx, my, mz, md, w);		// Hold both ends in place
+				quadrics[remap[b]].AddPlane(mx, my, mz, md, w);
+			}
+		}
+
+		double max_error = 0.0;		// Largest collapse error (squared)
+		size_t level = 0;	// Next target
+		std::vector<Collapse> collapses;	// Candidates
+		std::vector<unsigned int> collapse_to(n), tri_begin, tris;	// Collapse targets and triangles per position
+		std::vector<unsigned char> touched(n);	// Positions changed this pass
+
+		while (level < targets.size())	// Iterate through each target
+		{
+			if (indices.size() <= targets[level])	// If the target has been reached
+			{
+				out_levels.push_back(indices);	// Output level
+				out_errors.push_back((float)sqrt(max_error));
+				level++;
+				continue;
+			}
+
+			edges.Build(indices, n);	// Edges changed in the last pass
+			FindOpenEdges(indices, edges, n, open_out, open_in);
+
+			tri_begin.assign(n + 1, 0);		// Triangles per position
+			for (unsigned int i : indices)
+				tri_begin[remap[i] + 1]++;
+			for (size_t v = 0; v < n; v++)
+				tri_begin[v + 1] += tri_begin[v];
+			tris.resize(indices.size());
+			std::vector<unsigned int> fill(tri_begin.begin(), tri_begin.end() - 1);		// Write cursor per position
+			for (size_t i = 0; i < indices.size(); i++)
+				tris[fill[remap[indices[i]]]++] = (unsigned int)(i / 3);
+
+			auto allowed = [&](unsigned int from, unsigned int to)	// Can from move onto to?
+			{
+				if (remap[from] == remap[to]) return false;		// Same position
+				switch (kind[from])
+				{
+				case VK_MANIFOLD: return true;
+				case VK_BORDER:
+				case VK_SEAM: return (single(open_out[from]) && remap[open_out[from]] == remap[to]) || (single(open_in[from]) && remap[open_in[from]] == remap[to]);	// Along the open edge only
+				default: return false;
+				}
+			};
+
+			collapses.clear();	// Gather the cheapest direction of each edge
+			for (size_t t = 0; t < indices.size(); t += 3)
+				for (int k = 0; k < 3; k++)
+				{
+					unsigned int a = indices[t + k], b = indices[t + (k + 1) % 3];	// Edge
+					bool ab = allowed(a, b), ba = allowed(b, a);
+					if (!ab && !ba) continue;
+
+					double e_ab = ab ? quadrics[remap[a]].Error(positions[b]) : 0.0, e_ba = ba ? quadrics[remap[b]].Error(positions[a]) : 0.0;	// Costs
+					Collapse c;
+					if (ab && (!ba || e_ab <= e_ba)) { c.from = a; c.to = b; c.cost = e_ab; }
+					else { c.from = b; c.to = a; c.cost = e_ba; }
+					collapses.push_back(c);
+				}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; });	// Cheapest first
+
+			size_t goal = std::max<size_t>(1, (indices.size() - targets[level]) / 6);	// Collapses this pass (most remove two triangles)
+			for (size_t v = 0; v < n; v++) collapse_to[v] = (unsigned int)v;	// Reset
+			std::fill(touched.begin(), touched.end(), 0);
+			size_t applied = 0;		// Collapses done
+
+			for (const Collapse &c : collapses)		// Iterate through each candidate
+			{
+				if (applied >= goal)	// If the pass is done
+					break;
+
+				unsigned int rf = remap[c.from], rt = remap[c.to];	// Positions
+				if (touched[rf] || touched[rt])		// If either end moved this pass, its cost is stale
+					continue;
+				if (HasFlips(indices, tri_begin, tris, remap, positions, c.from, c.to))		// If the collapse folds the surface
+					continue;
+
+				if (kind[c.from] == VK_SEAM)	// If the other side of the seam must follow
+				{
+					unsigned int s = wedge[c.from];		// Other side
+					unsigned int t = (single(open_out[s]) && remap[open_out[s]] == rt) ? open_out[s] : (single(open_in[s]) && remap[open_in[s]] == rt) ? open_in[s] : SIMPLIFY_NONE;	// Its vertex at the target
+					if (t == SIMPLIFY_NONE)		// If the seam doesn't continue there
+						continue;
+					collapse_to[s] = t;
+				}
+
+				collapse_to[c.from] = c.to;		// Collapse
+				quadrics[rt].Add(quadrics[rf]);		// The target carries the error on
+				touched[rf] = touched[rt] = 1;
+				max_error = std::max(max_error, c.cost);
+				applied++;
+			}
+
+			if (applied == 0)	// If nothing more can collapse
+				break;	// The remaining targets can't be reached
+
+			size_t write = 0;	// Rewrite triangles, dropping collapsed ones
+			for (size_t t = 0; t < indices.size(); t += 3)
+			{
+				unsigned int a = collapse_to[indices[t]], b = collapse_to[indices[t + 1]], c = collapse_to[indices[t + 2]];
+				if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c])	// If the triangle has no area left
+					continue;
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+			indices.resize(write);
+		}
+	}
+
+	// Build levels of detail for every chunk of a mesh, appending their indices after the full mesh's so they share the index and vertex buffers
+	// Chunks hold byte offsets as drawn, each level holds one chunk per full chunk (with the same id) and the largest error of its chunks
+	static inline void BuildLods(VertexData &vd, const std::vector<Chunk> &chunks, std::vector<MeshLod> &out_lods)
+	{
+		size_t n = vd.positions.size();		// Vertex count
+		std::vector<unsigned int> remap, wedge;		// Position welding
+		WeldPositions(vd.positions, remap, wedge);
+
+		std::vector<int> owner(n, -1);	// Chunk using each position
+		std::vector<unsigned char> locked(n, 0);	// Positions shared between chunks stay put so chunks don't crack apart
+		for (size_t j = 0; j < chunks.size(); j++)	// Iterate through each chunk
+		{
+			size_t first = chunks[j]._index_offset / sizeof(unsigned int);		// First index
+			for (size_t i = first; i < first + chunks[j]._index_count; i++)
+			{
+				unsigned int r = remap[vd.indices[i]];	// Position
+				if (owner[r] < 0) owner[r] = (int)j;
+				else if (owner[r] != (int)j) locked[r] = 1;
+			}
+		}
+
+		std::vector<std::vector<std::vector<unsigned int>>> levels(chunks.size());	// Levels of each chunk
+		std::vector<std::vector<float>> errors(chunks.size());	// Error of each chunk level
+		JobSystem::ParallelFor(0, chunks.size(), 1, [&](size_t first, size_t last)	// Simplify each chunk
+		{
+			for (size_t j = first; j < last; j++)
+			{
+				std::vector<size_t> targets;	// Index count of each level
+				float ratio = 1.0f;
+				for (int l = 0; l < SIMPLIFY_LOD_LEVELS; l++)
+				{
+					ratio *= SIMPLIFY_LOD_RATIO;
+					targets.push_back((size_t)(chunks[j]._index_count / 3 * ratio) * 3);
+				}
+
+				SimplifyRange(vd.indices.data() + chunks[j]._index_offset / sizeof(unsigned int), chunks[j]._index_count, vd.positions, remap, wedge, locked, targets, levels[j], errors[j]);
+			}
+		});
+
+		size_t above = 0;	// Indices of the level above
+		for (const Chunk &c : chunks)
+			above += c._index_count;
+
+		for (int l = 0; l < SIMPLIFY_LOD_LEVELS; l++)	// Iterate through each level
+		{
+			size_t total = 0;	// Indices in this level
+			for (size_t j = 0; j < chunks.size(); j++)	// Chunks that stopped early reuse their last level
+				total += levels[j].empty() ? chunks[j]._index_count : levels[j][std::min((size_t)l, levels[j].size() - 1)].size();
+
+			if (total > above * SIMPLIFY_MIN_GAIN)	// If the level isn't worth drawing
+				break;	// Stop
+
+			MeshLod lod;	// New level
+			for (size_t j = 0; j < chunks.size(); j++)	// Iterate through each chunk
+			{
+				std::vector<unsigned int> range;	// Chunk indices for this level
+				float error = 0.0f;
+				if (levels[j].empty())	// If the chunk couldn't be simplified
+				{
+					size_t first = chunks[j]._index_offset / sizeof(unsigned int);
+					range.assign(vd.indices.begin() + first, vd.indices.begin() + first + chunks[j]._index_count);
+				}
+				else
+				{
+					size_t k = std::min((size_t)l, levels[j].size() - 1);
+					range = levels[j][k];
+					error = errors[j][k];
+				}
+
+				VertexCache::OptimiseCache(range.data(), range.size(), n);		// Order the level for the cache too
+				lod._chunks.push_back(Chunk((unsigned int)(vd.indices.size() * sizeof(unsigned int)), (unsigned int)range.size(), chunks[j]._id));		// Range after everything so far
+				vd.indices.insert(vd.indices.end(), range.begin(), range.end());
+				lod._error = std::max(lod._error, error);
+			}
+
+			out_lods.push_back(lod);	// Add level
+			above = total;
+		}
+	}
+};
+
+#endif
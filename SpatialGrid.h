@@ -0,0 +1,257 @@
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#define GRID_CELL_SIZE				4.0f	// Default cell edge length
+#define GRID_MAX_CELLS_PER_TRIANGLE	512		// Triangles covering more cells than this are kept in a separate list
+
+#include "Collision.h"	// Get collision data
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for storing collision arbitrary data
+		namespace Data
+		{
+			// A uniform grid of world space triangles, built once for geometry that never moves
+			// Only occupied cells are stored (hashed), and each cell is a run in one flat item list
+			class SpatialGrid
+			{
+			public:
+				TriangleData				t;			// Triangle data (world space)
+				std::vector<Aabb>			tb;			// Triangle bounds (world space)
+				std::vector<void*>			owner;		// User data of the object each triangle came from
+				std::vector<unsigned int>	source;		// Triangle id within the owner's collision data
+
+			private:
+				float						_cell;		// Cell edge length
+				float						_inv_cell;	// Inverse cell edge length
+				Aabb						_bounds;	// Bounds of every triangle
+				std::unordered_map<uint64_t, std::pair<unsigned int, unsigned int>>	_cells;		// First item and item count of each occupied cell
+				std::vector<unsigned int>	_items;		// Triangle ids ordered by cell
+				std::vector<unsigned int>	_large;		// Triangles too large to bucket, tested by every query
+
+			public:
+				// Default constructor
+				inline SpatialGrid() : _cell(GRID_CELL_SIZE), _inv_cell(1.0f / GRID_CELL_SIZE) {}
+
+				inline bool IsEmpty() const { return t.Size() == 0; }	// Return true if the grid holds no triangles
+				inline unsigned int GetCellCount() const { return (unsigned int)_cells.size(); }	// Return the number of occupied cells
+				inline const Aabb &GetBounds() const { return _bounds; }	// Return the bounds of every triangle
+
+				// Remove every triangle
+				inline void Clear()
+				{
+					t = TriangleData();		// Reset triangle data
+					tb.clear();		// Reset bounds
+					owner.clear();	// Reset owners
+					source.clear();		// Reset source ids
+					_cells.clear();		// Reset cells
+					_items.clear();		// Reset items
+					_large.clear();		// Reset large triangles
+					_bounds = Aabb();	// Reset bounds
+				}
+
+				// Add every triangle of an object in its current world frame (call Build once everything is added)
+				inline void Add(const CollisionData* cd, void* data)
+				{
+					unsigned int base = t.Size(), n = cd->t.Size();	// First new triangle, number of new triangles
+					t.Resize(base + n);		// Allocate triangle data once
+
+					for (unsigned int k = 0; k < 3; k++)	// Move point k of every triangle into world space in one batch
+						Math::TransformPointsSoA(cd->m, cd->t.x[k].data(), cd->t.y[k].data(), cd->t.z[k].data(), t.x[k].data() + base, t.y[k].data() + base, t.z[k].data() + base, n);
+
+					tb.resize(base + n);	// Allocate bounds
+					owner.resize(base + n, data);	// Assign owners
+					source.resize(base + n);	// Allocate source ids
+
+					for (unsigned int i = 0; i < n; i++)	// Iterate through each new triangle
+					{
+						t.Update(base + i);		// Calculate edges, normal and average
+
+						tb[base + i] = Aabb(t.P(base + i, 0), t.P(base + i, 0));	// Triangle bounds
+						tb[base + i].Grow(t.P(base + i, 1));
+						tb[base + i].Grow(t.P(base + i, 2));
+
+						source[base + i] = i;	// Assign source id
+					}
+				}
+
+				// Bucket every added triangle into cells of the given size
+				inline void Build(float cell_size = GRID_CELL_SIZE)
+				{
+					_cell = cell_size;	// Assign cell size
+					_inv_cell = 1.0f / cell_size;	// Assign inverse cell size
+					_cells.clear();		// Reset cells
+					_items.clear();		// Reset items
+					_large.clear();		// Reset large triangles
+					_bounds = Aabb();	// Reset bounds
+
+					// ------------------------- COUNT ITEMS PER CELL -------------------------
+					unsigned int total = 0;		// Total number of items
+
+					for (unsigned int i = 0; i < tb.size(); i++)	// Iterate through each triangle
+					{
+						_bounds.Grow(tb[i]);	// Grow grid bounds
+
+						glm::ivec3 lo = Cell(tb[i].min), hi = Cell(tb[i].max);	// Cell range
+						glm::ivec3 span = hi - lo + glm::ivec3(1);	// Cells per axis
+
+						if ((int64_t)span.x * span.y * span.z > GRID_MAX_CELLS_PER_TRIANGLE)	// If the triangle is too large to bucket
+						{
+							_large.push_back(i);	// Keep it aside
+							continue;	// Skip triangle
+						}
+
+						for (int x = lo.x; x <= hi.x; x++)
+							for (int y = lo.y; y <= hi.y; y++)
+								for (int z = lo.z; z <= hi.z; z++)
+								{
+									_cells[CellKey(x, y, z)].second++;	// Count item
+									total++;
+								}
+					}
+
+					// ------------------------- ASSIGN CELL RUNS -------------------------
+					unsigned int first = 0;		// Running offset
+					for (std::pair<const uint64_t, std::pair<unsigned int, unsigned int>> &c : _cells)	// Iterate through each cell
+					{
+						c.second.first = first;		// Assign run start
+						first += c.second.second;	// Advance offset
+						c.second.second = 0;	// Reset count for filling
+					}
+
+					// ------------------------- FILL CELLS -------------------------
+					_items.resize(total);	// Allocate items once
+
+					for (unsigned int i = 0; i < tb.size(); i++)	// Iterate through each triangle
+					{
+						glm::ivec3 lo = Cell(tb[i].min), hi = Cell(tb[i].max);	// Cell range
+						glm::ivec3 span = hi - lo + glm::ivec3(1);	// Cells per axis
+
+						if ((int64_t)span.x * span.y * span.z > GRID_MAX_CELLS_PER_TRIANGLE)	// If the triangle was kept aside
+							continue;	// Skip triangle
+
+						for (int x = lo.x; x <= hi.x; x++)
+							for (int y = lo.y; y <= hi.y; y++)
+								for (int z = lo.z; z <= hi.z; z++)
+								{
+									std::pair<unsigned int, unsigned int> &c = _cells[CellKey(x, y, z)];	// Get cell
+									_items[c.first + c.second++] = i;	// Add item
+								}
+					}
+				}
+
+				// Call f(triangle) once for every triangle whose bounds overlap the box
+				template <typename F>
+				inline void Query(const Aabb &box, F f) const
+				{
+					for (unsigned int i : _large)	// Iterate through each large triangle
+						if (tb[i].Overlaps(box))	// If it overlaps
+							f(i);	// Visit triangle
+
+					glm::ivec3 lo = Cell(box.min), hi = Cell(box.max);	// Cell range
+					glm::ivec3 span = hi - lo + glm::ivec3(1);	// Cells per axis
+
+					if ((int64_t)span.x * span.y * span.z > (int64_t)_cells.size())	// If the box covers more cells than are occupied
+					{
+						for (unsigned int i = 0; i < tb.size(); i++)	// Iterate through each triangle instead
+						{
+							glm::ivec3 s = Cell(tb[i].max) - Cell(tb[i].min) + glm::ivec3(1);	// Cells per axis
+							if ((int64_t)s.x * s.y * s.z <= GRID_MAX_CELLS_PER_TRIANGLE && tb[i].Overlaps(box))	// If bucketed and overlapping
+								f(i);	// Visit triangle
+						}
+
+						return;		// Return from function
+					}
+
+					for (int x = lo.x; x <= hi.x; x++)
+						for (int y = lo.y; y <= hi.y; y++)
+							for (int z = lo.z; z <= hi.z; z++)
+							{
+								std::unordered_map<uint64_t, std::pair<unsigned int, unsigned int>>::const_iterator it = _cells.find(CellKey(x, y, z));	// Find cell
+								if (it == _cells.end())		// If the cell is empty
+									continue;	// Skip cell
+
+								for (unsigned int k = it->second.first; k < it->second.first + it->second.second; k++)	// Iterate through each item
+								{
+									unsigned int i = _items[k];		// Get triangle
+									if (!tb[i].Overlaps(box))	// If the triangle misses the box
+										continue;	// Skip triangle
+
+									// A triangle spanning several cells is only reported from the first cell shared with the box
+									glm::ivec3 ref = Cell(glm::max(tb[i].min, box.min));	// Reference cell
+									if (ref.x == x && ref.y == y && ref.z == z)		// If this is the reference cell
+										f(i);	// Visit triangle
+								}
+							}
+				}
+
+				// Walk the cells along a ray and call f(triangle, t_max) for the triangles in each, nearest cell first
+				// The callback may shorten t_max (closest hit) or return true to stop (any hit); a triangle may be visited more than once
+				template <typename F>
+				inline void Raycast(const glm::vec3 &origin, const glm::vec3 &dir, float t_max, F f) const
+				{
+					if (IsEmpty())	// If there is nothing to hit
+						return;		// Return from function
+
+					for (unsigned int i : _large)	// Iterate through each large triangle
+						if (f(i, t_max))	// Visit triangle
+							return;		// Stop if the callback asked to
+
+					glm::vec3 inv_dir = 1.0f / dir;		// Inverse direction for slab tests
+					float t = _bounds.RayEntry(origin, inv_dir, t_max);		// Where the ray enters the grid
+					if (t == FLT_MAX)	// If the ray misses the grid
+						return;		// Return from function
+
+					// ------------------------- SET UP THE CELL WALK -------------------------
+					glm::ivec3 lo = Cell(_bounds.min), hi = Cell(_bounds.max);	// Occupied cell range
+					glm::ivec3 c = glm::clamp(Cell(origin + dir * t), lo, hi);	// Starting cell (clamped against rounding at the entry face)
+					glm::ivec3 step;	// Cell step per axis
+					glm::vec3 t_next, t_delta;	// Distance to the next cell boundary, and between boundaries
+
+					for (int a = 0; a < 3; a++)		// Iterate through each axis
+					{
+						if (dir[a] > 0.0f) { step[a] = 1; t_next[a] = ((c[a] + 1) * _cell - origin[a]) * inv_dir[a]; t_delta[a] = _cell * inv_dir[a]; }
+						else if (dir[a] < 0.0f) { step[a] = -1; t_next[a] = (c[a] * _cell - origin[a]) * inv_dir[a]; t_delta[a] = -_cell * inv_dir[a]; }
+						else { step[a] = 0; t_next[a] = FLT_MAX; t_delta[a] = FLT_MAX; }
+					}
+
+					// ------------------------- WALK -------------------------
+					while (t <= t_max)	// Iterate until past the closest hit
+					{
+						if (c.x < lo.x || c.y < lo.y || c.z < lo.z || c.x > hi.x || c.y > hi.y || c.z > hi.z)	// If the ray has left the grid
+							return;		// Return from function
+
+						std::unordered_map<uint64_t, std::pair<unsigned int, unsigned int>>::const_iterator it = _cells.find(CellKey(c.x, c.y, c.z));	// Find cell
+						if (it != _cells.end())		// If the cell is occupied
+						{
+							for (unsigned int k = it->second.first; k < it->second.first + it->second.second; k++)	// Iterate through each item
+								if (f(_items[k], t_max))	// Visit triangle
+									return;		// Stop if the callback asked to
+						}
+
+						int a = (t_next.x < t_next.y) ? ((t_next.x < t_next.z) ? 0 : 2) : ((t_next.y < t_next.z) ? 1 : 2);	// Axis of the nearest boundary
+						if (t_next[a] >= t_max)		// If every hit closer than t_max has been seen
+							return;		// Return from function
+
+						t = t_next[a];	// Advance to the boundary
+						c[a] += step[a];	// Step into the next cell
+						t_next[a] += t_delta[a];	// Next boundary on this axis
+					}
+				}
+
+			private:
+				// Return the cell that contains a point
+				inline glm::ivec3 Cell(const glm::vec3 &p) const
+				{
+					return glm::ivec3((int)glm::floor(p.x * _inv_cell), (int)glm::floor(p.y * _inv_cell), (int)glm::floor(p.z * _inv_cell));	// Return cell
+				}
+			};
+		}
+	}
+}
+
+#endif
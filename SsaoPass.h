@@ -127,7 +127,7 @@ public:
 		for (unsigned int i = 0; i < _sample_res; ++i)	// For each ssao sample...
 			glUniform3fv(_u_samples[i], 1, glm::value_ptr(_ssao_kernals[i]));	// Assign kernal uniform data
 
-		glUniformMatrix4fv(_u_projection, 1, GL_FALSE, glm::value_ptr(Content::_map->GetPlayerController()->GetProjectionMatrix()));	// Assign camera projection uniform data
+		glUniformMatrix4fv(_u_projection, 1, GL_FALSE, glm::value_ptr(Content::_map->GetSnapshot().proj));	// Assign camera projection uniform data
 
 		glActiveTexture(GL_TEXTURE0);	// Set active texture to index 0
 		glBindTexture(GL_TEXTURE_2D, _g_buffer_data->GetAttachments()[6]->_texture);	// Bind positions
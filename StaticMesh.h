@@ -34,11 +34,11 @@ public:
 	inline virtual void Render()
 	{
 		glUniform1i(_u_sel, _sel);	// Bind our selected uniform data
-		glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(_trans._mat));	// Bind our uniform data
+		glUniformMatrix4fv(_u_mat, 1, GL_FALSE, glm::value_ptr(GetRenderMatrix()));	// Bind our uniform data
 
 		_vao->Bind();	// Bind our element buffer object
 
-		for (Chunk c : _chunks)		// Iterate through each chunk element...
+		for (Chunk c : GetLodChunks())		// Iterate through each chunk element of the level of detail...
 		{
 			_mats[c._id]->Bind();	// Bind our material(s)
 
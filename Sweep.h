@@ -0,0 +1,287 @@
+#ifndef __SWEEP_H__
+#define __SWEEP_H__
+
+#define SWEEP_MAX_ITERATIONS	5		// Max number of slide iterations per move
+#define SWEEP_VERY_CLOSE		0.005f	// Distance kept between the ellipsoid and a surface (ellipsoid space)
+#define SWEEP_MIN_VELOCITY		0.0001f	// Remaining velocity below which sliding stops (ellipsoid space)
+
+#include "Collision.h"	// Get collision data
+#include "SpatialGrid.h"	// Get static triangle grid
+
+// A namespace block to store all collision data and functions
+namespace Collision
+{
+	// Normal device coordinate collision (3d)
+	namespace Ndc
+	{
+		// A namespace for sweeping an ellipsoid through triangle data and sliding along what it hits
+		// All tests run in ellipsoid space, where the ellipsoid is scaled to a unit sphere
+		namespace Sweep
+		{
+			// A structure for storing the state of a single sweep
+			struct Packet
+			{
+				glm::vec3	base;		// Sphere centre (ellipsoid space)
+				glm::vec3	vel;		// Velocity (ellipsoid space)
+				bool		found;		// Has a collision been found?
+				float		t;			// Nearest collision time along vel [0, 1]
+				glm::vec3	point;		// Nearest collision point (ellipsoid space)
+			};
+
+			// This function will return the lowest root of a*t^2 + b*t + c below max_r
+			inline static bool LowestRoot(float a, float b, float c, float max_r, float &root)
+			{
+				float det = b * b - 4.0f * a * c;	// Calculate determinant
+				if (det < 0.0f || glm::abs(a) < 1e-12f)	// If there is no real solution
+					return false;	// Return false
+
+				float sq = glm::sqrt(det);	// Square root of determinant
+				float r1 = (-b - sq) / (2.0f * a);	// Root 1
+				float r2 = (-b + sq) / (2.0f * a);	// Root 2
+
+				if (r1 > r2) std::swap(r1, r2);		// Order roots
+
+				if (r1 > 0.0f && r1 < max_r) { root = r1; return true; }	// Lowest root is valid
+				if (r2 > 0.0f && r2 < max_r) { root = r2; return true; }	// Highest root is valid
+
+				return false;	// Return false by default
+			}
+
+			// This function will return true if a point on a triangle's plane lies inside the triangle
+			inline static bool PointInTriangle(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+			{
+				glm::vec3 v0 = c - a, v1 = b - a, v2 = p - a;	// Vectors from a
+				float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d02 = glm::dot(v0, v2);
+				float d11 = glm::dot(v1, v1), d12 = glm::dot(v1, v2);
+				float denom = d00 * d11 - d01 * d01;	// Barycentric denominator
+
+				if (denom == 0.0f)	// If the triangle is degenerate
+					return false;	// Return false
+
+				float u = (d11 * d02 - d01 * d12) / denom;	// Barycentric u
+				float v = (d00 * d12 - d01 * d02) / denom;	// Barycentric v
+
+				return (u >= 0.0f) && (v >= 0.0f) && (u + v <= 1.0f);	// Return result
+			}
+
+			// Sweep the unit sphere in the packet against a triangle (ellipsoid space) and record the nearest hit
+			// Triangles are treated as two-sided so thin geometry blocks from either direction
+			inline static void SweepTriangle(Packet &pk, const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2)
+			{
+				glm::vec3 n = glm::cross(p1 - p0, p2 - p0);		// Triangle normal
+				float nl = glm::length(n);	// Normal length
+				if (nl <= 0.0f)		// If the triangle is degenerate
+					return;		// Return from function
+
+				n /= nl;	// Normalise
+
+				float dist = glm::dot(n, pk.base - p0);		// Signed distance from plane
+				if (dist < 0.0f) { n = -n; dist = -dist; }	// Face the plane towards the sphere
+
+				float n_dot_v = glm::dot(n, pk.vel);	// Velocity along normal
+				if (n_dot_v >= 0.0f && dist >= 1.0f)	// If moving away from (or parallel to) a plane that is not touched
+					return;		// Return from function
+
+				float t0, t1;	// Interval of time the sphere intersects the plane
+				bool embedded = false;	// Is the sphere embedded in the plane?
+
+				if (glm::abs(n_dot_v) < 1e-8f)	// If moving parallel to the plane
+				{
+					if (dist >= 1.0f)	// If not touching the plane
+						return;		// Return from function
+
+					embedded = true;	// Sphere is embedded in the plane
+					t0 = 0.0f; t1 = 1.0f;	// Whole sweep intersects the plane
+				}
+				else
+				{
+					t0 = (1.0f - dist) / n_dot_v;	// Time sphere touches the plane
+					t1 = (-1.0f - dist) / n_dot_v;	// Time sphere passes through the plane
+
+					if (t0 > t1) std::swap(t0, t1);		// Order interval
+
+					if (t0 > 1.0f || t1 < 0.0f)		// If the plane is never touched during this sweep
+						return;		// Return from function
+
+					t0 = glm::clamp(t0, 0.0f, 1.0f);	// Clamp interval
+					t1 = glm::clamp(t1, 0.0f, 1.0f);	// Clamp interval
+				}
+
+				bool found = false;		// Has this triangle been hit?
+				float t = 1.0f;		// Hit time
+				glm::vec3 point;	// Hit point
+
+				// ------------------------- FACE -------------------------
+				if (!embedded)	// If the sphere is not embedded, test the inside of the triangle first
+				{
+					glm::vec3 plane_point = pk.base - n + pk.vel * t0;	// Point the sphere touches the plane
+
+					if (PointInTriangle(plane_point, p0, p1, p2))	// If the touch point is inside the triangle
+					{
+						found = true;	// Record hit
+						t = t0;		// Record time
+						point = plane_point;	// Record point
+					}
+				}
+
+				// ------------------------- VERTICES AND EDGES -------------------------
+				if (!found)		// If the face was not hit, test the vertices and edges
+				{
+					float vel_sq = glm::dot(pk.vel, pk.vel);	// Squared velocity
+					float new_t;	// Root
+					const glm::vec3* p[3] = { &p0, &p1, &p2 };	// Triangle points
+
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each vertex
+					{
+						float b = 2.0f * glm::dot(pk.vel, pk.base - *p[k]);		// Linear term
+						float c = glm::dot(*p[k] - pk.base, *p[k] - pk.base) - 1.0f;	// Constant term
+
+						if (LowestRoot(vel_sq, b, c, t, new_t))		// If vertex k is hit earlier
+						{
+							t = new_t;	// Record time
+							found = true;	// Record hit
+							point = *p[k];	// Record point
+						}
+					}
+
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each edge
+					{
+						glm::vec3 edge = *p[(k + 1) % 3] - *p[k];	// Edge vector
+						glm::vec3 btv = *p[k] - pk.base;	// Base to vertex
+
+						float edge_sq = glm::dot(edge, edge);	// Squared edge length
+						float edge_dot_vel = glm::dot(edge, pk.vel);	// Edge along velocity
+						float edge_dot_btv = glm::dot(edge, btv);	// Edge along base to vertex
+
+						float a = edge_sq * -vel_sq + edge_dot_vel * edge_dot_vel;	// Quadratic term
+						float b = edge_sq * (2.0f * glm::dot(pk.vel, btv)) - 2.0f * edge_dot_vel * edge_dot_btv;	// Linear term
+						float c = edge_sq * (1.0f - glm::dot(btv, btv)) + edge_dot_btv * edge_dot_btv;	// Constant term
+
+						if (LowestRoot(a, b, c, t, new_t))	// If the infinite edge line is hit earlier
+						{
+							float f = (edge_dot_vel * new_t - edge_dot_btv) / edge_sq;	// Position along the edge
+
+							if (f >= 0.0f && f <= 1.0f)		// If the hit lies on the segment
+							{
+								t = new_t;	// Record time
+								found = true;	// Record hit
+								point = *p[k] + edge * f;	// Record point
+							}
+						}
+					}
+				}
+
+				if (found && (!pk.found || t < pk.t))	// If this is the nearest hit so far
+				{
+					pk.found = true;	// Record hit
+					pk.t = t;	// Record time
+					pk.point = point;	// Record point
+				}
+			}
+
+			// Gather the triangles of an object that may be touched by a swept ellipsoid (world space box), converted into ellipsoid space
+			// Only the gathered triangles are moved out of the object's local space
+			inline static void GatherTriangles(Data::CollisionData* obj, const Data::Aabb &box, const glm::vec3 &radii, std::vector<glm::vec3> &out_tris)
+			{
+				Data::Aabb local_box = box.Transform(obj->m_inv);	// Move box into local space
+
+				obj->bvh.QueryLeaves(local_box, [&](unsigned int first, unsigned int count)	// Visit nearby leaves only
+				{
+					for (unsigned int i = first; i < first + count; i++)	// Iterate through each leaf triangle
+					{
+						if (!local_box.Overlaps(obj->tb[i]))	// If the triangle itself is out of reach
+							continue;	// Skip triangle
+
+						for (unsigned int k = 0; k < 3; k++)	// Iterate through each point
+							out_tris.push_back(obj->ToWorld(obj->t.P(i, k)) / radii);		// Convert to ellipsoid space
+					}
+				});
+			}
+
+			// Gather the triangles of a static grid that may be touched by a swept ellipsoid (world space box), converted into ellipsoid space
+			inline static void GatherTriangles(const Data::SpatialGrid &grid, const Data::Aabb &box, const glm::vec3 &radii, std::vector<glm::vec3> &out_tris)
+			{
+				grid.Query(box, [&](unsigned int i)		// Visit nearby cells only
+				{
+					for (unsigned int k = 0; k < 3; k++)	// Iterate through each point
+						out_tris.push_back(grid.t.P(i, k) / radii);		// Convert to ellipsoid space
+				});
+			}
+
+			// Return the world space bounds of everything an ellipsoid can touch while moving by velocity
+			// Sliding never travels further than the original move, so this holds for every slide iteration
+			inline static Data::Aabb SweepBounds(const glm::vec3 &position, const glm::vec3 &velocity, const glm::vec3 &radii)
+			{
+				glm::vec3 reach = radii + glm::vec3(glm::length(velocity));		// Furthest the ellipsoid can reach
+				return Data::Aabb(position - reach, position + reach);	// Return bounds
+			}
+
+			// Move an ellipsoid from position by velocity, sliding along any triangles in the given objects and static grid
+			// Returns the final position of the ellipsoid centre
+			inline static glm::vec3 CollideAndSlide(const glm::vec3 &position, const glm::vec3 &velocity, const glm::vec3 &radii, const std::vector<Data::CollisionData*> &objects, const Data::SpatialGrid* grid = NULL)
+			{
+				// ------------------------- GATHER NEARBY TRIANGLES -------------------------
+				Data::Aabb box = SweepBounds(position, velocity, radii);	// Bounds of everything the move can touch
+
+				std::vector<glm::vec3> tris;	// Nearby triangles in ellipsoid space
+				for (Data::CollisionData* obj : objects)	// Iterate through each nearby object
+					GatherTriangles(obj, box, radii, tris);		// Gather triangles
+
+				if (grid)	// If there is static geometry
+					GatherTriangles(*grid, box, radii, tris);	// Gather triangles
+
+				// ------------------------- COLLIDE AND SLIDE -------------------------
+				glm::vec3 e_pos = position / radii;		// Position in ellipsoid space
+				glm::vec3 e_vel = velocity / radii;		// Velocity in ellipsoid space
+
+				for (unsigned int depth = 0; depth < SWEEP_MAX_ITERATIONS; depth++)		// Iterate until the move is used up
+				{
+					float speed = glm::length(e_vel);	// Remaining distance
+					if (speed < SWEEP_MIN_VELOCITY)		// If there is nothing left to move
+						break;	// Break from loop
+
+					Packet pk = { e_pos, e_vel, false, 1.0f, glm::vec3(0.0f) };	// Initialise packet
+
+					for (unsigned int i = 0; i + 2 < tris.size(); i += 3)	// Iterate through each nearby triangle
+						SweepTriangle(pk, tris[i], tris[i + 1], tris[i + 2]);	// Sweep triangle
+
+					if (!pk.found)	// If nothing was hit
+					{
+						e_pos += e_vel;		// Move the full distance
+						break;	// Break from loop
+					}
+
+					glm::vec3 dest = e_pos + e_vel;		// Where we wanted to end up
+					glm::vec3 new_base = e_pos;		// Where we end up
+					float nearest = pk.t * speed;	// Distance to the hit
+
+					if (nearest >= SWEEP_VERY_CLOSE)	// If not already touching
+					{
+						glm::vec3 dir = e_vel / speed;	// Direction of travel
+						new_base = e_pos + dir * (nearest - SWEEP_VERY_CLOSE);	// Stop just short of the hit
+						pk.point -= dir * SWEEP_VERY_CLOSE;		// Move the hit point back with us
+					}
+
+					glm::vec3 slide_normal = new_base - pk.point;	// Sliding plane normal
+					float sl = glm::length(slide_normal);	// Normal length
+					if (sl <= 0.0f)		// If the normal is degenerate
+					{
+						e_pos = new_base;	// Stay put
+						break;	// Break from loop
+					}
+
+					slide_normal /= sl;		// Normalise
+
+					glm::vec3 new_dest = dest - slide_normal * glm::dot(dest - pk.point, slide_normal);		// Project the destination onto the sliding plane
+
+					e_vel = new_dest - pk.point;	// Slide along the plane
+					e_pos = new_base;	// Advance
+				}
+
+				return e_pos * radii;	// Return position in world space
+			}
+		}
+	}
+}
+
+#endif
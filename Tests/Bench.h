@@ -0,0 +1,187 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#define BENCH_MIN_SECONDS	0.2		// Each timing repeats until it has run for at least this long
+#define BENCH_QUICK_SECONDS	0.0		// Timings under --quick run once
+
+#include <cstdio>	// Get printing
+#include <cstring>	// Get string compares
+#include <cstdint>	// Get fixed width integers
+#include <cmath>	// Get trigonometry
+#include <chrono>	// Get timers
+#include <random>	// Get random generators
+#include <vector>	// Get dynamic arrays
+#include <glm/glm.hpp>	// Get 3D variables
+
+// Shared helpers for the headless benchmark and correctness targets
+// Each target runs every size by default, or the smallest sizes only with --quick (used by ctest), and returns non-zero if a check failed
+namespace Bench
+{
+	// Kinds of synthetic triangle soup
+	enum SoupKind
+	{
+		SOUP_PLANE,		// Flat grid
+		SOUP_SPHERE,	// Closed UV sphere
+		SOUP_TERRAIN,	// Grid with noisy heights
+	};
+
+	static bool _quick = false;		// Only run the smallest sizes
+	static int _failures = 0;	// Number of failed checks
+
+	// Read the command line
+	static inline void Initialise(int argc, char** argv)
+	{
+		for (int i = 1; i < argc; i++)	// Iterate through each argument
+			if (strcmp(argv[i], "--quick") == 0)	// If only a smoke run is wanted
+				_quick = true;
+	}
+
+	// Return the current time in seconds
+	static inline double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();	// Return seconds
+	}
+
+	// Return the seconds one call of fn takes, repeating it until the total is long enough to trust
+	template <typename F>
+	static inline double Time(F fn)
+	{
+		double limit = _quick ? BENCH_QUICK_SECONDS : BENCH_MIN_SECONDS;	// Total time wanted
+		unsigned int runs = 0;	// Calls made
+		double start = Now(), elapsed = 0.0;
+
+		do
+		{
+			fn();	// Run
+			runs++;
+			elapsed = Now() - start;
+		} while (elapsed < limit);
+
+		return elapsed / runs;	// Return time per call
+	}
+
+	// Print one timing, with the time per item
+	static inline void Report(const char* name, size_t items, double seconds)
+	{
+		printf("  %-40s %9zu  %10.3f ms  %9.2f ns/item\n", name, items, seconds * 1e3, items ? seconds * 1e9 / items : 0.0);
+	}
+
+	// Print a comparison of a new path against the one it replaced
+	static inline void Compare(const char* name, size_t items, double old_seconds, double new_seconds)
+	{
+		printf("  %-40s %9zu  %10.3f ms -> %10.3f ms  (%.2fx)\n", name, items, old_seconds * 1e3, new_seconds * 1e3, new_seconds > 0.0 ? old_seconds / new_seconds : 0.0);
+	}
+
+	// Record a check, printing it if it failed
+	static inline bool Check(bool ok, const char* what)
+	{
+		if (!ok)	// If the check failed
+		{
+			_failures++;	// Count failure
+			printf("  FAILED: %s\n", what);		// Print failure
+		}
+
+		return ok;	// Return result
+	}
+
+	// Print the outcome and return the process exit code
+	static inline int Finish()
+	{
+		if (_failures)	// If anything failed
+			printf("%d check(s) failed\n", _failures);
+		else
+			printf("All checks passed\n");
+
+		return _failures ? 1 : 0;	// Return exit code
+	}
+
+	// Return the problem sizes to run
+	static inline std::vector<size_t> Sizes(size_t quick_max, size_t full_max)
+	{
+		std::vector<size_t> sizes;	// Powers of ten from 1k
+		for (size_t n = 1000; n <= (_quick ? quick_max : full_max); n *= 10)
+			sizes.push_back(n);
+
+		return sizes;	// Return sizes
+	}
+
+	// Return the name of a soup kind
+	static inline const char* SoupName(SoupKind kind)
+	{
+		return (kind == SOUP_PLANE) ? "plane" : (kind == SOUP_SPHERE) ? "sphere" : "terrain";	// Return name
+	}
+
+	// Build an indexed soup of roughly the given number of triangles (points, then three indices per triangle)
+	// Neighbouring triangles share their points exactly, as an imported mesh does
+	static inline void MakeIndexedSoup(SoupKind kind, size_t triangles, unsigned int seed, std::vector<glm::vec3> &out_points, std::vector<unsigned int> &out_indices)
+	{
+		std::mt19937 rng(seed);		// Deterministic noise
+		std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+		unsigned int cols = (unsigned int)glm::max(2.0f, std::sqrt((float)triangles * (kind == SOUP_SPHERE ? 1.0f : 0.5f)));	// Columns of quads
+		unsigned int rows = (unsigned int)glm::max(2.0f, (float)triangles / (2.0f * cols));		// Rows of quads
+		float size = 100.0f;	// World extent
+
+		out_points.clear();
+		out_indices.clear();
+
+		for (unsigned int r = 0; r <= rows; r++)	// Iterate through each row of points
+			for (unsigned int c = 0; c <= cols; c++)	// Iterate through each column of points
+			{
+				float u = (float)c / cols, v = (float)r / rows;		// Grid coordinates
+				if (kind == SOUP_SPHERE)	// If wrapping onto a sphere
+				{
+					float theta = v * 3.14159265f, phi = (c % cols) * 6.28318531f / cols;	// Angles (the last column wraps onto the first)
+					if (r == 0 || r == rows)	// If on a pole, every column shares one exact point
+						out_points.push_back(glm::vec3(0.0f, (r == 0) ? size * 0.5f : -size * 0.5f, 0.0f));
+					else
+						out_points.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)) * (size * 0.5f));
+				}
+				else
+				{
+					float h = (kind == SOUP_TERRAIN) ? 4.0f * std::sin(u * 17.0f) * std::cos(v * 13.0f) + noise(rng) : 0.0f;	// Height
+					out_points.push_back(glm::vec3((u - 0.5f) * size, h, (v - 0.5f) * size));
+				}
+			}
+
+		for (unsigned int r = 0; r < rows; r++)		// Iterate through each quad
+			for (unsigned int c = 0; c < cols; c++)
+			{
+				unsigned int a = r * (cols + 1) + c, b = a + 1, d = a + cols + 1, e = d + 1;	// Corners
+				unsigned int quad[6] = { a, d, e, a, e, b };	// Two triangles
+
+				bool first = !(kind == SOUP_SPHERE && r == rows - 1);	// The first triangle collapses at the bottom pole
+				bool second = !(kind == SOUP_SPHERE && r == 0);		// The second triangle collapses at the top pole
+				if (first) out_indices.insert(out_indices.end(), quad, quad + 3);
+				if (second) out_indices.insert(out_indices.end(), quad + 3, quad + 6);
+			}
+	}
+
+	// Build a soup of roughly the given number of triangles, three points per triangle
+	static inline std::vector<glm::vec3> MakeSoup(SoupKind kind, size_t triangles, unsigned int seed)
+	{
+		std::vector<glm::vec3> points, soup;	// Indexed points, expanded soup
+		std::vector<unsigned int> indices;
+		MakeIndexedSoup(kind, triangles, seed, points, indices);
+
+		soup.reserve(indices.size());
+		for (unsigned int i : indices)	// Expand each index
+			soup.push_back(points[i]);
+
+		return soup;	// Return soup
+	}
+
+	// Return a random unit vector
+	static inline glm::vec3 RandomDirection(std::mt19937 &rng)
+	{
+		std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+		while (true)	// Reject points outside the unit ball
+		{
+			glm::vec3 v(d(rng), d(rng), d(rng));
+			float l = glm::dot(v, v);
+			if (l > 1e-4f && l <= 1.0f)
+				return v / std::sqrt(l);	// Return direction
+		}
+	}
+}
+
+#endif
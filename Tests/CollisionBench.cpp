@@ -0,0 +1,988 @@
+// Collision benchmark and correctness checks
+// Times CollisionData construction, Update, IntersectRadii, IntersectVertex and the BVH, AABB tree and spatial grid queries on synthetic soups,
+// and checks every query against a brute-force reference over all triangles
+// Checks GJK, EPA and QuickHull against shapes whose distances and penetrations are known exactly, and the loose octree against brute force
+// Checks the raycast queries against brute force on rotated, non-uniformly scaled objects, and the swept ellipsoid against exact times of impact
+
+#include <cfloat>	// Get float limits
+#include <algorithm>	// Get sorting
+#include "Bench.h"	// Get timers, checks and soups
+#include "../SpatialGrid.h"		// Get collision data and the static grid
+#include "../AabbTree.h"	// Get the dynamic tree
+#include "../Gjk.h"		// Get convex shapes, GJK and EPA
+#include "../LooseOctree.h"		// Get the loose octree
+#include "../Raycast.h"	// Get the raycast queries
+#include "../Sweep.h"	// Get the swept ellipsoid
+
+#define RAYS	64		// Queries checked against brute force for each soup
+#define MOVERS	32		// Small moving objects tested with IntersectVertex for each soup
+#define OBJECTS	256		// Objects in the IntersectRadii all-pairs test
+#define OCTREE_HALF		128.0f	// Half size of the octree root in the octree test
+#define RAY_OBJECTS	16		// Objects in the raycast test
+#define RAY_DISTANCE	200.0f	// Length of the raycast test rays
+#define RAY_SCALE_MIN	0.02f	// Smallest scale on any axis of a raycast test object
+#define RAY_SCALE_MAX	0.1f	// Largest scale on any axis of a raycast test object
+#define CONVEX_TOLERANCE	0.002f	// Distance and depth tolerance of the convex queries, GJK on curved shapes converges to about this
+
+using namespace Collision::Ndc;
+
+// Return the closest hit fraction of the segment p0 -> p1 against every triangle of a soup, or FLT_MAX if nothing is hit
+static float BruteSegment(const std::vector<glm::vec3> &soup, const glm::vec3 &p0, const glm::vec3 &p1)
+{
+	glm::vec3 d = p1 - p0;	// Segment vector
+	float best = FLT_MAX;	// Closest hit
+
+	for (size_t i = 0; i + 2 < soup.size(); i += 3)		// Iterate through each triangle
+	{
+		glm::vec3 e0 = soup[i + 1] - soup[i], e1 = soup[i + 2] - soup[i];	// Edges from point 0
+		glm::vec3 pv = glm::cross(d, e1);
+		float det = glm::dot(e0, pv);	// Determinant
+		if (glm::abs(det) < 1e-8f)	// If parallel
+			continue;
+
+		glm::vec3 tv = p0 - soup[i];
+		float u = glm::dot(tv, pv) / det;	// Barycentric u
+		glm::vec3 qv = glm::cross(tv, e0);
+		float v = glm::dot(d, qv) / det;	// Barycentric v
+		float t = glm::dot(e1, qv) / det;	// Hit fraction
+
+		if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t <= 1.0f && t < best)	// If inside and closer
+			best = t;
+	}
+
+	return best;	// Return closest hit
+}
+
+// Return true if a sphere (local space) touches any triangle of an object
+static bool BruteSphere(const Data::CollisionData &cd, const glm::vec3 &centre, float radius)
+{
+	for (unsigned int i = 0; i < cd.t.Size(); i++)	// Iterate through each triangle
+	{
+		glm::vec3 cp = Detection::ClosestPointOnTriangle(centre, cd.t, i);
+		if (glm::dot(cp - centre, cp - centre) <= radius * radius)	// If within the radius
+			return true;
+	}
+
+	return false;
+}
+
+// Return a soup moved by a transform
+static std::vector<glm::vec3> TransformSoup(const glm::mat4 &m, const std::vector<glm::vec3> &soup)
+{
+	std::vector<glm::vec3> out(soup.size());
+	for (size_t i = 0; i < soup.size(); i++)	// Iterate through each point
+		out[i] = glm::vec3(m * glm::vec4(soup[i], 1.0f));
+
+	return out;
+}
+
+// Return true if two floats agree to a relative tolerance
+static bool Near(float a, float b, float tolerance)
+{
+	return glm::abs(a - b) <= tolerance * glm::max(1.0f, glm::max(glm::abs(a), glm::abs(b)));
+}
+
+// Check the collision data built from a soup against the soup itself
+static void CheckConstruction(const Data::CollisionData &cd, const std::vector<glm::vec3> &soup)
+{
+	Bench::Check(cd.t.Size() == soup.size() / 3, "construction keeps every triangle");
+	Bench::Check(cd.ti.size() == soup.size(), "construction indexes every triangle point");
+
+	bool indexed = true;	// Each triangle point matches its welded point
+	for (unsigned int i = 0; i < cd.t.Size() && indexed; i++)
+		for (unsigned int k = 0; k < 3; k++)
+			indexed &= glm::distance(cd.t.P(i, k), cd.pd[cd.ti[i * 3 + k]]) <= COLLISION_WELD_EPSILON;
+	Bench::Check(indexed, "construction point indices match the triangle points");
+
+	double sum_soup[3] = { 0.0, 0.0, 0.0 }, sum_t[3] = { 0.0, 0.0, 0.0 };	// Triangles are reordered, so compare the sums of their points
+	for (size_t i = 0; i < soup.size(); i++)
+	{
+		glm::vec3 p = cd.t.P((unsigned int)i / 3, (unsigned int)i % 3);
+		for (int c = 0; c < 3; c++)
+		{
+			sum_soup[c] += soup[i][c];
+			sum_t[c] += p[c];
+		}
+	}
+	Bench::Check(glm::abs(sum_soup[0] - sum_t[0]) + glm::abs(sum_soup[1] - sum_t[1]) + glm::abs(sum_soup[2] - sum_t[2]) <= 1e-3, "construction keeps the triangle points");
+
+	glm::vec3 centre(0.0f);		// Reference average of the unique points
+	for (const glm::vec3 &p : cd.pd)
+		centre += p;
+	centre /= (float)cd.pd.size();
+
+	float radius = 0.0f;	// Reference radius around the average
+	for (const glm::vec3 &p : cd.pd)
+		radius = glm::max(radius, glm::distance(p, centre));
+
+	Bench::Check(glm::distance(centre, cd.a) <= 1e-3f, "construction average matches brute force");
+	Bench::Check(Near(radius, cd.r, 1e-4f), "construction radius matches brute force");
+
+	bool bounded = true;	// Every triangle lies inside the hierarchy root
+	for (unsigned int i = 0; i < cd.t.Size() && bounded; i++)
+		for (unsigned int k = 0; k < 3; k++)
+			bounded &= cd.bvh.nodes[0].b.Contains(cd.t.P(i, k));
+	Bench::Check(bounded, "hierarchy root contains every triangle");
+}
+
+// Run every benchmark on one soup
+static void RunSoup(Bench::SoupKind kind, size_t triangles)
+{
+	std::mt19937 rng((unsigned int)triangles);	// Deterministic queries
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<glm::vec3> soup = Bench::MakeSoup(kind, triangles, 7);	// Local space soup
+	size_t n = soup.size() / 3;		// Triangles
+
+	printf("%s, %zu triangles\n", Bench::SoupName(kind), n);
+
+	// -------------------------- CONSTRUCTION --------------------------------------
+	Data::CollisionData* cd = NULL;
+	double t_build = Bench::Time([&]()
+	{
+		delete cd;
+		cd = new Data::CollisionData(COLLISION_TYPE_PER_VERTEX, soup);
+	});
+	Bench::Report("CollisionData construction", n, t_build);
+	CheckConstruction(*cd, soup);
+
+	// -------------------------- UPDATE --------------------------------------------
+	glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(10.0f, -4.0f, 3.0f)) * glm::rotate(glm::mat4(1.0f), 0.7f, glm::vec3(0.3f, 1.0f, 0.2f)) * glm::scale(glm::mat4(1.0f), glm::vec3(1.5f));
+	double t_update = Bench::Time([&]()
+	{
+		for (int i = 0; i < 1000; i++)	// Many updates per timing
+			cd->Update(m);
+	}) / 1000.0;
+	Bench::Report("CollisionData::Update", 1, t_update);
+
+	Bench::Check(glm::distance(cd->wa, glm::vec3(m * glm::vec4(cd->a, 1.0f))) <= 1e-3f, "update moves the average");
+	Bench::Check(Near(cd->wr, cd->r * 1.5f, 1e-4f), "update scales the radius");
+
+	std::vector<glm::vec3> world = TransformSoup(m, soup);	// World space soup
+	bool inside = true;		// World bounds hold every world point
+	for (const glm::vec3 &p : world)
+		inside &= Data::Aabb(cd->wb.min - glm::vec3(1e-3f), cd->wb.max + glm::vec3(1e-3f)).Contains(p);
+	Bench::Check(inside, "update bounds contain every world point");
+
+	Data::Aabb bounds;	// World bounds of the soup
+	for (const glm::vec3 &p : world)
+		bounds.Grow(p);
+	glm::vec3 lo = bounds.min - glm::vec3(5.0f), ext = bounds.Extent() + glm::vec3(10.0f);	// Query region
+
+	// -------------------------- SEGMENTS (BVH) ------------------------------------
+	std::vector<glm::vec3> p0(RAYS), p1(RAYS);	// Query segments
+	for (int r = 0; r < RAYS; r++)
+	{
+		p0[r] = lo + glm::vec3(unit(rng), unit(rng), unit(rng)) * ext;
+		p1[r] = bounds.Centre() + Bench::RandomDirection(rng) * glm::length(ext) * 0.3f;
+	}
+
+	std::vector<float> hit_bvh(RAYS), hit_brute(RAYS);	// Closest hit fractions
+	double t_seg = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+		{
+			float t = FLT_MAX;
+			unsigned int tri = 0;
+			hit_bvh[r] = Intersection::IntersectSegment(cd, p0[r], p1[r], t, tri) ? t : FLT_MAX;
+		}
+	});
+	double t_seg_brute = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+			hit_brute[r] = BruteSegment(world, p0[r], p1[r]);
+	});
+	Bench::Compare("IntersectSegment (brute -> BVH)", RAYS, t_seg_brute, t_seg);
+
+	int seg_ok = 0, seg_hits = 0;
+	for (int r = 0; r < RAYS; r++)
+	{
+		bool same = (hit_bvh[r] == FLT_MAX) ? (hit_brute[r] == FLT_MAX) : (hit_brute[r] != FLT_MAX && Near(hit_bvh[r], hit_brute[r], 1e-3f));
+		seg_ok += same;
+		seg_hits += (hit_brute[r] != FLT_MAX);
+	}
+	Bench::Check(seg_ok == RAYS, "IntersectSegment matches brute force");
+	Bench::Check(seg_hits > 0, "IntersectSegment queries hit something");
+
+	// -------------------------- SPHERES (BVH) -------------------------------------
+	std::vector<glm::vec3> centres(RAYS);	// Query spheres
+	std::vector<float> radii(RAYS);
+	for (int r = 0; r < RAYS; r++)
+	{
+		unsigned int tri = (unsigned int)(unit(rng) * (n - 1));		// Near a random triangle
+		centres[r] = world[tri * 3] + Bench::RandomDirection(rng) * (0.5f + 4.0f * unit(rng));
+		radii[r] = 0.25f + 2.0f * unit(rng);
+	}
+
+	std::vector<char> sphere_bvh(RAYS), sphere_brute(RAYS);
+	double t_sphere = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+			sphere_bvh[r] = Intersection::IntersectSphere(cd, centres[r], radii[r]);
+	});
+	double t_sphere_brute = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+			sphere_brute[r] = BruteSphere(*cd, cd->ToLocal(centres[r]), radii[r] / 1.5f);
+	});
+	Bench::Compare("IntersectSphere (brute -> BVH)", RAYS, t_sphere_brute, t_sphere);
+	Bench::Check(sphere_bvh == sphere_brute, "IntersectSphere matches brute force");
+
+	// -------------------------- BVH BOX QUERY -------------------------------------
+	bool query_ok = true;
+	for (int r = 0; r < RAYS; r++)
+	{
+		glm::vec3 c = cd->ToLocal(centres[r]);
+		Data::Aabb box(c - glm::vec3(radii[r] * 3.0f), c + glm::vec3(radii[r] * 3.0f));
+
+		std::vector<unsigned int> found, expected;
+		cd->bvh.Query(box, [&](unsigned int prim) { if (cd->tb[prim].Overlaps(box)) found.push_back(prim); });	// Whole leaves are reported, so filter them
+		for (unsigned int i = 0; i < cd->t.Size(); i++)
+			if (cd->tb[i].Overlaps(box))
+				expected.push_back(i);
+
+		std::sort(found.begin(), found.end());
+		query_ok &= (found == expected);
+	}
+	Bench::Check(query_ok, "Bvh::Query matches brute force");
+
+	// -------------------------- INTERSECT VERTEX ----------------------------------
+	std::vector<glm::vec3> mover_soup = Bench::MakeSoup(Bench::SOUP_SPHERE, 200, 3);	// Small moving object
+	for (glm::vec3 &p : mover_soup)
+		p *= 0.02f;		// Radius one
+
+	Data::CollisionData mover(COLLISION_TYPE_PER_VERTEX, mover_soup);
+	std::vector<glm::mat4> mover_m(MOVERS);
+	std::vector<glm::vec3> mover_v(MOVERS);
+	std::vector<float> mover_s(MOVERS);
+	for (int r = 0; r < MOVERS; r++)
+	{
+		unsigned int tri = (unsigned int)(unit(rng) * (n - 1));		// Above a random triangle
+		glm::vec3 centre = (world[tri * 3] + world[tri * 3 + 1] + world[tri * 3 + 2]) / 3.0f;
+		glm::vec3 normal = glm::normalize(glm::cross(world[tri * 3 + 1] - world[tri * 3], world[tri * 3 + 2] - world[tri * 3]));
+
+		mover_m[r] = glm::translate(glm::mat4(1.0f), centre + normal * (1.5f + 2.0f * unit(rng)) * ((r & 1) ? 1.0f : -1.0f));
+		mover_v[r] = -normal * ((r & 1) ? 1.0f : -1.0f) + Bench::RandomDirection(rng) * 0.3f;
+		mover_s[r] = 3.0f * unit(rng);
+	}
+
+	std::vector<char> vertex_fast(MOVERS), vertex_brute(MOVERS);
+	double t_vertex = Bench::Time([&]()
+	{
+		for (int r = 0; r < MOVERS; r++)
+		{
+			mover.Update(mover_m[r]);
+			vertex_fast[r] = Intersection::IntersectVertex(mover_s[r], mover_v[r], &mover, cd);
+		}
+	});
+	double t_vertex_brute = Bench::Time([&]()
+	{
+		for (int r = 0; r < MOVERS; r++)
+		{
+			glm::vec3 step = glm::normalize(mover_v[r]) * mover_s[r];
+			vertex_brute[r] = false;
+			for (size_t i = 0; i < mover.pd.size() && !vertex_brute[r]; i++)
+			{
+				glm::vec3 p = glm::vec3(mover_m[r] * glm::vec4(mover.pd[i], 1.0f));
+				vertex_brute[r] = (BruteSegment(world, p, p + step) != FLT_MAX);
+			}
+		}
+	});
+	Bench::Compare("IntersectVertex (brute -> BVH)", MOVERS, t_vertex_brute, t_vertex);
+	Bench::Check(vertex_fast == vertex_brute, "IntersectVertex matches brute force");
+	Bench::Check(std::count(vertex_brute.begin(), vertex_brute.end(), 1) > 0, "IntersectVertex queries hit something");
+	Bench::Check(!Intersection::IntersectVertex(1.0f, glm::vec3(0.0f), &mover, cd), "IntersectVertex ignores a still object");
+
+	// -------------------------- AABB TREE -----------------------------------------
+	Data::AabbTree tree;
+	std::vector<int> proxies(n);
+	double t_tree = Bench::Time([&]()
+	{
+		tree = Data::AabbTree();
+		for (size_t i = 0; i < n; i++)
+		{
+			Data::Aabb box(world[i * 3], world[i * 3]);
+			box.Grow(world[i * 3 + 1]);
+			box.Grow(world[i * 3 + 2]);
+			proxies[i] = tree.CreateProxy(box, (void*)(size_t)i);
+		}
+	});
+	Bench::Report("AabbTree build (one proxy per triangle)", n, t_tree);
+
+	bool tree_query = true, tree_ray = true;
+	double t_tree_query = 0.0;
+	for (int r = 0; r < RAYS; r++)
+	{
+		Data::Aabb box(centres[r] - glm::vec3(radii[r] * 3.0f), centres[r] + glm::vec3(radii[r] * 3.0f));
+
+		std::vector<int> found, expected;
+		double start = Bench::Now();
+		tree.Query(box, [&](int proxy) -> bool { found.push_back(proxy); return true; });
+		t_tree_query += Bench::Now() - start;
+
+		for (size_t i = 0; i < n; i++)
+			if (tree.GetFatAabb(proxies[i]).Overlaps(box))
+				expected.push_back(proxies[i]);
+
+		std::sort(found.begin(), found.end());
+		std::sort(expected.begin(), expected.end());
+		tree_query &= (found == expected);
+
+		// Every fat box on the segment, nearest first
+		glm::vec3 dir = p1[r] - p0[r];
+		found.clear();
+		expected.clear();
+		tree.Raycast(p0[r], dir, 1.0f, [&](int proxy, float&) -> bool { found.push_back(proxy); return false; });
+		for (size_t i = 0; i < n; i++)
+			if (tree.GetFatAabb(proxies[i]).RayEntry(p0[r], 1.0f / dir, 1.0f) != FLT_MAX)
+				expected.push_back(proxies[i]);
+
+		std::sort(found.begin(), found.end());
+		std::sort(expected.begin(), expected.end());
+		tree_ray &= (found == expected);
+	}
+	Bench::Report("AabbTree::Query", RAYS, t_tree_query);
+	Bench::Check(tree_query, "AabbTree::Query matches brute force");
+	Bench::Check(tree_ray, "AabbTree::Raycast matches brute force");
+
+	double t_move = Bench::Time([&]()
+	{
+		glm::vec3 offset = Bench::RandomDirection(rng) * 0.05f;		// Small moves mostly stay inside the fat boxes
+		for (size_t i = 0; i < n; i++)
+		{
+			Data::Aabb box = tree.GetFatAabb(proxies[i]);
+			box.Inflate(-AABB_TREE_MARGIN);
+			tree.MoveProxy(proxies[i], Data::Aabb(box.min + offset, box.max + offset));
+		}
+	});
+	Bench::Report("AabbTree::MoveProxy (every proxy)", n, t_move);
+
+	// -------------------------- SPATIAL GRID --------------------------------------
+	Data::SpatialGrid grid;
+	double t_grid = Bench::Time([&]()
+	{
+		grid.Clear();
+		grid.Add(cd, NULL);
+		grid.Build();
+	});
+	Bench::Report("SpatialGrid build", n, t_grid);
+
+	bool grid_query = true, grid_once = true;
+	int grid_ray = 0;
+	double t_grid_query = 0.0, t_grid_ray = 0.0;
+	for (int r = 0; r < RAYS; r++)
+	{
+		Data::Aabb box(centres[r] - glm::vec3(radii[r] * 3.0f), centres[r] + glm::vec3(radii[r] * 3.0f));
+
+		std::vector<unsigned int> found, expected;
+		double start = Bench::Now();
+		grid.Query(box, [&](unsigned int i) { found.push_back(i); });
+		t_grid_query += Bench::Now() - start;
+
+		for (unsigned int i = 0; i < grid.tb.size(); i++)
+			if (grid.tb[i].Overlaps(box))
+				expected.push_back(i);
+
+		std::sort(found.begin(), found.end());
+		grid_once &= (std::adjacent_find(found.begin(), found.end()) == found.end());
+		found.erase(std::unique(found.begin(), found.end()), found.end());
+		grid_query &= (found == expected);
+
+		// Closest hit along the segment
+		glm::vec3 dir = p1[r] - p0[r];
+		float best = 1.0f;
+		bool hit = false;
+		start = Bench::Now();
+		grid.Raycast(p0[r], dir, 1.0f, [&](unsigned int i, float &t_max) -> bool
+		{
+			float t;
+			if (Detection::RayToTriangle(p0[r], dir, grid.t, i, t_max, t))
+			{
+				t_max = best = t;
+				hit = true;
+			}
+			return false;
+		});
+		t_grid_ray += Bench::Now() - start;
+
+		grid_ray += hit ? (hit_brute[r] != FLT_MAX && Near(best, hit_brute[r], 1e-3f)) : (hit_brute[r] == FLT_MAX);
+	}
+	Bench::Report("SpatialGrid::Query", RAYS, t_grid_query);
+	Bench::Report("SpatialGrid::Raycast", RAYS, t_grid_ray);
+	Bench::Check(grid_query, "SpatialGrid::Query matches brute force");
+	Bench::Check(grid_once, "SpatialGrid::Query reports each triangle once");
+	Bench::Check(grid_ray == RAYS, "SpatialGrid::Raycast matches brute force");
+
+	delete cd;
+}
+
+// Return the world points of an object's triangles, in the object's own triangle order
+static std::vector<glm::vec3> WorldTriangles(const Data::CollisionData &cd)
+{
+	std::vector<glm::vec3> out(cd.t.Size() * 3);
+	for (unsigned int i = 0; i < cd.t.Size(); i++)	// Iterate through each triangle
+		for (unsigned int k = 0; k < 3; k++)
+			out[i * 3 + k] = glm::vec3(cd.m * glm::vec4(cd.t.P(i, k), 1.0f));
+
+	return out;
+}
+
+// Return true if a hit agrees with the world triangle it names: the brute force distance, a point on its plane and its normal
+static bool HitMatches(const Raycast::RayHit &h, const std::vector<glm::vec3> &world, float t)
+{
+	const glm::vec3* p = &world[h.triangle * 3];
+	glm::vec3 n = glm::normalize(glm::cross(p[1] - p[0], p[2] - p[0]));	// Normal of the moved points, no inverse transpose involved
+
+	return Near(h.t, t, 1e-3f) && Near(glm::dot(h.point, n), glm::dot(p[0], n), 1e-4f) && glm::dot(h.normal, n) >= 0.9999f;
+}
+
+// Return true if a hit list names each object brute force hits exactly once, nearest first, each agreeing with its triangle
+static bool HitsMatch(const std::vector<Raycast::RayHit> &hits, const std::vector<std::vector<glm::vec3>> &world, const std::vector<float> &expected)
+{
+	std::vector<char> seen(expected.size(), 0);
+	size_t count = (size_t)std::count_if(expected.begin(), expected.end(), [](float t) { return t != FLT_MAX; });
+	bool ok = (hits.size() == count);
+
+	for (size_t i = 0; i < hits.size() && ok; i++)
+	{
+		size_t o = (size_t)hits[i].data;
+		ok &= o < expected.size() && !seen[o] && expected[o] != FLT_MAX && HitMatches(hits[i], world[o], expected[o]) && (i == 0 || hits[i - 1].t <= hits[i].t);
+		seen[o] = 1;
+	}
+
+	return ok;
+}
+
+// Check RaycastClosest and RaycastAll, through the AABB tree and the spatial grid, against brute force over every triangle of rotated,
+// non-uniformly scaled objects, so the inverse transpose normals are checked against normals taken from the moved points
+static void RunRaycast()
+{
+	std::mt19937 rng(11);	// Deterministic objects and rays
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f), side(-1.0f, 1.0f);
+
+	printf("raycast, %d rotated objects scaled up to %g to 1 between axes\n", RAY_OBJECTS, RAY_SCALE_MAX / RAY_SCALE_MIN);
+
+	std::vector<Data::CollisionData*> objects(RAY_OBJECTS);
+	std::vector<std::vector<glm::vec3>> world(RAY_OBJECTS);		// World triangles of each object
+	Data::AabbTree tree;
+	Data::SpatialGrid grid;
+	for (int i = 0; i < RAY_OBJECTS; i++)
+	{
+		glm::vec3 scale = glm::vec3(RAY_SCALE_MIN) + glm::vec3(unit(rng), unit(rng), unit(rng)) * (RAY_SCALE_MAX - RAY_SCALE_MIN);
+		glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(side(rng), side(rng), side(rng)) * 20.0f) * glm::rotate(glm::mat4(1.0f), 6.2831853f * unit(rng), Bench::RandomDirection(rng)) * glm::scale(glm::mat4(1.0f), scale);
+
+		objects[i] = new Data::CollisionData(COLLISION_TYPE_PER_VERTEX, Bench::MakeSoup((i & 1) ? Bench::SOUP_TERRAIN : Bench::SOUP_SPHERE, 2000, i + 1));
+		objects[i]->Update(m);
+		world[i] = WorldTriangles(*objects[i]);
+
+		tree.CreateProxy(objects[i]->wb, (void*)(size_t)i);
+		grid.Add(objects[i], (void*)(size_t)i);
+	}
+	grid.Build();
+
+	auto all = [&](void* data) -> Data::CollisionData* { return objects[(size_t)data]; };	// Resolve every object
+	auto even = [&](void* data) -> Data::CollisionData* { return ((size_t)data & 1) ? NULL : objects[(size_t)data]; };	// Skip every odd object
+
+	bool closest_tree = true, closest_grid = true, all_tree = true, all_grid = true, skipped = true;
+	int rays = RAYS * 4, hits = 0, misses = 0;
+	double t_brute = 0.0, t_tree = 0.0, t_grid = 0.0;
+	std::vector<Raycast::RayHit> found;
+	for (int r = 0; r < rays; r++)
+	{
+		glm::vec3 origin = glm::vec3(side(rng), side(rng), side(rng)) * 40.0f;
+		glm::vec3 target = objects[r % RAY_OBJECTS]->wa + glm::vec3(side(rng), side(rng), side(rng)) * 4.0f;	// Near an object, so some rays pass beside it
+		glm::vec3 dir = glm::normalize(target - origin);
+
+		std::vector<float> expected(RAY_OBJECTS), expected_even(RAY_OBJECTS, FLT_MAX);	// Brute force closest hit distance on each object
+		double start = Bench::Now();
+		for (int i = 0; i < RAY_OBJECTS; i++)
+		{
+			float f = BruteSegment(world[i], origin, origin + dir * RAY_DISTANCE);
+			expected[i] = (f == FLT_MAX) ? FLT_MAX : f * RAY_DISTANCE;
+		}
+		t_brute += Bench::Now() - start;
+
+		for (int i = 0; i < RAY_OBJECTS; i += 2)
+			expected_even[i] = expected[i];
+		float nearest = *std::min_element(expected.begin(), expected.end()), nearest_even = *std::min_element(expected_even.begin(), expected_even.end());
+		hits += (nearest != FLT_MAX);
+		misses += (nearest == FLT_MAX);
+
+		// Closest hit
+		Raycast::RayHit h;
+		start = Bench::Now();
+		bool hit = Raycast::RaycastClosest(tree, origin, dir, RAY_DISTANCE, h, all);
+		t_tree += Bench::Now() - start;
+		closest_tree &= hit ? (nearest != FLT_MAX && h.cd == objects[(size_t)h.data] && HitMatches(h, world[(size_t)h.data], nearest)) : (nearest == FLT_MAX);
+
+		start = Bench::Now();
+		hit = Raycast::RaycastClosest(grid, origin, dir, RAY_DISTANCE, h, all);
+		t_grid += Bench::Now() - start;
+		closest_grid &= hit ? (nearest != FLT_MAX && h.cd == objects[(size_t)h.data] && HitMatches(h, world[(size_t)h.data], nearest)) : (nearest == FLT_MAX);
+
+		hit = Raycast::RaycastClosest(grid, origin, dir, RAY_DISTANCE, h, even);
+		skipped &= hit ? (nearest_even != FLT_MAX && HitMatches(h, world[(size_t)h.data], nearest_even)) : (nearest_even == FLT_MAX);
+
+		// Every hit object
+		Raycast::RaycastAll(tree, origin, dir, RAY_DISTANCE, found, all);
+		all_tree &= HitsMatch(found, world, expected);
+
+		Raycast::RaycastAll(grid, origin, dir, RAY_DISTANCE, found, all);
+		all_grid &= HitsMatch(found, world, expected);
+
+		Raycast::RaycastAll(tree, origin, dir, RAY_DISTANCE, found, even);
+		skipped &= HitsMatch(found, world, expected_even);
+	}
+
+	Bench::Compare("RaycastClosest (brute -> AabbTree)", rays, t_brute, t_tree);
+	Bench::Compare("RaycastClosest (brute -> SpatialGrid)", rays, t_brute, t_grid);
+	Bench::Check(hits > 0 && misses > 0, "raycast queries both hit and miss");
+	Bench::Check(closest_tree, "RaycastClosest through the AABB tree matches brute force, normals included");
+	Bench::Check(closest_grid, "RaycastClosest through the spatial grid matches brute force, normals included");
+	Bench::Check(all_tree, "RaycastAll through the AABB tree matches brute force, normals included");
+	Bench::Check(all_grid, "RaycastAll through the spatial grid matches brute force, normals included");
+	Bench::Check(skipped, "raycasts skip objects the resolver returns NULL for");
+
+	for (Data::CollisionData* cd : objects)
+		delete cd;
+}
+
+// Return the time a unit sphere sweeping from base by vel first touches a triangle, outputting the contact point, or -1 if it misses
+static float SweepTime(const glm::vec3 &base, const glm::vec3 &vel, const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2, glm::vec3 &out_point)
+{
+	Sweep::Packet pk = { base, vel, false, 1.0f, glm::vec3(0.0f) };
+	Sweep::SweepTriangle(pk, p0, p1, p2);
+	out_point = pk.point;
+
+	return pk.found ? pk.t : -1.0f;
+}
+
+// Check the swept sphere against a face, an edge and a vertex whose times of impact are known exactly, and slide an ellipsoid into a floor and a corner
+static void RunSweep()
+{
+	printf("swept ellipsoid\n");
+
+	// -------------------------- TIME OF IMPACT ------------------------------------
+	glm::vec3 point;
+	float t = SweepTime(glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(0.0f, -4.0f, 0.0f), glm::vec3(-5.0f, 0.0f, -5.0f), glm::vec3(5.0f, 0.0f, -5.0f), glm::vec3(0.0f, 0.0f, 5.0f), point);
+	Bench::Check(Near(t, 0.5f, 1e-5f) && glm::distance(point, glm::vec3(0.0f)) <= 1e-5f, "a sphere dropped onto a face touches it at the expected time and point");
+
+	// Falls at 45 degrees onto the edge along x of a triangle lying behind it, the face plane is touched first but outside the triangle
+	t = SweepTime(glm::vec3(0.0f, 2.0f, 2.0f), glm::vec3(0.0f, -2.0f, -2.0f), glm::vec3(-5.0f, 0.0f, 0.0f), glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -5.0f), point);
+	Bench::Check(Near(t, 1.0f - 1.0f / (2.0f * std::sqrt(2.0f)), 1e-5f) && glm::distance(point, glm::vec3(0.0f)) <= 1e-5f, "a sphere swept into an edge touches it at the expected time and point");
+
+	// Falls along the diagonal onto a corner whose triangle lies away from every axis it approaches along
+	t = SweepTime(glm::vec3(2.0f), glm::vec3(-2.0f), glm::vec3(0.0f), glm::vec3(-5.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, -5.0f), point);
+	Bench::Check(Near(t, 1.0f - 1.0f / (2.0f * std::sqrt(3.0f)), 1e-5f) && glm::distance(point, glm::vec3(0.0f)) <= 1e-5f, "a sphere swept into a vertex touches it at the expected time and point");
+
+	t = SweepTime(glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(0.0f, -1.5f, 0.0f), glm::vec3(-5.0f, 0.0f, -5.0f), glm::vec3(5.0f, 0.0f, -5.0f), glm::vec3(0.0f, 0.0f, 5.0f), point);
+	Bench::Check(t < 0.0f, "a sphere stopping short of a face misses it");
+
+	// -------------------------- FLOOR ---------------------------------------------
+	std::vector<glm::vec3> floor = { glm::vec3(-50.0f, 0.0f, -50.0f), glm::vec3(0.0f, 0.0f, 50.0f), glm::vec3(50.0f, 0.0f, -50.0f) };
+	Data::CollisionData floor_cd(COLLISION_TYPE_PER_VERTEX, floor);
+	floor_cd.Update(glm::mat4(1.0f));
+	std::vector<Data::CollisionData*> objects = { &floor_cd };
+
+	glm::vec3 radii(2.0f, 1.0f, 2.0f);	// Squashed ellipsoid, so ellipsoid space differs from world space
+	glm::vec3 end = Sweep::CollideAndSlide(glm::vec3(0.0f, 4.0f, 0.0f), glm::vec3(3.0f, -6.0f, 0.0f), radii, objects);
+	Bench::Check(end.y > radii.y && end.y <= radii.y * (1.0f + SWEEP_VERY_CLOSE) && Near(end.x, 3.0f, 1e-4f) && end.z == 0.0f, "an ellipsoid falling onto a floor stops one radius above it and slides the rest of the move along it");
+
+	// -------------------------- CORNER --------------------------------------------
+	// Two walls meeting at 60 degrees along the y axis, opening towards +z. Pushing into the corner bounces between the walls,
+	// each slide keeping half the move, so the move is never used up and only SWEEP_MAX_ITERATIONS ends the loop
+	glm::vec3 d0(0.5f, 0.0f, 0.8660254f), d1(-0.5f, 0.0f, 0.8660254f), up(0.0f, 10.0f, 0.0f);	// Wall directions from the corner
+	std::vector<glm::vec3> corner = { -up, d0 * 20.0f - up, d0 * 20.0f + up, -up, d0 * 20.0f + up, up,
+									  -up, up, d1 * 20.0f + up, -up, d1 * 20.0f + up, d1 * 20.0f - up };
+	Data::CollisionData corner_cd(COLLISION_TYPE_PER_VERTEX, corner);
+	corner_cd.Update(glm::mat4(1.0f));
+	objects = { &corner_cd };
+
+	glm::vec3 start(0.2f, 0.0f, 8.0f), move(-0.1f, 0.0f, -20.0f);
+	double t_slide = Bench::Time([&]()
+	{
+		for (int i = 0; i < 1000; i++)	// Many slides per timing
+			end = Sweep::CollideAndSlide(start, move, glm::vec3(1.0f), objects);
+	}) / 1000.0;
+	Bench::Report("CollideAndSlide (into a corner)", 1, t_slide);
+
+	glm::vec3 n0(-0.8660254f, 0.0f, 0.5f), n1(0.8660254f, 0.0f, 0.5f);	// Wall normals, facing into the corner
+	Bench::Check(glm::dot(end, n0) >= 1.0f - 1e-3f && glm::dot(end, n1) >= 1.0f - 1e-3f, "an ellipsoid slid into a corner stays outside both walls");
+	Bench::Check(end.z >= 2.0f - 1e-3f && end.z < start.z && Sweep::SweepBounds(start, move, glm::vec3(1.0f)).Contains(end), "an ellipsoid slid into a corner moves into it and stays within its sweep bounds");
+}
+
+// Return a box from its centre and half extents
+static Data::Aabb CentredBox(const glm::vec3 &centre, const glm::vec3 &half)
+{
+	return Data::Aabb(centre - half, centre + half);
+}
+
+// Return a random octree object: mostly small, some spanning many cells, some on cell boundaries, some leaving the root
+static Data::Aabb OctreeObject(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f), side(-1.0f, 1.0f);
+	float kind = unit(rng);
+	glm::vec3 centre(side(rng), side(rng), side(rng));
+
+	if (kind < 0.7f)	// Small
+		return CentredBox(centre * (OCTREE_HALF - 8.0f), glm::vec3(0.1f + 2.0f * unit(rng), 0.1f + 2.0f * unit(rng), 0.1f + 2.0f * unit(rng)));
+	if (kind < 0.85f)	// Large, wider than the loose bounds of deep cells
+		return CentredBox(centre * (OCTREE_HALF * 0.5f), glm::vec3(5.0f + 55.0f * unit(rng)));
+	if (kind < 0.95f)	// Centred on a cell boundary
+	{
+		glm::vec3 c = glm::floor(centre * 4.0f) * (OCTREE_HALF / 4.0f);
+		return CentredBox(c, glm::vec3(0.5f + 4.0f * unit(rng)));
+	}
+
+	return CentredBox(centre * (OCTREE_HALF * 1.5f), glm::vec3(10.0f + 20.0f * unit(rng)));	// Partly or wholly outside the root
+}
+
+// Check the loose octree against brute force over every live object, after inserts, removes and moves
+static void RunOctree(size_t n)
+{
+	std::mt19937 rng((unsigned int)n + 5);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f), side(-1.0f, 1.0f);
+
+	printf("loose octree, %zu objects\n", n);
+
+	// -------------------------- INSERT --------------------------------------------
+	Data::LooseOctree octree(glm::vec3(0.0f), OCTREE_HALF);
+	std::vector<Data::Aabb> boxes(n);
+	std::vector<int> proxies(n);
+	std::vector<char> alive(n, 1);
+	for (Data::Aabb &b : boxes)
+		b = OctreeObject(rng);
+
+	double t_build = Bench::Time([&]()
+	{
+		octree = Data::LooseOctree(glm::vec3(0.0f), OCTREE_HALF);
+		for (size_t i = 0; i < n; i++)
+			proxies[i] = octree.CreateProxy(boxes[i], (void*)(size_t)i);
+	});
+	Bench::Report("LooseOctree build", n, t_build);
+
+	// -------------------------- REMOVE AND MOVE -----------------------------------
+	double t_move = Bench::Time([&]()
+	{
+		for (size_t i = 0; i < n; i++)
+			if (alive[i])
+			{
+				glm::vec3 offset = Bench::RandomDirection(rng) * 0.05f;		// Small moves mostly stay in their cells
+				boxes[i] = Data::Aabb(boxes[i].min + offset, boxes[i].max + offset);
+				octree.MoveProxy(proxies[i], boxes[i]);
+			}
+	});
+	Bench::Report("LooseOctree::MoveProxy (every proxy)", n, t_move);
+
+	bool data = true;
+	for (size_t i = 0; i < n; i++)
+	{
+		float r = unit(rng);
+		if (r < 0.1f)	// Remove
+		{
+			octree.DestroyProxy(proxies[i]);
+			alive[i] = 0;
+		}
+		else if (r < 0.3f)	// Move across cells, sometimes growing past the loose bounds or leaving the root
+		{
+			boxes[i] = OctreeObject(rng);
+			octree.MoveProxy(proxies[i], boxes[i]);
+		}
+		else if (r < 0.4f)	// Grow in place
+		{
+			boxes[i] = CentredBox(boxes[i].Centre(), boxes[i].Extent() * (1.0f + 4.0f * unit(rng)));
+			octree.MoveProxy(proxies[i], boxes[i]);
+		}
+	}
+	for (size_t i = 0; i < n; i += 20)	// Insert again into the freed proxies
+		if (!alive[i])
+		{
+			boxes[i] = OctreeObject(rng);
+			proxies[i] = octree.CreateProxy(boxes[i], (void*)i);
+			alive[i] = 1;
+		}
+
+	size_t live = 0;
+	for (size_t i = 0; i < n; i++)
+		if (alive[i])
+		{
+			live++;
+			data &= octree.GetData(proxies[i]) == (void*)i && octree.GetAabb(proxies[i]).min == boxes[i].min;
+		}
+	Bench::Check(octree.GetCount() == live, "LooseOctree counts every live proxy");
+	Bench::Check(data, "LooseOctree keeps each proxy's data and box");
+
+	// -------------------------- QUERIES -------------------------------------------
+	auto check = [&](std::vector<int> found, std::vector<int> expected)	// Same proxies, each once
+	{
+		std::sort(found.begin(), found.end());
+		std::sort(expected.begin(), expected.end());
+		return found == expected;
+	};
+
+	bool box_ok = true, sphere_ok = true, frustum_ok = true, ray_ok = true, closest_ok = true;
+	double t_query = 0.0, t_brute = 0.0;
+	for (int r = 0; r < RAYS; r++)
+	{
+		std::vector<int> found, expected;
+
+		// Box
+		Data::Aabb box = CentredBox(glm::vec3(side(rng), side(rng), side(rng)) * OCTREE_HALF, glm::vec3(1.0f + 19.0f * unit(rng)));
+		double start = Bench::Now();
+		octree.Query(box, [&](int id) { found.push_back(id); return true; });
+		t_query += Bench::Now() - start;
+		start = Bench::Now();
+		for (size_t i = 0; i < n; i++)
+			if (alive[i] && boxes[i].Overlaps(box))
+				expected.push_back(proxies[i]);
+		t_brute += Bench::Now() - start;
+		box_ok &= check(found, expected);
+
+		// Sphere
+		glm::vec3 centre = box.Centre();
+		float radius = box.Extent().x * 0.5f;
+		found.clear();
+		expected.clear();
+		octree.QuerySphere(centre, radius, [&](int id) { found.push_back(id); return true; });
+		for (size_t i = 0; i < n; i++)
+		{
+			glm::vec3 d = centre - glm::clamp(centre, boxes[i].min, boxes[i].max);
+			if (alive[i] && glm::dot(d, d) <= radius * radius)
+				expected.push_back(proxies[i]);
+		}
+		sphere_ok &= check(found, expected);
+
+		// Frustum
+		glm::vec3 eye = glm::vec3(side(rng), side(rng), side(rng)) * OCTREE_HALF * 1.2f;
+		Frustum frustum(glm::perspective(glm::radians(30.0f + 60.0f * unit(rng)), 16.0f / 9.0f, 0.5f, 50.0f + 200.0f * unit(rng)) * glm::lookAt(eye, centre, glm::vec3(0.0f, 1.0f, 0.0f)));
+		found.clear();
+		expected.clear();
+		octree.QueryFrustum(frustum, [&](int id) { found.push_back(id); return true; });
+		for (size_t i = 0; i < n; i++)
+			if (alive[i] && frustum.TestAabb(boxes[i].min, boxes[i].max))
+				expected.push_back(proxies[i]);
+		frustum_ok &= check(found, expected);
+
+		// Ray, every box along it and then the nearest
+		glm::vec3 dir = centre + Bench::RandomDirection(rng) * 20.0f - eye, inv_dir = 1.0f / dir;
+		found.clear();
+		expected.clear();
+		octree.Raycast(eye, dir, 1.0f, [&](int id, float&) { found.push_back(id); return false; });
+		float nearest = FLT_MAX;
+		for (size_t i = 0; i < n; i++)
+			if (alive[i])
+			{
+				float t = boxes[i].RayEntry(eye, inv_dir, 1.0f);
+				if (t != FLT_MAX) expected.push_back(proxies[i]);
+				nearest = glm::min(nearest, t);
+			}
+		ray_ok &= check(found, expected);
+
+		float best = FLT_MAX;
+		octree.Raycast(eye, dir, 1.0f, [&](int id, float &t_max)
+		{
+			float t = octree.GetAabb(id).RayEntry(eye, inv_dir, t_max);
+			if (t < best) best = t_max = t;		// Shorten the ray to the nearest entry
+			return false;
+		});
+		closest_ok &= (best == nearest);
+	}
+	Bench::Compare("LooseOctree::Query (brute -> octree)", RAYS, t_brute, t_query);
+	Bench::Check(box_ok, "LooseOctree::Query matches brute force");
+	Bench::Check(sphere_ok, "LooseOctree::QuerySphere matches brute force");
+	Bench::Check(frustum_ok, "LooseOctree::QueryFrustum matches brute force");
+	Bench::Check(ray_ok, "LooseOctree::Raycast finds every box along the ray");
+	Bench::Check(closest_ok, "LooseOctree::Raycast finds the nearest box when shortening the ray");
+
+	// -------------------------- EMPTY ---------------------------------------------
+	for (size_t i = 0; i < n; i++)
+		if (alive[i])
+			octree.DestroyProxy(proxies[i]);
+	bool none = true;
+	octree.Query(Data::Aabb(glm::vec3(-1e6f), glm::vec3(1e6f)), [&](int) { none = false; return true; });
+	Bench::Check(none && octree.GetCount() == 0, "LooseOctree is empty after removing everything");
+}
+
+// Return the corners of a box as points
+static std::vector<glm::vec3> BoxPoints(const glm::vec3 &half)
+{
+	std::vector<glm::vec3> p;
+	for (int i = 0; i < 8; i++)
+		p.push_back(glm::vec3((i & 1) ? half.x : -half.x, (i & 2) ? half.y : -half.y, (i & 4) ? half.z : -half.z));
+
+	return p;
+}
+
+// Return true if GJK finds two shapes apart by an expected distance, with closest points that far apart
+static bool ApartBy(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, float distance)
+{
+	Convex::GjkResult g;
+	Convex::Contact c;
+	return !Convex::Gjk(a, ma, b, mb, g) && Near(g.distance, distance, CONVEX_TOLERANCE) && Near(glm::distance(g.point_a, g.point_b), distance, CONVEX_TOLERANCE) && !Convex::Collide(a, ma, b, mb, c);
+}
+
+// Return true if two shapes collide with an expected depth and normal
+static bool OverlapBy(const Data::ConvexShape &a, const glm::mat4 &ma, const Data::ConvexShape &b, const glm::mat4 &mb, float depth, const glm::vec3 &normal)
+{
+	Convex::Contact c;
+	return Convex::Collide(a, ma, b, mb, c) && Near(c.depth, depth, CONVEX_TOLERANCE) && glm::dot(c.normal, normal) >= 1.0f - CONVEX_TOLERANCE;
+}
+
+// Check GJK, EPA and QuickHull against shapes whose distances and penetrations are known exactly
+static void RunConvex()
+{
+	printf("convex shapes\n");
+
+	glm::mat4 I(1.0f);
+	auto at = [](float x, float y, float z) { return glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z)); };
+	glm::vec3 x(1.0f, 0.0f, 0.0f), y(0.0f, 1.0f, 0.0f);
+
+	// -------------------------- SPHERE - SPHERE -----------------------------------
+	Data::ConvexShape sphere = Data::MakeSphere(glm::vec3(0.0f), 1.0f), small = Data::MakeSphere(glm::vec3(0.0f), 0.5f);
+	Bench::Check(ApartBy(sphere, I, small, at(2.0f, 0.0f, 0.0f), 0.5f), "GJK sphere - sphere distance");
+	Bench::Check(OverlapBy(sphere, I, small, at(0.0f, 1.2f, 0.0f), 0.3f, y), "Collide sphere - sphere depth and normal");
+	Bench::Check(OverlapBy(sphere, glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), small, at(2.2f, 0.0f, 0.0f), 0.3f, x), "Collide scaled sphere - sphere depth and normal");
+
+	// -------------------------- BOX - BOX -----------------------------------------
+	Data::ConvexShape box = Data::MakeBox(glm::vec3(0.0f), glm::vec3(1.0f));
+	Bench::Check(ApartBy(box, I, box, at(2.5f, 0.3f, -0.2f), 0.5f), "GJK box - box face distance");
+	Bench::Check(ApartBy(box, I, box, at(3.0f, 3.0f, 0.0f), std::sqrt(2.0f)), "GJK box - box edge distance");
+	Bench::Check(OverlapBy(box, I, box, at(1.8f, 0.3f, 0.2f), 0.2f, x), "EPA box - box depth and normal");
+	Bench::Check(OverlapBy(box, I, box, at(0.1f, -1.9f, 0.4f), 0.1f, -y), "EPA box - box depth and normal below");
+
+	// A box turned 45 degrees about z pushes one edge into the face of the other
+	glm::mat4 turned = at(1.0f + std::sqrt(2.0f) - 0.1f, 0.0f, 0.0f) * glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	Bench::Check(OverlapBy(box, I, box, turned, 0.1f, x), "EPA box - turned box edge depth and normal");
+
+	// -------------------------- CAPSULE - BOX -------------------------------------
+	Data::ConvexShape capsule = Data::MakeCapsule(glm::vec3(0.0f), 0.5f, 1.0f);
+	Bench::Check(ApartBy(box, I, capsule, at(2.0f, 0.5f, 0.0f), 0.5f), "GJK box - capsule side distance");
+	Bench::Check(ApartBy(box, I, capsule, at(0.0f, 3.0f, 0.0f), 0.5f), "GJK box - capsule end distance");
+	Bench::Check(OverlapBy(box, I, capsule, at(1.3f, 0.5f, 0.0f), 0.2f, x), "Collide box - capsule depth and normal");
+	Bench::Check(OverlapBy(box, I, capsule, at(0.2f, 2.2f, 0.0f), 0.3f, y), "Collide box - capsule end depth and normal");
+
+	// -------------------------- HULLS ---------------------------------------------
+	std::vector<glm::vec3> cube = BoxPoints(glm::vec3(1.0f));
+	Data::ConvexShape hull = Data::MakeHull(cube);
+	Convex::GjkResult g;
+	Convex::Gjk(hull, I, hull, at(2.0f, 0.5f, 0.5f), g);
+	Bench::Check(g.distance <= CONVEX_TOLERANCE, "GJK hulls touching at a face have no distance");
+	Convex::Contact c;
+	Bench::Check(!Convex::Collide(hull, I, hull, at(2.0f, 0.5f, 0.5f), c) || c.depth <= CONVEX_TOLERANCE, "Collide hulls touching at a face have no depth");
+	Bench::Check(ApartBy(hull, I, hull, at(2.25f, 0.5f, 0.5f), 0.25f), "GJK hull - hull face distance");
+
+	// Both hulls turned about the same skew axis and overlapping along the turned x axis
+	glm::mat4 rot = glm::rotate(glm::mat4(1.0f), 0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+	glm::vec3 rx = glm::vec3(rot * glm::vec4(x, 0.0f)), ry = glm::vec3(rot * glm::vec4(y, 0.0f));
+	Bench::Check(OverlapBy(hull, rot, hull, glm::translate(glm::mat4(1.0f), rx * 1.85f + ry * 0.3f) * rot, 0.15f, rx), "EPA hulls on a rotated axis depth and normal");
+	Bench::Check(OverlapBy(hull, rot, sphere, glm::translate(glm::mat4(1.0f), ry * 1.6f), 0.4f, ry), "Collide rotated hull - sphere depth and normal");
+
+	double t_collide = Bench::Time([&]()
+	{
+		for (int i = 0; i < 1000; i++)
+			Convex::Collide(hull, rot, hull, glm::translate(glm::mat4(1.0f), rx * 1.85f + ry * 0.3f) * rot, c);
+	}) / 1000.0;
+	Bench::Report("Collide hull - hull (GJK + EPA)", 1, t_collide);
+
+	// -------------------------- QUICKHULL -----------------------------------------
+	// Cube corners plus duplicates, face centres, edge midpoints and inner points: only the corners are on the hull
+	std::vector<glm::vec3> cloud = cube;
+	cloud.insert(cloud.end(), cube.begin(), cube.end());
+	for (int a = 0; a < 3; a++)
+		for (float s = -1.0f; s <= 1.0f; s += 2.0f)
+		{
+			glm::vec3 face(0.0f);
+			face[a] = s;
+			cloud.push_back(face);	// Face centre
+			glm::vec3 edge(s);
+			edge[a] = 0.0f;
+			cloud.push_back(edge);	// Edge midpoint
+			cloud.push_back(face * 0.5f);	// Inside
+		}
+
+	std::vector<glm::vec3> corners = Data::QuickHull(cloud);
+	bool only_corners = corners.size() == 8;
+	for (const glm::vec3 &p : corners)
+		only_corners &= glm::abs(p.x) == 1.0f && glm::abs(p.y) == 1.0f && glm::abs(p.z) == 1.0f;
+	Bench::Check(only_corners, "QuickHull keeps only the corners of duplicate and coplanar points");
+
+	// A flat set has no volume, but its support function must still match the points
+	std::mt19937 rng(17);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<glm::vec3> flat(64);
+	for (glm::vec3 &p : flat)
+		p = glm::vec3(unit(rng), 0.5f, unit(rng));
+	std::vector<glm::vec3> flat_hull = Data::QuickHull(flat);
+
+	bool supports = true;
+	for (int i = 0; i < 64; i++)
+	{
+		glm::vec3 d = Bench::RandomDirection(rng);
+		float best = -FLT_MAX, best_hull = -FLT_MAX;
+		for (const glm::vec3 &p : flat) best = glm::max(best, glm::dot(p, d));
+		for (const glm::vec3 &p : flat_hull) best_hull = glm::max(best_hull, glm::dot(p, d));
+		supports &= Near(best, best_hull, 1e-5f);
+	}
+	Bench::Check(supports, "QuickHull of coplanar points keeps their support function");
+}
+
+// Time and check the radii test over every pair of a set of objects
+static void RunRadii()
+{
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<glm::vec3> soup = Bench::MakeSoup(Bench::SOUP_SPHERE, 200, 5);
+	std::vector<Data::CollisionData> objects(OBJECTS, Data::CollisionData(COLLISION_TYPE_PER_VERTEX, soup));
+	for (Data::CollisionData &o : objects)
+		o.Update(glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng), unit(rng), unit(rng)) * 2000.0f) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f + 2.0f * unit(rng))));
+
+	unsigned int pairs = 0, overlaps = 0;
+	double t_radii = Bench::Time([&]()
+	{
+		pairs = overlaps = 0;
+		for (unsigned int i = 0; i < OBJECTS; i++)
+			for (unsigned int j = i + 1; j < OBJECTS; j++, pairs++)
+				overlaps += Intersection::IntersectRadii(&objects[i], &objects[j]);
+	});
+	Bench::Report("IntersectRadii (all pairs)", pairs, t_radii);
+
+	float radius = 0.0f;	// Reference local radius
+	glm::vec3 centre(0.0f);
+	for (const glm::vec3 &p : objects[0].pd)
+		centre += p;
+	centre /= (float)objects[0].pd.size();
+	for (const glm::vec3 &p : objects[0].pd)
+		radius = glm::max(radius, glm::distance(p, centre));
+
+	unsigned int expected = 0;
+	for (unsigned int i = 0; i < OBJECTS; i++)
+		for (unsigned int j = i + 1; j < OBJECTS; j++)
+		{
+			const glm::mat4 &a = objects[i].m, &b = objects[j].m;
+			float d = glm::distance(glm::vec3(a * glm::vec4(centre, 1.0f)), glm::vec3(b * glm::vec4(centre, 1.0f)));
+			expected += (d <= radius * (a[0][0] + b[0][0]));
+		}
+
+	Bench::Check(overlaps == expected, "IntersectRadii matches brute force");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	RunRadii();
+	RunConvex();
+	RunRaycast();
+	RunSweep();
+
+	for (size_t n : Bench::Sizes(10000, 1000000))
+		RunOctree(n);
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_PLANE, Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+			RunSoup(kind, n);
+
+	return Bench::Finish();
+}
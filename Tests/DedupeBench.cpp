@@ -0,0 +1,95 @@
+// Vertex deduplication benchmark
+// Compares the open addressing hash table (serial and across the job system) against the std::map it replaced,
+// on smooth meshes where corners share vertices and faceted ones where they mostly don't, and checks all three agree
+
+#include "Bench.h"	// Get timers, checks and soups
+#include "Legacy.h"		// Get the old map deduplication
+#include "../VertexData.h"	// Get vertex deduplication
+
+// The unindexed streams an importer hands over: one position, uv and normal per triangle corner
+struct Streams
+{
+	std::vector<glm::vec3> positions, uvs, normals;
+};
+
+// The indexed output
+struct Indexed
+{
+	std::vector<unsigned int> indices;
+	std::vector<glm::vec3> positions, uvs, normals, tangents;
+
+	inline bool operator==(const Indexed &o) const { return indices == o.indices && positions == o.positions && uvs == o.uvs && normals == o.normals; }
+};
+
+// Expand an indexed soup into per-corner streams, with normals per vertex (smooth) or per face (faceted)
+static Streams MakeStreams(Bench::SoupKind kind, size_t triangles, bool faceted)
+{
+	std::vector<glm::vec3> points;
+	std::vector<unsigned int> indices;
+	Bench::MakeIndexedSoup(kind, triangles, 11, points, indices);
+
+	Streams s;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		glm::vec3 p[3] = { points[indices[i]], points[indices[i + 1]], points[indices[i + 2]] };
+		glm::vec3 face = glm::normalize(glm::cross(p[1] - p[0], p[2] - p[0]));
+		for (int k = 0; k < 3; k++)
+		{
+			s.positions.push_back(p[k]);
+			s.uvs.push_back(glm::vec3(p[k].x * 0.01f, p[k].z * 0.01f, 0.0f));
+			s.normals.push_back(faceted ? face : (glm::length(p[k]) > 0.0f ? glm::normalize(p[k]) : glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+	}
+
+	return s;
+}
+
+static void RunStreams(Bench::SoupKind kind, size_t triangles, bool faceted)
+{
+	Streams s = MakeStreams(kind, triangles, faceted);
+	size_t n = s.positions.size();
+
+	Indexed old_out, hash_out, parallel_out;
+	double t_map = Bench::Time([&]()
+	{
+		old_out = Indexed();
+		Legacy::IndexVertexData(s.positions, s.uvs, s.normals, old_out.indices, old_out.positions, old_out.uvs, old_out.normals, old_out.tangents);
+	});
+	double t_hash = Bench::Time([&]()
+	{
+		hash_out = Indexed();
+		IndexVertexData(s.positions, s.uvs, s.normals, hash_out.indices, hash_out.positions, hash_out.uvs, hash_out.normals, hash_out.tangents);
+	});
+	double t_parallel = Bench::Time([&]()
+	{
+		parallel_out = Indexed();
+		IndexVertexDataParallel(s.positions, s.uvs, s.normals, parallel_out.indices, parallel_out.positions, parallel_out.uvs, parallel_out.normals, parallel_out.tangents);
+	});
+
+	printf("%s %s, %zu corners -> %zu vertices\n", faceted ? "faceted" : "smooth", Bench::SoupName(kind), n, hash_out.positions.size());
+	Bench::Compare("dedupe (std::map -> hash table)", n, t_map, t_hash);
+
+	char name[64];
+	snprintf(name, sizeof(name), "dedupe (std::map -> %u threads)", JobSystem::GetThreadCount());
+	Bench::Compare(name, n, t_map, t_parallel);
+
+	Bench::Check(hash_out == old_out, "the hash table matches the map");
+	Bench::Check(parallel_out == old_out, "the parallel hash table matches the map");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+	JobSystem::Initialise();	// One worker per hardware thread, at least one
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+		{
+			RunStreams(kind, n, false);
+			RunStreams(kind, n, true);
+		}
+
+	JobSystem::Destroy();
+	return Bench::Finish();
+}
@@ -0,0 +1,36 @@
+// Header check
+// Includes every platform independent engine header after the headers that pull in windows.h, as Main.cpp does,
+// so a min or max macro leaking out of windows.h (or a header that stops compiling on its own) fails the build
+
+#ifdef _WIN32
+#include "../Mouse.h"	// Get windows.h, as the engine's first includes do
+#endif
+#include "../MappedFile.h"	// Get windows.h on Windows, mmap elsewhere
+#include "Bench.h"	// Get checks
+#include "../Math.h"
+#include "../Simd.h"
+#include "../Collision.h"
+#include "../Bvh.h"
+#include "../AabbTree.h"
+#include "../SpatialGrid.h"
+#include "../LooseOctree.h"
+#include "../Gjk.h"
+#include "../Sweep.h"
+#include "../Raycast.h"
+#include "../Transform.h"
+#include "../TransformStore.h"
+#include "../JobSystem.h"
+#include "../VertexData.h"
+#include "../VertexCache.h"
+#include "../Simplify.h"
+#include "../Chunk.h"
+#include "../MeshFile.h"
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	Bench::Check(std::min(1, 2) == 1 && glm::max(1.0f, 2.0f) == 2.0f, "min and max are functions, not macros");
+
+	return Bench::Finish();
+}
@@ -0,0 +1,145 @@
+// Job system benchmark
+// Measures the cost of a job, how ParallelFor scales from 1 to 64 threads, and how long jobs blocked on a dependency take to start,
+// and checks every job runs once and after its dependency
+
+#include <cmath>	// Get square roots
+#include "Bench.h"	// Get timers and checks
+#include "../JobSystem.h"	// Get the job system
+
+#define JOB_EMPTY_JOBS		100000	// Empty jobs queued for the overhead test
+#define JOB_BLOCKED_JOBS	256		// Jobs waiting on one slow job
+#define JOB_CHAIN_LENGTH	1000	// Jobs in the dependency chain
+
+// Spin on some arithmetic, so a job has a known amount of work
+static double Work(size_t first, size_t last)
+{
+	double s = 0.0;
+	for (size_t i = first; i < last; i++)
+		s += std::sqrt((double)i);
+
+	return s;
+}
+
+// Restart the system with a total thread count (1 runs every job inline)
+static void Restart(unsigned int threads)
+{
+	JobSystem::Destroy();
+	if (threads > 1)
+		JobSystem::Initialise(threads - 1);
+}
+
+// Queue empty jobs from the main thread and wait for them
+static void RunOverhead(unsigned int threads)
+{
+	Restart(threads);
+	std::atomic<int> ran(0);
+	double t = Bench::Time([&]()
+	{
+		JobCounter counter;
+		for (int i = 0; i < JOB_EMPTY_JOBS; i++)
+			JobSystem::Run([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+		JobSystem::Wait(counter);
+	});
+
+	char name[64];
+	snprintf(name, sizeof(name), "empty job, %u threads", threads);
+	Bench::Report(name, JOB_EMPTY_JOBS, t);
+	Bench::Check(ran.load() % JOB_EMPTY_JOBS == 0, "every empty job ran once");
+}
+
+// Sum a range in parallel on a pool of the given size and return seconds per call
+static double RunScaling(unsigned int threads, size_t items, double expected)
+{
+	Restart(threads);
+	Bench::Check(JobSystem::GetThreadCount() == threads, "the pool runs the requested number of threads");
+
+	std::vector<double> partial(items / 1024 + 1);
+	double sum = 0.0;
+	double t = Bench::Time([&]()
+	{
+		JobSystem::ParallelFor(0, partial.size(), 1, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; b++)
+				partial[b] = Work(b * 1024, glm::min(items, (b + 1) * 1024));
+		});
+
+		sum = 0.0;
+		for (double p : partial)
+			sum += p;
+	});
+
+	Bench::Check(std::abs(sum - expected) <= 1e-9 * expected, "ParallelFor covers every item once");
+	return t;
+}
+
+// Queue jobs behind one slow job, and a chain where each job waits on the one before
+static void RunDependencies(unsigned int threads)
+{
+	Restart(threads);
+	std::atomic<bool> slow_done(false);
+	std::atomic<int> early(0), ran(0);
+
+	double t = Bench::Time([&]()
+	{
+		slow_done = false;
+		JobCounter slow, blocked;
+		JobSystem::Run([&]() { Work(0, 2000000); slow_done = true; }, &slow);
+		for (int i = 0; i < JOB_BLOCKED_JOBS; i++)
+			JobSystem::Run([&]() { early += !slow_done; ran++; }, &blocked, &slow);
+		JobSystem::Wait(blocked);
+	});
+
+	char name[64];
+	snprintf(name, sizeof(name), "%d jobs behind a slow one, %u threads", JOB_BLOCKED_JOBS, threads);
+	Bench::Report(name, JOB_BLOCKED_JOBS, t);
+	Bench::Check(early == 0 && ran % JOB_BLOCKED_JOBS == 0, "blocked jobs run once, after their dependency");
+
+	std::vector<int> order;
+	order.reserve(JOB_CHAIN_LENGTH);
+	double t_chain = Bench::Time([&]()
+	{
+		order.clear();
+		std::vector<JobCounter> link(JOB_CHAIN_LENGTH);		// Counter of each job in the chain
+		for (int i = 0; i < JOB_CHAIN_LENGTH; i++)	// Queues run newest first, so nearly every job is found before it may start
+			JobSystem::Run([&order, i]() { order.push_back(i); }, &link[i], i ? &link[i - 1] : NULL);
+		JobSystem::Wait(link[JOB_CHAIN_LENGTH - 1]);
+	});
+
+	snprintf(name, sizeof(name), "chain of %d jobs, %u threads", JOB_CHAIN_LENGTH, threads);
+	Bench::Report(name, JOB_CHAIN_LENGTH, t_chain);
+
+	bool chain = order.size() == JOB_CHAIN_LENGTH;
+	for (size_t i = 0; i < order.size() && chain; i++)
+		chain &= order[i] == (int)i;
+	Bench::Check(chain, "a dependency chain runs in order");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	size_t items = Bench::_quick ? 1000000 : 50000000;	// Items summed by ParallelFor
+	double expected = Work(0, items);
+
+	std::vector<unsigned int> counts = Bench::_quick ? std::vector<unsigned int>{ 1, 2, 4 } : std::vector<unsigned int>{ 1, 2, 4, 8, 16, 32, 64 };
+	printf("job system, %u hardware threads\n", std::thread::hardware_concurrency());
+
+	double t_one = 0.0;
+	for (unsigned int threads : counts)
+	{
+		RunOverhead(threads);
+
+		double t = RunScaling(threads, items, expected);
+		if (threads == 1)
+			t_one = t;
+
+		char name[64];
+		snprintf(name, sizeof(name), "ParallelFor sum, %u threads", threads);
+		Bench::Compare(name, items, t_one, t);
+
+		RunDependencies(threads);
+	}
+
+	JobSystem::Destroy();
+	return Bench::Finish();
+}
@@ -0,0 +1,388 @@
+#ifndef __LEGACY_H__
+#define __LEGACY_H__
+
+#define CAT_POINT		0	// Collision arbitrary type corner
+#define CAT_EDGE		1	// Collision arbitrary type edge
+#define CAT_TRIANGLE	2	// Collision arbitrary type plane
+
+#include <cstdint>	// Get fixed width integers
+#include <cstdio>	// Get sscanf
+#include <vector>	// Get dynamic arrays
+#include <map>	// Get map variable
+#include <string>	// Get strings
+#include <fstream>	// Get file streams
+#include <glm/glm.hpp>	// Get 3D variables
+#include "../VertexData.h"	// Get vertex data
+#include "../Chunk.h"	// Get draw ranges
+
+// The code paths the current headers replaced, kept so the benchmarks can measure against them
+// Each block is copied from the engine as it was before the change, only renamed into this namespace
+namespace Legacy
+{
+	// -------------------------- TRIANGLE POINTER GRAPH (before TriangleData) --------------------------------------
+
+	// Abstract arbitrary class
+	struct Arbitrary
+	{
+		uint8_t t;	// Arbitrary type
+
+		// Default constructor
+		inline Arbitrary() : t(0) {}
+
+		// Virtual void
+		inline virtual void Update() = 0;
+	};
+
+	// Point arbitrary
+	struct Point : public Arbitrary
+	{
+		glm::vec3 p;	// Position
+
+		inline Point(glm::vec3 position)
+		{
+			t = CAT_POINT;	// Assign arbitrary type
+
+			p = position;	// Assign position
+		}
+
+		// Update
+		inline virtual void Update() {}
+	};
+
+	// Edge arbitrary
+	struct Edge : public Arbitrary
+	{
+		glm::vec3 p_0;	// Edge 0
+		glm::vec3 p_1;	// Edge 1
+		glm::vec3 a;	// Average
+		glm::vec3 v;	// Vector
+		glm::vec3 d;	// Direction
+
+		// Initial contructor
+		inline Edge(glm::vec3 point_0, glm::vec3 point_1)
+		{
+			t = CAT_EDGE;	// Assign arbitrary type
+
+			p_0 = point_0;	// Assign edge 0
+			p_1 = point_1;	// Assign edge 1
+
+			Update();	// Update
+		}
+
+		// Update
+		inline virtual void Update()
+		{
+			a = (p_0 + p_1) / 2.0f;		// Assign average
+			v = p_1 - p_0;	// Assign vector
+			d = glm::normalize(p_1 - p_0);	// Assign direction
+		}
+	};
+
+	// Triangle data structure
+	struct Triangle : public Arbitrary
+	{
+		glm::vec3	a;		// Average
+		glm::vec3	n;		// Normal
+		Point*		p[3];	// Three points
+		Edge*		e[3];	// Three edges
+
+		// Constructor
+		inline Triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+		{
+			t = CAT_TRIANGLE;	// Assign arbitrary type
+
+			p[0] = new Point(v0);	// Create point 0
+			p[1] = new Point(v1);	// Create point 1
+			p[2] = new Point(v2);	// Create point 2
+
+			e[0] = new Edge(v0, v1);	// Create edge 0
+			e[1] = new Edge(v1, v2);	// Create edge 1
+			e[2] = new Edge(v2, v0);	// Create edge 2
+
+			Update();	// Update vector data
+		}
+
+		// Deconstructor
+		inline ~Triangle()
+		{
+			for (unsigned int i = 0; i < 3; i++)	// Iterate for all three vertices
+			{
+				if (p[i])	delete p[i];	// Delete points
+				if (e[i])	delete e[i];	// Delete edges
+			}
+		}
+
+		// Update vectors
+		inline virtual void Update()
+		{
+			a = (p[0]->p + p[1]->p + p[2]->p) / 3.0f;	// Calculate average
+			n = glm::cross(p[1]->p - p[0]->p, p[2]->p - p[0]->p);	// Calculate normal
+
+			e[0]->p_0 = p[0]->p; e[0]->p_1 = p[1]->p;	// Caclulate edge 0
+			e[1]->p_0 = p[1]->p; e[1]->p_1 = p[2]->p;	// Caclulate edge 1
+			e[2]->p_0 = p[2]->p; e[2]->p_1 = p[0]->p;	// Caclulate edge 2
+
+			for (unsigned int i = 0; i < 3; i++)	// Iterate through each point
+			{
+				p[i]->Update();		// Update points
+				e[i]->Update();		// Update edges
+			}
+		}
+	};
+
+	// Build the triangle list the old CollisionData kept from a soup
+	static inline std::vector<Triangle*> BuildTriangles(const std::vector<glm::vec3> &triangle_data)
+	{
+		std::vector<Triangle*> t;	// List of triangle data
+
+		for (unsigned int i = 0; i + 2 < triangle_data.size(); i += 3)	// Iterate through each indexed vertex position
+			t.push_back(new Triangle(triangle_data[i], triangle_data[i + 1], triangle_data[i + 2]));	// Create triangle
+
+		return t;	// Return triangles
+	}
+
+	// Delete a triangle list
+	static inline void DeleteTriangles(std::vector<Triangle*> &t)
+	{
+		for (Triangle* tri : t)		// Iterate through each triangle
+			delete tri;
+		t.clear();
+	}
+
+	// Transform every triangle in place, as the old CollisionData::Update did
+	static inline void UpdateTriangles(std::vector<Triangle*> &t, const glm::mat4 &m)
+	{
+		glm::vec4 res(glm::vec4(0.0f));		// Result for each vertex position
+
+		for (unsigned int i = 0; i < t.size(); i++)		// Iterate through each triangle
+		{
+			for (unsigned int j = 0; j < 3; j++)	// Iterate through each vertex
+			{
+				glm::vec4 v_opt(glm::vec4(t[i]->p[j]->p, 1.0f));	// Optimise vertex position
+				res = glm::vec4(m * v_opt);		// Calculate transform result
+
+				t[i]->p[j]->p = glm::vec3(res.x / res.w, res.y / res.w, res.z / res.w);		// Convert transform result back to vec3
+			}
+
+			t[i]->Update();		// Update all arbitrary data
+		}
+	}
+
+	// Return the closest hit distance of a ray against every triangle of the graph, or t_max if nothing is hit
+	// The same Moller-Trumbore test the current kernels use, reading through the point pointers
+	static inline float RayToTriangles(const std::vector<Triangle*> &t, const glm::vec3 &origin, const glm::vec3 &dir, float t_max)
+	{
+		for (const Triangle* tri : t)	// Iterate through each triangle
+		{
+			glm::vec3 e0 = tri->e[0]->v, e1 = -tri->e[2]->v;	// Edges from point 0
+			glm::vec3 pv = glm::cross(dir, e1);
+			float det = glm::dot(e0, pv);	// Determinant
+			if (glm::abs(det) < 1e-8f)	// If parallel
+				continue;
+
+			float inv_det = 1.0f / det;
+			glm::vec3 tv = origin - tri->p[0]->p;
+			float u = glm::dot(tv, pv) * inv_det;	// Barycentric u
+			if (u < 0.0f || u > 1.0f) continue;
+
+			glm::vec3 qv = glm::cross(tv, e0);
+			float v = glm::dot(dir, qv) * inv_det;	// Barycentric v
+			if (v < 0.0f || u + v > 1.0f) continue;
+
+			float d = glm::dot(e1, qv) * inv_det;	// Ray distance
+			if (d >= 0.0f && d <= t_max)	// If closer
+				t_max = d;
+		}
+
+		return t_max;	// Return closest hit
+	}
+
+	// Return the approximate heap footprint of a triangle list (objects, the pointer list and one allocator header per object)
+	static inline size_t Bytes(const std::vector<Triangle*> &t)
+	{
+		size_t header = 2 * sizeof(void*);		// Typical allocator overhead per allocation
+		return t.capacity() * sizeof(Triangle*) + t.size() * (sizeof(Triangle) + 3 * sizeof(Point) + 3 * sizeof(Edge) + 7 * header);
+	}
+
+	// -------------------------- QUADRATIC WELD (before Data::Weld) --------------------------------------
+
+	// Return the unique points of a soup, removing exact duplicates by comparing every pair (the temp points are freed here, the old loop leaked them)
+	static inline std::vector<glm::vec3> WeldPoints(const std::vector<glm::vec3> &triangle_data)
+	{
+		std::vector<Point*> points;		// Temp point data
+		std::vector<glm::vec3> pd;	// Vertex position data
+
+		for (unsigned int i = 0; i < triangle_data.size(); i++)		// Iterate through each indexed vertex position
+			points.push_back(new Point(triangle_data[i]));	// Create temp point
+
+		std::vector<Point*> all = points;	// Every allocation, for clean up
+
+		// -------------------------- CLEAN UP DUPLICTE POINTS! --------------------------------------
+		for (unsigned int i = 0; i < points.size(); i++)		// Iterate through each edge
+		{
+			for (unsigned int j = 0; j < points.size(); j++)		// Iterate through each edge again
+			{
+				if (i != j)		// If i is not the same element as j
+				{
+					if (points[i]->p == points[j]->p)		// If both values are the same
+					{
+						points.erase(points.begin() + i);		// Remove duplicate
+						i > 0 ? i-- : i = 0;	// Re-assign iteration
+					}
+				}
+			}
+		}
+
+		// --------------------------- ASSIGN OPTIMISED POINT DATA ------------------------------
+		for (unsigned int i = 0; i < points.size(); i++)	// Iterate through each corner
+			pd.push_back(points[i]->p);		// Assign to temp container
+
+		for (Point* p : all)	// Iterate through each temp point
+			delete p;
+
+		return pd;	// Return unique points
+	}
+
+	// -------------------------- MAP DEDUPLICATION (before VertexHashTable) --------------------------------------
+
+	// This will be our packed version of a vertex
+	struct PackedVertex
+	{
+		glm::vec3 position;		// This will store our packed position data
+		glm::vec3 uv;	// This will store our packed uv data
+		glm::vec3 normal;	// This will pack our normal data
+		bool operator<(const PackedVertex that) const { return memcmp((void*)this, (void*)&that, sizeof(PackedVertex)) > 0; };	// Create an operator for comparing different vertex data
+	};
+
+	// This function will compare each vertex with an existing vertex
+	static inline bool GetSimilarVertexIndex(PackedVertex &packed, std::map<PackedVertex, unsigned int> &VertexToOutIndex, unsigned int &result)
+	{
+		std::map<PackedVertex, unsigned int>::iterator it = VertexToOutIndex.find(packed);	// Iterate through each vertex to check for duplicates
+		if (it == VertexToOutIndex.end())	// If the iterator has finished with no duplicates found...
+			return false;	// Return false - no duplicate found
+		else	// Otherwise...
+		{
+			result = it->second;	// Set the result to the indexed vertex
+			return true;	// Return true
+		}
+	}
+
+	// This function will take obj data and output optimised vertex data for an element buffer object
+	static inline void IndexVertexData(std::vector<glm::vec3> & in_vertices, std::vector<glm::vec3> & in_uvs, std::vector<glm::vec3> & in_normals, std::vector<unsigned int> & out_indices, std::vector<glm::vec3> & out_vertices, std::vector<glm::vec3> & out_uvs, std::vector<glm::vec3> & out_normals, std::vector<glm::vec3> & out_tangents)
+	{
+		std::map<PackedVertex, unsigned int> VertexToOutIndex;	// This will record any duplicated vertex data for our indices
+
+		for (unsigned int i = 0; i < in_vertices.size(); i++)	// Iterate through the number of vertex positions...
+		{
+			PackedVertex packed = { in_vertices[i], in_uvs[i], in_normals[i] };		// Set a temp vertex struct to our input data
+
+			unsigned int index;		// Use this index variable as the duplicated result
+			bool found = GetSimilarVertexIndex(packed, VertexToOutIndex, index);	// Try to find a similar vertex in out_XXXX
+
+			if (found)	// If a similar vertex has been found...
+				out_indices.push_back(index);	// A similar vertex already exists - use the existing one instead!
+			else	// Otherwise...
+			{
+				out_vertices.push_back(in_vertices[i]);		// Add the new vertex to our positions list
+				out_uvs.push_back(in_uvs[i]);	// Add the new vertex to our uv list
+				out_normals.push_back(in_normals[i]);	// Add the new vertex to our normal list
+				unsigned int newindex = (unsigned int)out_vertices.size() - 1;	// Set a new index for our out_index list
+				out_indices.push_back(newindex);	// Assign the new index
+				VertexToOutIndex[packed] = newindex;	// Assign the new index to our packed vertex list
+			}
+		}
+
+		out_tangents.assign(out_indices.size(), glm::vec3(0.0f));	// Assign empty tangents ready for further calculation
+	}
+
+	// -------------------------- TEXT MESH FILES (before MeshFile) --------------------------------------
+
+	// Write a text mesh as the old DataIO::SaveAs::MeshO did, materials are passed by name instead of read from the mesh
+	static inline bool WriteTextMesh(const char* file, const std::string &name, unsigned int type, VertexData &vd, std::vector<Chunk> &chunks, std::vector<std::string> &materials)
+	{
+		std::string d = " ";	// Create our delim
+		std::fstream f;		// Create our file stream variable
+
+		f.open(file, std::ios::out);	// Create a new file
+		if (f.is_open())	// If the file opened successfully...
+		{
+			f << "m" << d << type << d << name << "\n\n";	// Save the mesh type
+
+			for (unsigned int i = 0; i < chunks.size(); i++)		// Iterate through each chunk...
+				f << "c" << d << chunks[i]._id << d << chunks[i]._index_offset << d << chunks[i]._index_count << d << materials[i] << "\n";		// Save the chunk data with each materials assigned
+			f << "\n";	// Create a new line for next value types
+			for (unsigned int i = 0; i < vd.positions.size(); i++)		// Iterate through each vertex for our positions...
+				f << "p" << d << vd.positions[i].x << d << vd.positions[i].y << d << vd.positions[i].z << "\n";		// Save the positions
+			f << "\n";	// Create a new line for next value types
+			for (unsigned int i = 0; i < vd.texcoords.size(); i++)		// Iterate through each vertex for our texcoords...
+				f << "t" << d << vd.texcoords[i].x << d << vd.texcoords[i].y << "\n";		// Save the texcoords
+			f << "\n";	// Create a new line for next value types
+			for (unsigned int i = 0; i < vd.normals.size(); i++)		// Iterate through each vertex for our normals...
+				f << "n" << d << vd.normals[i].x << d << vd.normals[i].y  << d << vd.normals[i].z << "\n";		// Save the normals
+			f << "\n";	// Create a new line for next value types
+			for (unsigned int i = 0; i < vd.indices.size(); i++)		// Iterate through each index for our vertex indices...
+				f << "i" << d << vd.indices[i] << "\n";	// Save the indices
+		}
+
+		return f.is_open();		// Return true if the file was written
+	}
+
+	// Read a text mesh as the old DataIO::Open::MeshI did, without the upload (sscanf_s is replaced by sscanf with a width)
+	static inline bool ReadTextMesh(const char* file, std::string &n, unsigned int &t, VertexData &vd, std::vector<Chunk> &c, std::vector<std::string> &m)
+	{
+		std::ifstream _in(file);	// Check if the file is valid
+		if (!_in)	// If the file is invalid...
+			return false;	// Return false as failed
+
+		char data[256];		// Create a buffer for each line in the file
+		std::vector <std::string> line;		// This will contain our text from the buffer
+		while (_in.getline(data, 256))	// While each line is being read...
+			line.push_back(data);	// Assign the data to our string container
+
+		int cd[3];	// Store chunk data
+		float x, y, z;	// Create temp variables for vertex data
+		char chars[128];	// Create temp variable for character data
+
+		for (unsigned int i = 0; i < line.size(); i++)	// Iterate through each line...
+		{
+			switch ((line[i])[0])	// Check the value of the first character of each line
+			{
+			case 'm':	// If the character is a 'm'...
+				sscanf(line[i].c_str(), "m %u %127s", &t, chars);		// Scan this line
+				n = chars;	// Record name data
+				break;
+
+			case 'c':	// If the character is a 'c'...
+				sscanf(line[i].c_str(), "c %d %d %d %127s", &cd[0], &cd[1], &cd[2], chars);		// Scan this line
+
+				c.push_back(Chunk(cd[1], cd[2], cd[0]));	// Record chunk data
+				m.push_back(chars);		// Record material data
+				break;
+
+			case 'p':	// If the character is a 'p'...
+				sscanf(line[i].c_str(), "p %f %f %f", &x, &y, &z);		// Scan this line
+				vd.positions.push_back(glm::vec3(x, y, z));	// Record attrib data
+				break;
+
+			case 't':	// If the character is a 't'...
+				sscanf(line[i].c_str(), "t %f %f", &x, &y);		// Scan this line
+				vd.texcoords.push_back(glm::vec3(x, y, 0.0f));	// Record attrib data
+				break;
+
+			case 'n':	// If the character is a 'n'...
+				sscanf(line[i].c_str(), "n %f %f %f", &x, &y, &z);		// Scan this line
+				vd.normals.push_back(glm::vec3(x, y, z));	// Record attrib data
+				break;
+
+			case 'i':	// If the character is a 'i'...
+				sscanf(line[i].c_str(), "i %d", &cd[0]);		// Scan this line
+				vd.indices.push_back(cd[0]);	// Record attrib data
+				break;
+			}
+		}
+
+		return true;	// Return true as success
+	}
+}
+
+#endif
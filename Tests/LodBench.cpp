@@ -0,0 +1,193 @@
+// Level of detail benchmark
+// Times Simplify::BuildLods on closed spheres (with a wrap seam and two chunks) and open terrain, reports the triangles and error of each level,
+// measures how far the original surface is from each level, checks the levels are valid, and shows what distance selection draws
+
+#include <cfloat>	// Get float limits
+#include <map>	// Get edge counting
+#include "Bench.h"	// Get timers, checks and soups
+#include "../Collision.h"	// Get closest points on triangles
+#include "../Simplify.h"	// Get level of detail generation
+
+#define LOD_SAMPLES			256		// Original vertices measured against each level
+#define LOD_ERROR_SLACK		4.0f	// How far past its stored error a level may measure, stored errors are quadric estimates not bounds
+#define LOD_VIEW_HEIGHT		1080.0f	// Viewport height distance selection is shown for
+#define LOD_VIEW_FOV		60.0f	// Vertical field of view distance selection is shown for
+#define LOD_PIXEL_ERROR		1.0f	// Largest error in pixels a level may show, as MESH_LOD_PIXEL_ERROR in Mesh.h
+
+using namespace Collision::Ndc;
+
+// Return the indices of one level, every chunk in order
+static std::vector<unsigned int> LevelIndices(const VertexData &vd, const std::vector<Chunk> &chunks)
+{
+	std::vector<unsigned int> out;
+	for (const Chunk &c : chunks)
+	{
+		size_t first = c._index_offset / sizeof(unsigned int);
+		out.insert(out.end(), vd.indices.begin() + first, vd.indices.begin() + first + c._index_count);
+	}
+
+	return out;
+}
+
+// Return the number of welded edges with no twin running the other way, outputting the positions they join
+static size_t OpenEdges(const std::vector<unsigned int> &indices, const std::vector<unsigned int> &remap, std::vector<unsigned int> &out_ends)
+{
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;		// Direction count of each undirected edge
+	for (size_t t = 0; t + 2 < indices.size(); t += 3)
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int a = remap[indices[t + k]], b = remap[indices[t + (k + 1) % 3]];
+			edges[std::make_pair(glm::min(a, b), glm::max(a, b))] += (a < b) ? 1 : -1;
+		}
+
+	size_t open = 0;
+	out_ends.clear();
+	for (const std::pair<const std::pair<unsigned int, unsigned int>, int> &e : edges)
+		if (e.second != 0)	// If the edge has no twin
+		{
+			open += (size_t)std::abs(e.second);
+			out_ends.push_back(e.first.first);
+			out_ends.push_back(e.first.second);
+		}
+
+	return open;
+}
+
+// Return the largest distance from a sample of the original vertices to a level's surface
+static float MeasuredError(const VertexData &vd, const std::vector<unsigned int> &full, const std::vector<unsigned int> &level)
+{
+	Data::TriangleData t;	// The level, as the collision code stores triangles
+	t.Resize((unsigned int)level.size() / 3);
+	for (unsigned int i = 0; i < t.Size(); i++)
+		for (unsigned int k = 0; k < 3; k++)
+			t.SetP(i, k, vd.positions[level[i * 3 + k]]);
+
+	float worst = 0.0f;
+	size_t step = glm::max((size_t)1, full.size() / LOD_SAMPLES);
+	for (size_t s = 0; s < full.size(); s += step)	// Iterate through a sample of the used vertices
+	{
+		glm::vec3 p = vd.positions[full[s]];
+		float best = FLT_MAX;
+		for (unsigned int i = 0; i < t.Size() && best > 0.0f; i++)
+			best = glm::min(best, glm::distance(p, Detection::ClosestPointOnTriangle(p, t, i)));
+		worst = glm::max(worst, best);
+	}
+
+	return worst;
+}
+
+static void RunMesh(Bench::SoupKind kind, size_t triangles)
+{
+	VertexData input;
+	Bench::MakeIndexedSoup(kind, triangles, 9, input.positions, input.indices);
+	size_t n = input.positions.size(), tris = input.indices.size() / 3;
+
+	unsigned int half = (unsigned int)(tris / 2 * 3);	// Two chunks, as two materials would make
+	std::vector<Chunk> chunks = { Chunk(0, half, 0), Chunk(half * sizeof(unsigned int), (unsigned int)input.indices.size() - half, 1) };
+
+	printf("%s, %zu triangles\n", Bench::SoupName(kind), tris);
+
+	// -------------------------- BUILD ---------------------------------------------
+	VertexData vd;
+	std::vector<MeshLod> lods;
+	double t_build = Bench::Time([&]()
+	{
+		vd = input;
+		lods.clear();
+		Simplify::BuildLods(vd, chunks, lods);
+	});
+	Bench::Report("BuildLods", tris, t_build);
+
+	// -------------------------- EACH LEVEL ----------------------------------------
+	std::vector<unsigned int> remap, wedge;
+	Simplify::WeldPositions(vd.positions, remap, wedge);
+
+	std::vector<unsigned int> full = LevelIndices(vd, chunks), ends;
+	Data::Aabb box;		// Footprint of the full mesh
+	for (unsigned int i : full)
+		box.Grow(vd.positions[i]);
+	size_t above = full.size();
+	float last_error = 0.0f;
+	bool valid = true, reduced = true, ordered = true, closed = true, bounded = true;
+
+	for (size_t l = 0; l < lods.size(); l++)	// Iterate through each level
+	{
+		const MeshLod &lod = lods[l];
+		valid &= lod._chunks.size() == chunks.size();
+		for (size_t j = 0; j < lod._chunks.size() && valid; j++)	// Ids match, ranges sit after the full mesh and inside the buffer
+		{
+			const Chunk &c = lod._chunks[j];
+			size_t first = c._index_offset / sizeof(unsigned int);
+			valid &= c._id == chunks[j]._id && c._index_count % 3 == 0 && first >= input.indices.size() && first + c._index_count <= vd.indices.size();
+		}
+		if (!valid)
+			break;
+
+		std::vector<unsigned int> level = LevelIndices(vd, lod._chunks);
+		for (unsigned int i : level)
+			valid &= i < n;
+
+		size_t open = OpenEdges(level, remap, ends);
+		Data::Aabb level_box;
+		for (unsigned int i : level)
+			level_box.Grow(vd.positions[i]);
+		float measured = MeasuredError(vd, full, level);
+		printf("  %-40s %9zu  %5.1f%% of the level above  error %.4f  measured %.4f  open edges %zu\n", l == 0 ? "levels" : "", level.size() / 3, 100.0 * level.size() / above, lod._error, measured, open);
+
+		reduced &= level.size() <= above * SIMPLIFY_MIN_GAIN;
+		ordered &= lod._error >= last_error;
+		if (kind == Bench::SOUP_SPHERE)	// Closed: no edge may open
+			closed &= open == 0;
+		else	// Open: borders may lose vertices by sliding along themselves, but every open edge stays on the outline and the footprint holds
+		{
+			closed &= open > 0 && level_box.min.x == box.min.x && level_box.min.z == box.min.z && level_box.max.x == box.max.x && level_box.max.z == box.max.z;
+			for (unsigned int e : ends)
+				closed &= vd.positions[e].x == box.min.x || vd.positions[e].x == box.max.x || vd.positions[e].z == box.min.z || vd.positions[e].z == box.max.z;
+		}
+		bounded &= measured <= lod._error * LOD_ERROR_SLACK + 1e-4f;
+		above = level.size();
+		last_error = lod._error;
+	}
+
+	Bench::Check(!lods.empty(), "BuildLods builds at least one level");
+	Bench::Check(valid, "every level indexes valid vertices through one range per chunk, after the full mesh");
+	Bench::Check(reduced, "every level cuts the indices of the level above");
+	Bench::Check(ordered, "level errors grow with each level");
+	Bench::Check(closed, kind == Bench::SOUP_SPHERE ? "closed meshes stay closed across the seam and chunks" : "open borders are kept");
+	Bench::Check(bounded, "the original surface stays within the stored errors");
+
+	// -------------------------- DISTANCE SELECTION --------------------------------
+	// Picks levels as Mesh::GetLodChunks does, for a full screen height viewport
+	glm::vec3 centre;
+	float radius;
+	Math::BoundingSpherev3(vd.positions.data(), n, centre, radius);
+	float scale = LOD_VIEW_HEIGHT * 0.5f / std::tan(glm::radians(LOD_VIEW_FOV * 0.5f));		// Pixels per unit at unit distance
+
+	printf("  %-40s %9s ", "triangles drawn at radii away", "");
+	for (float radii = 2.0f; radii <= 512.0f; radii *= 4.0f)
+	{
+		float pixels = scale / (radius * (radii - 1.0f));	// Pixels covered by one mesh unit at the nearest point
+		size_t level = 0;
+		while (level < lods.size() && lods[level]._error * pixels <= LOD_PIXEL_ERROR)
+			level++;
+		size_t drawn = 0;
+		for (const Chunk &c : level ? lods[level - 1]._chunks : chunks)
+			drawn += c._index_count / 3;
+		printf(" %g: %zu", radii, drawn);
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+	JobSystem::Initialise();	// Chunks simplify in parallel
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+			RunMesh(kind, n);
+
+	JobSystem::Destroy();
+	return Bench::Finish();
+}
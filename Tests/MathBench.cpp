@@ -0,0 +1,203 @@
+// Maths kernel benchmark
+// Times the point set and point transform kernels in Math.h against plain per-point glm loops, reports their throughput, and checks they agree
+
+#include <cfloat>	// Get float limits
+#include "Bench.h"	// Get timers, checks and soups
+#include "../Math.h"	// Get the kernels
+
+// Print a kernel timing with its read bandwidth
+static void Bandwidth(const char* name, size_t points, double old_seconds, double new_seconds)
+{
+	Bench::Compare(name, points, old_seconds, new_seconds);
+	printf("  %-40s %9s  %10.2f GB/s\n", "", "", points * sizeof(glm::vec3) / new_seconds / 1e9);
+}
+
+// Return true if every point lies inside a sphere
+static bool Holds(const std::vector<glm::vec3> &p, const glm::vec3 &centre, float radius)
+{
+	for (const glm::vec3 &q : p)	// Iterate through each point
+		if (glm::distance(q, centre) > radius)
+			return false;
+
+	return true;
+}
+
+static void RunPoints(const char* name, const std::vector<glm::vec3> &p)
+{
+	size_t n = p.size();
+	printf("%s, %zu points\n", name, n);
+
+	// -------------------------- BOUNDS --------------------------------------------
+	glm::vec3 lo, hi, lo_ref, hi_ref;
+	double t_ref = Bench::Time([&]()
+	{
+		lo_ref = glm::vec3(FLT_MAX); hi_ref = glm::vec3(-FLT_MAX);
+		for (const glm::vec3 &q : p) { lo_ref = glm::min(lo_ref, q); hi_ref = glm::max(hi_ref, q); }
+	});
+	double t_new = Bench::Time([&]() { Math::Boundsv3(p.data(), n, lo, hi); });
+	Bandwidth("Boundsv3 (glm loop -> kernel)", n, t_ref, t_new);
+	Bench::Check(lo == lo_ref && hi == hi_ref, "Boundsv3 matches the glm loop");
+
+	// -------------------------- CENTROID ------------------------------------------
+	glm::vec3 c, c_ref;
+	t_ref = Bench::Time([&]()
+	{
+		double s[3] = { 0.0, 0.0, 0.0 };
+		for (const glm::vec3 &q : p) { s[0] += q.x; s[1] += q.y; s[2] += q.z; }
+		c_ref = glm::vec3((float)(s[0] / n), (float)(s[1] / n), (float)(s[2] / n));
+	});
+	t_new = Bench::Time([&]() { c = Math::Centroidv3(p.data(), n); });
+	Bandwidth("Centroidv3 (double loop -> kernel)", n, t_ref, t_new);
+	Bench::Check(glm::distance(c, c_ref) <= 1e-3f * glm::max(1.0f, glm::length(hi_ref - lo_ref)), "Centroidv3 matches the double precision loop");
+
+	// -------------------------- MAX DISTANCE --------------------------------------
+	float d = 0.0f, d_ref = 0.0f;
+	t_ref = Bench::Time([&]()
+	{
+		d_ref = 0.0f;
+		for (const glm::vec3 &q : p) d_ref = glm::max(d_ref, glm::distance(q, c));
+	});
+	t_new = Bench::Time([&]() { d = Math::MaxDistancev3(p.data(), n, c); });
+	Bandwidth("MaxDistancev3 (glm loop -> kernel)", n, t_ref, t_new);
+	Bench::Check(glm::abs(d - d_ref) <= 1e-5f * glm::max(1.0f, d_ref), "MaxDistancev3 matches the glm loop");
+
+	// -------------------------- MAX ABS COMPONENT ---------------------------------
+	float m = Math::MaxAbsComponentv3(p.data(), n), m_ref = 0.0f;
+	for (const glm::vec3 &q : p)
+		m_ref = glm::max(m_ref, glm::max(glm::abs(q.x), glm::max(glm::abs(q.y), glm::abs(q.z))));
+	Bench::Check(m == m_ref, "MaxAbsComponentv3 matches the glm loop");
+
+	// -------------------------- BOUNDING SPHERE -----------------------------------
+	glm::vec3 centre;
+	float radius;
+	glm::vec3 box_centre;	// The box centred sphere it replaced, with the old glm loops
+	float box_radius = 0.0f;
+	t_ref = Bench::Time([&]()
+	{
+		glm::vec3 l(FLT_MAX), h(-FLT_MAX);
+		for (const glm::vec3 &q : p) { l = glm::min(l, q); h = glm::max(h, q); }
+		box_centre = (l + h) * 0.5f;
+		box_radius = 0.0f;
+		for (const glm::vec3 &q : p) box_radius = glm::max(box_radius, glm::distance(q, box_centre));
+	});
+	t_new = Bench::Time([&]() { Math::BoundingSpherev3(p.data(), n, centre, radius); });
+	Bandwidth("BoundingSpherev3 (box loop -> Ritter)", n, t_ref, t_new);
+	printf("  %-40s %9s  radius %.3f (box centred %.3f)\n", "", "", radius, box_radius);
+
+	Bench::Check(Holds(p, centre, radius), "BoundingSpherev3 holds every point");
+}
+
+// Return the largest error between two point lists, relative to the size of the points
+static float MaxError(const glm::vec3* a, const glm::vec3* b, size_t n)
+{
+	float e = 0.0f;
+	for (size_t i = 0; i < n; i++)	// Iterate through each point
+		e = glm::max(e, glm::distance(a[i], b[i]) / glm::max(1.0f, glm::length(b[i])));
+
+	return e;
+}
+
+// Time the packed and split transforms against the per-point glm loop they replaced
+static void RunTransforms(size_t n, bool projective)
+{
+	std::mt19937 rng((unsigned int)n);
+	std::uniform_real_distribution<float> unit(-100.0f, 100.0f);
+
+	glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, -2.0f, 7.0f)) * glm::rotate(glm::mat4(1.0f), 0.4f, glm::vec3(1.0f, 2.0f, 0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 0.5f));
+	if (projective)		// If w has to be divided out
+	{
+		m[0][3] = 0.001f; m[1][3] = -0.002f; m[2][3] = 0.0005f; m[3][3] = 2.0f;		// A bottom row that keeps w positive over the cloud
+	}
+
+	std::vector<glm::vec3> in(n), ref(n), out(n);
+	std::vector<float> x(n), y(n), z(n), ox(n), oy(n), oz(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		in[i] = glm::vec3(unit(rng), unit(rng), unit(rng));
+		x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z;
+	}
+
+	printf("%s transform, %zu points\n", projective ? "projective" : "affine", n);
+
+	double t_ref = Bench::Time([&]()
+	{
+		for (size_t i = 0; i < n; i++)	// The old loop: one mat4 * vec4 per point
+		{
+			glm::vec4 r = m * glm::vec4(in[i], 1.0f);
+			ref[i] = projective ? glm::vec3(r.x / r.w, r.y / r.w, r.z / r.w) : glm::vec3(r);
+		}
+	});
+
+	double t_aos = Bench::Time([&]()
+	{
+		if (projective) Math::ProjectPointsv3(m, in.data(), out.data(), n);
+		else Math::TransformPointsv3(m, in.data(), out.data(), n);
+	});
+	Bandwidth("TransformAoS (glm loop -> kernel)", n, t_ref, t_aos);
+	Bench::Check(MaxError(out.data(), ref.data(), n) <= 1e-5f, "TransformAoS matches the glm loop");
+
+	double t_soa = Bench::Time([&]()
+	{
+		if (projective) Math::ProjectPointsSoA(m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), n);
+		else Math::TransformPointsSoA(m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), n);
+	});
+	Bandwidth("TransformSoA (glm loop -> kernel)", n, t_ref, t_soa);
+
+	for (size_t i = 0; i < n; i++)
+		out[i] = glm::vec3(ox[i], oy[i], oz[i]);
+	Bench::Check(MaxError(out.data(), ref.data(), n) <= 1e-5f, "TransformSoA matches the glm loop");
+
+	// In place, over a count that leaves a scalar tail
+	size_t odd = n - 5;
+	out = in;
+	if (projective) Math::ProjectPointsv3(m, out.data(), out.data(), odd);
+	else Math::TransformPointsv3(m, out.data(), out.data(), odd);
+	Bench::Check(MaxError(out.data(), ref.data(), odd) <= 1e-5f && out[odd] == in[odd], "TransformAoS works in place and stops at n");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	for (size_t n : Bench::Sizes(100000, 1000000))
+	{
+		RunTransforms(n, false);
+		RunTransforms(n, true);
+	}
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (size_t n : Bench::Sizes(100000, 1000000))
+	{
+		std::vector<glm::vec3> sphere = Bench::MakeSoup(Bench::SOUP_SPHERE, n / 3, 1);	// Every point on a radius 50 sphere
+		RunPoints("sphere", sphere);
+
+		glm::vec3 centre;
+		float radius;
+		Math::BoundingSpherev3(sphere.data(), sphere.size(), centre, radius);
+		Bench::Check(radius <= 50.0f * 1.001f, "BoundingSpherev3 is tight around a sphere");
+
+		std::vector<glm::vec3> cloud(n);	// Skewed cloud far from the origin, where a box centred sphere is loose
+		for (glm::vec3 &q : cloud)
+		{
+			glm::vec3 u(unit(rng), unit(rng), unit(rng));
+			q = glm::vec3(1000.0f, -500.0f, 250.0f) + (u.x < 0.01f ? Bench::RandomDirection(rng) * 40.0f : Bench::RandomDirection(rng) * (10.0f * u.y));
+		}
+		RunPoints("cloud", cloud);
+
+		std::vector<glm::vec3> terrain = Bench::MakeSoup(Bench::SOUP_TERRAIN, n / 3, 1);
+		RunPoints("terrain", terrain);
+	}
+
+	glm::vec3 centre(1.0f);
+	float radius = 1.0f;
+	Math::BoundingSpherev3(NULL, 0, centre, radius);
+	Bench::Check(radius == 0.0f, "BoundingSpherev3 of no points is empty");
+
+	glm::vec3 one(3.0f, 4.0f, 5.0f);
+	Math::BoundingSpherev3(&one, 1, centre, radius);
+	Bench::Check(glm::distance(centre, one) <= 1e-5f && radius <= 1e-4f, "BoundingSpherev3 of one point is that point");
+
+	return Bench::Finish();
+}
@@ -0,0 +1,170 @@
+// Mesh file benchmark
+// Compares loading the mapped binary mesh against parsing the text mesh it replaced, and checks that converting a text mesh
+// and saving a mesh opened from disk both keep every vertex, index, chunk and level of detail
+
+#include <cstdio>	// Get remove
+#include "Bench.h"	// Get timers, checks and soups
+#include "Legacy.h"		// Get the old text mesh reader and writer
+#include "../MeshFile.h"	// Get binary mesh files
+
+#define MESH_TEXT_FILE		"MeshBench.txt"		// Scratch text mesh
+#define MESH_BINARY_FILE	"MeshBench.mesh"	// Scratch binary mesh
+#define MESH_RESAVE_FILE	"MeshBench_resaved.mesh"	// Scratch binary mesh saved from an opened one
+
+// Return the contents of a file
+static std::vector<char> ReadBytes(const char* file)
+{
+	std::ifstream f(file, std::ios::binary);
+	return std::vector<char>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+// Return true if two chunk lists hold the same ranges
+static bool SameChunks(const std::vector<Chunk> &a, const std::vector<Chunk> &b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++)
+		if (a[i]._index_offset != b[i]._index_offset || a[i]._index_count != b[i]._index_count || a[i]._id != b[i]._id)
+			return false;
+
+	return true;
+}
+
+static void RunMesh(Bench::SoupKind kind, size_t triangles)
+{
+	// A mesh with two material groups and one level of detail
+	VertexData vd;
+	Bench::MakeIndexedSoup(kind, triangles, 3, vd.positions, vd.indices);
+	for (const glm::vec3 &p : vd.positions)
+	{
+		vd.texcoords.push_back(glm::vec3(p.x * 0.01f + 0.5f, p.z * 0.01f + 0.5f, 0.0f));
+		vd.normals.push_back(glm::length(p) > 0.0f ? glm::normalize(p) : glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	unsigned int half = (unsigned int)(vd.indices.size() / 6 * 3);		// Whole triangles in the first group
+	std::vector<Chunk> chunks = { Chunk(0, half, 0), Chunk(half * sizeof(unsigned int), (unsigned int)vd.indices.size() - half, 1) };
+	std::vector<std::string> materials = { "stone", "grass" };
+	MeshLod lod;
+	lod._chunks = { Chunk(0, half, 0) };
+	lod._error = 0.5f;
+	std::vector<MeshLod> lods = { lod };
+
+	printf("%s, %zu triangles, %zu vertices\n", Bench::SoupName(kind), vd.indices.size() / 3, vd.positions.size());
+
+	// -------------------------- CONVERT -------------------------------------------
+	Legacy::WriteTextMesh(MESH_TEXT_FILE, "bench", 0, vd, chunks, materials);
+	double t_convert = Bench::Time([&]() { MeshFile::ConvertText(MESH_TEXT_FILE, MESH_BINARY_FILE); });
+	Bench::Report("convert text -> binary", vd.positions.size(), t_convert);
+
+	// -------------------------- LOAD ----------------------------------------------
+	std::string name;
+	unsigned int type = 0;
+	VertexData text;
+	std::vector<Chunk> text_chunks;
+	std::vector<std::string> text_materials;
+	double t_text = Bench::Time([&]()
+	{
+		text = VertexData(); text_chunks.clear(); text_materials.clear();
+		Legacy::ReadTextMesh(MESH_TEXT_FILE, name, type, text, text_chunks, text_materials);
+	});
+
+	MeshFile mf;
+	bool opened = false;
+	double t_open = Bench::Time([&]() { opened = mf.Open(MESH_BINARY_FILE); });
+	Bench::Compare("load (text parse -> mapped binary)", vd.positions.size(), t_text, t_open);
+
+	VertexData binary;
+	double t_copy = Bench::Time([&]() { mf.GetVertexData(binary); });
+	Bench::Compare("load (text parse -> binary + CPU copy)", vd.positions.size(), t_text, t_open + t_copy);
+
+	// -------------------------- CONVERT ROUND TRIP --------------------------------
+	// The text keeps six digits, so the binary is compared with what the old reader made of the same text
+	Bench::Check(opened, "the converted mesh opens");
+	Bench::Check(mf.GetName() == name && mf.GetMeshType() == type, "ConvertText keeps the name and type");
+	Bench::Check(binary.positions == text.positions && binary.normals == text.normals && binary.texcoords == text.texcoords && binary.indices == text.indices, "ConvertText keeps every vertex and index");
+
+	std::vector<Chunk> groups;
+	bool names = mf.GetGroupCount() == text_materials.size();
+	for (unsigned int i = 0; i < mf.GetGroupCount(); i++)
+	{
+		groups.push_back(mf.GetChunk(i));
+		names &= names && mf.GetMaterialName(i) == text_materials[i];
+	}
+	Bench::Check(SameChunks(groups, text_chunks) && names, "ConvertText keeps the chunks and their materials");
+
+	text.tangents.assign(text.positions.size(), glm::vec3(0.0f));
+	CalculateTangents(text);
+	Bench::Check(binary.tangents == text.tangents, "ConvertText calculates the tangents");
+
+	// The old importer stored each chunk's end index where the count goes, which runs every chunk after the first past the indices
+	std::vector<Chunk> ends = { chunks[0], Chunk(chunks[1]._index_offset, (unsigned int)vd.indices.size(), chunks[1]._id) };
+	mf.Close();		// Unmap before the file can be overwritten
+	Legacy::WriteTextMesh(MESH_TEXT_FILE, "bench", 0, vd, ends, materials);
+	opened = MeshFile::ConvertText(MESH_TEXT_FILE, MESH_BINARY_FILE) && mf.Open(MESH_BINARY_FILE);
+	groups.clear();
+	for (unsigned int i = 0; opened && i < mf.GetGroupCount(); i++)
+		groups.push_back(mf.GetChunk(i));
+	Bench::Check(opened && SameChunks(groups, chunks), "ConvertText turns end indices stored as counts back into counts");
+	mf.Close();
+
+	// -------------------------- RESAVE ROUND TRIP ---------------------------------
+	// What SaveAs::MeshO does for a mesh opened from disk: copy the mapped streams out and write them again
+	MeshFile::Write(MESH_BINARY_FILE, "bench", 0, vd, chunks, materials, lods);		// Original with a level of detail
+	mf.Open(MESH_BINARY_FILE);
+
+	VertexData copy;
+	mf.GetVertexData(copy);
+	std::vector<Chunk> copy_chunks;
+	std::vector<std::string> copy_materials;
+	for (unsigned int i = 0; i < mf.GetGroupCount(); i++)
+	{
+		copy_chunks.push_back(mf.GetChunk(i));
+		copy_materials.push_back(mf.GetMaterialName(i));
+	}
+	std::vector<MeshLod> copy_lods;
+	mf.GetLods(copy_lods);
+	std::string copy_name = mf.GetName();
+	unsigned int copy_type = mf.GetMeshType();
+	mf.Close();		// Unmap before the file can be overwritten
+
+	MeshFile::Write(MESH_RESAVE_FILE, copy_name, copy_type, copy, copy_chunks, copy_materials, copy_lods);
+	Bench::Check(ReadBytes(MESH_RESAVE_FILE) == ReadBytes(MESH_BINARY_FILE), "a mesh opened from disk saves back byte for byte");
+
+	// -------------------------- CORRUPT IDS ---------------------------------------
+	// Meshes draw each range with the material its id names, so an id past the groups must fail to open rather than read past the materials
+	std::vector<char> bytes = ReadBytes(MESH_BINARY_FILE);
+	const MeshFileHeader* header = (const MeshFileHeader*)bytes.data();
+	const MeshFileChunk* table = (const MeshFileChunk*)(bytes.data() + header->header_bytes);
+	int corrupted = 0;
+	bool rejected = true;
+	for (uint32_t i = 0; i < header->chunk_count; i++)
+		if (table[i].tag == MESH_CHUNK_GROUPS || table[i].tag == MESH_CHUNK_LODS)	// Break the id of the first entry
+		{
+			std::vector<char> corrupt = bytes;
+			size_t at = (size_t)table[i].offset + (table[i].tag == MESH_CHUNK_GROUPS ? offsetof(MeshFileGroup, id) : offsetof(MeshFileLod, id));
+			uint32_t id = (uint32_t)chunks.size();
+			memcpy(corrupt.data() + at, &id, sizeof(id));
+			std::ofstream(MESH_RESAVE_FILE, std::ios::binary | std::ios::trunc).write(corrupt.data(), corrupt.size());
+
+			rejected &= !mf.Open(MESH_RESAVE_FILE);
+			corrupted++;
+		}
+	Bench::Check(corrupted == 2 && rejected, "a group or level of detail id past the groups fails to open");
+
+	std::remove(MESH_TEXT_FILE);
+	std::remove(MESH_BINARY_FILE);
+	std::remove(MESH_RESAVE_FILE);
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+			RunMesh(kind, n);
+
+	return Bench::Finish();
+}
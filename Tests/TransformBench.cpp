@@ -0,0 +1,173 @@
+// Transform benchmark
+// Checks the model matrix order against the scale * rotate * translate chain maps are authored against,
+// checks the blend and the transform store against brute force, and times the store's dirty update against recomputing every matrix
+
+#include "Bench.h"	// Get timers and checks
+#include "../TransformStore.h"	// Get the transform store
+
+#define STORE_MOVED		0.01f	// Fraction of transforms moved between updates
+
+// Return the largest component difference between two matrices, relative to their size
+static float MaxError(const glm::mat4 &a, const glm::mat4 &b)
+{
+	float e = 0.0f, s = 1.0f;
+	for (int c = 0; c < 4; c++)
+		for (int r = 0; r < 4; r++)
+		{
+			e = glm::max(e, glm::abs(a[c][r] - b[c][r]));
+			s = glm::max(s, glm::abs(b[c][r]));
+		}
+
+	return e / s;
+}
+
+// Return the model matrix Actor::UpdateModel built before the transform store
+static glm::mat4 LegacyModel(const glm::vec3 &position, const glm::vec3 &scale, const glm::vec3 &degrees)
+{
+	return glm::scale(scale) *
+		glm::rotate(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f)) *		// Rotation X
+		glm::rotate(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f)) *		// Rotation Y
+		glm::rotate(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f)) *		// Rotation Z
+		glm::translate(position);
+}
+
+static void RunCompose()
+{
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> pos(-100.0f, 100.0f), deg(-180.0f, 180.0f), sca(0.25f, 4.0f), unit(0.0f, 1.0f);
+
+	bool order = true, round_trip = true, ends = true, middle = true;
+	for (int i = 0; i < 1000; i++)
+	{
+		glm::vec3 p(pos(rng), pos(rng), pos(rng)), d(deg(rng), deg(rng), deg(rng)), s(sca(rng), sca(rng), sca(rng));
+		glm::mat4 m = Transform::Compose(p, Transform::EulerToQuat(d), s);
+		order &= MaxError(m, LegacyModel(p, s, d)) <= 1e-5f;
+
+		glm::vec3 p2, s2;
+		glm::quat r2;
+		round_trip &= Transform::Decompose(m, p2, r2, s2) && MaxError(Transform::Compose(p2, r2, s2), m) <= 1e-4f;
+
+		glm::vec3 q(pos(rng), pos(rng), pos(rng)), e(deg(rng), deg(rng), deg(rng)), t(sca(rng), sca(rng), sca(rng));
+		glm::mat4 b = Transform::Compose(q, Transform::EulerToQuat(e), t);
+		ends &= MaxError(Transform::Blend(m, b, 0.0f), m) <= 1e-4f && Transform::Blend(m, b, 1.0f) == b;
+
+		float k = unit(rng);	// Moving without turning or scaling blends the position alone
+		glm::mat4 c = Transform::Compose(q, Transform::EulerToQuat(d), s);
+		middle &= MaxError(Transform::Blend(m, c, k), Transform::Compose(glm::mix(p, q, k), Transform::EulerToQuat(d), s)) <= 1e-4f;
+	}
+
+	Bench::Check(order, "Compose matches scale * rotate * translate");
+	Bench::Check(round_trip, "Decompose undoes Compose");
+	Bench::Check(ends, "Blend returns its ends");
+	Bench::Check(middle, "Blend lerps the position");
+}
+
+static void RunStore(size_t n)
+{
+	std::mt19937 rng((unsigned int)n);
+	std::uniform_real_distribution<float> pos(-10.0f, 10.0f), deg(-180.0f, 180.0f), sca(0.5f, 2.0f), unit(0.0f, 1.0f);
+
+	printf("transform store, %zu transforms\n", n);
+
+	// A forest where most transforms hang off an earlier one, so parents always have lower handles
+	TransformStore store;
+	std::vector<int> parent(n, TRANSFORM_NULL);
+	double t_build = Bench::Time([&]()
+	{
+		store = TransformStore();
+		for (size_t i = 0; i < n; i++)
+		{
+			parent[i] = (i > 0 && unit(rng) < 0.8f) ? (int)(unit(rng) * i) : TRANSFORM_NULL;
+			store.Create(NULL, parent[i]);
+		}
+	});
+	Bench::Report("build", n, t_build);
+
+	std::vector<glm::vec3> p(n), d(n), s(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		p[i] = glm::vec3(pos(rng), pos(rng), pos(rng)); d[i] = glm::vec3(deg(rng), deg(rng), deg(rng)); s[i] = glm::vec3(sca(rng), sca(rng), sca(rng));
+		store.SetLocal((int)i, p[i], Transform::EulerToQuat(d[i]), s[i]);
+	}
+	store.Update();
+
+	// Every world matrix from scratch, parents first
+	std::vector<glm::mat4> world(n);
+	auto brute = [&]()
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			glm::mat4 local = Transform::Compose(p[i], Transform::EulerToQuat(d[i]), s[i]);
+			world[i] = (parent[i] == TRANSFORM_NULL) ? local : world[parent[i]] * local;
+		}
+	};
+
+	auto same = [&]()
+	{
+		bool ok = true;
+		for (size_t i = 0; i < n && ok; i++)
+			ok &= store.GetParent((int)i) == parent[i] && MaxError(store.GetWorld((int)i), world[i]) <= 1e-4f;
+		return ok;
+	};
+
+	brute();
+	Bench::Check(same(), "the store matches the world matrices from scratch");
+
+	// Move a few transforms, then update: only their sub trees are recomputed
+	size_t moved = glm::max((size_t)1, (size_t)(n * STORE_MOVED));
+	std::vector<int> pick(moved);
+	for (int &h : pick)
+		h = (int)(unit(rng) * n);
+
+	double t_all = Bench::Time(brute);
+	double t_dirty = Bench::Time([&]()
+	{
+		for (int h : pick)
+		{
+			p[h].y += 0.001f;
+			store.SetPosition(h, p[h]);
+		}
+		store.Update();
+	});
+	Bench::Compare("update 1% (every matrix -> dirty runs)", n, t_all, t_dirty);
+
+	brute();
+	Bench::Check(same(), "the store matches after moving transforms");
+
+	// Move every transform from the job system, as Map::UpdateActors does, each thread queueing on its own list
+	double t_parallel = Bench::Time([&]()
+	{
+		store.BeginDeferred(JobSystem::GetThreadCount());
+		JobSystem::ParallelFor(0, n, 64, [&](size_t first, size_t last)
+		{
+			for (size_t h = first; h < last; h++)
+			{
+				p[h].x += 0.001f;
+				store.SetLocal((int)h, p[h], Transform::EulerToQuat(d[h]), s[h]);
+			}
+		});
+		store.EndDeferred();
+		store.Update();
+	});
+	char name[64];
+	snprintf(name, sizeof(name), "update all, set from %u threads", JobSystem::GetThreadCount());
+	Bench::Report(name, n, t_parallel);
+
+	brute();
+	Bench::Check(same(), "the store matches after moving transforms from every thread");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	JobSystem::Initialise(3);	// Workers even on one core, so the deferred lists are shared out
+
+	RunCompose();
+
+	for (size_t n : Bench::Sizes(1000, 10000))
+		RunStore(n);
+
+	JobSystem::Destroy();
+	return Bench::Finish();
+}
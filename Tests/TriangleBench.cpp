@@ -0,0 +1,140 @@
+// Triangle storage benchmark
+// Compares the structure-of-arrays TriangleData against the Triangle* pointer graph it replaced:
+// build time, memory, transforming every triangle and a linear ray query over every triangle
+
+#include <cfloat>	// Get float limits
+#include "Bench.h"	// Get timers, checks and soups
+#include "Legacy.h"		// Get the old triangle graph
+#include "../Collision.h"	// Get triangle data and kernels
+
+#define RAYS	16		// Linear ray queries for each soup
+
+using namespace Collision::Ndc;
+
+// Fill triangle data from a soup, as CollisionData::Assign does
+static void BuildTriangleData(const std::vector<glm::vec3> &soup, Data::TriangleData &t)
+{
+	t = Data::TriangleData();
+	t.Resize((unsigned int)soup.size() / 3);	// Allocate once
+
+	for (unsigned int i = 0; i + 2 < soup.size(); i += 3)	// Iterate through each triangle
+	{
+		t.SetP(i / 3, 0, soup[i]);
+		t.SetP(i / 3, 1, soup[i + 1]);
+		t.SetP(i / 3, 2, soup[i + 2]);
+	}
+
+	t.Update();		// Edges, normals and averages
+}
+
+// Transform every triangle in place and recalculate its derived data
+static void UpdateTriangleData(Data::TriangleData &t, const glm::mat4 &m)
+{
+	for (unsigned int k = 0; k < 3; k++)	// Move point k of every triangle in one batch
+		Math::TransformPointsSoA(m, t.x[k].data(), t.y[k].data(), t.z[k].data(), t.x[k].data(), t.y[k].data(), t.z[k].data(), t.Size());
+
+	t.Update();		// Edges, normals and averages
+}
+
+static void RunSoup(Bench::SoupKind kind, size_t triangles)
+{
+	std::mt19937 rng((unsigned int)triangles);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<glm::vec3> soup = Bench::MakeSoup(kind, triangles, 7);
+	size_t n = soup.size() / 3;
+
+	printf("%s, %zu triangles\n", Bench::SoupName(kind), n);
+
+	// -------------------------- BUILD ---------------------------------------------
+	std::vector<Legacy::Triangle*> graph;
+	Data::TriangleData t;
+
+	double t_graph = Bench::Time([&]()
+	{
+		Legacy::DeleteTriangles(graph);
+		graph = Legacy::BuildTriangles(soup);
+	});
+	double t_soa = Bench::Time([&]() { BuildTriangleData(soup, t); });
+	Bench::Compare("build (Triangle* -> TriangleData)", n, t_graph, t_soa);
+
+	printf("  %-40s %9zu  %10.2f MB -> %10.2f MB\n", "memory", n, Legacy::Bytes(graph) / 1048576.0, t.Bytes() / 1048576.0);
+	Bench::Check(t.Size() == graph.size(), "both layouts hold every triangle");
+
+	bool same = true;	// Derived data agrees
+	for (unsigned int i = 0; i < t.Size() && same; i++)
+	{
+		glm::vec3 n_graph = graph[i]->n, a_graph = graph[i]->a;
+		float l = glm::length(n_graph);
+		same &= glm::distance(t.A(i), a_graph) <= 1e-4f;
+		same &= (l == 0.0f) || glm::distance(t.N(i), n_graph / l) <= 1e-4f;
+		for (unsigned int k = 0; k < 3; k++)
+			same &= glm::distance(t.E(i, k), graph[i]->e[k]->v) <= 1e-4f;
+	}
+	Bench::Check(same, "TriangleData matches the triangle graph");
+
+	// -------------------------- TRANSFORM -----------------------------------------
+	glm::mat4 m = glm::rotate(glm::mat4(1.0f), 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));	// Small rotation, so repeats stay bounded
+	double t_graph_update = Bench::Time([&]() { Legacy::UpdateTriangles(graph, m); });
+	double t_soa_update = Bench::Time([&]() { UpdateTriangleData(t, m); });
+	Bench::Compare("transform every triangle", n, t_graph_update, t_soa_update);
+
+	// Bring both layouts back to the same state before the queries
+	Legacy::DeleteTriangles(graph);
+	graph = Legacy::BuildTriangles(soup);
+	BuildTriangleData(soup, t);
+
+	// -------------------------- LINEAR RAY QUERY ----------------------------------
+	Data::Aabb bounds;
+	for (const glm::vec3 &p : soup)
+		bounds.Grow(p);
+
+	std::vector<glm::vec3> origins(RAYS), dirs(RAYS);
+	for (int r = 0; r < RAYS; r++)
+	{
+		origins[r] = bounds.min + glm::vec3(unit(rng), unit(rng), unit(rng)) * bounds.Extent() + glm::vec3(0.0f, 10.0f, 0.0f);
+		dirs[r] = bounds.Centre() + Bench::RandomDirection(rng) * 20.0f - origins[r];
+	}
+
+	std::vector<float> hit_graph(RAYS), hit_soa(RAYS);
+	double t_graph_ray = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+			hit_graph[r] = Legacy::RayToTriangles(graph, origins[r], dirs[r], 2.0f);
+	});
+	double t_soa_ray = Bench::Time([&]()
+	{
+		for (int r = 0; r < RAYS; r++)
+		{
+			float t_max = 2.0f;
+			unsigned int tri = 0;
+			Detection::RayToTriangles(origins[r], dirs[r], t, 0, t.Size(), t_max, tri);
+			hit_soa[r] = t_max;
+		}
+	});
+	Bench::Compare("ray against every triangle", n * RAYS, t_graph_ray, t_soa_ray);
+
+	bool rays = true;
+	int hits = 0;
+	for (int r = 0; r < RAYS; r++)
+	{
+		rays &= glm::abs(hit_graph[r] - hit_soa[r]) <= 1e-4f * glm::max(1.0f, hit_graph[r]);
+		hits += (hit_soa[r] < 2.0f);
+	}
+	Bench::Check(rays, "ray queries agree between the layouts");
+	Bench::Check(hits > 0, "ray queries hit something");
+
+	Legacy::DeleteTriangles(graph);
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_PLANE, Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+			RunSoup(kind, n);
+
+	return Bench::Finish();
+}
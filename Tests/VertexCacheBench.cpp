@@ -0,0 +1,189 @@
+// Vertex cache benchmark
+// Measures what each VertexCache pass does to the ACMR, ATVR and fetched memory lines of meshes imported in scan order and with shuffled triangles and vertices,
+// times the passes, and checks every chunk keeps exactly its triangles
+
+#include <algorithm>	// Get sorting and shuffles
+#include <tuple>	// Get tuple compares
+#include "Bench.h"	// Get timers, checks and soups
+#include "../VertexCache.h"		// Get the optimiser
+
+#define FETCH_VERTEX_BYTES	48	// Bytes per interleaved vertex, as MeshFile stores them
+#define FETCH_LINE_BYTES	64	// Bytes per memory cache line
+#define FETCH_LINES			32	// Lines kept by the modelled fetch cache
+
+typedef std::tuple<float, float, float> Corner;		// A vertex position, ordered
+typedef std::tuple<Corner, Corner, Corner> Face;	// A triangle, rotated to start at its smallest corner
+
+// Return the triangles of a chunk by position, each rotated to start at its smallest corner so winding is kept, sorted
+static std::vector<Face> Faces(const VertexData &vd, const Chunk &c)
+{
+	std::vector<Face> faces;
+	size_t first = c._index_offset / sizeof(unsigned int);
+	for (size_t i = first; i + 2 < first + c._index_count; i += 3)
+	{
+		Corner k[3];
+		for (int j = 0; j < 3; j++)
+		{
+			const glm::vec3 &p = vd.positions[vd.indices[i + j]];
+			k[j] = Corner(p.x, p.y, p.z);
+		}
+
+		int s = (k[1] < k[0]) ? 1 : 0;
+		if (k[2] < k[s]) s = 2;
+		faces.push_back(Face(k[s], k[(s + 1) % 3], k[(s + 2) % 3]));
+	}
+
+	std::sort(faces.begin(), faces.end());
+	return faces;
+}
+
+// Return the memory lines loaded per triangle: every vertex the FIFO vertex cache misses is read through a small LRU of lines
+static double FetchLines(const std::vector<unsigned int> &indices, size_t vertex_count)
+{
+	std::vector<unsigned int> stamp(vertex_count, 0);	// Vertex cache, as VertexCache::Analyse models it
+	unsigned int misses = 0;
+	std::vector<size_t> lines;	// Line cache, most recent last
+	size_t loads = 0;
+
+	for (unsigned int v : indices)
+	{
+		if (stamp[v] != 0 && misses - stamp[v] < VERTEX_CACHE_FIFO)	// If the vertex is still shaded
+			continue;
+		stamp[v] = ++misses;
+
+		for (size_t l = (size_t)v * FETCH_VERTEX_BYTES / FETCH_LINE_BYTES; l <= ((size_t)v * FETCH_VERTEX_BYTES + FETCH_VERTEX_BYTES - 1) / FETCH_LINE_BYTES; l++)
+		{
+			std::vector<size_t>::iterator it = std::find(lines.begin(), lines.end(), l);
+			if (it != lines.end())
+				lines.erase(it);
+			else
+			{
+				loads++;
+				if (lines.size() == FETCH_LINES)
+					lines.erase(lines.begin());
+			}
+			lines.push_back(l);
+		}
+	}
+
+	return indices.size() ? (double)loads / (indices.size() / 3) : 0.0;
+}
+
+// Print cache statistics
+static void Stats(const char* name, const VertexCacheStats &s, const VertexData &vd)
+{
+	printf("  %-40s %9s  ACMR %.3f  ATVR %.3f  lines/tri %.3f\n", name, "", s.acmr, s.atvr, FetchLines(vd.indices, vd.positions.size()));
+}
+
+// Return seconds per call of a pass, preparing its input outside the timing each time
+template <typename S, typename P>
+static double TimePass(S setup, P pass)
+{
+	double total = 0.0, limit = Bench::_quick ? BENCH_QUICK_SECONDS : BENCH_MIN_SECONDS;
+	size_t runs = 0;
+	do
+	{
+		setup();
+		double start = Bench::Now();
+		pass();
+		total += Bench::Now() - start;
+		runs++;
+	} while (total < limit);
+
+	return total / runs;
+}
+
+static void RunMesh(Bench::SoupKind kind, size_t triangles, bool shuffled)
+{
+	VertexData vd;
+	Bench::MakeIndexedSoup(kind, triangles, 5, vd.positions, vd.indices);
+	size_t n = vd.positions.size(), tris = vd.indices.size() / 3;
+	vd.texcoords.assign(n, glm::vec3(0.0f));
+	vd.normals.assign(n, glm::vec3(0.0f, 1.0f, 0.0f));
+	vd.tangents.assign(n, glm::vec3(1.0f, 0.0f, 0.0f));
+
+	unsigned int half = (unsigned int)(tris / 2 * 3);	// Two chunks, as two materials would make
+	std::vector<Chunk> chunks = { Chunk(0, half, 0), Chunk(half * sizeof(unsigned int), (unsigned int)vd.indices.size() - half, 1) };
+
+	if (shuffled)	// Vertices and the triangles of each chunk in random order, as some exporters write them
+	{
+		std::mt19937 rng((unsigned int)tris);
+		std::vector<unsigned int> remap(n);
+		for (unsigned int v = 0; v < n; v++) remap[v] = v;
+		std::shuffle(remap.begin(), remap.end(), rng);
+
+		std::vector<glm::vec3> moved(n);
+		for (size_t v = 0; v < n; v++) moved[remap[v]] = vd.positions[v];
+		vd.positions.swap(moved);
+		for (unsigned int &i : vd.indices) i = remap[i];
+
+		std::vector<unsigned int> out(vd.indices.size());
+		for (const Chunk &c : chunks)
+		{
+			size_t first = c._index_offset / sizeof(unsigned int) / 3, count = c._index_count / 3;
+			std::vector<size_t> order(count);
+			for (size_t t = 0; t < count; t++) order[t] = first + t;
+			std::shuffle(order.begin(), order.end(), rng);
+
+			for (size_t t = 0; t < count; t++)
+				for (int j = 0; j < 3; j++)
+					out[(first + t) * 3 + j] = vd.indices[order[t] * 3 + j];
+		}
+		vd.indices.swap(out);
+	}
+
+	printf("%s %s, %zu triangles\n", shuffled ? "shuffled" : "scan order", Bench::SoupName(kind), tris);
+
+	// -------------------------- EACH PASS -----------------------------------------
+	// Each pass is timed on the output of the ones before it
+	VertexData input = vd, cached, drawn, work;
+	Stats("input", VertexCache::Analyse(vd.indices, chunks, n), vd);
+
+	auto cache = [&](VertexData &d) { for (const Chunk &c : chunks) VertexCache::OptimiseCache(d.indices.data() + c._index_offset / sizeof(unsigned int), c._index_count, n); };
+	auto overdraw = [&](VertexData &d) { for (const Chunk &c : chunks) VertexCache::OptimiseOverdraw(d.indices.data() + c._index_offset / sizeof(unsigned int), c._index_count, d.positions); };
+
+	double t_cache = TimePass([&]() { cached = input; }, [&]() { cache(cached); });
+	Stats("after OptimiseCache", VertexCache::Analyse(cached.indices, chunks, n), cached);
+	double t_overdraw = TimePass([&]() { drawn = cached; }, [&]() { overdraw(drawn); });
+	Stats("after OptimiseOverdraw", VertexCache::Analyse(drawn.indices, chunks, n), drawn);
+	double t_fetch = TimePass([&]() { work = drawn; }, [&]() { VertexCache::OptimiseFetch(work); });
+	Stats("after OptimiseFetch", VertexCache::Analyse(work.indices, chunks, n), work);
+
+	Bench::Report("OptimiseCache", tris, t_cache);
+	Bench::Report("OptimiseOverdraw", tris, t_overdraw);
+	Bench::Report("OptimiseFetch", tris, t_fetch);
+
+	// -------------------------- WHOLE IMPORT STAGE --------------------------------
+	VertexCacheStats before, after;
+	double t_all = TimePass([&]() { work = input; }, [&]() { VertexCache::Optimise(work, chunks, before, after); });
+	Bench::Report("Optimise (every pass)", tris, t_all);
+
+	Bench::Check(after.acmr <= before.acmr && after.atvr >= 1.0f, "Optimise doesn't make the cache worse");
+	Bench::Check(Faces(work, chunks[0]) == Faces(input, chunks[0]) && Faces(work, chunks[1]) == Faces(input, chunks[1]), "every chunk keeps its triangles and winding");
+
+	bool ordered = true;	// Fetch order: each new vertex is the next one
+	unsigned int next = 0;
+	for (unsigned int i : work.indices)
+	{
+		ordered &= i <= next;
+		if (i == next) next++;
+	}
+	Bench::Check(ordered, "OptimiseFetch numbers vertices in first use order");
+	if (shuffled)	// If the vertex numbering had no locality to keep
+		Bench::Check(FetchLines(work.indices, n) < FetchLines(drawn.indices, n), "OptimiseFetch loads fewer lines than a shuffled numbering");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+		{
+			RunMesh(kind, n, false);
+			RunMesh(kind, n, true);
+		}
+
+	return Bench::Finish();
+}
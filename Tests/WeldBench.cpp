@@ -0,0 +1,100 @@
+// Weld benchmark
+// Compares the hash grid Data::Weld against the quadratic duplicate removal it replaced, and checks it against a sort based reference
+
+#include <algorithm>	// Get sorting
+#include <tuple>	// Get tuple compares
+#include "Bench.h"	// Get timers, checks and soups
+#include "Legacy.h"		// Get the old weld
+#include "../Collision.h"	// Get the weld
+
+#define WELD_JITTER		0.2f	// Jitter added to each copy, as a fraction of the weld epsilon
+
+using namespace Collision::Ndc;
+
+// Order points by their components
+static bool Less(const glm::vec3 &a, const glm::vec3 &b)
+{
+	return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+}
+
+// Return the exact unique points of a soup, sorted
+static std::vector<glm::vec3> SortedUnique(std::vector<glm::vec3> points)
+{
+	std::sort(points.begin(), points.end(), Less);
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+	return points;
+}
+
+// Check a weld result: every point maps to a unique point within epsilon
+static bool Mapped(const std::vector<glm::vec3> &points, const std::vector<glm::vec3> &unique, const std::vector<unsigned int> &index, float epsilon)
+{
+	if (index.size() != points.size())	// If a point has no index
+		return false;
+
+	for (size_t i = 0; i < points.size(); i++)	// Iterate through each point
+		if (index[i] >= unique.size() || glm::distance(points[i], unique[index[i]]) > epsilon)
+			return false;
+
+	return true;
+}
+
+static void RunSoup(Bench::SoupKind kind, size_t triangles, size_t legacy_max)
+{
+	std::mt19937 rng((unsigned int)triangles);
+	std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+
+	std::vector<glm::vec3> soup = Bench::MakeSoup(kind, triangles, 7);
+	size_t n = soup.size();		// Points
+
+	printf("%s, %zu points\n", Bench::SoupName(kind), n);
+
+	std::vector<glm::vec3> reference = SortedUnique(soup);	// Exact unique points
+
+	// -------------------------- HASH GRID WELD ------------------------------------
+	std::vector<glm::vec3> unique;
+	std::vector<unsigned int> index;
+	double t_hash = Bench::Time([&]() { Data::Weld(soup, COLLISION_WELD_EPSILON, unique, index); });
+
+	Bench::Check(SortedUnique(unique) == reference, "Weld keeps exactly the unique points");
+	Bench::Check(Mapped(soup, unique, index, 0.0f), "Weld maps every point to its copy");
+
+	// -------------------------- QUADRATIC WELD ------------------------------------
+	if (triangles <= legacy_max)	// If the old weld finishes in reasonable time
+	{
+		std::vector<glm::vec3> old;
+		double t_old = Bench::Time([&]() { old = Legacy::WeldPoints(soup); });
+		Bench::Compare("weld (pairwise -> hash grid)", n, t_old, t_hash);
+		Bench::Check(SortedUnique(old) == reference, "the old weld agrees with the reference");
+	}
+	else
+	{
+		Bench::Report("weld (hash grid)", n, t_hash);
+		printf("  %-40s %9zu  skipped, quadratic\n", "weld (pairwise)", n);
+	}
+
+	// -------------------------- WELD WITHIN EPSILON -------------------------------
+	// Copies of a point are moved by less than epsilon, so exact compares no longer find them
+	// Each copy moves along one axis only, so the jitter plus float rounding stays inside epsilon
+	std::vector<glm::vec3> noisy = soup;
+	for (size_t i = 0; i < noisy.size(); i++)
+		noisy[i][(int)(i % 3)] += jitter(rng) * (COLLISION_WELD_EPSILON * WELD_JITTER);
+
+	double t_noisy = Bench::Time([&]() { Data::Weld(noisy, COLLISION_WELD_EPSILON, unique, index); });
+	Bench::Report("weld (hash grid, jittered copies)", n, t_noisy);
+	Bench::Check(unique.size() == reference.size(), "Weld merges jittered copies");
+	Bench::Check(Mapped(noisy, unique, index, COLLISION_WELD_EPSILON), "Weld maps every jittered point within epsilon");
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Initialise(argc, argv);
+
+	size_t legacy_max = Bench::_quick ? 1000 : 10000;	// Largest soup the pairwise weld is timed on
+
+	Bench::SoupKind kinds[] = { Bench::SOUP_PLANE, Bench::SOUP_SPHERE, Bench::SOUP_TERRAIN };
+	for (Bench::SoupKind kind : kinds)
+		for (size_t n : Bench::Sizes(10000, 1000000))
+			RunSoup(kind, n, legacy_max);
+
+	return Bench::Finish();
+}
@@ -1,7 +1,7 @@
 #ifndef __TEXT_H__
 #define __TEXT_H__
 
-#include <glm\gtc\type_ptr.hpp>		// Get valur_ptr for glm
+#include <glm/gtc/type_ptr.hpp>		// Get valur_ptr for glm
 #include "Control.h"	// Include control for deriving
 #include "Font.h"	// Include font struct
 #include "Keys.h"	// Get key macro definitions
@@ -7,6 +7,7 @@
 
 
 // This class will be responsible for maintaining a fixed fps, also known as "timestep"
+// In fixed mode frame time is banked in an accumulator and paid out as whole ticks of _tick seconds, so the simulation runs the same at any frame rate
 class TimeStepCounter
 {
 private:
@@ -14,8 +15,44 @@ private:
 	LARGE_INTEGER	_last;			// Get the last time (elapsed time)
 	LARGE_INTEGER	_current;		// The current time
 
+	bool			_fixed;			// Is the simulation stepped at a fixed rate?
+	unsigned int	_max_steps;		// Most ticks paid out in one frame
+	unsigned int	_steps;			// Ticks to run this frame
+	double			_accumulator;	// Frame time not yet simulated
+	float			_alpha;			// How far the render state is between the previous and current tick (0 - 1)
+
 public:
-	double			_delta;			// The tick rate (this variable is public as it MUST be an lvalue for parsing)
+	double			_delta;			// The frame time (this variable is public as it MUST be an lvalue for parsing)
+	double			_tick;			// The time of one simulation tick (_delta when not fixed)
+
+	// Default constructor - variable timestep
+	inline TimeStepCounter() : _fixed(false), _max_steps(SIM_MAX_SUBSTEPS), _steps(1), _accumulator(0.0), _alpha(1.0f), _delta(0.0), _tick(0.0) {}
+
+	inline bool IsFixed() { return _fixed; }	// Return true if the simulation is stepped at a fixed rate
+	inline unsigned int GetSteps() { return _steps; }	// Return the number of ticks to run this frame
+	inline float GetAlpha() { return _alpha; }	// Return the render interpolation factor
+
+	// Step the simulation at a fixed rate in ticks per second, running at most max_steps ticks a frame
+	inline void SetFixedStep(double rate, unsigned int max_steps = SIM_MAX_SUBSTEPS)
+	{
+		if (rate <= 0.0 || max_steps == 0)	// If the rate can't be used
+		{
+			std::cerr << "TimeStep Error: The tick rate and max substeps must be above zero!\n";	// Print out error message
+			return;		// Return from function
+		}
+
+		_fixed = true;	// Enable fixed steps
+		_tick = 1.0 / rate;		// Assign tick time
+		_max_steps = max_steps;		// Assign substep limit
+		_accumulator = 0.0;		// Reset banked time
+	}
+
+	// Step the simulation once a frame with the frame time
+	inline void SetVariableStep()
+	{
+		_fixed = false;		// Disable fixed steps
+		_accumulator = 0.0;		// Reset banked time
+	}
 
 	// Initialise the our perfomance counter by getting the frequency
 	inline void Initialise()
@@ -24,11 +61,28 @@ public:
 		QueryPerformanceCounter(&_last);
 	}
 
-	// Analyse our performance counter by performing delta calculation
+	// Analyse our performance counter by performing delta calculation, then work out the ticks and interpolation factor for this frame
 	inline void Analyse()
 	{
 		QueryPerformanceCounter(&_current);
 		_delta = ((double)(_current.QuadPart - _last.QuadPart) / (double)_frequency.QuadPart) * _rt_speed;
+
+		if (!_fixed)	// If the simulation follows the frame rate
+		{
+			_tick = _delta;		// One tick of the whole frame
+			_steps = 1;		// Run it once
+			_alpha = 1.0f;	// Draw the current state
+			return;		// Return from function
+		}
+
+		_accumulator += _delta;		// Bank frame time
+
+		if (_accumulator > _tick * _max_steps)	// If we've fallen too far behind (a hitch or breakpoint)
+			_accumulator = _tick * _max_steps;	// Drop the rest rather than spiral, the simulation slows down instead of taking one huge step
+
+		_steps = (unsigned int)(_accumulator / _tick);	// Whole ticks due
+		_accumulator -= _steps * _tick;		// Pay them out
+		_alpha = (float)(_accumulator / _tick);		// Left over fraction of a tick
 	}
 
 	// Reset the time back to current
@@ -1,9 +1,10 @@
 #ifndef __TRANSFORM_H__
 #define __TRANSFORM_H__
 
-#include <glm\glm.hpp>	// Get 3D variables
-#include <glm\gtc\type_ptr.hpp>		// Get glm conversion type
-#include <glm\gtx\transform.hpp>	// Get transform functions
+#include <glm/glm.hpp>	// Get 3D variables
+#include <glm/gtc/type_ptr.hpp>		// Get glm conversion type
+#include <glm/gtx/transform.hpp>	// Get transform functions
+#include <glm/gtc/quaternion.hpp>	// Get quaternions
 
 // A basic transform structure
 typedef struct {
@@ -13,4 +14,57 @@ typedef struct {
 	glm::mat4	_mat;	// 4x4 model matrix
 } Transformv3;
 
+// A namespace block for transform helpers
+namespace Transform
+{
+	// Return the rotation of X, then Y, then Z euler angles in degrees (the same as rotX * rotY * rotZ)
+	inline static glm::quat EulerToQuat(const glm::vec3 &degrees)
+	{
+		return glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f)) *	// Rotation X
+			glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f)) *	// Rotation Y
+			glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f));	// Rotation Z
+	}
+
+	// Return the model matrix of a position, rotation and scale in the engine's order, scale * rotate * translate
+	// The position is applied first, so it is turned by the rotation and stretched by the scale; maps are authored against this
+	inline static glm::mat4 Compose(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+	{
+		glm::mat3 r = glm::mat3_cast(rotation);	// Rotation matrix
+		glm::mat3 l(r[0] * scale, r[1] * scale, r[2] * scale);	// S * R, each row of R scaled
+		return glm::mat4(glm::vec4(l[0], 0.0f), glm::vec4(l[1], 0.0f), glm::vec4(l[2], 0.0f), glm::vec4(l * position, 1.0f));	// Return S * R * T
+	}
+
+	// Split a matrix built by Compose back into position, rotation and scale
+	// Returns false if the scale is degenerate and there is no rotation to find
+	inline static bool Decompose(const glm::mat4 &m, glm::vec3 &position, glm::quat &rotation, glm::vec3 &scale)
+	{
+		glm::mat3 l(m);		// S * R
+		glm::mat3 lt = glm::transpose(l);	// Rows of S * R
+		scale = glm::vec3(glm::length(lt[0]), glm::length(lt[1]), glm::length(lt[2]));	// Each row of R has unit length
+
+		if (glm::min(scale.x, glm::min(scale.y, scale.z)) < 1e-6f)	// If the scale is degenerate
+			return false;	// Return false
+
+		glm::mat3 r(l[0] / scale, l[1] / scale, l[2] / scale);	// Rotation matrix
+		rotation = glm::quat_cast(r);	// Assign rotation
+		position = glm::transpose(r) * (glm::vec3(m[3]) / scale);	// Undo the scale, then the rotation
+		return true;	// Return true
+	}
+
+	// Return a model matrix between a and b, lerping position and scale and slerping rotation (matrices built by Compose)
+	inline static glm::mat4 Blend(const glm::mat4 &a, const glm::mat4 &b, float t)
+	{
+		if (t >= 1.0f || a == b)	// If there is nothing to blend
+			return b;	// Return the newest
+
+		glm::vec3 pa, pb, sa, sb;	// Position and scale of a and b
+		glm::quat ra, rb;	// Rotation of a and b
+
+		if (!Decompose(a, pa, ra, sa) || !Decompose(b, pb, rb, sb))	// If either is degenerate
+			return (t < 0.5f) ? a : b;	// Return the nearest
+
+		return Compose(glm::mix(pa, pb, t), glm::slerp(ra, rb, t), glm::mix(sa, sb, t));	// Return blend
+	}
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#ifndef __TRANSFORM_STORE_H__
+#define __TRANSFORM_STORE_H__
+
+#define TRANSFORM_NULL	-1	// Null transform handle
+
+#include <vector>	// Get dynamic arrays
+#include <algorithm>	// Get sort
+#include <iostream>		// Get error output
+#include <cstdint>	// Get fixed width integers
+#include "Transform.h"	// Get transform functions
+#include "JobSystem.h"	// Get thread indices
+
+// A data oriented store of local transforms and their world matrices
+// Slots are kept in depth first order, so every parent comes before its children and each sub tree is one contiguous run
+// Only the sub trees of transforms changed since the last update are recomputed, parents first
+class TransformStore
+{
+private:
+	// ------------------------- PER SLOT DATA (depth first order) -------------------------
+	std::vector<glm::vec3>		_pos;		// Local position
+	std::vector<glm::quat>		_rot;		// Local rotation
+	std::vector<glm::vec3>		_sca;		// Local scale
+	std::vector<glm::mat4>		_local;		// Local matrix (S * R * T, see Transform::Compose)
+	std::vector<glm::mat4>		_world;		// World matrix
+	std::vector<int>			_parent;	// Parent slot (TRANSFORM_NULL for roots)
+	std::vector<unsigned int>	_size;		// Number of slots in the sub tree, including itself
+	std::vector<uint8_t>		_dirty;		// Has the local transform changed since the last update?
+	std::vector<int>			_handle;	// Handle of each slot
+	std::vector<void*>			_data;		// User data of each slot
+
+	// ------------------------- PER HANDLE DATA -------------------------
+	std::vector<int>			_slot;		// Slot of each handle (TRANSFORM_NULL when free)
+	std::vector<int>			_free;		// Free handles
+
+	std::vector<int>			_pending;	// Handles changed since the last update
+	std::vector<int>			_changed;	// Handles whose world matrix changed in the last update
+	std::vector<std::vector<int>>	_deferred;	// Handles changed by each thread during a parallel update (empty outside one)
+
+public:
+	inline unsigned int Size() const { return (unsigned int)_pos.size(); }	// Return the number of transforms
+	inline bool IsValid(int handle) const { return handle >= 0 && handle < (int)_slot.size() && _slot[handle] != TRANSFORM_NULL; }	// Return true if the handle is in use
+
+	inline const glm::vec3 &GetPosition(int handle) const { return _pos[_slot[handle]]; }	// Return local position
+	inline const glm::quat &GetRotation(int handle) const { return _rot[_slot[handle]]; }	// Return local rotation
+	inline const glm::vec3 &GetScale(int handle) const { return _sca[_slot[handle]]; }	// Return local scale
+	inline const glm::mat4 &GetLocal(int handle) const { return _local[_slot[handle]]; }	// Return local matrix (as of the last update)
+	inline const glm::mat4 &GetWorld(int handle) const { return _world[_slot[handle]]; }	// Return world matrix (as of the last update)
+	inline void* GetData(int handle) const { return _data[_slot[handle]]; }		// Return user data
+	inline const std::vector<int> &GetChanged() const { return _changed; }	// Return the handles whose world matrix changed in the last update
+
+	// Return the parent handle (TRANSFORM_NULL for roots)
+	inline int GetParent(int handle) const
+	{
+		int p = _parent[_slot[handle]];		// Parent slot
+		return (p == TRANSFORM_NULL) ? TRANSFORM_NULL : _handle[p];		// Return handle
+	}
+
+	// Create a transform at the origin and return its handle
+	inline int Create(void* data, int parent = TRANSFORM_NULL)
+	{
+		int handle;		// New handle
+		if (!_free.empty())		// If a handle can be reused
+		{
+			handle = _free.back();	// Reuse handle
+			_free.pop_back();
+		}
+		else
+		{
+			handle = (int)_slot.size();		// New handle
+			_slot.push_back(TRANSFORM_NULL);
+		}
+
+		int slot = (int)_pos.size();	// New roots go at the end, which keeps the depth first order
+		_slot[handle] = slot;	// Map handle
+
+		_pos.push_back(glm::vec3(0.0f));
+		_rot.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		_sca.push_back(glm::vec3(1.0f));
+		_local.push_back(glm::mat4(1.0f));
+		_world.push_back(glm::mat4(1.0f));
+		_parent.push_back(TRANSFORM_NULL);
+		_size.push_back(1);
+		_dirty.push_back(0);
+		_handle.push_back(handle);
+		_data.push_back(data);
+
+		MarkDirty(slot);	// Compute on the next update
+
+		if (parent != TRANSFORM_NULL)	// If the transform has a parent
+			SetParent(handle, parent);	// Attach it
+
+		return handle;	// Return handle
+	}
+
+	// Remove a transform, its children move up to its parent
+	inline void Destroy(int handle)
+	{
+		if (!IsValid(handle))	// If the handle isn't in use
+			return;		// Return from function
+
+		int slot = _slot[handle];	// Get slot
+		std::vector<int> children;	// Direct children
+		for (int s = slot + 1; s < slot + (int)_size[slot]; s += _size[s])		// Walk direct children
+			children.push_back(_handle[s]);
+
+		int parent = GetParent(handle);		// New parent of the children
+		for (int c : children)
+			SetParent(c, parent);	// Move child up
+
+		slot = _slot[handle];	// The node is a leaf now, find it again
+		for (int p = _parent[slot]; p != TRANSFORM_NULL; p = _parent[p])	// Shrink every ancestor
+			_size[p]--;
+
+		EraseSlots(slot, 1);	// Remove slot
+		_slot[handle] = TRANSFORM_NULL;		// Free handle
+		_free.push_back(handle);
+	}
+
+	// Attach a transform to a new parent (TRANSFORM_NULL to make it a root), keeping its local transform
+	// Returns false if the parent is the transform itself or one of its children
+	inline bool SetParent(int handle, int parent)
+	{
+		int slot = _slot[handle];	// Get slot
+		unsigned int n = _size[slot];	// Sub tree size
+
+		if (parent != TRANSFORM_NULL && _slot[parent] >= slot && _slot[parent] < slot + (int)n)	// If the parent is inside the sub tree
+		{
+			std::cerr << "Transform Error: A transform can't be parented to itself or its children!\n";	// Print out error message
+			return false;	// Return false
+		}
+
+		// ------------------------- TAKE THE SUB TREE OUT -------------------------
+		for (int p = _parent[slot]; p != TRANSFORM_NULL; p = _parent[p])	// Shrink every old ancestor
+			_size[p] -= n;
+
+		std::vector<unsigned int> order(_pos.size());	// New slot order
+		unsigned int k = 0;
+		for (unsigned int s = 0; s < _pos.size(); s++)	// Everything outside the sub tree keeps its order
+			if ((int)s < slot || (int)s >= slot + (int)n)
+				order[k++] = s;
+
+		// ------------------------- PUT IT BACK AFTER THE NEW PARENT'S SUB TREE -------------------------
+		unsigned int at = k;	// Roots go at the end
+		if (parent != TRANSFORM_NULL)	// If there is a new parent
+		{
+			int ps = _slot[parent];		// Parent slot (old order)
+			at = (unsigned int)(std::find(order.begin(), order.begin() + k, (unsigned int)ps) - order.begin()) + _size[ps];	// After the parent's sub tree (sizes already exclude the moved run)
+		}
+
+		std::copy_backward(order.begin() + at, order.begin() + k, order.begin() + k + n);	// Make room
+		for (unsigned int i = 0; i < n; i++)
+			order[at + i] = slot + i;	// Insert sub tree
+
+		if (parent != TRANSFORM_NULL)	// If there is a new parent
+			for (int p = _slot[parent]; p != TRANSFORM_NULL; p = _parent[p])	// Grow every new ancestor (old slots are still valid here)
+				_size[p] += n;
+
+		_parent[slot] = (parent == TRANSFORM_NULL) ? TRANSFORM_NULL : _slot[parent];	// Link sub tree root (old slot, remapped below)
+		Reorder(order);		// Apply new order
+
+		MarkDirty(_slot[handle]);	// Recompute the moved sub tree
+		return true;	// Return true
+	}
+
+	// Assign the local transform
+	inline void SetLocal(int handle, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+	{
+		int slot = _slot[handle];	// Get slot
+		_pos[slot] = position;	// Assign position
+		_rot[slot] = rotation;	// Assign rotation
+		_sca[slot] = scale;		// Assign scale
+		MarkDirty(slot);	// Recompute on the next update
+	}
+
+	inline void SetPosition(int handle, const glm::vec3 &value) { _pos[_slot[handle]] = value; MarkDirty(_slot[handle]); }	// Assign local position
+	inline void SetRotation(int handle, const glm::quat &value) { _rot[_slot[handle]] = value; MarkDirty(_slot[handle]); }	// Assign local rotation
+	inline void SetScale(int handle, const glm::vec3 &value) { _sca[_slot[handle]] = value; MarkDirty(_slot[handle]); }	// Assign local scale
+
+	// Start a parallel update: until EndDeferred, each thread queues changes on its own list
+	// Only the local transform setters may be called meanwhile, each slot from one thread, nothing that adds, removes or reparents
+	inline void BeginDeferred(unsigned int threads)
+	{
+		_deferred.assign(threads, std::vector<int>());	// One list per thread
+	}
+
+	// End a parallel update, merging every thread's changes into the pending list
+	inline void EndDeferred()
+	{
+		for (const std::vector<int> &d : _deferred)		// Iterate through each thread's list
+			_pending.insert(_pending.end(), d.begin(), d.end());	// Merge (Update sorts them parents first)
+
+		_deferred.clear();	// Back to queueing directly
+	}
+
+	// Recompute the world matrix of every changed transform and everything below it
+	inline void Update()
+	{
+		_changed.clear();	// Reset changed list
+
+		if (_pending.empty())	// If nothing changed
+			return;		// Return from function
+
+		std::vector<int> slots;		// Changed slots
+		slots.reserve(_pending.size());
+		for (int h : _pending)
+			if (IsValid(h))		// Skip transforms destroyed since they were queued
+				slots.push_back(_slot[h]);
+		std::sort(slots.begin(), slots.end());	// Parents first
+		_pending.clear();	// Reset pending list
+
+		int end = 0;	// End of the last recomputed run
+		for (int s : slots)		// Iterate through each changed slot
+		{
+			if (s < end)	// If an ancestor's run already covered it
+				continue;	// Skip slot
+
+			end = s + (int)_size[s];	// Sub tree run
+			for (int i = s; i < end; i++)	// Parents come before children, so one pass is enough
+			{
+				if (_dirty[i])	// If the local transform changed
+				{
+					_local[i] = Transform::Compose(_pos[i], _rot[i], _sca[i]);	// Rebuild local matrix
+					_dirty[i] = 0;	// Reset dirty
+				}
+
+				_world[i] = (_parent[i] == TRANSFORM_NULL) ? _local[i] : _world[_parent[i]] * _local[i];	// Concatenate with the parent
+				_changed.push_back(_handle[i]);		// Record change
+			}
+		}
+	}
+
+private:
+	// Flag a slot for the next update
+	inline void MarkDirty(int slot)
+	{
+		if (!_dirty[slot])	// If it isn't already pending
+		{
+			_dirty[slot] = 1;	// Flag slot (each slot is only set from one thread)
+			if (_deferred.empty())	// If not in a parallel update
+				_pending.push_back(_handle[slot]);	// Queue handle
+			else
+				_deferred[JobSystem::GetThreadIndex()].push_back(_handle[slot]);	// Queue handle on this thread's list
+		}
+	}
+
+	// Permute every slot array so that new slot i holds old slot order[i], and remap slot links
+	inline void Reorder(const std::vector<unsigned int> &order)
+	{
+		std::vector<int> remap(_pos.size(), TRANSFORM_NULL);	// New slot of each old slot (TRANSFORM_NULL if dropped)
+		for (unsigned int i = 0; i < order.size(); i++)
+			remap[order[i]] = (int)i;
+
+		Permute(_pos, order); Permute(_rot, order); Permute(_sca, order);
+		Permute(_local, order); Permute(_world, order);
+		Permute(_parent, order); Permute(_size, order); Permute(_dirty, order);
+		Permute(_handle, order); Permute(_data, order);
+
+		for (unsigned int i = 0; i < _parent.size(); i++)	// Remap parent links
+			if (_parent[i] != TRANSFORM_NULL)
+				_parent[i] = remap[_parent[i]];
+
+		for (unsigned int i = 0; i < _handle.size(); i++)	// Remap handles
+			_slot[_handle[i]] = (int)i;
+	}
+
+	// Remove count slots starting at first, and remap slot links
+	inline void EraseSlots(int first, int count)
+	{
+		std::vector<unsigned int> order;	// Remaining slots
+		for (unsigned int s = 0; s < _pos.size(); s++)
+			if ((int)s < first || (int)s >= first + count)
+				order.push_back(s);
+
+		for (unsigned int i = 0; i < _parent.size(); i++)	// Point links into the removed run at nothing (callers have moved children out already)
+			if (_parent[i] >= first && _parent[i] < first + count)
+				_parent[i] = TRANSFORM_NULL;
+
+		Reorder(order);		// Drop removed slots
+	}
+
+	// Gather a slot array into a new order
+	template <typename T>
+	inline static void Permute(std::vector<T> &a, const std::vector<unsigned int> &order)
+	{
+		std::vector<T> tmp(order.size());	// Temp array
+		for (unsigned int i = 0; i < order.size(); i++)
+			tmp[i] = a[order[i]];	// Gather
+		a.swap(tmp);	// Swap in reordered array
+	}
+};
+
+#endif
@@ -23,7 +23,9 @@ public:
 	{
 		_vbo_data = vbo_data;	// Assign vertex buffer object data
 		_ebo_data = ebo_data;	// Assign element object data
-		_num_attribs = vbo_data.size();	// Initialise num attribs
+		_num_attribs = 0;	// Initialise num attribs
+		for (Vbo* v : vbo_data)		// Iterate through each vbo
+			_num_attribs += v->GetNumAttribs();		// Count its attributes
 
 		Create(vbo_data);	// Create the vao
 	}
@@ -68,7 +70,7 @@ public:
 		glBindVertexArray(_vao);	// Bind our vertex array
 
 		unsigned int i;		// Teno index variable
-		for (i = 0; i < _num_attribs; i++)
+		for (i = 0; i < _vbo_data.size(); i++)
 			_vbo_data[i]->Create();		// Generate the vbo data
 
 		if (_ebo_data)	// If we're using an ebo...
@@ -5,6 +5,13 @@
 #include <glew.h>	// Get our glew variables
 #include <glm/glm.hpp>	// Get glm variables
 
+// One attribute read out of an interleaved vertex buffer
+struct VertexAttrib
+{
+	uint16_t	location;	// Shader location
+	GLint		components;		// Number of floats
+	size_t		offset;		// Byte offset inside each vertex
+};
 
 // This class will contain element buffer object data as an abstract class
 class Vbo
@@ -14,10 +21,14 @@ private:
 	size_t					_float_ptr_offset;	// The float pointer offset
 	uint16_t				_location_offset;	// The vertex location offset
 	std::vector<float*>		_buffer_data;	// Our buffer data
+	const void*				_raw_data;	// Interleaved vertex bytes (only read by Create, NULL when using buffer data)
+	size_t					_raw_bytes;		// Number of interleaved bytes
+	GLsizei					_stride;	// Bytes per interleaved vertex
+	std::vector<VertexAttrib>	_attribs;	// Attributes inside each interleaved vertex
 
 public:
 	// Default constructor
-	inline Vbo() {}
+	inline Vbo() : _raw_data(NULL), _raw_bytes(0), _stride(0) {}
 
 	// Initial constructor
 	inline Vbo(std::vector<float*> buffer_data, size_t float_ptr_offset, uint16_t location_offset)
@@ -25,6 +36,20 @@ public:
 		_buffer_data = buffer_data;		// Assign buffer data
 		_float_ptr_offset = float_ptr_offset;	// Assign float pointer offset
 		_location_offset = location_offset;		// Assign location offset
+		_raw_data = NULL;	// Not interleaved
+		_raw_bytes = 0;
+		_stride = 0;
+	}
+
+	// Interleaved constructor, data only has to stay valid until Create (so it can point straight into a mapped file)
+	inline Vbo(const void* data, size_t bytes, GLsizei stride, std::vector<VertexAttrib> attribs)
+	{
+		_float_ptr_offset = 0;	// Unused
+		_location_offset = 0;
+		_raw_data = data;	// Assign interleaved data
+		_raw_bytes = bytes;
+		_stride = stride;
+		_attribs = attribs;		// Assign attributes
 	}
 
  	// Deconstructor
@@ -47,9 +72,31 @@ public:
 		return _buffer_data;	// Return the buffer data
 	}
 
+	// Get the number of vertex attributes this buffer feeds
+	inline size_t GetNumAttribs()
+	{
+		return _raw_data ? _attribs.size() : 1;		// Return attribute count
+	}
+
 	// This function will bind our vao and vbo objects
  	inline void Create()
  	{
+		if (_raw_data)	// If the buffer is interleaved
+		{
+			glGenBuffers(1, &_vbo);		// Generate our buffer object
+			glBindBuffer(GL_ARRAY_BUFFER, _vbo);	// Bind our buffer object
+			glBufferData(GL_ARRAY_BUFFER, _raw_bytes, _raw_data, GL_STATIC_DRAW);	// Upload every vertex at once
+
+			for (VertexAttrib &a : _attribs)	// Iterate through each attribute
+			{
+				glEnableVertexAttribArray(a.location);	// Enable vertex location attrib
+				glVertexAttribPointer(a.location, a.components, GL_FLOAT, GL_FALSE, _stride, (void*)a.offset);	// Set the vertex pointer data
+			}
+
+			_raw_data = NULL;	// The data may not outlive the upload
+			return;		// Return from function
+		}
+
 		size_t size = sizeof(_buffer_data[0]) * _float_ptr_offset;	// Calculate bytes
 		
 		glGenBuffers(1, &_vbo);		// Generate our buffer object
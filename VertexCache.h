@@ -0,0 +1,322 @@
+#ifndef __VERTEX_CACHE_H__
+#define __VERTEX_CACHE_H__
+
+#define VERTEX_CACHE_SIZE			32		// LRU entries modelled when ordering triangles
+#define VERTEX_CACHE_FIFO			16		// FIFO entries modelled when measuring (the usual hardware reference)
+#define VERTEX_OVERDRAW_THRESHOLD	1.05f	// How much worse a cluster's ACMR may get so it can be drawn in a better order
+
+#include <vector>	// Get dynamic arrays
+#include <cmath>	// Get pow
+#include <algorithm>	// Get sort
+#include <glm/glm.hpp>	// Get 3D variables
+#include "VertexData.h"		// Get vertex data
+#include "Chunk.h"	// Get index ranges
+
+// Post transform vertex cache statistics of an index buffer
+struct VertexCacheStats
+{
+	float acmr;		// Average cache miss ratio (vertices shaded per triangle, 0.5 is ideal for large grids, 3 is the worst)
+	float atvr;		// Average transformed vertex ratio (vertices shaded per vertex used, 1 is ideal)
+
+	// Default constructor
+	inline VertexCacheStats() : acmr(0.0f), atvr(0.0f) {}
+};
+
+// Reorders triangles and vertices at import so each vertex is shaded as few times as possible
+// Every pass that rasterises a mesh (geometry, shadows, picking, volumetrics) pays the vertex cost again, so it adds up
+namespace VertexCache
+{
+	// Simulate a FIFO vertex cache over some index ranges (in bytes, as chunks store them) and return its statistics
+	static inline VertexCacheStats Analyse(const std::vector<unsigned int> &indices, const std::vector<Chunk> &chunks, size_t vertex_count)
+	{
+		std::vector<unsigned int> stamp(vertex_count, 0);	// Miss count when each vertex was last loaded
+		std::vector<unsigned char> used(vertex_count, 0);	// Was the vertex referenced?
+		unsigned int misses = 0;	// Vertices shaded
+		size_t triangles = 0, unique = 0;	// Counts
+
+		for (const Chunk &c : chunks)	// Iterate through each chunk
+		{
+			size_t first = c._index_offset / sizeof(unsigned int);	// First index
+			for (size_t i = first; i < first + c._index_count; i++)		// Iterate through each index
+			{
+				unsigned int v = indices[i];	// Vertex
+				if (!used[v]) { used[v] = 1; unique++; }	// Count vertices used
+
+				if (stamp[v] == 0 || misses - stamp[v] >= VERTEX_CACHE_FIFO)	// If the vertex isn't in the cache
+				{
+					misses++;	// Shade it
+					stamp[v] = misses;	// Entered the cache now
+				}
+			}
+
+			triangles += c._index_count / 3;	// Count triangles
+		}
+
+		VertexCacheStats s;		// Result
+		s.acmr = triangles ? (float)misses / triangles : 0.0f;
+		s.atvr = unique ? (float)misses / unique : 0.0f;
+		return s;	// Return statistics
+	}
+
+	// Score of a vertex from its LRU cache position (-1 when not cached) and how many unemitted triangles still use it (Forsyth)
+	static inline float VertexScore(int cache_pos, unsigned int live)
+	{
+		static float cache_score[VERTEX_CACHE_SIZE];	// Score per cache position
+		static float valence_score[64];		// Score per remaining triangle count
+		static bool tables = false;		// Have the tables been built?
+
+		if (!tables)	// If this is the first call
+		{
+			for (int i = 0; i < VERTEX_CACHE_SIZE; i++)		// The last triangle's vertices get a fixed score so they aren't reused straight away
+				cache_score[i] = (i < 3) ? 0.75f : powf(1.0f - (float)(i - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+			for (int i = 0; i < 64; i++)	// Vertices with few triangles left are finished off first
+				valence_score[i] = (i == 0) ? 0.0f : 2.0f * powf((float)i, -0.5f);
+			tables = true;
+		}
+
+		if (live == 0)	// If the vertex is done
+			return -1.0f;	// Return no score
+
+		return ((cache_pos >= 0) ? cache_score[cache_pos] : 0.0f) + valence_score[std::min(live, 63u)];		// Return score
+	}
+
+	// Reorder the triangles of one index range for a small LRU cache (Tom Forsyth's linear speed optimiser)
+	static inline void OptimiseCache(unsigned int* indices, size_t count, size_t vertex_count)
+	{
+		size_t tris = count / 3;	// Triangle count
+		if (tris < 2)	// If there's nothing to order
+			return;		// Return from function
+
+		std::vector<unsigned int> live(vertex_count, 0);	// Unemitted triangles per vertex
+		for (size_t i = 0; i < tris * 3; i++)	// Count uses
+			live[indices[i]]++;
+
+		std::vector<unsigned int> adj_begin(vertex_count + 1, 0);	// Each vertex's triangle list
+		for (size_t v = 0; v < vertex_count; v++)	// Prefix sum of uses
+			adj_begin[v + 1] = adj_begin[v] + live[v];
+
+		std::vector<unsigned int> adj(tris * 3);	// Triangles of each vertex, the live ones first
+		std::vector<unsigned int> fill(adj_begin.begin(), adj_begin.end() - 1);		// Write cursor per vertex
+		for (size_t t = 0; t < tris; t++)	// Fill lists
+			for (int k = 0; k < 3; k++)
+				adj[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+
+		std::vector<int> cache_pos(vertex_count, -1);	// LRU position of each vertex
+		std::vector<float> score(vertex_count);		// Score of each vertex
+		for (size_t v = 0; v < vertex_count; v++)	// Score vertices
+			score[v] = VertexScore(-1, live[v]);
+
+		std::vector<float> tri_score(tris);		// Score of each triangle
+		std::vector<unsigned char> emitted(tris, 0);	// Has the triangle been output?
+		int best = 0;	// Next triangle
+		for (size_t t = 0; t < tris; t++)	// Score triangles
+		{
+			tri_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+			if (tri_score[t] > tri_score[best]) best = (int)t;	// Start from the best
+		}
+
+		std::vector<unsigned int> out(tris * 3);	// Reordered indices
+		unsigned int cache[VERTEX_CACHE_SIZE + 3], cache_size = 0;	// LRU cache (with room for the triangle being added)
+		size_t cursor = 0;	// Scan position for when the cache has no candidates
+
+		for (size_t e = 0; e < tris; e++)	// Emit each triangle
+		{
+			if (best < 0)	// If no cached vertex has triangles left
+			{
+				while (emitted[cursor]) cursor++;	// Take the next unemitted triangle in input order
+				best = (int)cursor;
+			}
+
+			const unsigned int* tri = indices + best * 3;	// Triangle
+			out[e * 3] = tri[0];	// Emit it
+			out[e * 3 + 1] = tri[1];
+			out[e * 3 + 2] = tri[2];
+			emitted[best] = 1;
+
+			unsigned int next[VERTEX_CACHE_SIZE + 3], next_size = 0;	// New cache order, this triangle first
+			for (int k = 0; k < 3; k++)		// Iterate through each corner
+			{
+				unsigned int v = tri[k];	// Vertex
+				if (k == 0 || (v != tri[0] && (k == 1 || v != tri[1])))	// Degenerate triangles repeat a vertex
+					next[next_size++] = v;
+
+				unsigned int* list = &adj[adj_begin[v]];	// Remove the triangle from the vertex's live list
+				for (unsigned int j = 0; j < live[v]; j++)
+					if (list[j] == (unsigned int)best) { std::swap(list[j], list[live[v] - 1]); break; }
+				live[v]--;
+			}
+
+			for (unsigned int i = 0; i < cache_size; i++)	// Keep the rest of the old cache in order
+				if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+					next[next_size++] = cache[i];
+
+			best = -1;	// Pick the next triangle from those touching the cache
+			float best_score = -1.0f;
+			for (unsigned int i = 0; i < next_size; i++)	// Iterate through each cache entry (including ones pushed out)
+			{
+				unsigned int v = next[i];	// Vertex
+				cache_pos[v] = (i < VERTEX_CACHE_SIZE) ? (int)i : -1;	// New position
+				score[v] = VertexScore(cache_pos[v], live[v]);	// New score
+			}
+
+			for (unsigned int i = 0; i < next_size; i++)	// Rescore the triangles of every moved vertex
+			{
+				unsigned int v = next[i];	// Vertex
+				for (unsigned int j = 0; j < live[v]; j++)	// Iterate through its live triangles
+				{
+					unsigned int t = adj[adj_begin[v] + j];		// Triangle
+					tri_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+					if (i < VERTEX_CACHE_SIZE && tri_score[t] > best_score) { best_score = tri_score[t]; best = (int)t; }	// Track the best cached candidate
+				}
+			}
+
+			cache_size = std::min(next_size, (unsigned int)VERTEX_CACHE_SIZE);		// Drop what fell out
+			std::copy(next, next + cache_size, cache);
+		}
+
+		std::copy(out.begin(), out.end(), indices);		// Write the new order back
+	}
+
+	// Reorder clusters of an already cache optimised index range so outward facing ones draw first (Sander et al.)
+	// Clusters start where the cache order restarts, and are split further while that keeps the ACMR within the threshold
+	static inline void OptimiseOverdraw(unsigned int* indices, size_t count, const std::vector<glm::vec3> &positions)
+	{
+		size_t tris = count / 3;	// Triangle count
+		if (tris < 2)	// If there's nothing to order
+			return;		// Return from function
+
+		std::vector<unsigned int> stamp(positions.size(), 0);	// FIFO simulation, as in Analyse
+		unsigned int misses = 0;	// Vertices shaded
+		auto shade = [&](unsigned int v)	// Returns 1 if the vertex missed
+		{
+			if (stamp[v] == 0 || misses - stamp[v] >= VERTEX_CACHE_FIFO) { stamp[v] = ++misses; return 1u; }
+			return 0u;
+		};
+		auto flush = [&]() { misses += VERTEX_CACHE_FIFO; };	// Empty the cache
+
+		std::vector<size_t> hard(1, 0);		// Triangles where every vertex misses, the optimiser started a new area there
+		for (size_t t = 0; t < tris; t++)	// Iterate through each triangle
+			if (shade(indices[t * 3]) + shade(indices[t * 3 + 1]) + shade(indices[t * 3 + 2]) == 3 && t > 0)
+				hard.push_back(t);
+		hard.push_back(tris);	// End marker
+
+		std::vector<size_t> cuts;	// Cluster starts
+		for (size_t h = 0; h + 1 < hard.size(); h++)	// Iterate through each hard cluster
+		{
+			size_t begin = hard[h], end = hard[h + 1];	// Triangle range
+			cuts.push_back(begin);
+
+			flush();	// Measure the hard cluster on its own
+			unsigned int m = 0;		// Misses
+			for (size_t t = begin; t < end; t++)
+				m += shade(indices[t * 3]) + shade(indices[t * 3 + 1]) + shade(indices[t * 3 + 2]);
+			float limit = (float)m / (end - begin) * VERTEX_OVERDRAW_THRESHOLD;		// Worst ACMR allowed for a piece
+
+			flush();	// Cut into pieces that each stay under the limit when drawn from a cold cache
+			size_t piece = begin;	// Piece start
+			unsigned int piece_misses = 0;
+			for (size_t t = begin; t < end; t++)
+			{
+				piece_misses += shade(indices[t * 3]) + shade(indices[t * 3 + 1]) + shade(indices[t * 3 + 2]);
+				size_t n = t + 1 - piece;	// Triangles in the piece
+				if (t + 1 < end && n >= 8 && (float)piece_misses / n <= limit)	// If the piece can stand alone
+				{
+					cuts.push_back(t + 1);	// Start another
+					piece = t + 1;
+					piece_misses = 0;
+					flush();
+				}
+			}
+		}
+		cuts.push_back(tris);	// End marker
+
+		glm::vec3 centre(0.0f);		// Area weighted mesh centroid
+		float area = 0.0f;
+		std::vector<glm::vec3> c_centre(cuts.size() - 1, glm::vec3(0.0f)), c_normal(cuts.size() - 1, glm::vec3(0.0f));	// Cluster centroids and normals
+		for (size_t c = 0; c + 1 < cuts.size(); c++)	// Iterate through each cluster
+		{
+			float c_area = 0.0f;	// Cluster area
+			for (size_t t = cuts[c]; t < cuts[c + 1]; t++)	// Iterate through each triangle
+			{
+				const glm::vec3 &a = positions[indices[t * 3]], &b = positions[indices[t * 3 + 1]], &d = positions[indices[t * 3 + 2]];
+				glm::vec3 n = glm::cross(b - a, d - a);		// Twice the area along the normal
+				float w = glm::length(n);
+				c_normal[c] += n;
+				c_centre[c] += (a + b + d) * (w / 3.0f);
+				c_area += w;
+			}
+
+			centre += c_centre[c];
+			area += c_area;
+			c_centre[c] = (c_area > 0.0f) ? c_centre[c] / c_area : positions[indices[cuts[c] * 3]];
+		}
+		if (area > 0.0f) centre /= area;
+
+		std::vector<float> key(cuts.size() - 1);	// How far each cluster faces out of the mesh
+		std::vector<size_t> order(cuts.size() - 1);		// Cluster draw order
+		for (size_t c = 0; c < order.size(); c++)	// Iterate through each cluster
+		{
+			float len = glm::length(c_normal[c]);	// Normal length
+			key[c] = (len > 0.0f) ? glm::dot(c_centre[c] - centre, c_normal[c] / len) : 0.0f;
+			order[c] = c;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key[a] > key[b]; });	// Outward facing clusters occlude the rest, so draw them first
+
+		std::vector<unsigned int> out;	// Reordered indices
+		out.reserve(tris * 3);
+		for (size_t c : order)	// Iterate through each cluster in draw order
+			out.insert(out.end(), indices + cuts[c] * 3, indices + cuts[c + 1] * 3);
+		std::copy(out.begin(), out.end(), indices);		// Write the new order back
+	}
+
+	// Renumber vertices in the order the index buffer first uses them, so vertex fetches walk memory forwards
+	static inline void OptimiseFetch(VertexData &vd)
+	{
+		size_t n = vd.positions.size();		// Vertex count
+		std::vector<unsigned int> remap(n, 0xFFFFFFFF);		// New index of each vertex
+		unsigned int next = 0;	// Next new index
+
+		for (unsigned int &i : vd.indices)	// Iterate through each index
+		{
+			if (remap[i] == 0xFFFFFFFF) remap[i] = next++;	// First use
+			i = remap[i];	// Renumber
+		}
+
+		for (size_t v = 0; v < n; v++)	// Unused vertices go last
+			if (remap[v] == 0xFFFFFFFF) remap[v] = next++;
+
+		auto permute = [&](std::vector<glm::vec3> &a)	// Move an attribute into the new order
+		{
+			if (a.size() != n)	// If it isn't per vertex
+				return;		// Leave it
+			std::vector<glm::vec3> b(n);
+			for (size_t v = 0; v < n; v++) b[remap[v]] = a[v];
+			a.swap(b);
+		};
+
+		permute(vd.positions);	// Reorder attributes
+		permute(vd.texcoords);
+		permute(vd.normals);
+		permute(vd.tangents);
+	}
+
+	// Run every pass over a mesh: triangles per chunk for the cache and then overdraw, then the vertices for fetching
+	// Outputs the cache statistics from before and after
+	static inline void Optimise(VertexData &vd, const std::vector<Chunk> &chunks, VertexCacheStats &out_before, VertexCacheStats &out_after)
+	{
+		out_before = Analyse(vd.indices, chunks, vd.positions.size());	// Measure input order
+
+		for (const Chunk &c : chunks)	// Iterate through each chunk
+		{
+			unsigned int* first = vd.indices.data() + c._index_offset / sizeof(unsigned int);	// First index
+			OptimiseCache(first, c._index_count, vd.positions.size());	// Order for the cache
+			OptimiseOverdraw(first, c._index_count, vd.positions);	// Order clusters for overdraw
+		}
+
+		OptimiseFetch(vd);	// Order vertices
+
+		out_after = Analyse(vd.indices, chunks, vd.positions.size());	// Measure output order
+	}
+};
+
+#endif
@@ -1,9 +1,16 @@
 #ifndef __VERTEX_DATA_H__
 #define __VERTEX_DATA_H__
 
+#define VERTEX_HASH_EMPTY	0xFFFFFFFF	// Unused hash table slot
+#define VERTEX_PARALLEL_MIN	(1 << 16)	// Fewest vertices worth deduplicating across threads
+#define VERTEX_SHARD_BITS	6	// Hash shards deduplicated in parallel (as a power of two)
+#define VERTEX_SHARING		4	// Expected corners per unique vertex, sizes hash tables up front (they grow if it's wrong)
+
 #include <vector>	// Get dynamic array
-#include <map>	// Get map variable
-#include <glm\glm.hpp>	// Get glm variables
+#include <cstdint>	// Get fixed width types
+#include <cstring>	// Get memcmp
+#include <glm/glm.hpp>	// Get glm variables
+#include "JobSystem.h"	// Get worker threads
 
 // This struct contains vertex data
 struct VertexData
@@ -21,48 +28,293 @@ struct PackedVertex
 	glm::vec3 position;		// This will store our packed position data
 	glm::vec3 uv;	// This will store our packed uv data
 	glm::vec3 normal;	// This will pack our normal data
-	bool operator<(const PackedVertex that) const { return memcmp((void*)this, (void*)&that, sizeof(PackedVertex)) > 0; };	// Create an operator for comparing different vertex data
 };
 
-// This function will compare each vertex with an existing vertex
-static inline bool GetSimilarVertexIndex(PackedVertex &packed, std::map<PackedVertex, unsigned int> &VertexToOutIndex, unsigned int &result)
+// A slot of the vertex hash table
+struct VertexHashSlot
+{
+	uint32_t hash;	// Low bits of the hash, pick the slot and are checked before comparing vertices
+	uint32_t index;		// Output index (VERTEX_HASH_EMPTY when unused)
+};
+
+// Join the bits of two floats into one word
+static inline uint64_t PackFloatBits(const float &a, const float &b)
+{
+	uint32_t x, y;	// Float bits
+	memcpy(&x, &a, sizeof(float));
+	memcpy(&y, &b, sizeof(float));
+	return x | ((uint64_t)y << 32);		// Return word
+}
+
+// Hash the bytes of a vertex, so vertices that compare equal bytewise always hash equal
+static inline uint64_t HashPackedVertex(const glm::vec3 &position, const glm::vec3 &uv, const glm::vec3 &normal)
 {
-	std::map<PackedVertex, unsigned int>::iterator it = VertexToOutIndex.find(packed);	// Iterate through each vertex to check for duplicates
-	if (it == VertexToOutIndex.end())	// If the iterator has finished with no duplicates found...
-		return false;	// Return false - no duplicate found
-	else	// Otherwise...
+	uint64_t w[5] = { PackFloatBits(position.x, position.y), PackFloatBits(position.z, uv.x), PackFloatBits(uv.y, uv.z), PackFloatBits(normal.x, normal.y), PackFloatBits(normal.z, 0.0f) };	// Vertex bits as words, loaded per float to avoid stalls on overlapping copies
+
+	uint64_t h = 0x9E3779B97F4A7C15ull;		// Seed
+	for (int i = 0; i < 5; i++)		// Iterate through each word
 	{
-		result = it->second;	// Set the result to the indexed vertex
-		return true;	// Return true
+		h = (h ^ w[i]) * 0xFF51AFD7ED558CCDull;		// Mix word in
+		h ^= h >> 32;
 	}
+
+	h *= 0xC4CEB9FE1A85EC53ull;		// Finalise so every input bit reaches the low bits
+	h ^= h >> 29;
+	return h;	// Return hash
 }
 
+// Compare two vertices bytewise
+static inline bool SamePackedVertex(const glm::vec3 &p_0, const glm::vec3 &t_0, const glm::vec3 &n_0, const glm::vec3 &p_1, const glm::vec3 &t_1, const glm::vec3 &n_1)
+{
+	return memcmp(&p_0, &p_1, sizeof(glm::vec3)) == 0 && memcmp(&t_0, &t_1, sizeof(glm::vec3)) == 0 && memcmp(&n_0, &n_1, sizeof(glm::vec3)) == 0;	// Return true if every byte matches
+}
+
+// An open addressing hash table from vertices to output indices, kept at most half full
+// Only hashes and indices are stored, the vertices themselves are compared through a callback
+class VertexHashTable
+{
+private:
+	std::vector<VertexHashSlot>	_slots;		// Slots (a power of two)
+	size_t						_mask;	// Slot count - 1
+	size_t						_count;		// Used slots
+
+	// Double the slot count and re-insert every entry
+	inline void Grow()
+	{
+		std::vector<VertexHashSlot> old;	// Current slots
+		old.swap(_slots);
+
+		VertexHashSlot empty = { 0, VERTEX_HASH_EMPTY };	// Unused slot
+		_slots.assign(old.size() * 2, empty);	// Clear slots
+		_mask = _slots.size() - 1;
+
+		for (VertexHashSlot &s : old)	// Iterate through each old slot
+			if (s.index != VERTEX_HASH_EMPTY)	// If it's used
+			{
+				size_t i = s.hash & _mask;	// First slot
+				while (_slots[i].index != VERTEX_HASH_EMPTY) i = (i + 1) & _mask;	// Probe linearly
+				_slots[i] = s;	// Move entry
+			}
+	}
+
+public:
+	// Default constructor
+	inline VertexHashTable() : _mask(0), _count(0) { Reserve(0); }
+
+	// Clear the table and size it for a number of unique vertices
+	inline void Reserve(size_t count)
+	{
+		size_t cap = 16;	// Capacity
+		while (cap < count * 2) cap <<= 1;	// Round up to a power of two
+
+		VertexHashSlot empty = { 0, VERTEX_HASH_EMPTY };	// Unused slot
+		_slots.assign(cap, empty);	// Clear slots
+		_mask = cap - 1;
+		_count = 0;
+	}
+
+	// Find the index of an equal vertex, or insert next if there isn't one, returns true if found
+	template <typename F>
+	inline bool FindOrInsert(uint64_t hash, uint32_t next, F equal, uint32_t &out_index)
+	{
+		uint32_t tag = (uint32_t)hash;	// Slot check
+		size_t i = tag & _mask;		// First slot
+
+		while (true)	// Probe linearly
+		{
+			VertexHashSlot &s = _slots[i];	// Slot
+			if (s.index == VERTEX_HASH_EMPTY)	// If the vertex is new
+			{
+				s.hash = tag;	// Insert it
+				s.index = next;
+				out_index = next;
+
+				if (++_count * 2 > _slots.size())	// If the table is over half full
+					Grow();		// Make room
+
+				return false;	// Return false
+			}
+
+			if (s.hash == tag && equal(s.index))	// If the vertex is already in the table
+			{
+				out_index = s.index;	// Output its index
+				return true;	// Return true
+			}
+
+			i = (i + 1) & _mask;	// Next slot
+		}
+	}
+};
+
 // This function will take obj data and output optimised vertex data for an element buffer object
 static inline void IndexVertexData(std::vector<glm::vec3> & in_vertices, std::vector<glm::vec3> & in_uvs, std::vector<glm::vec3> & in_normals, std::vector<unsigned int> & out_indices, std::vector<glm::vec3> & out_vertices, std::vector<glm::vec3> & out_uvs, std::vector<glm::vec3> & out_normals, std::vector<glm::vec3> & out_tangents)
 {
-	std::map<PackedVertex, unsigned int> VertexToOutIndex;	// This will record any duplicated vertex data for our indices
+	size_t n = in_vertices.size();	// Vertex count
+	size_t base = out_vertices.size();	// Vertices already in the output
+	size_t index_base = out_indices.size();		// Indices already in the output
+
+	VertexHashTable table;	// This will record any duplicated vertex data for our indices
+	table.Reserve(n / VERTEX_SHARING);	// Size for a typical mesh
 
-	for (unsigned int i = 0; i < in_vertices.size(); i++)	// Iterate through the number of vertex positions...
+	std::vector<uint32_t> first;	// Input index of each unique vertex
+	first.reserve(n / VERTEX_SHARING);
+	out_indices.resize(index_base + n);		// One index per vertex
+
+	for (unsigned int i = 0; i < n; i++)	// Iterate through the number of vertex positions...
 	{
-		PackedVertex packed = { in_vertices[i], in_uvs[i], in_normals[i] };		// Set a temp vertex struct to our input data
+		uint64_t hash = HashPackedVertex(in_vertices[i], in_uvs[i], in_normals[i]);		// Hash this vertex
 
 		unsigned int index;		// Use this index variable as the duplicated result
-		bool found = GetSimilarVertexIndex(packed, VertexToOutIndex, index);	// Try to find a similar vertex in out_XXXX
+		bool found = table.FindOrInsert(hash, (uint32_t)first.size(), [&](uint32_t o)	// Try to find a similar earlier vertex
+		{
+			uint32_t r = first[o];	// Earlier vertex
+			return SamePackedVertex(in_vertices[r], in_uvs[r], in_normals[r], in_vertices[i], in_uvs[i], in_normals[i]);
+		}, index);
 
-		if (found)	// If a similar vertex has been found...
-			out_indices.push_back(index);	// A similar vertex already exists - use the existing one instead!
-		else	// Otherwise...
+		if (!found)		// If this is a new vertex...
+			first.push_back(i);		// Record where it was first used
+
+		out_indices[index_base + i] = (unsigned int)(base + index);		// Assign the index
+	}
+
+	out_vertices.resize(base + first.size());	// Room for the unique vertices
+	out_uvs.resize(base + first.size());
+	out_normals.resize(base + first.size());
+	for (size_t k = 0; k < first.size(); k++)	// Copy each unique vertex in first use order
+	{
+		out_vertices[base + k] = in_vertices[first[k]];		// Add the new vertex to our positions list
+		out_uvs[base + k] = in_uvs[first[k]];	// Add the new vertex to our uv list
+		out_normals[base + k] = in_normals[first[k]];	// Add the new vertex to our normal list
+	}
+	
+	out_tangents.assign(out_indices.size(), glm::vec3(0.0f));	// Assign empty tangents ready for further calculation
+}
+
+// The same as IndexVertexData with the work spread over the job system, the output is identical
+// Vertices are bucketed by hash into shards, each shard is deduplicated on its own, then the unique vertices are numbered in input order
+static inline void IndexVertexDataParallel(std::vector<glm::vec3> & in_vertices, std::vector<glm::vec3> & in_uvs, std::vector<glm::vec3> & in_normals, std::vector<unsigned int> & out_indices, std::vector<glm::vec3> & out_vertices, std::vector<glm::vec3> & out_uvs, std::vector<glm::vec3> & out_normals, std::vector<glm::vec3> & out_tangents)
+{
+	size_t n = in_vertices.size();	// Vertex count
+	if (n < VERTEX_PARALLEL_MIN || JobSystem::GetThreadCount() < 2)		// If threads wouldn't pay for themselves
+	{
+		IndexVertexData(in_vertices, in_uvs, in_normals, out_indices, out_vertices, out_uvs, out_normals, out_tangents);	// Run serially
+		return;		// Return from function
+	}
+
+	const size_t shards = (size_t)1 << VERTEX_SHARD_BITS;	// Shard count
+	const size_t blocks = JobSystem::GetThreadCount() * 4;	// Input ranges for counting passes
+	auto shard_of = [](uint64_t h) { return (size_t)(h >> (64 - VERTEX_SHARD_BITS)); };	// Top bits pick the shard, low bits the slot
+	auto block_begin = [&](size_t b) { return n * b / blocks; };	// First vertex of a block
+
+	std::vector<uint64_t> hash(n);	// Hash of each vertex
+	JobSystem::ParallelFor(0, n, 0, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)	// Iterate through each vertex
+			hash[i] = HashPackedVertex(in_vertices[i], in_uvs[i], in_normals[i]);	// Hash it
+	});
+
+	std::vector<uint32_t> offsets(blocks * shards, 0);	// Vertices of each shard in each block, then where they go
+	JobSystem::ParallelFor(0, blocks, 1, [&](size_t first, size_t last)
+	{
+		for (size_t b = first; b < last; b++)	// Iterate through each block
+			for (size_t i = block_begin(b); i < block_begin(b + 1); i++)	// Count vertices per shard
+				offsets[b * shards + shard_of(hash[i])]++;
+	});
+
+	std::vector<uint32_t> shard_begin(shards + 1);	// First slot of each shard in the bucketed order
+	uint32_t at = 0;	// Running offset
+	for (size_t s = 0; s < shards; s++)		// Iterate through each shard
+	{
+		shard_begin[s] = at;
+		for (size_t b = 0; b < blocks; b++)		// Blocks in input order keep each shard in input order
 		{
-			out_vertices.push_back(in_vertices[i]);		// Add the new vertex to our positions list
-			out_uvs.push_back(in_uvs[i]);	// Add the new vertex to our uv list
-			out_normals.push_back(in_normals[i]);	// Add the new vertex to our normal list
-			unsigned int newindex = (unsigned int)out_vertices.size() - 1;	// Set a new index for our out_index list
-			out_indices.push_back(newindex);	// Assign the new index
-			VertexToOutIndex[packed] = newindex;	// Assign the new index to our packed vertex list
+			uint32_t c = offsets[b * shards + s];	// Count
+			offsets[b * shards + s] = at;	// Becomes the write offset
+			at += c;
 		}
-		
 	}
-	
+	shard_begin[shards] = at;
+
+	std::vector<uint32_t> order(n);		// Vertex ids bucketed by shard
+	JobSystem::ParallelFor(0, blocks, 1, [&](size_t first, size_t last)
+	{
+		for (size_t b = first; b < last; b++)	// Iterate through each block
+			for (size_t i = block_begin(b); i < block_begin(b + 1); i++)	// Scatter vertex ids
+				order[offsets[b * shards + shard_of(hash[i])]++] = (uint32_t)i;
+	});
+
+	std::vector<uint32_t> local(n);		// Shard unique id of each vertex
+	std::vector<std::vector<uint32_t>> reps(shards);	// First vertex of each shard unique
+	JobSystem::ParallelFor(0, shards, 1, [&](size_t first, size_t last)
+	{
+		VertexHashTable table;	// Reused across this range's shards
+		for (size_t s = first; s < last; s++)	// Iterate through each shard
+		{
+			table.Reserve((shard_begin[s + 1] - shard_begin[s]) / VERTEX_SHARING);	// Size for the shard
+			for (uint32_t k = shard_begin[s]; k < shard_begin[s + 1]; k++)	// Iterate through the shard's vertices in input order
+			{
+				uint32_t i = order[k];	// Vertex id
+				uint32_t id;	// Shard unique id
+				if (!table.FindOrInsert(hash[i], (uint32_t)reps[s].size(), [&](uint32_t o)
+				{
+					uint32_t r = reps[s][o];	// Earlier vertex
+					return SamePackedVertex(in_vertices[r], in_uvs[r], in_normals[r], in_vertices[i], in_uvs[i], in_normals[i]);
+				}, id))
+					reps[s].push_back(i);	// New unique vertex
+				local[i] = id;
+			}
+		}
+	});
+
+	std::vector<uint32_t> &global = order;	// Output index of each first occurrence (reuses the bucket array)
+	std::vector<uint8_t> first_use(n, 0);	// Is the vertex the first of its kind?
+	JobSystem::ParallelFor(0, shards, 1, [&](size_t first, size_t last)
+	{
+		for (size_t s = first; s < last; s++)	// Iterate through each shard
+			for (uint32_t r : reps[s])	// Mark first occurrences
+				first_use[r] = 1;
+	});
+
+	std::vector<uint32_t> block_base(blocks + 1, 0);	// Unique vertices before each block
+	JobSystem::ParallelFor(0, blocks, 1, [&](size_t first, size_t last)
+	{
+		for (size_t b = first; b < last; b++)	// Iterate through each block
+			for (size_t i = block_begin(b); i < block_begin(b + 1); i++)	// Count first occurrences
+				block_base[b + 1] += first_use[i];
+	});
+	for (size_t b = 0; b < blocks; b++)		// Scan block counts
+		block_base[b + 1] += block_base[b];
+
+	size_t base = out_vertices.size();	// Vertices already in the output
+	size_t index_base = out_indices.size();		// Indices already in the output
+	out_vertices.resize(base + block_base[blocks]);		// Room for the unique vertices
+	out_uvs.resize(base + block_base[blocks]);
+	out_normals.resize(base + block_base[blocks]);
+	out_indices.resize(index_base + n);		// One index per vertex
+
+	JobSystem::ParallelFor(0, blocks, 1, [&](size_t first, size_t last)
+	{
+		for (size_t b = first; b < last; b++)	// Iterate through each block
+		{
+			uint32_t g = block_base[b];		// Next output index
+			for (size_t i = block_begin(b); i < block_begin(b + 1); i++)	// Number first occurrences in input order
+				if (first_use[i])
+				{
+					global[i] = g;	// Record output index
+					out_vertices[base + g] = in_vertices[i];	// Copy vertex
+					out_uvs[base + g] = in_uvs[i];
+					out_normals[base + g] = in_normals[i];
+					g++;
+				}
+		}
+	});
+
+	JobSystem::ParallelFor(0, n, 0, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)	// Iterate through each vertex
+			out_indices[index_base + i] = (unsigned int)(base + global[reps[shard_of(hash[i])][local[i]]]);	// Index of its first occurrence
+	});
+
 	out_tangents.assign(out_indices.size(), glm::vec3(0.0f));	// Assign empty tangents ready for further calculation
 }
 
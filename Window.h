@@ -1,6 +1,9 @@
 #ifndef __WINDOW_H__
 #define __WINDOW_H__
 
+#ifndef NOMINMAX
+#define NOMINMAX	// Keep windows from defining min and max macros over std::min and glm::min
+#endif
 #include <windows.h>	// Include windows for WinAPI framework
 #include "Callback.h"	// Our callback events
 #include "Globals.h"	// Access our global variables